@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <glm/vec3.hpp>
 
 #include "ModelInterface.h"
@@ -84,6 +85,223 @@ namespace PoseEditor {
 		/// </summary>
 		/// <returns>true if the saving succeeded</returns>
 		virtual bool cmdSaveFile(std::string path) = 0;
+		/// <summary>
+		/// call when the UI logic determines the euler angles should be presented in a different rotation order.
+		/// Affects the current pawn and the files opened or created afterwards.
+		/// </summary>
+		/// <param name="order">new rotation order.</param>
+		virtual void cmdSetRotationOrder(PoseData::RotationOrder order) = 0;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should be blended toward the pose stored in the provided file.
+		/// Bones are matched by ID, bones missing in the file keep their rotation. Forms a single undo step.
+		/// </summary>
+		/// <param name="path">file holding the target pose.</param>
+		/// <param name="weight">0 keeps the current pose, 1 takes the target pose.</param>
+		/// <param name="slerp">true to interpolate with slerp instead of nlerp.</param>
+		/// <param name="maskPath">file of per bone factors of weight (see PoseBlend::openMask()), every bone takes weight if empty.</param>
+		/// <returns>true if the files could be opened</returns>
+		virtual bool cmdBlendFile(std::string path, float weight, bool slerp, std::string maskPath) = 0;
+		/// <summary>
+		/// call when the UI logic determines the difference from the pose stored in basePath to the current pawn should be saved
+		/// into path. Applying the saved file as a layer on top of the base pose gives the current pose again.
+		/// </summary>
+		/// <returns>true if the base could be opened and the difference saved</returns>
+		virtual bool cmdSaveDifferenceFile(std::string basePath, std::string path) = 0;
+		/// <summary>
+		/// call when the UI logic determines the difference pose stored in the provided file should be applied as an additive layer
+		/// on top of the current pawn. The layers are kept, so their weights can be changed later. Editing the pawn in any other way
+		/// starts a new stack, on top of the edited pose. Forms a single undo step.
+		/// </summary>
+		/// <param name="path">file holding the difference pose.</param>
+		/// <param name="weight">0 disables the layer, 1 applies it fully.</param>
+		/// <returns>index of the new layer, -1 if the file could not be opened</returns>
+		virtual int cmdAddLayerFile(std::string path, float weight) = 0;
+		/// <summary>
+		/// call when the UI logic determines the layer at index should be applied with a different weight.
+		/// Only that layer is recomputed. Forms a single undo step, wrap slider drags in cmdBeginEdit() and cmdCommitEdit().
+		/// </summary>
+		/// <param name="index">index returned by cmdAddLayerFile().</param>
+		/// <param name="weight">0 disables the layer, 1 applies it fully.</param>
+		virtual void cmdSetLayerWeight(int index, float weight) = 0;
+		/// <summary>
+		/// call when the UI logic determines the current pose should be kept as it is and the layers forgotten.
+		/// </summary>
+		virtual void cmdClearLayers() = 0;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should take the weighted mean pose of the provided files.
+		/// Bones are matched by ID, bones missing in every file keep their rotation. Forms a single undo step.
+		/// </summary>
+		/// <param name="paths">files holding the poses to average.</param>
+		/// <param name="weights">weight of every file, files without a weight get 1.</param>
+		/// <returns>true if all files could be opened</returns>
+		virtual bool cmdAverageFiles(const std::vector<std::string>& paths, const std::vector<float>& weights) = 0;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should be mirrored across the plane. Every selected bone takes the
+		/// reflected rotation of its counterpart on the other side of the skeleton (found by the mirror rules), bones without one
+		/// reflect their own rotation. Forms a single undo step.
+		/// </summary>
+		/// <param name="plane">plane to mirror across.</param>
+		/// <param name="roots">bones whose subtrees are mirrored, all bones if empty.</param>
+		virtual void cmdMirror(PoseData::MirrorPlane plane, const std::vector<ID>& roots) = 0;
+		/// <summary>
+		/// call when the UI logic determines the counterparts of bones should be found by different name patterns.
+		/// </summary>
+		/// <param name="rules">pairs of patterns, the first one contained in a bone name decides.</param>
+		virtual void cmdSetMirrorRules(const std::vector<PoseData::MirrorRule>& rules) = 0;
+		/// <summary>
+		/// call when the UI logic determines poses should be retargeted onto the skeleton stored in the provided file.
+		/// The mapping of bones is built once per source skeleton and reused by every following cmdRetarget().
+		/// </summary>
+		/// <param name="skeletonPath">file holding the target skeleton in its rest pose.</param>
+		/// <param name="mapPath">optional file of "target name, source name" pairs overriding the name matching, empty for none.</param>
+		/// <param name="sourceRestPath">optional file holding the rest pose of the source rig, empty to copy the rotations without
+		/// correcting for the different rest orientations.</param>
+		/// <returns>true if all provided files could be read</returns>
+		virtual bool cmdSetRetargetTarget(std::string skeletonPath, std::string mapPath, std::string sourceRestPath) = 0;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should be replaced by its pose moved onto the retarget skeleton.
+		/// The result is a new unsaved pawn.
+		/// </summary>
+		/// <returns>false if no retarget skeleton was set</returns>
+		virtual bool cmdRetarget() = 0;
+		/// <summary>
+		/// call when the UI logic determines the joint at the tip of a chain should reach the target. The bones from root down to
+		/// the parent of tip are rotated by inverse kinematics and written back as a single undo step (or as part of the open edit).
+		/// The chain is found once and reused while the same root and tip are solved.
+		/// </summary>
+		/// <param name="rootid">first bone of the chain.</param>
+		/// <param name="tipid">bone whose joint should reach the target, a descendant of root.</param>
+		/// <param name="target">world space position.</param>
+		/// <param name="solver">algorithm used.</param>
+		/// <param name="iterations">largest amount of passes over the chain.</param>
+		/// <param name="tolerance">distance from the target at which the solve stops.</param>
+		/// <returns>distance of the tip from the target after the solve, negative if tip is not a descendant of root</returns>
+		virtual float cmdSolveIK(ID rootid, ID tipid, glm::vec3 target, PoseData::IKSolver solver, int iterations, float tolerance) = 0;
+		/// <summary>
+		/// call when the UI logic determines every bone should be brought back within its rotation limits.
+		/// </summary>
+		/// <returns>amount of bones clamped</returns>
+		virtual int cmdClampToLimits() = 0;
+		/// <summary>
+		/// call when the UI logic determines a new animation clip should be started from the current pawn: the pawn becomes the
+		/// skeleton of the clip and its pose the key of every bone at time 0.
+		/// </summary>
+		/// <param name="frameRate">frames per second of the clip.</param>
+		virtual void cmdNewClip(float frameRate) = 0;
+		/// <summary>
+		/// call when the UI logic determines an animation clip should be opened from the provided path (.clip or .clipb).
+		/// The pawn is replaced by the skeleton of the clip posed at time 0.
+		/// </summary>
+		/// <returns>true if the opening succeeded</returns>
+		virtual bool cmdOpenClip(std::string path) = 0;
+		/// <summary>
+		/// call when the UI logic determines the animation clip should be saved to the provided path. Paths ending with .clipb
+		/// are written in the binary format, any other path is given the .clip extension of the text format.
+		/// </summary>
+		/// <returns>true if the saving succeeded</returns>
+		virtual bool cmdSaveClip(std::string path) = 0;
+		/// <summary>
+		/// call when the UI logic determines the pawn should show the animation clip at a different time. Bones are matched to
+		/// the tracks by ID. The pose is not recorded for undo.
+		/// </summary>
+		/// <param name="time">seconds from the start of the clip, clamped to its duration.</param>
+		virtual void cmdSetClipTime(float time) = 0;
+		/// <summary>
+		/// call when the UI logic determines the current pose of the pawn should be keyed into the animation clip. Every track
+		/// with a bone of the same ID in the pawn gets a key at time, replacing the key already there.
+		/// </summary>
+		/// <param name="time">seconds from the start of the clip.</param>
+		virtual void cmdClipKeyPose(float time) = 0;
+		/// <summary>
+		/// call when the UI logic determines tracks of the animation clip should interpolate between their keys differently.
+		/// </summary>
+		/// <param name="boneids">bones whose tracks change, all tracks if empty.</param>
+		virtual void cmdSetClipInterpolation(PoseData::Interpolation interpolation, const std::vector<ID>& boneids) = 0;
+		/// <summary>
+		/// call when the UI logic determines the keys of the animation clip which its interpolation reproduces within a tolerance
+		/// should be removed, such as after recording a key on every frame.
+		/// </summary>
+		/// <param name="tolerance">largest angle in degrees a removed key may lie from its reduced track.</param>
+		/// <param name="globalSpace">true to bound the global orientations of the bones instead of their local rotations.</param>
+		/// <param name="boneids">bones with their own tolerance, given in the same order by tolerances.</param>
+		/// <returns>key counts before and after, and the largest errors.</returns>
+		virtual PoseData::KeyReduction cmdReduceClip(float tolerance, bool globalSpace, const std::vector<ID>& boneids, const std::vector<float>& tolerances) = 0;
+		/// <summary>
+		/// call when the UI logic determines a new pose library should be started on the skeleton of the current pawn, without poses.
+		/// </summary>
+		virtual void cmdNewLibrary() = 0;
+		/// <summary>
+		/// call when the UI logic determines a pose library should be opened from the provided path (.plib).
+		/// The pawn is replaced by the skeleton of the library showing its first pose.
+		/// </summary>
+		/// <returns>true if the opening succeeded</returns>
+		virtual bool cmdOpenLibrary(std::string path) = 0;
+		/// <summary>
+		/// call when the UI logic determines the pose library should be saved to the provided path, given the .plib extension.
+		/// </summary>
+		/// <returns>true if the saving succeeded</returns>
+		virtual bool cmdSaveLibrary(std::string path) = 0;
+		/// <summary>
+		/// call when the UI logic determines the current pose of the pawn should be added to the pose library. Bones are matched
+		/// to the skeleton of the library by ID.
+		/// </summary>
+		/// <returns>index of the added pose, -1 if no library is open.</returns>
+		virtual int cmdLibraryAddPose() = 0;
+		/// <summary>
+		/// call when the UI logic determines the pawn should show a different pose of the library. Bones are matched to the
+		/// skeleton of the library by ID. Takes the same time for any pose of any library. The pose is not recorded for undo.
+		/// </summary>
+		/// <param name="pose">index of the pose, clamped to the poses of the library.</param>
+		virtual void cmdShowLibraryPose(int pose) = 0;
+		/// <summary>
+		/// call when the UI logic determines the poses of the library closest to the current pawn should be found. Bones are
+		/// matched to the skeleton of the library by ID. The search index is built by the first search and again once the library
+		/// or the compared bones change, after which a search takes milliseconds in a library of millions of poses.
+		/// </summary>
+		/// <param name="count">most poses found, the closest ones. 0 or less finds every pose within radius.</param>
+		/// <param name="radius">largest distance in degrees of a found pose (see PoseSearch), negative for any distance.</param>
+		/// <param name="global">compares the global orientations of the bones instead of their local rotations.</param>
+		/// <param name="boneids">key bones compared, every bone when empty.</param>
+		/// <returns>the poses found, closest first. The library state lists them too.</returns>
+		virtual std::vector<PoseData::PoseMatch> cmdFindSimilarPoses(int count, float radius, bool global, const std::vector<ID>& boneids) = 0;
+		/// <summary>
+		/// call when the UI logic determines the poses of the library should be replaced by representatives of clusters of
+		/// similar poses (see PoseCluster). With a count the poses are split into that many clusters by k-means, otherwise the
+		/// poses within threshold of an earlier pose are collapsed into it. The library is left unsaved, showing its first pose.
+		/// The replaced poses are kept until the library is saved, so cmdRestoreLibrary() can bring them back.
+		/// </summary>
+		/// <param name="count">amount of clusters, 0 or less deduplicates instead.</param>
+		/// <param name="threshold">largest distance in degrees of a pose collapsed by deduplication.</param>
+		/// <param name="global">compares the global orientations of the bones instead of their local rotations.</param>
+		/// <param name="boneids">key bones compared, every bone when empty.</param>
+		/// <param name="mappingPath">file the cluster of every pose is written to as csv (see PoseCluster::saveMapping()), if not empty.</param>
+		/// <returns>amount of poses before and after, and their distances to the representatives. Zero poses if nothing was done.</returns>
+		virtual PoseData::ClusterReport cmdClusterLibrary(int count, float threshold, bool global, const std::vector<ID>& boneids, std::string mappingPath) = 0;
+		/// <summary>
+		/// call when the UI logic determines the poses replaced by cmdClusterLibrary() should come back. Restores the library as
+		/// it was before its first clustering since it was last saved, opened or created. Adding a pose or saving the library
+		/// releases the replaced poses.
+		/// </summary>
+		/// <returns>true if the poses were restored.</returns>
+		virtual bool cmdRestoreLibrary() = 0;
+
+		/// <summary>
+		/// call when the UI logic begins a continuous edit, such as dragging a slider. Commands issued until cmdCommitEdit()
+		/// form a single undo step, so the UI may send one command per frame while the user drags.
+		/// </summary>
+		virtual void cmdBeginEdit() = 0;
+		/// <summary>
+		/// call when the UI logic finishes a continuous edit started by cmdBeginEdit().
+		/// </summary>
+		virtual void cmdCommitEdit() = 0;
+		/// <summary>
+		/// call when the UI logic determines the last bone operation should be reverted.
+		/// </summary>
+		virtual void cmdUndo() = 0;
+		/// <summary>
+		/// call when the UI logic determines the last reverted bone operation should be reapplied.
+		/// </summary>
+		virtual void cmdRedo() = 0;
 
 		/// <summary>
 		/// call when the UI logic determines a new bone should be added.
@@ -129,5 +347,23 @@ namespace PoseEditor {
 		/// <param name="boneid">bone to be changed.</param>
 		/// <param name="parentid">new parent id, pass -1 to make the provided bone a root bone.</param>
 		virtual void cmdBoneSetParent(ID boneid, ID parentid) = 0;
+		/// <summary>
+		/// call when the UI logic determines the given bone should sit at a different offset from its parent joint.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="offset">position of the joint relative to the parent joint, in the frame of the parent.</param>
+		virtual void cmdBoneSetOffset(ID boneid, glm::vec3 offset) = 0;
+		/// <summary>
+		/// call when the UI logic determines the given bone should get new rotation limits. The current rotation is clamped to them.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="limit">swing and twist range in degrees.</param>
+		virtual void cmdBoneSetLimit(ID boneid, PoseData::JointLimit limit) = 0;
+		/// <summary>
+		/// call when the UI logic determines the given bone should be driven by another bone, or no longer be driven.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="constraint">new constraint, ConstraintType::Free removes it.</param>
+		virtual void cmdBoneSetConstraint(ID boneid, PoseData::BoneConstraint constraint) = 0;
 	};
 }
\ No newline at end of file
@@ -15,18 +15,175 @@ PoseEditor::ApplicationInstance* app;
 int main(int argc, char* argv[]) {
 	std::printf("Welcome to pose editor\n");
 
-	// At this stage you could introduce any other combination of components using command line arguments:
-	app = new PoseEditor::ApplicationInstance();
-	app->initComponents(
-		/* dynamic cast here is needed because due to the interdependence of the interfaces and forward declaration,
-		the implementations don't realize they are children of their interfaces in this scope. */
-		std::dynamic_pointer_cast<PoseEditor::Model>(std::make_shared<PoseModel::PoseModel>()),
-		std::dynamic_pointer_cast<PoseEditor::Viewer>(std::make_shared<ViewerGUI::ViewerGLFW>()),
-		std::dynamic_pointer_cast<PoseEditor::Controller>(std::make_shared<PoseController::PoseController>()));
-	app->init();
-	app->start();
-
-	return 0;
+	std::vector<std::string> args(argv + 1, argv + argc);
+
+	// --trace <path> records the whole session regardless of the other switches:
+	for (size_t i = 0; i + 1 < args.size(); i++) {
+		if (args[i] == "--trace") {
+#if PROFILER_ENABLED
+			Trace::setOutputPath(args[i + 1]);
+			Trace::start();
+			args.erase(args.begin() + i, args.begin() + i + 2);
+			break;
+#else
+			// the events come from the profiling scopes, a trace of this build would be empty:
+			std::fprintf(stderr, "Trouble starting trace: profiling is compiled out of this build (PROFILER_ENABLED 0).\n");
+			return 1;
+#endif
+		}
+	}
+
+	// benchmarks count heap allocations, the editor does not:
+	if (!args.empty() && args[0].compare(0, 8, "--bench-") == 0)
+		Benchmark::setAllocationCounting(true);
+
+	int result = 0;
+	// Headless operations requested on the command line skip the editor window entirely:
+	if (!args.empty() && args[0] == "--bench-ui") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000;
+		int frames = args.size() > 2 ? std::atoi(args[2].c_str()) : 100;
+		result = Benchmark::runUIBenchmark(bones, frames);
+	}
+	else if (!args.empty() && args[0] == "--bench-fk") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 100000;
+		int iterations = args.size() > 2 ? std::atoi(args[2].c_str()) : 100;
+		result = Benchmark::runFKBenchmark(bones, iterations);
+	}
+	else if (!args.empty() && args[0] == "--bench-euler") {
+		int rotations = args.size() > 1 ? std::atoi(args[1].c_str()) : 10000000;
+		int iterations = args.size() > 2 ? std::atoi(args[2].c_str()) : 3;
+		result = Benchmark::runEulerBenchmark(rotations, iterations);
+	}
+	else if (!args.empty() && args[0] == "--bench-blend") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000000;
+		int iterations = args.size() > 2 ? std::atoi(args[2].c_str()) : 20;
+		result = Benchmark::runBlendBenchmark(bones, iterations);
+	}
+	else if (!args.empty() && args[0] == "--bench-layers") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000000;
+		int layers = args.size() > 2 ? std::atoi(args[2].c_str()) : 8;
+		int iterations = args.size() > 3 ? std::atoi(args[3].c_str()) : 10;
+		result = Benchmark::runLayerBenchmark(bones, layers, iterations);
+	}
+	else if (!args.empty() && args[0] == "--bench-average") {
+		int poses = args.size() > 1 ? std::atoi(args[1].c_str()) : 10000;
+		int bones = args.size() > 2 ? std::atoi(args[2].c_str()) : 500;
+		int iterations = args.size() > 3 ? std::atoi(args[3].c_str()) : 3;
+		result = Benchmark::runAverageBenchmark(poses, bones, iterations);
+	}
+	else if (!args.empty() && args[0] == "--bench-mirror") {
+		int poses = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000;
+		int bones = args.size() > 2 ? std::atoi(args[2].c_str()) : 1000;
+		result = Benchmark::runMirrorBenchmark(poses, bones);
+	}
+	else if (!args.empty() && args[0] == "--bench-retarget") {
+		int poses = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000;
+		int bones = args.size() > 2 ? std::atoi(args[2].c_str()) : 1000;
+		result = Benchmark::runRetargetBenchmark(poses, bones);
+	}
+	else if (!args.empty() && args[0] == "--bench-ik") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 100;
+		int solves = args.size() > 2 ? std::atoi(args[2].c_str()) : 1000;
+		result = Benchmark::runIKBenchmark(bones, solves);
+	}
+	else if (!args.empty() && args[0] == "--bench-limits") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000000;
+		int iterations = args.size() > 2 ? std::atoi(args[2].c_str()) : 10;
+		result = Benchmark::runLimitsBenchmark(bones, iterations);
+	}
+	else if (!args.empty() && args[0] == "--bench-constraints") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 100000;
+		int iterations = args.size() > 2 ? std::atoi(args[2].c_str()) : 100;
+		result = Benchmark::runConstraintBenchmark(bones, iterations);
+	}
+	else if (!args.empty() && args[0] == "--bench-clip") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 500;
+		int frames = args.size() > 2 ? std::atoi(args[2].c_str()) : 10000;
+		result = Benchmark::runClipBenchmark(bones, frames);
+	}
+	else if (!args.empty() && args[0] == "--bench-reduce") {
+		int bones = args.size() > 1 ? std::atoi(args[1].c_str()) : 500;
+		int frames = args.size() > 2 ? std::atoi(args[2].c_str()) : 3000;
+		result = Benchmark::runReduceBenchmark(bones, frames);
+	}
+	else if (!args.empty() && args[0] == "--bench-quantize") {
+		int poses = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000000;
+		int bones = args.size() > 2 ? std::atoi(args[2].c_str()) : 8;
+		result = Benchmark::runQuantizeBenchmark(poses, bones);
+	}
+	else if (!args.empty() && args[0] == "--bench-library") {
+		int poses = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000000;
+		int bones = args.size() > 2 ? std::atoi(args[2].c_str()) : 16;
+		result = Benchmark::runLibraryBenchmark(poses, bones);
+	}
+	else if (!args.empty() && args[0] == "--bench-search") {
+		int poses = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000000;
+		int bones = args.size() > 2 ? std::atoi(args[2].c_str()) : 16;
+		result = Benchmark::runSearchBenchmark(poses, bones);
+	}
+	else if (!args.empty() && args[0] == "--bench-cluster") {
+		int poses = args.size() > 1 ? std::atoi(args[1].c_str()) : 1000000;
+		int bones = args.size() > 2 ? std::atoi(args[2].c_str()) : 16;
+		result = Benchmark::runClusterBenchmark(poses, bones);
+	}
+	else if (!args.empty() && args[0] == "--blend") {
+		result = CommandLine::runBlend(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--difference") {
+		result = CommandLine::runDifference(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--layer") {
+		result = CommandLine::runLayer(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--average") {
+		result = CommandLine::runAverage(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--mirror") {
+		result = CommandLine::runMirror(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--retarget") {
+		result = CommandLine::runRetarget(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--ik") {
+		result = CommandLine::runIK(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--clip") {
+		result = CommandLine::runClip(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--reduce") {
+		result = CommandLine::runReduce(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--compact") {
+		result = CommandLine::runCompact(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--library") {
+		result = CommandLine::runLibrary(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--search") {
+		result = CommandLine::runSearch(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else if (!args.empty() && args[0] == "--cluster") {
+		result = CommandLine::runCluster(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	else {
+		// At this stage you could introduce any other combination of components using command line arguments:
+		app = new PoseEditor::ApplicationInstance();
+		app->initComponents(
+			/* dynamic cast here is needed because due to the interdependence of the interfaces and forward declaration,
+			the implementations don't realize they are children of their interfaces in this scope. */
+			std::dynamic_pointer_cast<PoseEditor::Model>(std::make_shared<PoseModel::PoseModel>()),
+			std::dynamic_pointer_cast<PoseEditor::Viewer>(std::make_shared<ViewerGUI::ViewerGLFW>()),
+			std::dynamic_pointer_cast<PoseEditor::Controller>(std::make_shared<PoseController::PoseController>()));
+		app->init();
+		app->start();
+	}
+
+	if (Trace::isCapturing()) {
+		Trace::stop();
+		if (Trace::flush(Trace::getOutputPath()))
+			std::printf("Trace written: %s\n", Trace::getOutputPath().c_str());
+	}
+	return result;
 }
 
 void PoseEditor::ApplicationInstance::initComponents(
@@ -52,6 +209,7 @@ bool PoseEditor::ApplicationInstance::init() {
 void PoseEditor::ApplicationInstance::start() {
 	running = true;
 	while (running) {
+		PROFILE_SCOPE("ApplicationInstance::frame");
 		controller->update();
 		running = controller->getApplicationActive();
 	}
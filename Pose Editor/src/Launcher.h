@@ -12,10 +12,15 @@
 
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "view_glfw/ViewerGUI.h"
 #include "model/PoseDataModel.h"
 #include "controller/PoseController.h"
+#include "benchmark/Benchmark.h"
+#include "cli/CommandLine.h"
+#include "profiler/Profiler.h"
 
 namespace PoseEditor {
 
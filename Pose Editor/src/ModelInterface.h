@@ -38,11 +38,39 @@ namespace PoseEditor {
 		/// </summary>
 		virtual void resetDelta() = 0;
 
+		/// <returns>
+		/// details on which bones changed since the last resetDelta().
+		/// </returns>
+		virtual const PoseData::PawnDelta& getDelta() = 0;
+
+		/// <returns>
+		/// count of the changes to the bones or rotations of the pawn so far. Equal values mean the pose did not change in between.
+		/// </returns>
+		virtual unsigned long long getPoseRevision() = 0;
+
+		/// <returns>
+		/// count of the changes to the bone set of the pawn so far: bones added, removed or reordered, or a new pawn.
+		/// Equal values mean the pawn holds the same bones in the same order.
+		/// </returns>
+		virtual unsigned long long getStructureRevision() = 0;
+
 		/// <summary>
 		/// Provides a const reference to the current pawn for other parts of the program.
 		/// </summary>
 		const virtual PoseData::BonePawn& getCurrentPawn() = 0;
 
+		/// <summary>
+		/// Provides the global rotation (parent_global * local) of the given bone.
+		/// </summary>
+		/// <returns>global rotation or identity if the bone does not exist.</returns>
+		virtual glm::quat getGlobalRotation(ID boneid) = 0;
+
+		/// <summary>
+		/// Provides the world space position of the joint of the given bone, derived from the offsets and global rotations of its ancestors.
+		/// </summary>
+		/// <returns>joint position or the origin if the bone does not exist.</returns>
+		virtual glm::vec3 getJointPosition(ID boneid) = 0;
+
 		// === command functions ===
 
 		/// <summary>
@@ -65,6 +93,31 @@ namespace PoseEditor {
 		/// called by Controller to set whether the current BonePawn has been saved. This value will be dirtied by any transformative opearation.
 		/// </summary>
 		virtual void cmdSetSaved(bool arg) = 0;
+		/// <summary>
+		/// called by Controller to change the order in which the euler angles of the pawn are applied. The quaternions are kept,
+		/// euler angles of all bones (including the undo history) are derived anew in the given order. An open edit is
+		/// committed first, so its step is converted with the rest of the history.
+		/// </summary>
+		/// <param name="order">new rotation order.</param>
+		virtual void cmdSetRotationOrder(PoseData::RotationOrder order) = 0;
+
+		/// <summary>
+		/// called by Controller when a continuous edit (such as dragging a slider) begins. All commands until the matching
+		/// cmdCommitEdit() form a single undo step. Transactions may nest, only the outermost one records the undo step.
+		/// </summary>
+		virtual void cmdBeginEdit() = 0;
+		/// <summary>
+		/// called by Controller when a continuous edit ends. Closes the transaction opened by cmdBeginEdit().
+		/// </summary>
+		virtual void cmdCommitEdit() = 0;
+		/// <summary>
+		/// called by Controller to revert the bones to the state before the last undoable command or transaction.
+		/// </summary>
+		virtual void cmdUndo() = 0;
+		/// <summary>
+		/// called by Controller to reapply the last command or transaction reverted by cmdUndo().
+		/// </summary>
+		virtual void cmdRedo() = 0;
 
 		/// <summary>
 		/// called by Controller to add a new bone.
@@ -110,5 +163,49 @@ namespace PoseEditor {
 		/// <param name="boneid">bone to be changed.</param>
 		/// <param name="parentid">new parent id, pass -1 to make the provided bone a root bone.</param>
 		virtual void cmdBoneSetParent(ID boneid, ID parentid) = 0;
+		/// <summary>
+		/// called by Controller to move a joint relative to its parent joint. The joints of the whole subtree follow.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="offset">position of the joint relative to the parent joint, in the frame of the parent.</param>
+		virtual void cmdBoneSetOffset(ID boneid, glm::vec3 offset) = 0;
+		/// <summary>
+		/// called by Controller to replace the rotation of every bone at once, such as with the result of a blend.
+		/// The euler angles are derived from the new quaternions. Forms a single undo step.
+		/// </summary>
+		/// <param name="rotations">new quaternions indexed the same as the pawn's bones. Ignored if the sizes differ.</param>
+		virtual void cmdPawnSetRotations(const std::vector<glm::quat>& rotations) = 0;
+		/// <summary>
+		/// called by Controller to show a frame of an animation clip or a pose of a library. Same as cmdPawnSetRotations(), except the
+		/// rotations are not clamped, the change is not recorded for undo and does not mark the pawn unsaved: the pose is stored there.
+		/// Ignored during an open edit.
+		/// </summary>
+		/// <param name="rotations">new quaternions indexed the same as the pawn's bones. Ignored if the sizes differ.</param>
+		virtual void cmdPawnPlayRotations(const std::vector<glm::quat>& rotations) = 0;
+		/// <summary>
+		/// called by Controller to set the rotations of several bones at once, such as the result of an inverse kinematics solve.
+		/// Every bone is updated the same as by cmdBoneSetRotation(), but from a quaternion. Forms a single undo step.
+		/// </summary>
+		/// <param name="boneids">bones to be changed, bones not found are skipped.</param>
+		/// <param name="rotations">new quaternion of every bone in boneids. Ignored if the sizes differ.</param>
+		virtual void cmdBonesSetRotations(const std::vector<ID>& boneids, const std::vector<glm::quat>& rotations) = 0;
+		/// <summary>
+		/// called by Controller to change the rotation limits of a bone. The limit is sanitized first and the current rotation
+		/// is clamped to it.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="limit">new limit in degrees.</param>
+		virtual void cmdBoneSetLimit(ID boneid, PoseData::JointLimit limit) = 0;
+		/// <summary>
+		/// called by Controller to clamp the rotation of every bone to its limits. Forms a single undo step if anything was clamped.
+		/// </summary>
+		/// <returns>amount of bones clamped.</returns>
+		virtual int cmdClampToLimits() = 0;
+		/// <summary>
+		/// called by Controller to change the constraint of a bone. The bone and every constraint reading it are re-evaluated.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="constraint">new constraint, ConstraintType::Free removes it.</param>
+		virtual void cmdBoneSetConstraint(ID boneid, PoseData::BoneConstraint constraint) = 0;
 	};
 }
\ No newline at end of file
@@ -19,11 +19,48 @@ typedef int ID;
 
 namespace PoseData {
 
+	/// <summary>
+	/// Rotation limits of a joint in degrees, split into the twist about the local Y axis of the bone and the swing of that axis away
+	/// from the parent's. The defaults do not limit anything.
+	/// </summary>
+	struct JointLimit {
+		/// <summary>largest angle the local Y axis may swing away, within [0, 180].</summary>
+		float swing = 180.0f;
+		/// <summary>smallest twist about the local Y axis, within [-180, twistMax].</summary>
+		float twistMin = -180.0f;
+		/// <summary>largest twist about the local Y axis, within [twistMin, 180].</summary>
+		float twistMax = 180.0f;
+	};
+
+	/// <summary>
+	/// Ways a constraint derives the local rotation of a bone from another bone, its driver.
+	/// </summary>
+	enum class ConstraintType {
+		/// <summary>the bone is posed directly.</summary>
+		Free,
+		/// <summary>the local rotation of the driver scaled by the factor, 1 copies it as is.</summary>
+		CopyRotation,
+		/// <summary>the twist of the driver about its local Y axis scaled by the factor replaces the twist of the bone, its swing is kept.</summary>
+		Twist,
+		/// <summary>the smallest turn pointing the local Y axis of the bone at the joint of the driver. Does not use the factor.</summary>
+		AimAt
+	};
+
+	/// <summary>
+	/// Rotation constraint of a bone, evaluated by the Model whenever the driver (or anything it depends on) changes.
+	/// </summary>
+	struct BoneConstraint {
+		ConstraintType type = ConstraintType::Free;
+		/// <summary>ID of the bone the rotation is derived from.</summary>
+		ID driver = -1;
+		float factor = 1.0f;
+	};
+
 	/// <summary>
 	/// Data corresponding to an individual bone. Additionally, keeps track of euler angles for the use in View.
 	/// </summary>
 	struct BoneData {
-		//[BoneID] [ParentBoneID] [Quaternion X] [Quaternion Y] [Quaternion Z] [Quaternion W] [Name]
+		//[BoneID] [ParentBoneID] [Quaternion X] [Quaternion Y] [Quaternion Z] [Quaternion W] [Name] ([Offset X] [Offset Y] [Offset Z] ([Swing] [Twist Min] [Twist Max] ([Constraint] [Driver] [Factor])))
 		ID id;
 		ID parent;
 		/// <summary>Should be kept synchronized with eulerRotation.</summary>
@@ -31,8 +68,48 @@ namespace PoseData {
 		/// <summary>Euler angles of rotation (in degrees) Should be kept synchronized with quaternion.</summary>
 		glm::vec3 eulerRotation = glm::vec3(0, 0, 0); //generated value
 		std::string displayName;
+		/// <summary>
+		/// Position of the joint relative to the parent joint, in the frame of the parent. For roots the position in world space.
+		/// Optional in the file, bones without it sit on their parent's joint.
+		/// </summary>
+		glm::vec3 offset = glm::vec3(0, 0, 0);
+		/// <summary>rotation limits enforced by the Model. Optional in the file.</summary>
+		JointLimit limit;
+		/// <summary>rotation constraint evaluated by the Model. Optional in the file.</summary>
+		BoneConstraint constraint;
 	};
 
+	/// <summary>
+	/// Order in which the euler angles of a bone are applied. XYZ rotates about X first, then Y and Z last (q = qZ * qY * qX),
+	/// which is the convention of glm::quat(glm::vec3) and glm::eulerAngles. Target engines differ in the order they expect.
+	/// </summary>
+	enum class RotationOrder { XYZ, XZY, YXZ, YZX, ZXY, ZYX };
+
+	/// <summary>
+	/// Plane a pose is mirrored across, named by the two axes it contains. YZ swaps left and right of a skeleton facing along Z.
+	/// </summary>
+	enum class MirrorPlane { YZ, XZ, XY };
+
+	/// <summary>
+	/// Pair of bone name patterns marking the two sides of a skeleton, such as Left / Right.
+	/// </summary>
+	struct MirrorRule {
+		std::string left;
+		std::string right;
+	};
+
+	/// <summary>
+	/// Inverse kinematics algorithm. CCD turns one joint at a time toward the target, starting at the tip, which bends the end of the chain most.
+	/// FABRIK moves the joints along the chain first and derives the rotations afterwards, which spreads the bend more evenly.
+	/// </summary>
+	enum class IKSolver { CCD, FABRIK };
+
+	/// <summary>
+	/// Interpolation between the keys of an animation track. Step holds every key until the next one. Nlerp normalizes the linear
+	/// interpolation of the quaternions, Slerp also keeps the angular speed constant. Both take the shorter path.
+	/// </summary>
+	enum class Interpolation { Step, Nlerp, Slerp };
+
 	/// <summary>
 	/// BonePawn is mostly just a vector of bones. The idea is that you can include meta information such as the original file path
 	/// in case your controller can handle multiple editor windows, etc.
@@ -55,6 +132,123 @@ namespace PoseData {
 		/// false if any change occured on this pawn which has not yet been recorded to a permanent file.
 		/// </summary>
 		bool saved = false;
+		/// <summary>
+		/// Order of the euler angles presented to the user. Quaternions are the stored rotation, so this does not affect the saved file.
+		/// </summary>
+		RotationOrder rotationOrder = RotationOrder::XYZ;
+	};
+
+	/// <summary>
+	/// Summary of the animation clip edited alongside the pawn, as presented by the View. The pawn shows the pose of the clip at time.
+	/// </summary>
+	struct ClipState {
+		/// <summary>true if a clip is open.</summary>
+		bool loaded = false;
+		/// <summary>the full path the clip was loaded from or saved to. Empty for new clips.</summary>
+		std::string filePath = "";
+		std::string fileName = "";
+		/// <summary>false if the clip changed since it was loaded or saved.</summary>
+		bool saved = true;
+		float frameRate = 30.0f;
+		/// <summary>time of the last key in seconds.</summary>
+		float duration = 0.0f;
+		/// <summary>time shown by the pawn in seconds.</summary>
+		float time = 0.0f;
+		int trackCount = 0;
+		int keyCount = 0;
+		/// <summary>interpolation of the first track.</summary>
+		Interpolation interpolation = Interpolation::Nlerp;
+		/// <summary>true if the tracks do not share the same interpolation.</summary>
+		bool mixedInterpolation = false;
+	};
+
+	/// <summary>
+	/// A pose of the library found by a similarity search.
+	/// </summary>
+	struct PoseMatch {
+		/// <summary>index of the pose in the library.</summary>
+		int pose = -1;
+		std::string name = "";
+		/// <summary>distance from the searched pose in degrees.</summary>
+		float distance = 0.0f;
+	};
+
+	/// <summary>
+	/// Summary of the pose library browsed alongside the pawn, as presented by the View.
+	/// </summary>
+	struct LibraryState {
+		/// <summary>true if a library is open.</summary>
+		bool loaded = false;
+		/// <summary>the full path the library was loaded from or saved to. Empty for new libraries.</summary>
+		std::string filePath = "";
+		std::string fileName = "";
+		/// <summary>false if poses were added since the library was loaded or saved.</summary>
+		bool saved = true;
+		int poseCount = 0;
+		int boneCount = 0;
+		/// <summary>pose shown by the pawn, -1 if none.</summary>
+		int pose = -1;
+		std::string poseName = "";
+		/// <summary>poses found by the last similarity search, closest first.</summary>
+		std::vector<PoseMatch> matches;
+		/// <summary>true if the poses replaced by clustering can still be restored, see cmdRestoreLibrary().</summary>
+		bool restorable = false;
+	};
+
+	/// <summary>
+	/// Outcome of removing the keys of a clip which its interpolation reproduces within a tolerance.
+	/// </summary>
+	struct KeyReduction {
+		int keysBefore = 0;
+		int keysAfter = 0;
+		/// <summary>largest angle in degrees between a removed key and its track after the reduction, at the time of the key.</summary>
+		float maxError = 0.0f;
+		/// <summary>largest angle in degrees between a global bone orientation before and after the reduction, -1 if not measured.</summary>
+		float maxGlobalError = -1.0f;
+	};
+
+	/// <summary>
+	/// Outcome of replacing the poses of a library by representatives of clusters of similar poses.
+	/// </summary>
+	struct ClusterReport {
+		int posesBefore = 0;
+		int posesAfter = 0;
+		/// <summary>largest and mean distance in degrees from a pose to the representative of its cluster.</summary>
+		float maxDistance = 0.0f;
+		float meanDistance = 0.0f;
+		/// <summary>passes of k-means, 1 for deduplication.</summary>
+		int iterations = 0;
+	};
+
+	/// <summary>
+	/// Describes which parts of the pawn changed since the Model's delta was last reset.
+	/// Allows the View to refresh only the information derived from the affected bones.
+	/// </summary>
+	struct PawnDelta {
+		/// <summary>
+		/// true if bones were replaced, added, removed or reordered. Any per-bone information should be considered stale.
+		/// </summary>
+		bool structure = false;
+		/// <summary>
+		/// IDs of bones whose id, name or parent changed.
+		/// </summary>
+		std::vector<ID> labels;
+		/// <summary>
+		/// IDs of bones whose rotation changed.
+		/// </summary>
+		std::vector<ID> rotations;
+		/// <summary>
+		/// IDs of bones whose offset changed.
+		/// </summary>
+		std::vector<ID> offsets;
+		/// <summary>
+		/// IDs of bones whose rotation limits changed.
+		/// </summary>
+		std::vector<ID> limits;
+		/// <summary>
+		/// IDs of bones whose constraint changed.
+		/// </summary>
+		std::vector<ID> constraints;
 	};
 
 }
\ No newline at end of file
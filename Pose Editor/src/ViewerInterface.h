@@ -58,6 +58,19 @@ namespace PoseEditor {
 		/// It is important that this reference is const to avoid improper application design.
 		/// </summary>
 		/// <param name="currentPawn">Const reference to the active pawn in the model.</param>
-		virtual void updateView(const PoseData::BonePawn currentPawn) = 0;
+		/// <param name="delta">Which bones of the pawn changed since the last call.</param>
+		virtual void updateView(const PoseData::BonePawn& currentPawn, const PoseData::PawnDelta& delta) = 0;
+
+		/// <summary>
+		/// Called by the controller whenever the animation clip, or the time shown from it, changes.
+		/// </summary>
+		/// <param name="clip">Const reference to the state of the clip held by the controller.</param>
+		virtual void updateClip(const PoseData::ClipState& clip) = 0;
+
+		/// <summary>
+		/// Called by the controller whenever the pose library, or the pose shown from it, changes.
+		/// </summary>
+		/// <param name="library">Const reference to the state of the library held by the controller.</param>
+		virtual void updateLibrary(const PoseData::LibraryState& library) = 0;
 	};
 }
\ No newline at end of file
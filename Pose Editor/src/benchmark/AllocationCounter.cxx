@@ -0,0 +1,65 @@
+/// <title>Allocation Counter</title>
+/// <desc>
+///		Counts heap allocations of the whole process so benchmarks can verify allocation-free code paths.
+///		Replaces the global operator new and delete of the whole executable and provides allocator hooks for ImGui.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.h"
+
+/* relaxed ordering is enough, the counter is only compared between two points on the same thread */
+static std::atomic<size_t> s_AllocationCount(0);
+static std::atomic<bool> s_Counting(false);
+
+void Benchmark::setAllocationCounting(bool enabled) {
+	s_Counting.store(enabled, std::memory_order_relaxed);
+}
+
+size_t Benchmark::getAllocationCount() {
+	return s_AllocationCount.load(std::memory_order_relaxed);
+}
+
+void* Benchmark::imguiCountingAlloc(size_t size, void*) {
+	if (s_Counting.load(std::memory_order_relaxed))
+		s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size);
+}
+
+void Benchmark::imguiCountingFree(void* ptr, void*) {
+	std::free(ptr);
+}
+
+void* operator new(size_t size) {
+	if (s_Counting.load(std::memory_order_relaxed))
+		s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
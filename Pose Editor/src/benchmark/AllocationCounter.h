@@ -0,0 +1,37 @@
+/// <title>Allocation Counter</title>
+/// <desc>
+///		Counts heap allocations of the whole process so benchmarks can verify allocation-free code paths.
+///		Replaces the global operator new and delete of the whole executable, the editor included, and provides allocator
+///		hooks for ImGui, which allocates through malloc. The replacements only count while counting is enabled, which
+///		the Launcher does for the --bench-* switches, otherwise they forward to malloc and free.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <cstddef>
+
+namespace Benchmark {
+
+	/// <summary>
+	/// Starts or stops counting allocations. Off by default, so the editor pays no atomic increment per allocation.
+	/// </summary>
+	void setAllocationCounting(bool enabled);
+
+	/// <returns>
+	/// total amount of allocations made through operator new and the ImGui hooks while counting was enabled.
+	/// </returns>
+	size_t getAllocationCount();
+
+	/// <summary>
+	/// Allocator for ImGui::SetAllocatorFunctions() which counts towards getAllocationCount().
+	/// </summary>
+	void* imguiCountingAlloc(size_t size, void* userData);
+	/// <summary>
+	/// Deallocator for ImGui::SetAllocatorFunctions() matching imguiCountingAlloc().
+	/// </summary>
+	void imguiCountingFree(void* ptr, void* userData);
+}
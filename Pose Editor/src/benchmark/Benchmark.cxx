@@ -0,0 +1,1640 @@
+/// <title>Benchmark</title>
+/// <desc>
+///		Headless performance measurements of the application components.
+///		Launched from the command line (see Launcher.cxx) so they can run on machines without a GPU.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#define WARMUP_FRAMES 3
+#define DISPLAY_WIDTH 1280.f
+#define DISPLAY_HEIGHT 720.f
+#define FK_TOLERANCE 1e-4f
+#define FK_EDITED_SUBTREE 21
+#define BLEND_TOLERANCE 1e-5f
+#define BLEND_WEIGHT 0.3f
+#define LAYER_TOLERANCE 1e-5f
+/// <summary>largest angle in radians the poses of the average benchmark deviate from the base pose.</summary>
+#define AVERAGE_SPREAD 0.3f
+#define RETARGET_TOLERANCE 1e-5f
+#define IK_TOLERANCE 1e-3f
+/// <summary>turn limit in radians of the limited CCD variant of the IK benchmark.</summary>
+#define IK_MAX_TURN 0.1f
+/// <summary>passes allowed when a target missed by the IK benchmark is solved again, enough for every solver to reach it.</summary>
+#define IK_REACH_PASSES 20000
+/// <summary>degrees a clamped rotation may lie outside its limit in the limits benchmark.</summary>
+#define LIMITS_TOLERANCE 1e-2f
+#define CONSTRAINT_TOLERANCE 1e-4f
+/// <summary>frames of the synthetic clip of the clip benchmark.</summary>
+#define CLIP_FRAMES 300
+/// <summary>tolerance in degrees of the reduce benchmark, and the slack of checking it by sampling.</summary>
+#define REDUCE_TOLERANCE 0.5f
+#define REDUCE_SLACK 0.05f
+/// <summary>most poses of the quantize benchmark written into the pose file text which is parsed.</summary>
+#define QUANTIZE_CSV_POSES 20000
+/// <summary>random poses read, and poses shown through the controller, by the library benchmark.</summary>
+#define LIBRARY_LOOKUPS 100000
+#define LIBRARY_SHOWS 1000
+/// <summary>frames of a take of the search benchmark, and the largest turn in radians of a bone between its frames.</summary>
+#define SEARCH_TAKE_FRAMES 1000
+#define SEARCH_STEP 0.02f
+/// <summary>queries of the search benchmark, the poses a nearest neighbour query asks for and the radius in degrees of a range query.</summary>
+#define SEARCH_QUERIES 200
+#define SEARCH_COUNT 10
+#define SEARCH_RADIUS 3.0f
+/// <summary>degrees a distance found by the tree may differ from the scan, for rounding.</summary>
+#define SEARCH_TOLERANCE 1e-3f
+/// <summary>frames a pose of the cluster benchmark is held, the largest jitter in radians of a bone while held and the largest turn between held poses.</summary>
+#define CLUSTER_HOLD_FRAMES 8
+#define CLUSTER_JITTER 0.002f
+#define CLUSTER_STEP 0.2f
+/// <summary>threshold in degrees of the deduplication and the amount of clusters of k-means in the cluster benchmark.</summary>
+#define CLUSTER_THRESHOLD 1.0f
+#define CLUSTER_COUNT 256
+/// <summary>
+/// smallest root mean square angle in degrees between the known poses k-means has to recover in the cluster benchmark, and the
+/// largest jitter in radians around them. The jitter is kept tiny, k-means++ then seeds two centers on one known pose too rarely to matter.
+/// </summary>
+#define CLUSTER_SEPARATION 10.0f
+#define CLUSTER_KNOWN_JITTER 0.0002f
+
+#include "Benchmark.h"
+
+PoseData::BonePawn Benchmark::generatePawn(int boneCount, int branching) {
+	PoseData::BonePawn pawn;
+	pawn.originalFileName = "benchmark_" + std::to_string(boneCount) + ".csv";
+	pawn.loaded = false;
+	pawn.saved = true;
+	pawn.bones.reserve(boneCount);
+	for (int i = 0; i < boneCount; i++) {
+		PoseData::BoneData bone;
+		bone.id = i + 1;
+		bone.parent = i == 0 ? -1 : (i - 1) / branching + 1;
+		/* spread the angles out, so the conversions don't hit trivial cases */
+		bone.eulerRotation = glm::vec3((i * 37) % 358 - 179, (i * 11) % 178 - 89, (i * 53) % 358 - 179);
+		bone.displayName = "bone_" + std::to_string(bone.id);
+		bone.offset = glm::vec3((i % 7) * 0.1f - 0.3f, 1.0f, (i % 5) * 0.1f - 0.2f);
+		pawn.bones.push_back(bone);
+	}
+	/* same round trip as cmdBoneSetRotation */
+	RotationBatch::pawnEulerToQuat(pawn);
+	RotationBatch::pawnQuatToEuler(pawn);
+	return pawn;
+}
+
+void Benchmark::printProfilerStats() {
+#if PROFILER_ENABLED
+	std::vector<Profiler::PhaseStats> phases;
+	Profiler::getStats(phases);
+	std::printf("%-36s %10s %10s %10s %10s %10s\n", "profiler phase", "count", "min ms", "avg ms", "p99 ms", "max ms");
+	for (const auto& phase : phases) {
+		std::printf("%-36s %10lld %10.4f %10.4f %10.4f %10.4f\n", phase.name, phase.totalCount, phase.min, phase.avg, phase.p99, phase.max);
+	}
+#endif
+}
+
+int Benchmark::runUIBenchmark(int boneCount, int frameCount) {
+	if (boneCount < 0 || frameCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d or frame count %d.\n", boneCount, frameCount);
+		return 1;
+	}
+
+	/* wire up the components the same way ApplicationInstance does, but keep the viewer headless */
+	auto model = std::make_shared<PoseModel::PoseModel>();
+	auto viewer = std::make_shared<ViewerGUI::ViewerGLFW>();
+	auto controller = std::make_shared<PoseController::PoseController>();
+	controller->setModel(std::dynamic_pointer_cast<PoseEditor::Model>(model));
+	controller->setViewer(std::dynamic_pointer_cast<PoseEditor::Viewer>(viewer));
+	viewer->setController(std::dynamic_pointer_cast<PoseEditor::Controller>(controller));
+	ImGui::SetAllocatorFunctions(imguiCountingAlloc, imguiCountingFree);
+	if (!viewer->initHeadless(DISPLAY_WIDTH, DISPLAY_HEIGHT)) {
+		std::fprintf(stderr, "Benchmark: failed to create a headless ImGui context.\n");
+		return 1;
+	}
+
+	Profiler::reset();
+	model->cmdSetPawn(generatePawn(boneCount));
+	viewer->updateView(model->getCurrentPawn(), model->getDelta());
+	model->resetDelta();
+
+	std::printf("UI benchmark: %d bones, %d frames per mode\n", boneCount, frameCount);
+	std::printf("%-16s %10s %10s %10s %10s %10s %10s %10s\n", "mode", "avg ms", "min ms", "max ms", "allocs", "vertices", "indices", "draw cmds");
+
+	const struct { const char* name; bool hierarchy; bool simple; } modes[] = {
+		{ "list", false, false },
+		{ "list simple", false, true },
+		{ "hierarchy", true, false },
+		{ "hierarchy simple", true, true },
+	};
+	for (const auto& mode : modes) {
+		viewer->setDisplayMode(mode.hierarchy, mode.simple);
+		/* the first frames lay out windows and fill caches, keep them out of the measurement */
+		for (int i = 0; i < WARMUP_FRAMES; i++)
+			viewer->renderHeadlessFrame();
+
+		double total = 0, minTime = 0, maxTime = 0;
+		size_t allocations = 0;
+		ViewerGUI::FrameStats stats;
+		for (int i = 0; i < frameCount; i++) {
+			size_t allocationsBefore = getAllocationCount();
+			stats = viewer->renderHeadlessFrame();
+			stats.allocationCount = static_cast<int>(getAllocationCount() - allocationsBefore);
+			allocations += stats.allocationCount;
+			total += stats.cpuTime;
+			minTime = i == 0 ? stats.cpuTime : std::min(minTime, stats.cpuTime);
+			maxTime = std::max(maxTime, stats.cpuTime);
+		}
+		std::printf("%-16s %10.3f %10.3f %10.3f %10.1f %10d %10d %10d\n", mode.name, total / frameCount, minTime, maxTime,
+			static_cast<double>(allocations) / frameCount, stats.vertexCount, stats.indexCount, stats.drawCommandCount);
+	}
+
+	/* model side of a slider drag: one coalesced rotation command and view sync per frame */
+	if (boneCount > 0) {
+		ID draggedBone = model->getCurrentPawn().bones[boneCount / 2].id;
+		double total = 0;
+		size_t allocations = 0;
+		controller->cmdBeginEdit();
+		/* the first command builds the bone lookup of the model, keep it out of the measurement */
+		controller->cmdBoneSetRotation(draggedBone, glm::vec3(0, 0, 0));
+		viewer->updateView(model->getCurrentPawn(), model->getDelta());
+		model->resetDelta();
+		for (int i = 0; i < frameCount; i++) {
+			size_t allocationsBefore = getAllocationCount();
+			auto begin = std::chrono::high_resolution_clock::now();
+			controller->cmdBoneSetRotation(draggedBone, glm::vec3(i % 90, 0, 0));
+			viewer->updateView(model->getCurrentPawn(), model->getDelta());
+			model->resetDelta();
+			auto end = std::chrono::high_resolution_clock::now();
+			total += std::chrono::duration<double, std::milli>(end - begin).count();
+			allocations += getAllocationCount() - allocationsBefore;
+		}
+		controller->cmdCommitEdit();
+		std::printf("%-16s %10.3f %10s %10s %10.1f\n", "rotation drag", total / frameCount, "-", "-",
+			static_cast<double>(allocations) / frameCount);
+	}
+
+	printProfilerStats();
+	viewer->cleanUp();
+	return 0;
+}
+
+int Benchmark::runFKBenchmark(int boneCount, int iterations) {
+	if (boneCount <= 0 || iterations <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d or iteration count %d.\n", boneCount, iterations);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn pawn = generatePawn(boneCount);
+	std::printf("FK benchmark: %d bones, %d iterations, %s kernel\n", boneCount, iterations, QUAT_SIMD_SSE2 ? "SSE2" : "scalar");
+	std::printf("%-16s %12s %12s\n", "phase", "avg ms", "ns / bone");
+
+	auto begin = std::chrono::high_resolution_clock::now();
+	PoseKinematics::FKOrder order = PoseKinematics::buildOrder(pawn);
+	auto end = std::chrono::high_resolution_clock::now();
+	double buildTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	std::printf("%-16s %12.4f %12.2f\n", "build order", buildTime, buildTime * 1e6 / boneCount);
+
+	std::vector<glm::quat> local, global;
+	PoseKinematics::gatherLocal(pawn, order, local);
+	PoseKinematics::evaluate(order, local, global);
+	double total = 0;
+	for (int i = 0; i < iterations; i++) {
+		begin = std::chrono::high_resolution_clock::now();
+		PoseKinematics::evaluate(order, local, global);
+		end = std::chrono::high_resolution_clock::now();
+		total += std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+	std::printf("%-16s %12.4f %12.2f\n", "evaluate", total / iterations, total * 1e6 / iterations / boneCount);
+
+	/* the kernel has to agree with plain glm::quat multiplication */
+	int mismatches = 0;
+	for (int slot = 0; slot < boneCount; slot++) {
+		glm::quat expected = order.parents[slot] < 0 ? local[slot] : global[order.parents[slot]] * local[slot];
+		for (int c = 0; c < 4; c++)
+			if (std::abs(expected[c] - global[slot][c]) > FK_TOLERANCE) {
+				mismatches++;
+				break;
+			}
+	}
+	if (mismatches > 0)
+		std::fprintf(stderr, "Benchmark: %d bones differ from glm::quat multiplication.\n", mismatches);
+
+	PoseKinematics::JointPositions offsets, positions;
+	PoseKinematics::gatherOffsets(pawn, order, offsets);
+	PoseKinematics::evaluatePositions(order, global, offsets, positions);
+	total = 0;
+	for (int i = 0; i < iterations; i++) {
+		begin = std::chrono::high_resolution_clock::now();
+		PoseKinematics::evaluatePositions(order, global, offsets, positions);
+		end = std::chrono::high_resolution_clock::now();
+		total += std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+	std::printf("%-16s %12.4f %12.2f\n", "positions", total / iterations, total * 1e6 / iterations / boneCount);
+
+	/* the joints have to agree with glm rotating the offsets, relative to the parent as positions grow along the chain */
+	int misplaced = 0;
+	for (int slot = 0; slot < boneCount; slot++) {
+		int parent = order.parents[slot];
+		glm::vec3 expected = parent < 0 ? offsets.get(slot) : positions.get(parent) + global[parent] * offsets.get(slot);
+		glm::vec3 difference = expected - positions.get(slot);
+		if (std::abs(difference.x) > FK_TOLERANCE || std::abs(difference.y) > FK_TOLERANCE || std::abs(difference.z) > FK_TOLERANCE)
+			misplaced++;
+	}
+	if (misplaced > 0)
+		std::fprintf(stderr, "Benchmark: %d joints differ from glm::quat rotation.\n", misplaced);
+
+	/* incremental update after rotating a bone with a small subtree, the way a slider drag does */
+	int editedSlot = boneCount - 1;
+	for (int slot = 0; slot < boneCount; slot++)
+		if (order.subtreeEnd[slot] - slot >= FK_EDITED_SUBTREE)
+			editedSlot = slot;
+	ID editedBone = pawn.bones[order.bones[editedSlot]].id;
+	PoseModel::PoseModel model;
+	model.cmdSetPawn(pawn);
+	model.getGlobalRotation(editedBone);
+	model.cmdBeginEdit();
+	total = 0;
+	int updated = 0;
+	for (int i = 0; i < iterations; i++) {
+		model.cmdBoneSetRotation(editedBone, glm::vec3(i % 90, 0, 0));
+		begin = std::chrono::high_resolution_clock::now();
+		updated = model.updateKinematics();
+		end = std::chrono::high_resolution_clock::now();
+		total += std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+	model.cmdCommitEdit();
+	std::printf("%-16s %12.4f %12.2f   (%d bones per update)\n", "incremental", total / iterations, total * 1e6 / iterations / updated, updated);
+	model.cmdBoneSetOffset(editedBone, glm::vec3(0.5f, 2.0f, -0.5f));
+
+	/* the cache has to agree with a full evaluation of the edited pawn */
+	std::vector<glm::quat> expected = PoseKinematics::computeGlobal(model.getCurrentPawn());
+	PoseKinematics::JointPositions expectedPositions = PoseKinematics::computePositions(model.getCurrentPawn());
+	int stale = 0;
+	for (int i = 0; i < boneCount; i++) {
+		ID id = model.getCurrentPawn().bones[i].id;
+		glm::quat cached = model.getGlobalRotation(id);
+		glm::vec3 difference = expectedPositions.get(i) - model.getJointPosition(id);
+		bool differs = std::abs(difference.x) > FK_TOLERANCE || std::abs(difference.y) > FK_TOLERANCE || std::abs(difference.z) > FK_TOLERANCE;
+		for (int c = 0; c < 4; c++)
+			differs = differs || std::abs(expected[i][c] - cached[c]) > FK_TOLERANCE;
+		if (differs)
+			stale++;
+	}
+	if (stale > 0)
+		std::fprintf(stderr, "Benchmark: %d bones differ after the incremental update.\n", stale);
+
+	printProfilerStats();
+	return mismatches + misplaced + stale > 0 ? 1 : 0;
+}
+
+int Benchmark::runEulerBenchmark(int rotationCount, int iterations) {
+	if (rotationCount <= 0 || iterations <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid rotation count %d or iteration count %d.\n", rotationCount, iterations);
+		return 1;
+	}
+
+	Profiler::reset();
+	RotationBatch::EulerLanes euler, roundTrip;
+	RotationBatch::QuatLanes quat;
+	euler.resize(rotationCount);
+	for (int i = 0; i < rotationCount; i++) {
+		/* the full slider range, deterministic but not periodic within a SIMD block */
+		euler.x[i] = (i * 37 % 36000) * 0.01f - 180.0f;
+		euler.y[i] = (i * 11 % 17800) * 0.01f - 89.0f;
+		euler.z[i] = (i * 53 % 36000) * 0.01f - 180.0f;
+	}
+	std::printf("Euler benchmark: %d rotations, %d iterations, %s kernels\n", rotationCount, iterations, QUAT_SIMD_SSE2 ? "SSE2" : "scalar");
+	std::printf("%-6s %-14s %12s %12s %12s\n", "order", "conversion", "batch ms", "scalar ms", "max error");
+
+	const PoseData::RotationOrder orders[] = { PoseData::RotationOrder::XYZ, PoseData::RotationOrder::XZY, PoseData::RotationOrder::YXZ,
+		PoseData::RotationOrder::YZX, PoseData::RotationOrder::ZXY, PoseData::RotationOrder::ZYX };
+	std::vector<glm::quat> referenceQuat(rotationCount);
+	std::vector<glm::vec3> referenceEuler(rotationCount);
+	bool valid = true;
+	for (PoseData::RotationOrder order : orders) {
+		RotationBatch::eulerToQuat(euler, quat, order);
+		RotationBatch::quatToEuler(quat, roundTrip, order);
+		double batchToQuat = 0, batchToEuler = 0;
+		for (int i = 0; i < iterations; i++) {
+			auto begin = std::chrono::high_resolution_clock::now();
+			RotationBatch::eulerToQuat(euler, quat, order);
+			auto middle = std::chrono::high_resolution_clock::now();
+			RotationBatch::quatToEuler(quat, roundTrip, order);
+			auto end = std::chrono::high_resolution_clock::now();
+			batchToQuat += std::chrono::duration<double, std::milli>(middle - begin).count();
+			batchToEuler += std::chrono::duration<double, std::milli>(end - middle).count();
+		}
+
+		/* reference: the per bone conversions of PoseDataUtil, once */
+		auto begin = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < rotationCount; i++)
+			referenceQuat[i] = PoseDataUtil::eulerToQuat(glm::vec3(euler.x[i], euler.y[i], euler.z[i]), order);
+		auto middle = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < rotationCount; i++)
+			referenceEuler[i] = PoseDataUtil::quatToEuler(glm::quat(quat.w[i], quat.x[i], quat.y[i], quat.z[i]), order);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		float quatError = 0, eulerError = 0;
+		for (int i = 0; i < rotationCount; i++) {
+			quatError = std::max({ quatError, std::abs(referenceQuat[i].w - quat.w[i]), std::abs(referenceQuat[i].x - quat.x[i]),
+				std::abs(referenceQuat[i].y - quat.y[i]), std::abs(referenceQuat[i].z - quat.z[i]) });
+			eulerError = std::max({ eulerError, std::abs(referenceEuler[i].x - roundTrip.x[i]),
+				std::abs(referenceEuler[i].y - roundTrip.y[i]), std::abs(referenceEuler[i].z - roundTrip.z[i]) });
+		}
+		std::printf("%-6s %-14s %12.3f %12.3f %12.2e\n", EulerOrder::orderName(order), "euler to quat", batchToQuat / iterations,
+			std::chrono::duration<double, std::milli>(middle - begin).count(), quatError);
+		std::printf("%-6s %-14s %12.3f %12.3f %12.2e\n", EulerOrder::orderName(order), "quat to euler", batchToEuler / iterations,
+			std::chrono::duration<double, std::milli>(end - middle).count(), eulerError);
+		valid = valid && quatError <= ROTATION_BATCH_QUAT_TOLERANCE && eulerError <= ROTATION_BATCH_EULER_TOLERANCE;
+	}
+
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: batch conversions exceed the documented tolerance.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runBlendBenchmark(int boneCount, int iterations) {
+	if (boneCount <= 0 || iterations <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d or iteration count %d.\n", boneCount, iterations);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn pawn = generatePawn(boneCount);
+	PoseData::BonePawn target = pawn;
+	for (int i = 0; i < boneCount; i++) {
+		/* unrelated rotations, every third one in the opposite hemisphere */
+		glm::quat q = pawn.bones[(static_cast<long long>(i) * 7919) % boneCount].quaternion;
+		target.bones[i].quaternion = i % 3 == 0 ? -q : q;
+	}
+	RotationBatch::QuatLanes from, to, result;
+	from.resize(boneCount);
+	to.resize(boneCount);
+	std::vector<float> mask(boneCount);
+	for (int i = 0; i < boneCount; i++) {
+		const glm::quat& a = pawn.bones[i].quaternion;
+		const glm::quat& b = target.bones[i].quaternion;
+		from.w[i] = a.w; from.x[i] = a.x; from.y[i] = a.y; from.z[i] = a.z;
+		to.w[i] = b.w; to.x[i] = b.x; to.y[i] = b.y; to.z[i] = b.z;
+		mask[i] = (i % 5) * 0.25f;
+	}
+	std::printf("Blend benchmark: %d bones, %d iterations, %s kernels\n", boneCount, iterations, QUAT_SIMD_SSE2 ? "SSE2" : "scalar");
+	std::printf("%-14s %12s %12s %12s %12s\n", "blend", "kernel ms", "GB/s", "glm ms", "max error");
+
+	std::vector<glm::quat> reference(boneCount);
+	bool valid = true;
+	for (PoseBlend::BlendMode mode : { PoseBlend::BlendMode::Nlerp, PoseBlend::BlendMode::Slerp }) {
+		for (bool masked : { false, true }) {
+			const float* weights = masked ? mask.data() : nullptr;
+			PoseBlend::blend(from, to, BLEND_WEIGHT, weights, result, mode);
+			double kernel = 0;
+			for (int i = 0; i < iterations; i++) {
+				auto begin = std::chrono::high_resolution_clock::now();
+				PoseBlend::blend(from, to, BLEND_WEIGHT, weights, result, mode);
+				auto end = std::chrono::high_resolution_clock::now();
+				kernel += std::chrono::duration<double, std::milli>(end - begin).count();
+			}
+			kernel /= iterations;
+
+			/* reference: glm per quaternion, once */
+			auto begin = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < boneCount; i++) {
+				glm::quat a = pawn.bones[i].quaternion, b = target.bones[i].quaternion;
+				float t = masked ? BLEND_WEIGHT * mask[i] : BLEND_WEIGHT;
+				if (glm::dot(a, b) < 0.0f)
+					b = -b;
+				reference[i] = glm::normalize(mode == PoseBlend::BlendMode::Slerp ? glm::slerp(a, b, t) : a * (1.0f - t) + b * t);
+			}
+			auto end = std::chrono::high_resolution_clock::now();
+
+			float error = 0;
+			for (int i = 0; i < boneCount; i++) {
+				error = std::max({ error, std::abs(reference[i].w - result.w[i]), std::abs(reference[i].x - result.x[i]),
+					std::abs(reference[i].y - result.y[i]), std::abs(reference[i].z - result.z[i]) });
+			}
+			/* two quaternions read and one written per bone, plus the mask */
+			double bytes = static_cast<double>(boneCount) * (3 * 4 * sizeof(float) + (masked ? sizeof(float) : 0));
+			std::string name = std::string(mode == PoseBlend::BlendMode::Slerp ? "slerp" : "nlerp") + (masked ? " masked" : "");
+			std::printf("%-14s %12.3f %12.2f %12.3f %12.2e\n", name.c_str(), kernel, bytes / (kernel * 1e6),
+				std::chrono::duration<double, std::milli>(end - begin).count(), error);
+			valid = valid && error <= BLEND_TOLERANCE;
+		}
+	}
+
+	/* end to end: matching by ID against a pawn listing the bones in reverse */
+	std::vector<glm::quat> ordered = PoseBlend::blendRotations(pawn, target, BLEND_WEIGHT);
+	std::reverse(target.bones.begin(), target.bones.end());
+	auto begin = std::chrono::high_resolution_clock::now();
+	std::vector<glm::quat> matched = PoseBlend::blendRotations(pawn, target, BLEND_WEIGHT);
+	auto end = std::chrono::high_resolution_clock::now();
+	bool same = matched == ordered;
+	std::printf("blendRotations with bones matched by ID: %.3f ms, %s\n", std::chrono::duration<double, std::milli>(end - begin).count(),
+		same ? "matches the ordered pawn" : "DIFFERS from the ordered pawn");
+	printProfilerStats();
+
+	if (!valid || !same)
+		std::fprintf(stderr, "Benchmark: blend results exceed the documented tolerance.\n");
+	return valid && same ? 0 : 1;
+}
+
+int Benchmark::runLayerBenchmark(int boneCount, int layerCount, int iterations) {
+	if (boneCount <= 0 || layerCount <= 0 || iterations <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d, layer count %d or iteration count %d.\n", boneCount, layerCount, iterations);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn base = generatePawn(boneCount);
+	std::vector<PoseData::BonePawn> differences;
+	std::vector<float> weights;
+	PoseLayers::LayerStack stack;
+	stack.setBase(base);
+	for (int l = 0; l < layerCount; l++) {
+		/* every layer turns the base into a shuffled copy of itself */
+		PoseData::BonePawn target = base;
+		for (int i = 0; i < boneCount; i++)
+			target.bones[i].quaternion = base.bones[(static_cast<long long>(i) * (7919 + l * 104729)) % boneCount].quaternion;
+		differences.push_back(PoseLayers::difference(base, target));
+		weights.push_back(0.2f + 0.6f * l / layerCount);
+		stack.addLayer(differences.back(), weights.back());
+	}
+	std::printf("Layer benchmark: %d bones, %d layers, %d iterations, %s kernels\n", boneCount, layerCount, iterations, QUAT_SIMD_SSE2 ? "SSE2" : "scalar");
+
+	/* every layer changed, then a single one */
+	double full = 0, single = 0;
+	for (int i = 0; i < iterations; i++) {
+		for (int l = 0; l < layerCount; l++)
+			stack.setWeight(l, weights[l] + (i % 2 ? 0.05f : 0.0f));
+		auto begin = std::chrono::high_resolution_clock::now();
+		stack.evaluate();
+		auto middle = std::chrono::high_resolution_clock::now();
+		stack.setWeight(layerCount / 2, weights[layerCount / 2] + 0.1f);
+		auto end = std::chrono::high_resolution_clock::now();
+		stack.evaluate();
+		auto singleEnd = std::chrono::high_resolution_clock::now();
+		full += std::chrono::duration<double, std::milli>(middle - begin).count();
+		single += std::chrono::duration<double, std::milli>(singleEnd - end).count();
+	}
+	for (int l = 0; l < layerCount; l++)
+		stack.setWeight(l, weights[l]);
+	const std::vector<glm::quat>& result = stack.evaluate();
+
+	/* reference: one layer after another with glm, once */
+	auto begin = std::chrono::high_resolution_clock::now();
+	std::vector<glm::quat> reference(boneCount);
+	for (int i = 0; i < boneCount; i++)
+		reference[i] = base.bones[i].quaternion;
+	for (int l = 0; l < layerCount; l++) {
+		for (int i = 0; i < boneCount; i++) {
+			glm::quat delta = differences[l].bones[i].quaternion;
+			if (delta.w < 0.0f)
+				delta = -delta;
+			reference[i] = glm::normalize(reference[i] * glm::slerp(glm::quat(1.0f, 0.0f, 0.0f, 0.0f), delta, weights[l]));
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	float error = 0;
+	for (int i = 0; i < boneCount; i++) {
+		/* q and -q are the same rotation */
+		float sign = glm::dot(reference[i], result[i]) < 0.0f ? -1.0f : 1.0f;
+		glm::quat d = reference[i] - sign * result[i];
+		error = std::max({ error, std::abs(d.w), std::abs(d.x), std::abs(d.y), std::abs(d.z) });
+	}
+	std::printf("%-32s %12s %12s\n", "phase", "ms", "ns/bone");
+	std::printf("%-32s %12.3f %12.3f\n", "evaluate, every layer changed", full / iterations, full / iterations * 1e6 / boneCount);
+	std::printf("%-32s %12.3f %12.3f\n", "evaluate, one layer changed", single / iterations, single / iterations * 1e6 / boneCount);
+	std::printf("%-32s %12.3f %12.3f\n", "glm, layer by layer", std::chrono::duration<double, std::milli>(end - begin).count(),
+		std::chrono::duration<double, std::milli>(end - begin).count() * 1e6 / boneCount);
+	std::printf("max error against glm: %.2e\n", error);
+	printProfilerStats();
+
+	if (error > LAYER_TOLERANCE) {
+		std::fprintf(stderr, "Benchmark: layer results exceed the documented tolerance.\n");
+		return 1;
+	}
+	return 0;
+}
+
+int Benchmark::runAverageBenchmark(int poseCount, int boneCount, int iterations) {
+	if (poseCount <= 0 || boneCount <= 0 || iterations <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid pose count %d, bone count %d or iteration count %d.\n", poseCount, boneCount, iterations);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn base = generatePawn(boneCount);
+	std::vector<PoseData::BonePawn> poses(poseCount);
+	std::vector<float> weights(poseCount);
+	unsigned int seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+	};
+	for (int k = 0; k < poseCount; k++) {
+		poses[k].bones = base.bones;
+		for (int b = 0; b < boneCount; b++) {
+			/* a small rotation about a random axis, symmetric around the base */
+			glm::vec3 axis(random(), random(), random() + 2.0f);
+			glm::quat q = base.bones[b].quaternion * glm::angleAxis(random() * AVERAGE_SPREAD, glm::normalize(axis) * (k % 2 ? 1.0f : -1.0f));
+			poses[k].bones[b].quaternion = (k + b) % 3 == 0 ? -q : q;
+		}
+		weights[k] = 0.5f + (k % 7) * 0.25f;
+	}
+	std::printf("Average benchmark: %d poses, %d bones, %d iterations, %d threads\n", poseCount, boneCount, iterations,
+		Parallel::ThreadPool::shared().getThreadCount());
+
+	std::vector<glm::quat> mean;
+	double total = 0;
+	for (int i = 0; i < iterations; i++) {
+		auto begin = std::chrono::high_resolution_clock::now();
+		mean = PoseAverage::averageRotations(base, poses, weights);
+		auto end = std::chrono::high_resolution_clock::now();
+		total += std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+	std::printf("average: %.3f ms\n", total / iterations);
+
+	bool deterministic = true;
+	for (int threads = 1; threads <= 3; threads++) {
+		Parallel::ThreadPool pool(threads);
+		deterministic = deterministic && PoseAverage::averageRotations(base, poses, weights, pool) == mean;
+	}
+	float deviation = 0;
+	for (int b = 0; b < boneCount; b++) {
+		float d = std::abs(glm::dot(glm::normalize(base.bones[b].quaternion), mean[b]));
+		deviation = std::max(deviation, 2.0f * std::acos(std::min(d, 1.0f)));
+	}
+	std::printf("identical with 1, 2 and 3 threads: %s\n", deterministic ? "yes" : "NO");
+	std::printf("largest angle between the mean and the base pose: %.2e rad (poses deviate up to %.2f rad)\n", deviation, AVERAGE_SPREAD);
+	printProfilerStats();
+
+	if (!deterministic)
+		std::fprintf(stderr, "Benchmark: the mean depends on the amount of threads.\n");
+	return deterministic ? 0 : 1;
+}
+
+int Benchmark::runMirrorBenchmark(int poseCount, int boneCount) {
+	if (poseCount <= 0 || boneCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid pose count %d or bone count %d.\n", poseCount, boneCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn pawn = generatePawn(boneCount);
+	/* the root stays in the middle, the other bones form pairs */
+	for (int i = 1; i < boneCount; i++)
+		pawn.bones[i].displayName = std::string(i % 2 ? "Left_" : "Right_") + std::to_string((i + 1) / 2);
+	std::vector<PoseData::BonePawn> poses(poseCount, pawn);
+	for (int k = 0; k < poseCount; k++)
+		for (int i = 0; i < boneCount; i++)
+			poses[k].bones[i].quaternion = pawn.bones[(i + k) % boneCount].quaternion;
+	std::printf("Mirror benchmark: %d poses, %d bones\n", poseCount, boneCount);
+
+	PoseMirror::SymmetryCache cache;
+	std::vector<glm::quat> mirrored, restored;
+	auto begin = std::chrono::high_resolution_clock::now();
+	for (const PoseData::BonePawn& pose : poses)
+		PoseMirror::mirrorRotations(pose, cache.get(pose), PoseData::MirrorPlane::YZ, {}, mirrored);
+	auto middle = std::chrono::high_resolution_clock::now();
+	for (const PoseData::BonePawn& pose : poses)
+		PoseMirror::mirrorRotations(pose, PoseMirror::buildMap(pose, PoseMirror::defaultRules()), PoseData::MirrorPlane::YZ, {}, mirrored);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	/* mirroring twice across any plane gives the pose back */
+	bool valid = cache.size() == 1 && cache.get(pawn).pairedCount == (boneCount - 1) / 2 * 2;
+	for (PoseData::MirrorPlane plane : { PoseData::MirrorPlane::YZ, PoseData::MirrorPlane::XZ, PoseData::MirrorPlane::XY }) {
+		PoseData::BonePawn pose = poses.back();
+		PoseMirror::mirrorRotations(pose, cache.get(pose), plane, {}, mirrored);
+		for (int i = 0; i < boneCount; i++)
+			pose.bones[i].quaternion = mirrored[i];
+		PoseMirror::mirrorRotations(pose, cache.get(pose), plane, {}, restored);
+		for (int i = 0; i < boneCount; i++)
+			valid = valid && restored[i] == poses.back().bones[i].quaternion;
+	}
+
+	double cached = std::chrono::duration<double, std::milli>(middle - begin).count();
+	double rebuilt = std::chrono::duration<double, std::milli>(end - middle).count();
+	std::printf("%-28s %12s %12s\n", "phase", "ms", "ns/bone");
+	std::printf("%-28s %12.3f %12.3f\n", "cached symmetry map", cached, cached * 1e6 / (static_cast<double>(poseCount) * boneCount));
+	std::printf("%-28s %12.3f %12.3f\n", "map rebuilt for every pose", rebuilt, rebuilt * 1e6 / (static_cast<double>(poseCount) * boneCount));
+	std::printf("mirroring twice restores the pose: %s\n", valid ? "yes" : "NO");
+	printProfilerStats();
+
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: mirroring is not symmetric.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runRetargetBenchmark(int poseCount, int boneCount) {
+	if (poseCount <= 0 || boneCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid pose count %d or bone count %d.\n", poseCount, boneCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn sourceRest = generatePawn(boneCount);
+	for (int i = 0; i < boneCount; i++)
+		sourceRest.bones[i].displayName = "Bone_Part_" + std::to_string(i);
+	/* the target rig: reversed order, names written as "rig:bonepart<i>" and rest rotations of its own */
+	PoseData::BonePawn targetRest = sourceRest;
+	std::reverse(targetRest.bones.begin(), targetRest.bones.end());
+	for (int i = 0; i < boneCount; i++) {
+		PoseData::BoneData& bone = targetRest.bones[i];
+		bone.displayName = "rig:bonepart" + bone.displayName.substr(10);
+		bone.quaternion = sourceRest.bones[(i * 7 + 3) % boneCount].quaternion;
+	}
+	std::vector<PoseData::BonePawn> poses(poseCount, sourceRest);
+	for (int k = 0; k < poseCount; k++)
+		for (int i = 0; i < boneCount; i++)
+			poses[k].bones[i].quaternion = sourceRest.bones[(i + k + 1) % boneCount].quaternion;
+	std::printf("Retarget benchmark: %d poses, %d bones\n", poseCount, boneCount);
+
+	PoseRetarget::Retargeter forward, backward;
+	forward.setTarget(targetRest);
+	forward.setSourceRest(&sourceRest);
+	backward.setTarget(sourceRest);
+	backward.setSourceRest(&targetRest);
+	auto begin = std::chrono::high_resolution_clock::now();
+	const PoseRetarget::MappingTable& table = forward.table(poses[0]);
+	auto middle = std::chrono::high_resolution_clock::now();
+	std::vector<glm::quat> rotations;
+	for (const PoseData::BonePawn& pose : poses)
+		PoseRetarget::transfer(pose, forward.table(pose), rotations);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	/* there and back again */
+	float error = 0;
+	for (int k = 0; k < std::min(poseCount, 10); k++) {
+		PoseData::BonePawn restored = backward.retarget(forward.retarget(poses[k]));
+		for (int i = 0; i < boneCount; i++) {
+			glm::quat a = restored.bones[i].quaternion, b = poses[k].bones[i].quaternion;
+			float sign = glm::dot(a, b) < 0.0f ? -1.0f : 1.0f;
+			glm::quat d = a - sign * b;
+			error = std::max({ error, std::abs(d.w), std::abs(d.x), std::abs(d.y), std::abs(d.z) });
+		}
+	}
+	bool valid = table.mappedCount == boneCount && forward.tableCount() == 1 && error <= RETARGET_TOLERANCE;
+
+	double build = std::chrono::duration<double, std::milli>(middle - begin).count();
+	double batch = std::chrono::duration<double, std::milli>(end - middle).count();
+	std::printf("%-28s %12s %12s\n", "phase", "ms", "ns/bone");
+	std::printf("%-28s %12.3f %12.3f\n", "build mapping table", build, build * 1e6 / boneCount);
+	std::printf("%-28s %12.3f %12.3f\n", "transfer all poses", batch, batch * 1e6 / (static_cast<double>(poseCount) * boneCount));
+	std::printf("mapped bones: %d of %d, tables built: %d\n", table.mappedCount, boneCount, forward.tableCount());
+	std::printf("max error retargeting there and back: %.2e\n", error);
+	printProfilerStats();
+
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: retargeting did not map every bone or does not restore the poses.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runIKBenchmark(int chainLength, int solveCount) {
+	/* a chain of two bones has a single segment, its tip cannot reach the targets inside the sphere it moves on */
+	if (chainLength < 3 || solveCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid chain length %d or solve count %d.\n", chainLength, solveCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	/* one chain of unit segments bent slightly at every joint, so no solve starts from a straight line */
+	PoseData::BonePawn pawn = generatePawn(chainLength, 1);
+	for (int i = 0; i < chainLength; i++) {
+		pawn.bones[i].offset = glm::vec3(0.0f, i == 0 ? 0.0f : 1.0f, 0.0f);
+		pawn.bones[i].quaternion = PoseDataUtil::eulerToQuat(glm::vec3((i % 5) - 2.0f, (i % 3) - 1.0f, 3.0f));
+	}
+	/* targets between a fifth and three quarters of the chain length away from the root, in all directions */
+	std::vector<glm::vec3> targets(solveCount);
+	for (int k = 0; k < solveCount; k++) {
+		float radius = (0.2f + 0.55f * ((k * 37) % 100) / 100.0f) * (chainLength - 1);
+		float azimuth = k * 2.39996f, height = ((k * 61) % 200) / 100.0f - 1.0f;
+		float ring = std::sqrt(1.0f - height * height);
+		targets[k] = radius * glm::vec3(ring * std::cos(azimuth), height, ring * std::sin(azimuth));
+	}
+	std::printf("IK benchmark: %d bone chain, %d targets\n", chainLength, solveCount);
+	std::printf("%-12s %10s %10s %10s %10s %10s %10s\n", "solver", "avg ms", "max ms", "avg passes", "reached", "avg miss", "allocs");
+
+	PoseIK::ChainSolver chain;
+	if (!chain.setChain(pawn, pawn.bones.front().id, pawn.bones.back().id)) {
+		std::fprintf(stderr, "Benchmark: the synthetic chain could not be found.\n");
+		return 1;
+	}
+	/* CCD bends the end of a long chain first and converges slowly, the turn limit spreads the bend */
+	PoseIK::Settings variants[3];
+	variants[1].maxTurn = IK_MAX_TURN;
+	variants[2].solver = PoseData::IKSolver::FABRIK;
+	const char* names[3] = { "CCD", "CCD limited", "FABRIK" };
+	std::vector<char> missed(solveCount);
+	int unreached = 0;
+	bool valid = true;
+	for (int v = 0; v < 3; v++) {
+		const PoseIK::Settings& settings = variants[v];
+		double total = 0, slowest = 0, miss = 0;
+		long long passes = 0;
+		int reached = 0;
+		size_t allocations = getAllocationCount();
+		for (int k = 0; k < solveCount; k++) {
+			auto begin = std::chrono::high_resolution_clock::now();
+			PoseIK::Result result = chain.solve(pawn, glm::quat(1, 0, 0, 0), glm::vec3(0, 0, 0), targets[k], settings);
+			auto end = std::chrono::high_resolution_clock::now();
+			double time = std::chrono::duration<double, std::milli>(end - begin).count();
+			total += time;
+			slowest = std::max(slowest, time);
+			passes += result.iterations;
+			reached += result.reached ? 1 : 0;
+			missed[k] = !result.reached;
+			miss += result.distance;
+		}
+		allocations = getAllocationCount() - allocations;
+		std::printf("%-12s %10.4f %10.4f %10.2f %10d %10.4f %10zu\n", names[v],
+			total / solveCount, slowest, static_cast<double>(passes) / solveCount, reached, miss / solveCount, allocations);
+
+		/* the solved rotations have to put the tip where the solver reports it */
+		for (int k = 0; k < std::min(solveCount, 10); k++) {
+			PoseIK::Result result = chain.solve(pawn, glm::quat(1, 0, 0, 0), glm::vec3(0, 0, 0), targets[k], settings);
+			PoseData::BonePawn solved = pawn;
+			for (size_t j = 0; j < chain.getRotations().size(); j++)
+				solved.bones[chain.getBones()[j]].quaternion = chain.getRotations()[j];
+			PoseKinematics::JointPositions positions = PoseKinematics::computePositions(solved);
+			float distance = glm::length(targets[k] - positions.get(chain.getBones().back()));
+			valid = valid && std::abs(distance - result.distance) <= IK_TOLERANCE;
+		}
+		/* every target lies within reach, a solver missing one within its passes has to get there given enough of them */
+		PoseIK::Settings patient = settings;
+		patient.maxIterations = IK_REACH_PASSES;
+		for (int k = 0; k < solveCount; k++) {
+			if (missed[k] && !chain.solve(pawn, glm::quat(1, 0, 0, 0), glm::vec3(0, 0, 0), targets[k], patient).reached) {
+				std::fprintf(stderr, "Benchmark: %s gave up on reachable target %d.\n", names[v], k);
+				unreached++;
+			}
+		}
+		valid = valid && allocations == 0;
+	}
+	printProfilerStats();
+
+	valid = valid && unreached == 0;
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: a solver allocated, reported a wrong distance or missed a reachable target.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runLimitsBenchmark(int boneCount, int iterations) {
+	if (boneCount <= 0 || iterations <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d or iteration count %d.\n", boneCount, iterations);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn pawn = generatePawn(boneCount);
+	/* cones, twist ranges and both together, every fourth bone stays free */
+	for (int i = 0; i < boneCount; i++) {
+		PoseData::JointLimit& limit = pawn.bones[i].limit;
+		switch (i % 4) {
+		case 0: limit.swing = 20.0f + (i % 7) * 10.0f; break;
+		case 1: limit.twistMin = -30.0f - (i % 5) * 10.0f; limit.twistMax = 15.0f + (i % 3) * 20.0f; break;
+		case 2: limit.swing = 45.0f; limit.twistMin = -10.0f; limit.twistMax = 60.0f; break;
+		default: break;
+		}
+	}
+	std::vector<glm::quat> original(boneCount);
+	for (int i = 0; i < boneCount; i++)
+		original[i] = pawn.bones[i].quaternion;
+	std::printf("Limits benchmark: %d bones, %d iterations, %s kernels\n", boneCount, iterations, QUAT_SIMD_SSE2 ? "SSE2" : "scalar");
+
+	double batch = 0;
+	int clamped = 0;
+	for (int k = 0; k < iterations; k++) {
+		for (int i = 0; i < boneCount; i++)
+			pawn.bones[i].quaternion = original[i];
+		auto begin = std::chrono::high_resolution_clock::now();
+		clamped = PoseLimits::clampPawn(pawn);
+		auto end = std::chrono::high_resolution_clock::now();
+		batch += std::chrono::duration<double, std::milli>(end - begin).count();
+	}
+	batch /= iterations;
+
+	/* reference: the scalar clamp and euler conversion per bone, once */
+	std::vector<glm::quat> reference(boneCount);
+	int referenceClamped = 0;
+	auto begin = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < boneCount; i++) {
+		bool changed;
+		reference[i] = PoseLimits::clamp(original[i], pawn.bones[i].limit, &changed);
+		if (changed) {
+			referenceClamped++;
+			pawn.bones[i].eulerRotation = PoseDataUtil::quatToEuler(reference[i], pawn.rotationOrder);
+		}
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	double scalar = std::chrono::duration<double, std::milli>(end - begin).count();
+
+	float error = 0, excess = 0;
+	for (int i = 0; i < boneCount; i++) {
+		glm::quat q = pawn.bones[i].quaternion;
+		error = std::max(error, 1.0f - std::abs(glm::dot(q, reference[i])));
+		/* measured apart from the decomposition of the clamp: the angle the Y axis turned and the twist left about it */
+		if (q.w < 0.0f)
+			q = -q;
+		const PoseData::JointLimit& limit = pawn.bones[i].limit;
+		glm::vec3 axis = QuatSimd::rotate(q, glm::vec3(0, 1, 0));
+		float swing = glm::degrees(std::acos(glm::clamp(axis.y, -1.0f, 1.0f)));
+		float twist = glm::degrees(2.0f * std::atan2(q.y, q.w));
+		excess = std::max({ excess, swing - limit.swing, limit.twistMin - twist, twist - limit.twistMax });
+	}
+	int again = PoseLimits::clampPawn(pawn);
+
+	/* one quaternion read per bone, clamped bones write a quaternion and euler angles back */
+	double bytes = static_cast<double>(boneCount) * 4 * sizeof(float) + static_cast<double>(clamped) * 7 * sizeof(float);
+	std::printf("%-10s %12s %12s %12s %12s %12s %12s\n", "limits", "batch ms", "GB/s", "scalar ms", "clamped", "max error", "max excess");
+	std::printf("%-10s %12.3f %12.2f %12.3f %12d %12.2e %12.2e\n", "clamp", batch, bytes / (batch * 1e6), scalar, clamped, error, excess);
+	std::printf("second pass clamped %d bones\n", again);
+	printProfilerStats();
+
+	bool valid = clamped == referenceClamped && again == 0 && error <= BLEND_TOLERANCE && excess <= LIMITS_TOLERANCE;
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: the batch clamp disagreed with the scalar clamp or left a rotation outside its limit.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runConstraintBenchmark(int boneCount, int iterations) {
+	if (boneCount < 8 || iterations <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d or iteration count %d.\n", boneCount, iterations);
+		return 1;
+	}
+
+	Profiler::reset();
+	/* siblings come in groups of four (breadth first, four children per bone), the first of every group stays free */
+	PoseData::BonePawn pawn = generatePawn(boneCount);
+	for (int i = 1; i < boneCount; i++) {
+		pawn.bones[i].offset = glm::vec3(0.0f, 1.0f, 0.0f);
+		PoseData::BoneConstraint& constraint = pawn.bones[i].constraint;
+		switch (i % 4) {
+		case 1: constraint = { PoseData::ConstraintType::CopyRotation, pawn.bones[i - 1].id, 0.5f }; break;
+		case 2: constraint = { PoseData::ConstraintType::Twist, pawn.bones[i - 1].id, 0.5f }; break;
+		case 3: constraint = { PoseData::ConstraintType::AimAt, pawn.bones[i - 3].id, 1.0f }; break;
+		default: break;
+		}
+	}
+	std::printf("Constraint benchmark: %d bones, %d iterations, %d threads\n", boneCount, iterations, Parallel::ThreadPool::shared().getThreadCount());
+	std::printf("%-14s %12s %12s %12s\n", "phase", "avg ms", "evaluated", "us/constraint");
+
+	PoseModel::PoseModel model;
+	auto begin = std::chrono::high_resolution_clock::now();
+	model.cmdSetPawn(pawn);
+	auto end = std::chrono::high_resolution_clock::now();
+	double time = std::chrono::duration<double, std::milli>(end - begin).count();
+	int evaluated = model.getConstraintsEvaluated();
+	std::printf("%-14s %12.3f %12d %12.4f\n", "build + all", time, evaluated, time * 1e3 / std::max(evaluated, 1));
+
+	/* a free bone at the end of the pawn drives only its siblings, the root is an ancestor of every aim */
+	int leaf = boneCount - 1;
+	while (leaf % 4 != 0)
+		leaf--;
+	struct Edit { const char* name; ID bone; };
+	for (const Edit& edit : { Edit{ "leaf driver", pawn.bones[leaf].id }, Edit{ "root", pawn.bones[0].id } }) {
+		double total = 0;
+		model.cmdBeginEdit();
+		for (int k = 0; k < iterations; k++) {
+			begin = std::chrono::high_resolution_clock::now();
+			model.cmdBoneSetRotation(edit.bone, glm::vec3(k % 90, 10.0f, 20.0f));
+			end = std::chrono::high_resolution_clock::now();
+			total += std::chrono::duration<double, std::milli>(end - begin).count();
+		}
+		model.cmdCommitEdit();
+		evaluated = model.getConstraintsEvaluated();
+		std::printf("%-14s %12.4f %12d %12.4f\n", edit.name, total / iterations, evaluated, total * 1e3 / iterations / std::max(evaluated, 1));
+	}
+	printProfilerStats();
+
+	/* the incrementally updated pose has to match evaluating every constraint of it from scratch */
+	PoseModel::PoseModel fresh;
+	fresh.cmdSetPawn(model.getCurrentPawn());
+	int differs = 0;
+	for (int i = 0; i < boneCount; i++) {
+		float dot = std::abs(glm::dot(model.getCurrentPawn().bones[i].quaternion, fresh.getCurrentPawn().bones[i].quaternion));
+		differs += dot < 1.0f - CONSTRAINT_TOLERANCE ? 1 : 0;
+	}
+	size_t rejected = model.getRejectedConstraints().size();
+	std::printf("rejected constraints %zu, bones differing from a full evaluation %d\n", rejected, differs);
+
+	bool valid = rejected == 0 && differs == 0;
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: constraints were rejected or the incremental evaluation differs from a full one.\n");
+	return valid ? 0 : 1;
+}
+
+/// <summary>
+/// Pose of the clip at time by binary search and glm interpolation per track, the reference of runClipBenchmark().
+/// </summary>
+static void referenceClipPose(const PoseClip::Clip& clip, float time, std::vector<glm::quat>& pose) {
+	pose.resize(clip.getTrackCount());
+	for (int t = 0; t < clip.getTrackCount(); t++) {
+		int count = clip.getKeyCount(t), k = clip.findKey(t, time);
+		if (count == 0) {
+			pose[t] = clip.getSkeleton().bones[t].quaternion;
+			continue;
+		}
+		PoseData::Interpolation interpolation = clip.getInterpolation(t);
+		if (k < 0 || k + 1 >= count || interpolation == PoseData::Interpolation::Step) {
+			pose[t] = clip.getKeyRotation(t, std::max(k, 0));
+			continue;
+		}
+		float start = clip.getKeyTime(t, k);
+		float alpha = (time - start) / (clip.getKeyTime(t, k + 1) - start);
+		glm::quat a = clip.getKeyRotation(t, k), b = clip.getKeyRotation(t, k + 1);
+		if (glm::dot(a, b) < 0.0f)
+			b = -b;
+		pose[t] = glm::normalize(interpolation == PoseData::Interpolation::Slerp ? glm::slerp(a, b, alpha) : a * (1.0f - alpha) + b * alpha);
+	}
+}
+
+int Benchmark::runClipBenchmark(int boneCount, int frameCount) {
+	if (boneCount <= 0 || frameCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d or frame count %d.\n", boneCount, frameCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	/* track t is keyed every (t % 5) + 1 frames with rotations changing by up to a few tens of degrees per key */
+	PoseData::BonePawn skeleton = generatePawn(boneCount);
+	std::vector<std::vector<PoseClip::Key>> tracks(boneCount);
+	const float frameRate = 30.0f;
+	for (int t = 0; t < boneCount; t++) {
+		for (int f = 0; f <= CLIP_FRAMES; f += t % 5 + 1) {
+			glm::vec3 euler((f * 7 + t) % 90 - 45.0f, (f * 3 + t * 11) % 60 - 30.0f, (f + t * 5) % 40 - 20.0f);
+			tracks[t].push_back({ f / frameRate, PoseDataUtil::eulerToQuat(euler) });
+		}
+	}
+	PoseClip::Clip clip;
+	clip.build(skeleton, tracks, frameRate);
+	const PoseData::Interpolation modes[3] = { PoseData::Interpolation::Step, PoseData::Interpolation::Nlerp, PoseData::Interpolation::Slerp };
+	for (int t = 0; t < boneCount; t++)
+		clip.setInterpolation(t, modes[t % 3]);
+	std::printf("Clip benchmark: %d tracks, %d keys, %d samples per pass, %s kernels\n", boneCount, clip.getKeyCount(), frameCount,
+		QUAT_SIMD_SSE2 ? "SSE2" : "scalar");
+
+	/* playback at twice the frame rate lands between the keys, wrapping to the start once the clip ends */
+	float duration = clip.getDuration();
+	std::vector<float> forward(frameCount), scattered(frameCount);
+	for (int k = 0; k < frameCount; k++) {
+		forward[k] = std::fmod(k / (2.0f * frameRate), duration);
+		scattered[k] = std::fmod(k * 0.6180339f, 1.0f) * duration;
+	}
+
+	std::printf("%-12s %12s %12s %12s %12s\n", "sampling", "us/frame", "searches", "allocs", "max error");
+	std::vector<glm::quat> pose(boneCount), reference;
+	PoseClip::Sampler sampler(clip);
+	sampler.sample(0.0f, pose); // grows the buffers
+	bool valid = true;
+	/* the reference passes search every track each frame, samplePose holds the keys, the glm pass interpolates them */
+	struct Pass { const char* name; const std::vector<float>* times; bool sampler; bool interpolate; };
+	for (const Pass& pass : { Pass{ "forward", &forward, true, true }, Pass{ "scattered", &scattered, true, true },
+		Pass{ "samplePose", &forward, false, false }, Pass{ "search + glm", &forward, false, true } }) {
+		sampler.reset();
+		size_t allocations = getAllocationCount();
+		auto begin = std::chrono::high_resolution_clock::now();
+		for (float time : *pass.times) {
+			if (pass.sampler)
+				sampler.sample(time, pose);
+			else if (pass.interpolate)
+				referenceClipPose(clip, time, pose);
+			else
+				clip.samplePose(time, pose);
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		allocations = getAllocationCount() - allocations;
+		double time = std::chrono::duration<double, std::micro>(end - begin).count();
+		long long searches = pass.sampler ? sampler.getSearches() : static_cast<long long>(frameCount) * boneCount;
+
+		float error = 0.0f;
+		if (pass.sampler) {
+			sampler.reset();
+			for (int k = 0; k < frameCount; k += std::max(frameCount / 100, 1)) {
+				sampler.sample((*pass.times)[k], pose);
+				referenceClipPose(clip, (*pass.times)[k], reference);
+				for (int t = 0; t < boneCount; t++)
+					error = std::max(error, 1.0f - std::abs(glm::dot(pose[t], reference[t])));
+			}
+			valid = valid && error <= BLEND_TOLERANCE && allocations == 0;
+		}
+		std::printf("%-12s %12.3f %12.2f %12zu %12.2e\n", pass.name, time / frameCount, static_cast<double>(searches) / frameCount,
+			allocations, error);
+		/* forward playback searches on the first frame and after wrapping around only */
+		if (pass.times == &forward && pass.sampler) {
+			long long wraps = static_cast<long long>(frameCount / (2.0f * frameRate * duration)) + 1;
+			valid = valid && searches <= wraps * boneCount;
+		}
+	}
+	printProfilerStats();
+
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: the sampler allocated, searched during forward playback or differs from the reference.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runReduceBenchmark(int boneCount, int frameCount) {
+	if (boneCount <= 0 || frameCount < 2) {
+		std::fprintf(stderr, "Benchmark: invalid bone count %d or frame count %d.\n", boneCount, frameCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	/* every bone swings at its own frequency with a hundredth of a degree of noise, as recorded motion keys every frame */
+	PoseData::BonePawn skeleton = generatePawn(boneCount);
+	for (int i = 1; i < boneCount; i++)
+		skeleton.bones[i].offset = glm::vec3(0.0f, 1.0f, 0.0f);
+	const float frameRate = 30.0f;
+	std::vector<int> sizes(boneCount, frameCount);
+	std::vector<float> times;
+	std::vector<glm::quat> rotations;
+	times.reserve(static_cast<size_t>(boneCount) * frameCount);
+	rotations.reserve(static_cast<size_t>(boneCount) * frameCount);
+	for (int t = 0; t < boneCount; t++) {
+		float frequency = 0.1f + (t % 7) * 0.05f, amplitude = t % 4 == 3 ? 0.0f : 5.0f + (t % 5) * 5.0f;
+		for (int f = 0; f < frameCount; f++) {
+			float time = f / frameRate, phase = 6.2831853f * frequency * time + t;
+			float noise = ((f * 7919 + t * 104729) % 201 - 100) * 1e-4f;
+			glm::vec3 euler(amplitude * std::sin(phase) + noise, 0.5f * amplitude * std::cos(1.3f * phase) - noise, noise);
+			times.push_back(time);
+			rotations.push_back(PoseDataUtil::eulerToQuat(euler));
+		}
+	}
+	PoseClip::Clip clip;
+	clip.build(skeleton, sizes, std::move(times), std::move(rotations), frameRate);
+	std::printf("Reduce benchmark: %d tracks, %d frames, %d keys, tolerance %.2f deg, %d threads\n", boneCount, frameCount,
+		clip.getKeyCount(), REDUCE_TOLERANCE, Parallel::ThreadPool::shared().getThreadCount());
+	std::printf("%-8s %10s %10s %10s %10s %12s %12s\n", "space", "ms", "keys", "kept", "ratio", "max error", "global error");
+
+	bool valid = true;
+	std::vector<glm::quat> pose;
+	for (bool globalSpace : { false, true }) {
+		PoseReduce::Settings settings;
+		settings.tolerance = REDUCE_TOLERANCE;
+		settings.globalSpace = globalSpace;
+		auto begin = std::chrono::high_resolution_clock::now();
+		PoseClip::Clip reduced = PoseReduce::reduce(clip, settings);
+		auto end = std::chrono::high_resolution_clock::now();
+		double time = std::chrono::duration<double, std::milli>(end - begin).count();
+		PoseData::KeyReduction report;
+		PoseReduce::reduce(clip, settings, &report);
+		float globalError = PoseReduce::measureGlobalError(clip, reduced);
+		std::printf("%-8s %10.2f %10d %10d %10.1f %12.4f %12.4f\n", globalSpace ? "global" : "local", time, report.keysBefore,
+			report.keysAfter, static_cast<double>(report.keysBefore) / std::max(report.keysAfter, 1), report.maxError, globalError);
+
+		/* every frame of the reduced clip has to stay within the tolerance of the recording, in the space it was bounded in */
+		float sampled = 0.0f;
+		PoseClip::Sampler sampler(reduced);
+		for (int f = 0; f < frameCount; f++) {
+			sampler.sample(clip.getKeyTime(0, f), pose);
+			for (int t = 0; t < boneCount; t++)
+				sampled = std::max(sampled, PoseReduce::angleBetween(pose[t], clip.getKeyRotation(t, f)));
+		}
+		float bound = globalSpace ? globalError : sampled;
+		valid = valid && report.keysAfter < report.keysBefore && bound <= REDUCE_TOLERANCE + REDUCE_SLACK &&
+			report.maxError <= REDUCE_TOLERANCE + REDUCE_SLACK && (!globalSpace || report.maxGlobalError == globalError);
+	}
+	printProfilerStats();
+
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: the reduction kept every key or exceeded the tolerance.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runQuantizeBenchmark(int poseCount, int boneCount) {
+	if (poseCount <= 0 || boneCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid pose count %d or bone count %d.\n", poseCount, boneCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	size_t count = static_cast<size_t>(poseCount) * boneCount;
+	unsigned int seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+	};
+	/* rotations of every pose one after another, uniform over all orientations */
+	std::vector<glm::quat> rotations(count);
+	for (glm::quat& q : rotations) {
+		do {
+			q = glm::quat(random(), random(), random(), random());
+		} while (glm::dot(q, q) < 1e-2f || glm::dot(q, q) > 1.0f);
+		q = glm::normalize(q);
+	}
+	RotationBatch::QuatLanes lanes, decoded;
+	lanes.resize(count);
+	decoded.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		lanes.w[i] = rotations[i].w; lanes.x[i] = rotations[i].x; lanes.y[i] = rotations[i].y; lanes.z[i] = rotations[i].z;
+	}
+
+	/* parsing the same bones from the text of a pose file, the cost of loading them from csv */
+	int csvPoses = std::min(poseCount, QUANTIZE_CSV_POSES);
+	std::stringstream text;
+	PoseData::BoneData bone;
+	bone.displayName = "bone";
+	int columns = PoseDataUtil::pawnCSVColumns(PoseData::BonePawn());
+	for (int i = 0; i < csvPoses * boneCount; i++) {
+		bone.id = i % boneCount;
+		bone.parent = bone.id - 1;
+		bone.quaternion = rotations[i];
+		PoseDataUtil::boneWriteCSVLine(text, bone, columns);
+		text << "\n";
+	}
+	std::vector<std::string> lines;
+	for (std::string line; std::getline(text, line);)
+		lines.push_back(line);
+	auto begin = std::chrono::high_resolution_clock::now();
+	int column = 0;
+	std::string problem;
+	bool parsed = true;
+	for (const std::string& line : lines)
+		parsed = PoseDataUtil::boneParseCSVLine(bone, line, column, problem) && parsed;
+	auto end = std::chrono::high_resolution_clock::now();
+	double csvTime = std::chrono::duration<double, std::nano>(end - begin).count() / lines.size();
+
+	std::printf("Quantize benchmark: %d poses, %d bones, %zu rotations, %.1f MB as floats\n", poseCount, boneCount, count,
+		count * sizeof(glm::quat) / 1048576.0);
+	std::printf("%-8s %10s %10s %10s %10s %10s %10s %10s %10s\n", "bits", "MB", "ratio", "pack ns", "scalar ns", "unpack ns",
+		"scalar ns", "max error", "bound");
+
+	bool valid = parsed, identical = true, bounded = true;
+	double slowest = 0.0;
+	for (QuatPack::Precision precision : { QuatPack::Precision::Bits32, QuatPack::Precision::Bits48 }) {
+		int bytes = QuatPack::bytesPer(precision);
+		std::vector<uint8_t> packed(count * bytes), scalar(count * bytes);
+		begin = std::chrono::high_resolution_clock::now();
+		QuatPack::pack(lanes, precision, packed.data());
+		end = std::chrono::high_resolution_clock::now();
+		double packTime = std::chrono::duration<double, std::nano>(end - begin).count() / count;
+
+		begin = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < count; i++) {
+			if (precision == QuatPack::Precision::Bits32) {
+				uint32_t bits = QuatPack::pack32(rotations[i]);
+				std::memcpy(&scalar[i * 4], &bits, sizeof(bits));
+			}
+			else {
+				QuatPack::pack48(rotations[i], &scalar[i * 6]);
+			}
+		}
+		end = std::chrono::high_resolution_clock::now();
+		double scalarPackTime = std::chrono::duration<double, std::nano>(end - begin).count() / count;
+		/* the packed bytes are little endian, as is every target of the editor */
+		identical = identical && packed == scalar;
+
+		begin = std::chrono::high_resolution_clock::now();
+		QuatPack::unpack(packed.data(), count, precision, decoded);
+		end = std::chrono::high_resolution_clock::now();
+		double unpackTime = std::chrono::duration<double, std::nano>(end - begin).count() / count;
+
+		float error = 0.0f;
+		double checksum = 0.0;
+		begin = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < count; i++) {
+			uint32_t bits = 0;
+			if (precision == QuatPack::Precision::Bits32)
+				std::memcpy(&bits, &packed[i * 4], sizeof(bits));
+			glm::quat q = precision == QuatPack::Precision::Bits32 ? QuatPack::unpack32(bits) : QuatPack::unpack48(&packed[i * 6]);
+			checksum += q.w;
+		}
+		end = std::chrono::high_resolution_clock::now();
+		double scalarUnpackTime = std::chrono::duration<double, std::nano>(end - begin).count() / count;
+		for (size_t i = 0; i < count; i++) {
+			glm::quat q(decoded.w[i], decoded.x[i], decoded.y[i], decoded.z[i]);
+			error = std::max(error, QuatPack::angleBetween(q, rotations[i]));
+			checksum -= q.w;
+		}
+
+		/* the same rotations kept as a library would, appended pose after pose */
+		QuatPack::PackedRotations library;
+		library.reset(precision);
+		library.append(rotations);
+		library.shrink();
+		double megabytes = library.getByteSize() / 1048576.0;
+		std::printf("%-8d %10.1f %10.2f %10.2f %10.2f %10.2f %10.2f %10.4f %10.4f\n", bytes * 8, megabytes,
+			count * sizeof(glm::quat) / 1048576.0 / megabytes, packTime, scalarPackTime, unpackTime, scalarUnpackTime, error,
+			QuatPack::maxError(precision));
+		bounded = bounded && error <= QuatPack::maxError(precision) && std::abs(checksum) < 1e-3 * count;
+		identical = identical && library.get(count - 1) == glm::quat(decoded.w[count - 1], decoded.x[count - 1], decoded.y[count - 1], decoded.z[count - 1]);
+		slowest = std::max(slowest, unpackTime);
+	}
+	std::printf("csv parse: %.2f ns per bone, %.1fx the slowest unpack\n", csvTime, csvTime / slowest);
+	printProfilerStats();
+
+	valid = valid && identical && bounded && slowest < csvTime;
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: the kernels differ from the scalar functions, exceed the error bound or decode slower than csv.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runLibraryBenchmark(int poseCount, int boneCount) {
+	if (poseCount <= 0 || boneCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid pose count %d or bone count %d.\n", poseCount, boneCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn skeleton = generatePawn(boneCount);
+	unsigned int seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+	};
+	/* the same rotations pose after pose, the way a file or pawn per pose holds them */
+	size_t count = static_cast<size_t>(poseCount) * boneCount;
+	std::vector<glm::quat> poseMajor(count), pose(boneCount);
+	for (size_t i = 0; i < count; i++) {
+		glm::vec3 axis(random(), random(), random() + 2.0f);
+		poseMajor[i] = glm::normalize(skeleton.bones[i % boneCount].quaternion * glm::angleAxis(random() * AVERAGE_SPREAD, glm::normalize(axis)));
+	}
+	PoseLibrary::Library library;
+	auto begin = std::chrono::high_resolution_clock::now();
+	library.reset(skeleton);
+	library.reserve(poseCount);
+	for (int p = 0; p < poseCount; p++) {
+		std::copy(poseMajor.begin() + static_cast<size_t>(p) * boneCount, poseMajor.begin() + static_cast<size_t>(p + 1) * boneCount, pose.begin());
+		library.addPose(pose, "pose_" + std::to_string(p));
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	double buildTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	std::printf("Library benchmark: %d poses, %d bones\n", poseCount, boneCount);
+	std::printf("%-28s %12s %12s\n", "", "library", "pose-major");
+
+	/* random poses, each has to match the stored one */
+	bool valid = library.getPoseCount() == poseCount;
+	std::vector<int> lookups(LIBRARY_LOOKUPS);
+	for (int& index : lookups)
+		index = static_cast<int>((random() * 0.5f + 0.5f) * (poseCount - 1) + 0.5f);
+	begin = std::chrono::high_resolution_clock::now();
+	for (int index : lookups) {
+		library.getPose(index, pose);
+		valid = valid && pose[boneCount - 1] == poseMajor[static_cast<size_t>(index) * boneCount + boneCount - 1];
+	}
+	end = std::chrono::high_resolution_clock::now();
+	double libraryLookup = std::chrono::duration<double, std::nano>(end - begin).count() / LIBRARY_LOOKUPS;
+	begin = std::chrono::high_resolution_clock::now();
+	for (int index : lookups) {
+		std::copy(poseMajor.begin() + static_cast<size_t>(index) * boneCount, poseMajor.begin() + static_cast<size_t>(index + 1) * boneCount, pose.begin());
+		valid = valid && pose[0] == library.getRotation(index, 0);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	double poseMajorLookup = std::chrono::duration<double, std::nano>(end - begin).count() / LIBRARY_LOOKUPS;
+	std::printf("%-28s %12.1f %12.1f\n", "random pose ns", libraryLookup, poseMajorLookup);
+
+	/* every bone scanned across all poses: how close it stays to its rest rotation */
+	std::vector<double> libraryScan(boneCount, 0.0), poseMajorScan(boneCount, 0.0);
+	begin = std::chrono::high_resolution_clock::now();
+	for (int b = 0; b < boneCount; b++) {
+		const RotationBatch::QuatLanes& row = library.getRow(b);
+		const glm::quat& rest = skeleton.bones[b].quaternion;
+		double sum = 0.0;
+		for (int p = 0; p < poseCount; p++)
+			sum += std::abs(rest.w * row.w[p] + rest.x * row.x[p] + rest.y * row.y[p] + rest.z * row.z[p]);
+		libraryScan[b] = sum;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	double libraryScanTime = std::chrono::duration<double, std::nano>(end - begin).count() / count;
+	begin = std::chrono::high_resolution_clock::now();
+	for (int b = 0; b < boneCount; b++) {
+		const glm::quat& rest = skeleton.bones[b].quaternion;
+		double sum = 0.0;
+		for (int p = 0; p < poseCount; p++) {
+			const glm::quat& q = poseMajor[static_cast<size_t>(p) * boneCount + b];
+			sum += std::abs(rest.w * q.w + rest.x * q.x + rest.y * q.y + rest.z * q.z);
+		}
+		poseMajorScan[b] = sum;
+	}
+	end = std::chrono::high_resolution_clock::now();
+	double poseMajorScanTime = std::chrono::duration<double, std::nano>(end - begin).count() / count;
+	valid = valid && libraryScan == poseMajorScan;
+	std::printf("%-28s %12.2f %12.2f\n", "bone scan ns per pose", libraryScanTime, poseMajorScanTime);
+
+	/* a pawn per pose repeats the skeleton, the names of its bones are not counted */
+	double libraryMemory = (library.getRotationBytes() + poseCount * sizeof(std::string)) / 1048576.0;
+	double pawnMemory = static_cast<double>(poseCount) * (sizeof(PoseData::BonePawn) + boneCount * sizeof(PoseData::BoneData)) / 1048576.0;
+	std::printf("%-28s %12.1f %12.1f (pawns)\n", "memory MB", libraryMemory, pawnMemory);
+	std::printf("%-28s %12.1f\n", "build ms", buildTime);
+
+	/* the file, and browsing it the way the editor does */
+	const std::string libraryPath = "benchmark_library.plib", posePath = "benchmark_library.csv";
+	begin = std::chrono::high_resolution_clock::now();
+	bool saved = PoseLibrary::saveLibrary(library, libraryPath);
+	end = std::chrono::high_resolution_clock::now();
+	double saveTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	begin = std::chrono::high_resolution_clock::now();
+	PoseLibrary::Library opened = PoseLibrary::openLibrary(libraryPath);
+	end = std::chrono::high_resolution_clock::now();
+	double openTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	float error = 0.0f;
+	valid = valid && saved && opened.getPoseCount() == poseCount && opened.getBoneCount() == boneCount;
+	for (int p = 0; valid && p < poseCount; p++) {
+		for (int b = 0; b < boneCount; b++)
+			error = std::max(error, QuatPack::angleBetween(opened.getRotation(p, b), library.getRotation(p, b)));
+	}
+	valid = valid && error <= QuatPack::maxError(QuatPack::Precision::Bits48);
+	std::printf("%-28s %12.1f %12.1f (open), %.1f MB, max error %.4f deg\n", "file save ms", saveTime, openTime,
+		std::ifstream(libraryPath, std::ios::binary | std::ios::ate).tellg() / 1048576.0, error);
+
+	/* the rows kept packed as in the file: the same rotations in a fraction of the memory, each read unpacks one */
+	begin = std::chrono::high_resolution_clock::now();
+	PoseLibrary::Library packed = PoseLibrary::openLibrary(libraryPath, PoseData::RotationOrder::XYZ, true);
+	end = std::chrono::high_resolution_clock::now();
+	double packedOpenTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	valid = valid && packed.isPacked() && packed.getPoseCount() == poseCount;
+	begin = std::chrono::high_resolution_clock::now();
+	for (int index : lookups) {
+		packed.getPose(index, pose);
+		valid = valid && pose[boneCount - 1] == opened.getRotation(index, boneCount - 1);
+	}
+	end = std::chrono::high_resolution_clock::now();
+	double packedLookup = std::chrono::duration<double, std::nano>(end - begin).count() / LIBRARY_LOOKUPS;
+	std::printf("%-28s %12.1f %12.1f (open), %.1f MB, random pose %.1f ns\n", "packed rows", opened.getRotationBytes() / 1048576.0,
+		packedOpenTime, packed.getRotationBytes() / 1048576.0, packedLookup);
+
+	auto model = std::make_shared<PoseModel::PoseModel>();
+	auto controller = std::make_shared<PoseController::PoseController>();
+	controller->setModel(std::dynamic_pointer_cast<PoseEditor::Model>(model));
+	valid = valid && controller->cmdOpenLibrary(libraryPath);
+	begin = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < LIBRARY_SHOWS; i++)
+		controller->cmdShowLibraryPose(lookups[i % LIBRARY_LOOKUPS]);
+	end = std::chrono::high_resolution_clock::now();
+	double showTime = std::chrono::duration<double, std::micro>(end - begin).count() / LIBRARY_SHOWS;
+	PoseDataUtil::saveFile(library.getPawn(lookups[0]), posePath);
+	begin = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < LIBRARY_SHOWS; i++)
+		model->cmdSetPawn(PoseDataUtil::openFile(posePath));
+	end = std::chrono::high_resolution_clock::now();
+	double fileTime = std::chrono::duration<double, std::micro>(end - begin).count() / LIBRARY_SHOWS;
+	std::printf("%-28s %12.1f %12.1f (pose file)\n", "show pose us", showTime, fileTime);
+	std::remove(libraryPath.c_str());
+	std::remove(posePath.c_str());
+	printProfilerStats();
+
+	valid = valid && showTime < fileTime;
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: the library lost poses, exceeded the file error bound or shows poses slower than pose files.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runSearchBenchmark(int poseCount, int boneCount) {
+	if (poseCount <= 0 || boneCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid pose count %d or bone count %d.\n", poseCount, boneCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn skeleton = generatePawn(boneCount);
+	unsigned int seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+	};
+	auto turn = [&random](float angle) { return glm::angleAxis(random() * angle, glm::normalize(glm::vec3(random(), random(), random() + 2.0f))); };
+	/* takes of recorded motion: every take starts anywhere and moves every bone a little per frame */
+	PoseLibrary::Library library;
+	library.reset(skeleton);
+	library.reserve(poseCount);
+	std::vector<glm::quat> pose(boneCount);
+	for (int p = 0; p < poseCount; p++) {
+		for (int b = 0; b < boneCount; b++)
+			pose[b] = glm::normalize(p % SEARCH_TAKE_FRAMES == 0 ? skeleton.bones[b].quaternion * turn(glm::pi<float>()) : pose[b] * turn(SEARCH_STEP));
+		library.addPose(pose, "pose_" + std::to_string(p));
+	}
+	std::printf("Search benchmark: %d poses in takes of %d frames, %d bones, %d threads\n", poseCount, SEARCH_TAKE_FRAMES, boneCount,
+		Parallel::ThreadPool::shared().getThreadCount());
+	std::printf("%-10s %10s %10s %12s %12s %12s %12s %10s\n", "feature", "build ms", "index MB", "k-NN ms", "range ms", "scan ms",
+		"distances", "found");
+
+	/* queries are library poses moved a little, every one compared with the scan of all poses */
+	std::vector<std::vector<glm::quat>> queries(SEARCH_QUERIES);
+	for (std::vector<glm::quat>& query : queries) {
+		library.getPose(static_cast<int>((random() * 0.5f + 0.5f) * (poseCount - 1) + 0.5f), query);
+		for (glm::quat& q : query)
+			q = glm::normalize(q * turn(SEARCH_STEP));
+	}
+	std::vector<ID> keyBones;
+	for (int b = 0; b < boneCount; b += 4)
+		keyBones.push_back(skeleton.bones[boneCount - 1 - b].id);
+	bool valid = true;
+	double bestScan = 0.0, bestSearch = 0.0;
+	const struct { const char* name; PoseSearch::Feature feature; bool key; } modes[] = {
+		{ "local", PoseSearch::Feature::Local, false },
+		{ "global key", PoseSearch::Feature::Global, true },
+	};
+	for (const auto& mode : modes) {
+		PoseSearch::Settings settings;
+		settings.feature = mode.feature;
+		if (mode.key)
+			settings.bones = keyBones;
+		PoseSearch::Index index;
+		auto begin = std::chrono::high_resolution_clock::now();
+		valid = valid && index.build(library, settings);
+		auto end = std::chrono::high_resolution_clock::now();
+		double buildTime = std::chrono::duration<double, std::milli>(end - begin).count();
+
+		double nearestTime = 0.0, rangeTime = 0.0, scanTime = 0.0;
+		long long distances = 0, found = 0;
+		for (const std::vector<glm::quat>& query : queries) {
+			int distanceCount = 0;
+			begin = std::chrono::high_resolution_clock::now();
+			std::vector<PoseSearch::Match> nearest = index.search(query, SEARCH_COUNT, -1.0f, &distanceCount);
+			end = std::chrono::high_resolution_clock::now();
+			nearestTime += std::chrono::duration<double, std::milli>(end - begin).count();
+			distances += distanceCount;
+			begin = std::chrono::high_resolution_clock::now();
+			std::vector<PoseSearch::Match> range = index.search(query, 0, SEARCH_RADIUS);
+			end = std::chrono::high_resolution_clock::now();
+			rangeTime += std::chrono::duration<double, std::milli>(end - begin).count();
+			found += range.size();
+			begin = std::chrono::high_resolution_clock::now();
+			std::vector<PoseSearch::Match> scanned = index.scan(query, SEARCH_COUNT);
+			end = std::chrono::high_resolution_clock::now();
+			scanTime += std::chrono::duration<double, std::milli>(end - begin).count();
+			valid = valid && nearest.size() == scanned.size() && range.size() == index.scan(query, 0, SEARCH_RADIUS).size();
+			for (size_t i = 0; valid && i < nearest.size(); i++)
+				valid = std::abs(nearest[i].distance - scanned[i].distance) <= SEARCH_TOLERANCE;
+		}
+		std::printf("%-10s %10.1f %10.1f %12.3f %12.3f %12.3f %12.0f %10.1f\n", mode.name, buildTime, index.getByteSize() / 1048576.0,
+			nearestTime / SEARCH_QUERIES, rangeTime / SEARCH_QUERIES, scanTime / SEARCH_QUERIES, static_cast<double>(distances) / SEARCH_QUERIES,
+			static_cast<double>(found) / SEARCH_QUERIES);
+		bestScan = std::max(bestScan, scanTime);
+		bestSearch = std::max(bestSearch, nearestTime);
+	}
+
+	/* the same queries asked through the controller, for the pose the pawn shows */
+	const std::string libraryPath = "benchmark_search.plib";
+	auto model = std::make_shared<PoseModel::PoseModel>();
+	auto controller = std::make_shared<PoseController::PoseController>();
+	controller->setModel(std::dynamic_pointer_cast<PoseEditor::Model>(model));
+	valid = valid && PoseLibrary::saveLibrary(library, libraryPath) && controller->cmdOpenLibrary(libraryPath);
+	controller->cmdFindSimilarPoses(SEARCH_COUNT, -1.0f, false, {});
+	double controllerTime = 0.0;
+	for (int i = 0; i < SEARCH_QUERIES; i++) {
+		int shown = (i * 7919) % poseCount;
+		controller->cmdShowLibraryPose(shown);
+		auto begin = std::chrono::high_resolution_clock::now();
+		std::vector<PoseData::PoseMatch> matches = controller->cmdFindSimilarPoses(SEARCH_COUNT, -1.0f, false, {});
+		auto end = std::chrono::high_resolution_clock::now();
+		controllerTime += std::chrono::duration<double, std::milli>(end - begin).count();
+		/* the shown pose itself is the closest, up to the euler round trip of the pawn */
+		valid = valid && !matches.empty() && matches[0].distance <= SEARCH_RADIUS;
+	}
+	std::remove(libraryPath.c_str());
+	std::printf("%-28s %12.3f\n", "controller k-NN ms", controllerTime / SEARCH_QUERIES);
+	printProfilerStats();
+
+	valid = valid && bestSearch < bestScan;
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: the index found other poses than the scan, missed the shown pose or was slower than the scan.\n");
+	return valid ? 0 : 1;
+}
+
+int Benchmark::runClusterBenchmark(int poseCount, int boneCount) {
+	if (poseCount <= 0 || boneCount <= 0) {
+		std::fprintf(stderr, "Benchmark: invalid pose count %d or bone count %d.\n", poseCount, boneCount);
+		return 1;
+	}
+
+	Profiler::reset();
+	PoseData::BonePawn skeleton = generatePawn(boneCount);
+	unsigned int seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+	};
+	auto turn = [&random](float angle) { return glm::angleAxis(random() * angle, glm::normalize(glm::vec3(random(), random(), random() + 2.0f))); };
+	/* takes of recorded motion holding every pose for a few frames, the held frames differ by jitter only */
+	PoseLibrary::Library library;
+	library.reset(skeleton);
+	library.reserve(poseCount);
+	std::vector<glm::quat> held(boneCount), pose(boneCount);
+	for (int p = 0; p < poseCount; p++) {
+		if (p % CLUSTER_HOLD_FRAMES == 0) {
+			for (int b = 0; b < boneCount; b++)
+				held[b] = glm::normalize(p % SEARCH_TAKE_FRAMES == 0 ? skeleton.bones[b].quaternion * turn(glm::pi<float>()) : held[b] * turn(CLUSTER_STEP));
+		}
+		for (int b = 0; b < boneCount; b++)
+			pose[b] = glm::normalize(held[b] * turn(CLUSTER_JITTER));
+		library.addPose(pose, "pose_" + std::to_string(p));
+	}
+	std::printf("Cluster benchmark: %d poses held for %d frames, %d bones, %d threads\n", poseCount, CLUSTER_HOLD_FRAMES, boneCount,
+		Parallel::ThreadPool::shared().getThreadCount());
+	std::printf("%-24s %10s %10s %12s %12s %12s %12s\n", "method", "time ms", "poses", "library MB", "index ms", "mean deg", "max deg");
+
+	/* the downstream work, building the search index, before and after deduplication */
+	PoseSearch::Settings settings;
+	PoseSearch::Index index;
+	auto begin = std::chrono::high_resolution_clock::now();
+	bool valid = index.build(library, settings);
+	auto end = std::chrono::high_resolution_clock::now();
+	double fullIndexTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	index = PoseSearch::Index();
+	std::printf("%-24s %10s %10d %12.1f %12.1f %12s %12s\n", "full", "", poseCount, library.getRotationBytes() / 1048576.0, fullIndexTime, "", "");
+
+	begin = std::chrono::high_resolution_clock::now();
+	PoseCluster::Result deduplicated = PoseCluster::deduplicate(library, settings, CLUSTER_THRESHOLD);
+	PoseLibrary::Library reduced = PoseCluster::representatives(library, deduplicated);
+	end = std::chrono::high_resolution_clock::now();
+	double dedupTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	begin = std::chrono::high_resolution_clock::now();
+	valid = valid && index.build(reduced, settings);
+	end = std::chrono::high_resolution_clock::now();
+	double reducedIndexTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	PoseData::ClusterReport dedupReport = PoseCluster::summarize(deduplicated);
+	std::printf("%-24s %10.1f %10d %12.1f %12.1f %12.4f %12.4f\n", "deduplicate 1 deg", dedupTime, dedupReport.posesAfter,
+		reduced.getRotationBytes() / 1048576.0, reducedIndexTime, dedupReport.meanDistance, dedupReport.maxDistance);
+	valid = valid && dedupReport.posesAfter > 0 && dedupReport.posesAfter < poseCount && dedupReport.maxDistance <= CLUSTER_THRESHOLD + SEARCH_TOLERANCE;
+
+	/* k-means of the deduplicated poses against every n-th pose, both measured to the closest representative */
+	int clusterCount = std::min(CLUSTER_COUNT, reduced.getPoseCount());
+	begin = std::chrono::high_resolution_clock::now();
+	PoseCluster::Result clustered = PoseCluster::kMeans(reduced, settings, clusterCount);
+	end = std::chrono::high_resolution_clock::now();
+	double kMeansTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	PoseCluster::Result even;
+	for (int c = 0; c < clusterCount; c++)
+		even.representatives.push_back(static_cast<int>(static_cast<long long>(c) * reduced.getPoseCount() / clusterCount));
+	const struct { const char* name; const PoseCluster::Result& result; } picks[] = {
+		{ "k-means", clustered },
+		{ "even steps", even },
+	};
+	double meanDistance[2] = { 0.0, 0.0 };
+	std::vector<glm::quat> rotations;
+	for (int m = 0; m < 2; m++) {
+		PoseSearch::Index representatives;
+		valid = valid && representatives.build(PoseCluster::representatives(reduced, picks[m].result), settings);
+		double sum = 0.0;
+		float largest = 0.0f;
+		for (int p = 0; p < reduced.getPoseCount(); p++) {
+			reduced.getPose(p, rotations);
+			std::vector<PoseSearch::Match> closest = representatives.search(rotations, 1);
+			float distance = closest.empty() ? 180.0f : closest[0].distance;
+			sum += distance;
+			largest = std::max(largest, distance);
+		}
+		meanDistance[m] = sum / std::max(reduced.getPoseCount(), 1);
+		char name[32];
+		std::snprintf(name, sizeof(name), "%s %d", picks[m].name, clusterCount);
+		std::printf("%-24s %10.1f %10d %12.3f %12s %12.4f %12.4f\n", name, m == 0 ? kMeansTime : 0.0, clusterCount,
+			clusterCount * boneCount * sizeof(glm::quat) / 1048576.0, "", meanDistance[m], largest);
+	}
+	std::printf("%-24s %10d\n", "k-means iterations", clustered.iterations);
+	valid = valid && static_cast<int>(clustered.representatives.size()) <= clusterCount;
+
+	/* the same amount of poses jittered around known poses far apart, k-means has to give every known pose a cluster of its own */
+	int knownPoses = std::max(reduced.getPoseCount(), clusterCount);
+	std::vector<std::vector<glm::quat>> centers;
+	while (static_cast<int>(centers.size()) < clusterCount) {
+		for (int b = 0; b < boneCount; b++)
+			pose[b] = glm::normalize(skeleton.bones[b].quaternion * turn(glm::pi<float>()));
+		bool apart = true;
+		for (size_t c = 0; apart && c < centers.size(); c++) {
+			float squared = 0.0f;
+			for (int b = 0; b < boneCount; b++)
+				squared += QuatPack::angleBetween(pose[b], centers[c][b]) * QuatPack::angleBetween(pose[b], centers[c][b]);
+			apart = squared >= CLUSTER_SEPARATION * CLUSTER_SEPARATION * boneCount;
+		}
+		if (apart)
+			centers.push_back(pose);
+	}
+	auto knownCluster = [&](int p) { return static_cast<int>(static_cast<long long>(p) * clusterCount / knownPoses); };
+	PoseLibrary::Library known;
+	known.reset(skeleton);
+	known.reserve(knownPoses);
+	for (int p = 0; p < knownPoses; p++) {
+		for (int b = 0; b < boneCount; b++)
+			pose[b] = glm::normalize(centers[knownCluster(p)][b] * turn(CLUSTER_KNOWN_JITTER));
+		known.addPose(pose, "pose_" + std::to_string(p));
+	}
+	begin = std::chrono::high_resolution_clock::now();
+	PoseCluster::Result recovered = PoseCluster::kMeans(known, settings, clusterCount);
+	end = std::chrono::high_resolution_clock::now();
+	double recoveredTime = std::chrono::duration<double, std::milli>(end - begin).count();
+	bool exact = static_cast<int>(recovered.representatives.size()) == clusterCount;
+	std::vector<int> clusterOfKnown(clusterCount, -1), knownOfCluster(recovered.representatives.size(), -1);
+	for (int p = 0; exact && p < knownPoses; p++) {
+		int cluster = recovered.clusters[p], center = knownCluster(p);
+		if (clusterOfKnown[center] < 0 && knownOfCluster[cluster] < 0) {
+			clusterOfKnown[center] = cluster;
+			knownOfCluster[cluster] = center;
+		}
+		exact = clusterOfKnown[center] == cluster && knownOfCluster[cluster] == center;
+	}
+	PoseData::ClusterReport recoveredReport = PoseCluster::summarize(recovered);
+	char name[32];
+	std::snprintf(name, sizeof(name), "k-means known %d", clusterCount);
+	std::printf("%-24s %10.1f %10d %12.3f %12s %12.4f %12.4f %s\n", name, recoveredTime, recoveredReport.posesAfter,
+		clusterCount * boneCount * sizeof(glm::quat) / 1048576.0, "", recoveredReport.meanDistance, recoveredReport.maxDistance,
+		exact ? "recovered" : "NOT recovered");
+	printProfilerStats();
+
+	valid = valid && exact;
+	if (!valid)
+		std::fprintf(stderr, "Benchmark: a pose was farther than the threshold from its representative, or k-means did not recover the known clusters.\n");
+	return valid ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+/// <title>Benchmark</title>
+/// <desc>
+///		Headless performance measurements of the application components.
+///		Launched from the command line (see Launcher.cxx) so they can run on machines without a GPU.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../PoseData.h"
+#include "AllocationCounter.h"
+#include "../model/PoseDataModel.h"
+#include "../model/PoseDataUtil.h"
+#include "../model/PoseKinematics.h"
+#include "../model/RotationBatch.h"
+#include "../model/PoseBlend.h"
+#include "../model/PoseLayers.h"
+#include "../model/PoseAverage.h"
+#include "../model/PoseMirror.h"
+#include "../model/PoseRetarget.h"
+#include "../model/PoseIK.h"
+#include "../model/PoseLimits.h"
+#include "../model/PoseConstraints.h"
+#include "../model/PoseClip.h"
+#include "../model/PoseLibrary.h"
+#include "../model/PoseSearch.h"
+#include "../model/PoseCluster.h"
+#include "../model/PoseReduce.h"
+#include "../model/QuatPack.h"
+#include "../controller/PoseController.h"
+#include "../view_glfw/ViewerGUI.h"
+#include "../profiler/Profiler.h"
+
+/// <summary>
+/// Benchmark holds the headless measurements of the editor together with helpers generating their input data.
+/// Each run function prints its report to stdout and returns the process exit code.
+/// </summary>
+namespace Benchmark {
+
+	/// <summary>
+	/// Generates a deterministic pawn with a tree hierarchy and varied rotations.
+	/// </summary>
+	/// <param name="boneCount">amount of bones in the pawn.</param>
+	/// <param name="branching">amount of children per bone. Bones are listed in breadth first order.</param>
+	PoseData::BonePawn generatePawn(int boneCount, int branching = 4);
+
+	/// <summary>
+	/// Prints the rolling statistics of all phases recorded by the Profiler. Prints nothing when the profiler is compiled out.
+	/// </summary>
+	void printProfilerStats();
+
+	/// <summary>
+	/// Runs ViewerGLFW::renderUI() on a headless ImGui context for frameCount frames in every display mode
+	/// and reports per-frame CPU time and heap allocations together with the vertex, index and draw command counts of ImDrawData.
+	/// Finishes with the per-frame cost of syncing a rotation slider drag between the Model and the View
+	/// and the Profiler phases recorded along the way.
+	/// </summary>
+	/// <param name="boneCount">size of the synthetic pawn displayed.</param>
+	/// <param name="frameCount">amount of measured frames per display mode.</param>
+	/// <returns>process exit code.</returns>
+	int runUIBenchmark(int boneCount, int frameCount);
+
+	/// <summary>
+	/// Measures PoseKinematics on a synthetic pawn: building the evaluation order, evaluating the global rotations and the joint positions.
+	/// Reports nanoseconds per bone and validates the result against glm::quat multiplication and rotation.
+	/// Finishes with the incremental update of the PoseModel FK cache after rotating a bone with a small subtree.
+	/// </summary>
+	/// <param name="boneCount">size of the synthetic pawn.</param>
+	/// <param name="iterations">amount of measured evaluations.</param>
+	/// <returns>process exit code.</returns>
+	int runFKBenchmark(int boneCount, int iterations);
+
+	/// <summary>
+	/// Measures the RotationBatch conversions in every rotation order on a sweep over the slider range, compares them with
+	/// PoseDataUtil::eulerToQuat and PoseDataUtil::quatToEuler and checks the documented tolerance.
+	/// </summary>
+	/// <param name="rotationCount">amount of rotations converted per iteration.</param>
+	/// <param name="iterations">amount of measured conversions.</param>
+	/// <returns>process exit code.</returns>
+	int runEulerBenchmark(int rotationCount, int iterations);
+
+	/// <summary>
+	/// Measures the PoseBlend kernels with nlerp and slerp, with and without a per bone mask, on two synthetic pawns.
+	/// Reports milliseconds and memory throughput per blend, validates the result against glm and finishes with
+	/// PoseBlend::blendRotations on pawns listing their bones in a different order.
+	/// </summary>
+	/// <param name="boneCount">size of the synthetic pawns.</param>
+	/// <param name="iterations">amount of measured blends.</param>
+	/// <returns>process exit code.</returns>
+	int runBlendBenchmark(int boneCount, int iterations);
+
+	/// <summary>
+	/// Measures PoseLayers::LayerStack on a synthetic pawn: evaluating a stack with every layer changed, and again after
+	/// changing the weight of a single layer. Compares both with applying the layers one after another with glm.
+	/// </summary>
+	/// <param name="boneCount">size of the synthetic pawn.</param>
+	/// <param name="layerCount">amount of layers in the stack.</param>
+	/// <param name="iterations">amount of measured evaluations.</param>
+	/// <returns>process exit code.</returns>
+	int runLayerBenchmark(int boneCount, int layerCount, int iterations);
+
+	/// <summary>
+	/// Measures PoseAverage on synthetic poses scattered around a base pawn, some of them with negated quaternions.
+	/// Reports the time with the shared thread pool, checks the result is identical with 1, 2 and 3 threads
+	/// and how far the mean lies from the base pose.
+	/// </summary>
+	/// <param name="poseCount">amount of averaged poses.</param>
+	/// <param name="boneCount">size of every pose.</param>
+	/// <param name="iterations">amount of measured averages.</param>
+	/// <returns>process exit code.</returns>
+	int runAverageBenchmark(int poseCount, int boneCount, int iterations);
+
+	/// <summary>
+	/// Measures PoseMirror on synthetic poses of a skeleton with Left_ / Right_ bone pairs: mirroring a batch of poses with the
+	/// symmetry map taken from a SymmetryCache, and with the map rebuilt for every pose. Checks that mirroring twice restores the pose.
+	/// </summary>
+	/// <param name="poseCount">amount of mirrored poses.</param>
+	/// <param name="boneCount">size of every pose.</param>
+	/// <returns>process exit code.</returns>
+	int runMirrorBenchmark(int poseCount, int boneCount);
+
+	/// <summary>
+	/// Measures PoseRetarget between two synthetic rigs: the target lists the bones in reverse with differently written names
+	/// and its own rest pose. Reports building the mapping table and transferring a batch of poses with the table reused,
+	/// and checks that retargeting back onto the source rig restores every pose.
+	/// </summary>
+	/// <param name="poseCount">amount of retargeted poses.</param>
+	/// <param name="boneCount">size of every pose.</param>
+	/// <returns>process exit code.</returns>
+	int runRetargetBenchmark(int poseCount, int boneCount);
+
+	/// <summary>
+	/// Measures PoseIK on a single synthetic chain: CCD, CCD with a turn limit and FABRIK reach for a series of targets,
+	/// each solve starting from the same pose. Reports milliseconds per solve, passes per solve, the targets reached, the average
+	/// distance left and heap allocations made while solving, which should be none.
+	/// Checks the reported distances against the joint positions of PoseKinematics with the solved rotations applied,
+	/// and that every solver reaches the targets it missed once it may make IK_REACH_PASSES passes.
+	/// </summary>
+	/// <param name="chainLength">amount of bones in the chain, at least 3.</param>
+	/// <param name="solveCount">amount of targets solved per solver.</param>
+	/// <returns>process exit code.</returns>
+	int runIKBenchmark(int chainLength, int solveCount);
+
+	/// <summary>
+	/// Measures PoseLimits::clampPawn on a synthetic pawn where three of four bones carry a swing or twist limit, every
+	/// iteration starting from the same unclamped rotations. Compares against the scalar clamp per bone, checks that every
+	/// clamped rotation lies within its limit and that a second pass leaves the pawn untouched.
+	/// </summary>
+	/// <param name="boneCount">size of the pawn.</param>
+	/// <param name="iterations">amount of measured passes.</param>
+	/// <returns>process exit code.</returns>
+	int runLimitsBenchmark(int boneCount, int iterations);
+
+	/// <summary>
+	/// Measures the constraint evaluation of PoseModel on a synthetic pawn where three of four siblings are driven: one copies
+	/// the free sibling, one takes the twist of the copy and one aims at the free sibling. Reports building the graph with a
+	/// full evaluation, then rotating a leaf driver and the root, which re-evaluate only their dependents.
+	/// Checks the incrementally updated pose against a full evaluation from scratch.
+	/// </summary>
+	/// <param name="boneCount">size of the pawn.</param>
+	/// <param name="iterations">amount of measured edits per driver.</param>
+	/// <returns>process exit code.</returns>
+	int runConstraintBenchmark(int boneCount, int iterations);
+
+	/// <summary>
+	/// Measures PoseClip::Sampler on a synthetic clip whose tracks are keyed every one to five frames and cycle through the
+	/// step, nlerp and slerp interpolations. Plays the clip forward at twice its frame rate, wrapping around, then samples it
+	/// at scattered times, and compares both against searching every track each frame, with Clip::samplePose holding the keys
+	/// and with glm interpolating them. Reports microseconds per frame, binary searches per frame and heap allocations made
+	/// while sampling, which should be none. Checks the sampled poses against the glm interpolation.
+	/// </summary>
+	/// <param name="boneCount">amount of tracks of the clip.</param>
+	/// <param name="frameCount">amount of measured samples per pass.</param>
+	/// <returns>process exit code.</returns>
+	int runClipBenchmark(int boneCount, int frameCount);
+
+	/// <summary>
+	/// Measures PoseReduce::reduce on a synthetic recording keying every bone on every frame: smooth motion with a little noise,
+	/// every fourth bone left still. Reduces it bounding the local and then the global error, reports the time, the compression
+	/// ratio and the largest local and global errors. Checks the errors against the tolerance by sampling the reduced clip.
+	/// </summary>
+	/// <param name="boneCount">amount of tracks of the clip.</param>
+	/// <param name="frameCount">amount of recorded frames.</param>
+	/// <returns>process exit code.</returns>
+	int runReduceBenchmark(int boneCount, int frameCount);
+
+	/// <summary>
+	/// Measures QuatPack on a library of random poses at both precisions: packing and unpacking with the SSE2 kernels against
+	/// the scalar functions, the memory of the packed library against plain quaternions and the largest error against
+	/// QuatPack::maxError(). Compares unpacking a rotation with parsing the line of a bone from a pose file.
+	/// Checks that the kernels give the same bytes as the scalar functions and that decoding is faster than parsing.
+	/// </summary>
+	/// <param name="poseCount">amount of poses of the library.</param>
+	/// <param name="boneCount">amount of bones of every pose.</param>
+	/// <returns>process exit code.</returns>
+	int runQuantizeBenchmark(int poseCount, int boneCount);
+
+	/// <summary>
+	/// Measures PoseLibrary on a library of poses slightly rotated away from a synthetic pawn, against the same rotations
+	/// stored pose after pose. Reports building it, reading random poses, scanning one bone across all poses, the memory
+	/// against a pawn per pose, saving and opening the library file and showing a pose through the controller next to
+	/// opening a pose file. Checks the poses read back, the scans and the opened file against the stored rotations.
+	/// </summary>
+	/// <param name="poseCount">amount of poses of the library.</param>
+	/// <param name="boneCount">amount of bones of every pose.</param>
+	/// <returns>process exit code.</returns>
+	int runLibraryBenchmark(int poseCount, int boneCount);
+
+	/// <summary>
+	/// Measures PoseSearch on a library of synthetic motion takes, comparing the local rotations of all bones and the global
+	/// orientations of key bones. Reports building the index on the thread pool, nearest neighbour and range queries, the
+	/// scan of every pose they replace and the poses compared per query, and queries through the controller. Checks the
+	/// queries against the scan.
+	/// </summary>
+	/// <param name="poseCount">amount of poses of the library.</param>
+	/// <param name="boneCount">amount of bones of every pose.</param>
+	/// <returns>process exit code.</returns>
+	int runSearchBenchmark(int poseCount, int boneCount);
+
+	/// <summary>
+	/// Measures PoseCluster on a library of synthetic takes whose poses are held for a few frames with small jitter, the
+	/// near duplicates of recorded motion. Reports deduplication, the memory of the library and the index build before and
+	/// after it, then k-means of the deduplicated library against representatives picked at even steps. Checks every pose
+	/// is within the threshold of its representative, and that k-means of as many poses jittered around known poses far
+	/// apart gives every known pose a cluster of its own.
+	/// </summary>
+	/// <param name="poseCount">amount of poses of the library.</param>
+	/// <param name="boneCount">amount of bones of every pose.</param>
+	/// <returns>process exit code.</returns>
+	int runClusterBenchmark(int poseCount, int boneCount);
+}
\ No newline at end of file
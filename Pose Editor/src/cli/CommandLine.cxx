@@ -0,0 +1,568 @@
+/// <title>Command Line</title>
+/// <desc>
+///		Headless editing operations launched from the command line (see Launcher.cxx).
+///		They drive the same Model and Controller as the editor window, only without a View.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include "CommandLine.h"
+
+CommandLine::Session CommandLine::createSession() {
+	Session session;
+	session.model = std::make_shared<PoseModel::PoseModel>();
+	session.controller = std::make_shared<PoseController::PoseController>();
+	session.controller->setModel(std::dynamic_pointer_cast<PoseEditor::Model>(session.model));
+	return session;
+}
+
+int CommandLine::runBlend(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --blend [--mask <mask.csv>] <pose.csv> <target.csv> <weight> <output.csv> [slerp]\n";
+	std::string mask;
+	size_t first = 0;
+	if (args.size() > 1 && args[0] == "--mask") {
+		mask = args[1];
+		first = 2;
+	}
+	if (args.size() < first + 4) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	float weight = static_cast<float>(std::atof(args[first + 2].c_str()));
+	bool slerp = args.size() > first + 4 && args[first + 4] == "slerp";
+	Session session = createSession();
+	if (!session.controller->cmdOpenFile(args[first])) {
+		std::fprintf(stderr, "Blend: could not open '%s'.\n", args[first].c_str());
+		return 1;
+	}
+	if (!session.controller->cmdBlendFile(args[first + 1], weight, slerp, mask)) {
+		std::fprintf(stderr, "Blend: could not open '%s'%s%s.\n", args[first + 1].c_str(), mask.empty() ? "" : " or the mask ", mask.c_str());
+		return 1;
+	}
+	if (!session.controller->cmdSaveFile(args[first + 3])) {
+		std::fprintf(stderr, "Blend: could not save '%s'.\n", args[first + 3].c_str());
+		return 1;
+	}
+	return 0;
+}
+
+int CommandLine::runDifference(const std::vector<std::string>& args) {
+	if (args.size() < 3) {
+		std::fprintf(stderr, "Usage: --difference <base.csv> <target.csv> <output.csv>\n");
+		return 1;
+	}
+	Session session = createSession();
+	if (!session.controller->cmdOpenFile(args[1])) {
+		std::fprintf(stderr, "Difference: could not open '%s'.\n", args[1].c_str());
+		return 1;
+	}
+	if (!session.controller->cmdSaveDifferenceFile(args[0], args[2])) {
+		std::fprintf(stderr, "Difference: could not open '%s' or save '%s'.\n", args[0].c_str(), args[2].c_str());
+		return 1;
+	}
+	return 0;
+}
+
+int CommandLine::runLayer(const std::vector<std::string>& args) {
+	if (args.size() < 4 || args.size() % 2 != 0) {
+		std::fprintf(stderr, "Usage: --layer <base.csv> <output.csv> <layer.csv> <weight> [<layer.csv> <weight> ...]\n");
+		return 1;
+	}
+	Session session = createSession();
+	if (!session.controller->cmdOpenFile(args[0])) {
+		std::fprintf(stderr, "Layer: could not open '%s'.\n", args[0].c_str());
+		return 1;
+	}
+	for (size_t i = 2; i + 1 < args.size(); i += 2) {
+		if (session.controller->cmdAddLayerFile(args[i], static_cast<float>(std::atof(args[i + 1].c_str()))) < 0) {
+			std::fprintf(stderr, "Layer: could not open '%s'.\n", args[i].c_str());
+			return 1;
+		}
+	}
+	if (!session.controller->cmdSaveFile(args[1])) {
+		std::fprintf(stderr, "Layer: could not save '%s'.\n", args[1].c_str());
+		return 1;
+	}
+	return 0;
+}
+
+int CommandLine::runAverage(const std::vector<std::string>& args) {
+	if (args.size() < 3 || args.size() % 2 != 1) {
+		std::fprintf(stderr, "Usage: --average <output.csv> <pose.csv> <weight> [<pose.csv> <weight> ...]\n");
+		return 1;
+	}
+	std::vector<std::string> paths;
+	std::vector<float> weights;
+	for (size_t i = 1; i + 1 < args.size(); i += 2) {
+		paths.push_back(args[i]);
+		weights.push_back(static_cast<float>(std::atof(args[i + 1].c_str())));
+	}
+	Session session = createSession();
+	if (!session.controller->cmdOpenFile(paths[0]) || !session.controller->cmdAverageFiles(paths, weights)) {
+		std::fprintf(stderr, "Average: could not open all of the poses.\n");
+		return 1;
+	}
+	if (!session.controller->cmdSaveFile(args[0])) {
+		std::fprintf(stderr, "Average: could not save '%s'.\n", args[0].c_str());
+		return 1;
+	}
+	return 0;
+}
+
+int CommandLine::runMirror(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --mirror <YZ|XZ|XY> [--roots <id,id,...>] <input.csv> <output.csv> [<input.csv> <output.csv> ...]\n";
+	if (args.empty()) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	PoseData::MirrorPlane plane;
+	if (args[0] == "YZ")
+		plane = PoseData::MirrorPlane::YZ;
+	else if (args[0] == "XZ")
+		plane = PoseData::MirrorPlane::XZ;
+	else if (args[0] == "XY")
+		plane = PoseData::MirrorPlane::XY;
+	else {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	size_t first = 1;
+	std::vector<ID> roots;
+	if (args.size() > 2 && args[1] == "--roots") {
+		std::stringstream list(args[2]);
+		std::string id;
+		while (std::getline(list, id, ','))
+			roots.push_back(std::atoi(id.c_str()));
+		first = 3;
+	}
+	if (args.size() < first + 2 || (args.size() - first) % 2 != 0) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	Session session = createSession();
+	for (size_t i = first; i + 1 < args.size(); i += 2) {
+		if (!session.controller->cmdOpenFile(args[i])) {
+			std::fprintf(stderr, "Mirror: could not open '%s'.\n", args[i].c_str());
+			return 1;
+		}
+		session.controller->cmdMirror(plane, roots);
+		if (!session.controller->cmdSaveFile(args[i + 1])) {
+			std::fprintf(stderr, "Mirror: could not save '%s'.\n", args[i + 1].c_str());
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int CommandLine::runRetarget(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --retarget <skeleton.csv> [--map <map.csv>] [--rest <source_rest.csv>] <input.csv> <output.csv> [<input.csv> <output.csv> ...]\n";
+	if (args.empty()) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	size_t first = 1;
+	std::string mapPath, restPath;
+	while (first + 1 < args.size() && (args[first] == "--map" || args[first] == "--rest")) {
+		(args[first] == "--map" ? mapPath : restPath) = args[first + 1];
+		first += 2;
+	}
+	if (args.size() < first + 2 || (args.size() - first) % 2 != 0) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	Session session = createSession();
+	if (!session.controller->cmdSetRetargetTarget(args[0], mapPath, restPath)) {
+		std::fprintf(stderr, "Retarget: could not read the skeleton, map or rest pose.\n");
+		return 1;
+	}
+	for (size_t i = first; i + 1 < args.size(); i += 2) {
+		if (!session.controller->cmdOpenFile(args[i])) {
+			std::fprintf(stderr, "Retarget: could not open '%s'.\n", args[i].c_str());
+			return 1;
+		}
+		session.controller->cmdRetarget();
+		if (!session.controller->cmdSaveFile(args[i + 1])) {
+			std::fprintf(stderr, "Retarget: could not save '%s'.\n", args[i + 1].c_str());
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int CommandLine::runIK(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --ik <pose.csv> <root id> <tip id> <x,y,z> <output.csv> [ccd|fabrik]\n";
+	if (args.size() < 5 || args.size() > 6 || (args.size() == 6 && args[5] != "ccd" && args[5] != "fabrik")) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	glm::vec3 target(0, 0, 0);
+	std::stringstream list(args[3]);
+	std::string value;
+	for (int axis = 0; axis < 3 && std::getline(list, value, ','); axis++)
+		target[axis] = static_cast<float>(std::atof(value.c_str()));
+	PoseData::IKSolver solver = args.size() == 6 && args[5] == "fabrik" ? PoseData::IKSolver::FABRIK : PoseData::IKSolver::CCD;
+	PoseIK::Settings settings;
+	Session session = createSession();
+	if (!session.controller->cmdOpenFile(args[0])) {
+		std::fprintf(stderr, "IK: could not open '%s'.\n", args[0].c_str());
+		return 1;
+	}
+	float distance = session.controller->cmdSolveIK(std::atoi(args[1].c_str()), std::atoi(args[2].c_str()), target, solver,
+		settings.maxIterations, settings.tolerance);
+	if (distance < 0.0f) {
+		std::fprintf(stderr, "IK: bone %s is not a descendant of bone %s.\n", args[2].c_str(), args[1].c_str());
+		return 1;
+	}
+	if (distance > settings.tolerance)
+		std::fprintf(stderr, "IK: the target is out of reach, the tip stopped %g away.\n", distance);
+	if (!session.controller->cmdSaveFile(args[4])) {
+		std::fprintf(stderr, "IK: could not save '%s'.\n", args[4].c_str());
+		return 1;
+	}
+	return 0;
+}
+
+int CommandLine::runClip(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --clip <output.clip|output.clipb> <input.clip|input.clipb>\n"
+		"       --clip <output.clip|output.clipb> <frame rate> <pose.csv> [<pose.csv> ...]\n";
+	/* a clip file as the only input is converted, anything else starts with the frame rate */
+	bool convert = args.size() == 2 && PoseClip::addExtension(args[1], PoseClip::formatOf(args[1])) == args[1];
+	if (args.size() < 2 || (args.size() == 2 && !convert)) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	Session session = createSession();
+	if (convert) {
+		if (!session.controller->cmdOpenClip(args[1])) {
+			std::fprintf(stderr, "Clip: could not open '%s'.\n", args[1].c_str());
+			return 1;
+		}
+		if (!session.controller->cmdSaveClip(args[0])) {
+			std::fprintf(stderr, "Clip: could not save '%s'.\n", args[0].c_str());
+			return 1;
+		}
+		return 0;
+	}
+	float frameRate = static_cast<float>(std::atof(args[1].c_str()));
+	if (frameRate <= 0.0f) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	/* the poses are gathered first, so the key arrays of the clip are built once */
+	std::vector<PoseData::BonePawn> poses;
+	poses.reserve(args.size() - 2);
+	for (size_t i = 2; i < args.size(); i++) {
+		poses.push_back(PoseDataUtil::openFile(args[i]));
+		if (!poses.back().loaded) {
+			std::fprintf(stderr, "Clip: could not open '%s'.\n", args[i].c_str());
+			return 1;
+		}
+	}
+	PoseClip::Clip clip = PoseClip::fromPoses(poses, frameRate);
+	PoseClip::ClipFormat format = PoseClip::formatOf(args[0]);
+	std::string path = PoseClip::addExtension(args[0], format);
+	if (!PoseClip::saveClip(clip, path, format)) {
+		std::fprintf(stderr, "Clip: could not save '%s'.\n", path.c_str());
+		return 1;
+	}
+	std::printf("Clip: %zu frames, %d bones, %d keys saved into '%s'.\n", poses.size(), clip.getTrackCount(), clip.getKeyCount(), path.c_str());
+	return 0;
+}
+
+/// <returns>size of the file in bytes, 0 if it can't be opened.</returns>
+static long long fileSize(const std::string& path) {
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	return file.is_open() ? static_cast<long long>(file.tellg()) : 0;
+}
+
+/// <returns>milliseconds taken by PoseClip::openClip() on the file.</returns>
+static double clipLoadTime(const std::string& path) {
+	auto begin = std::chrono::high_resolution_clock::now();
+	PoseClip::Clip clip = PoseClip::openClip(path);
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int CommandLine::runReduce(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --reduce [--global] [--bones <id:degrees,...>] <input clip> <output clip> <degrees>\n";
+	bool globalSpace = false;
+	std::vector<ID> boneids;
+	std::vector<float> tolerances;
+	size_t first = 0;
+	while (first < args.size() && (args[first] == "--global" || args[first] == "--bones")) {
+		if (args[first] == "--global") {
+			globalSpace = true;
+			first++;
+			continue;
+		}
+		if (first + 1 >= args.size()) {
+			std::fprintf(stderr, "%s", usage);
+			return 1;
+		}
+		std::stringstream list(args[first + 1]);
+		std::string entry;
+		while (std::getline(list, entry, ',')) {
+			size_t colon = entry.find(':');
+			if (colon == std::string::npos) {
+				std::fprintf(stderr, "%s", usage);
+				return 1;
+			}
+			boneids.push_back(std::atoi(entry.substr(0, colon).c_str()));
+			tolerances.push_back(static_cast<float>(std::atof(entry.substr(colon + 1).c_str())));
+		}
+		first += 2;
+	}
+	if (args.size() != first + 3) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	const std::string& input = args[first];
+	float tolerance = static_cast<float>(std::atof(args[first + 2].c_str()));
+	Session session = createSession();
+	if (!session.controller->cmdOpenClip(input)) {
+		std::fprintf(stderr, "Reduce: could not open '%s'.\n", input.c_str());
+		return 1;
+	}
+	PoseData::KeyReduction report = session.controller->cmdReduceClip(tolerance, globalSpace, boneids, tolerances);
+	std::string output = PoseClip::addExtension(args[first + 1], PoseClip::formatOf(args[first + 1]));
+	if (!session.controller->cmdSaveClip(output)) {
+		std::fprintf(stderr, "Reduce: could not save '%s'.\n", output.c_str());
+		return 1;
+	}
+	std::printf("Reduce: %d -> %d keys (%.1fx), max error %.4f deg", report.keysBefore, report.keysAfter,
+		static_cast<double>(report.keysBefore) / std::max(report.keysAfter, 1), report.maxError);
+	if (report.maxGlobalError >= 0.0f)
+		std::printf(", max global error %.4f deg", report.maxGlobalError);
+	std::printf("\n        %lld -> %lld bytes, loaded in %.3f -> %.3f ms\n", fileSize(input), fileSize(output),
+		clipLoadTime(input), clipLoadTime(output));
+	return 0;
+}
+
+/// <returns>milliseconds taken by PoseDataUtil::openFile() on the file.</returns>
+static double poseLoadTime(const std::string& path) {
+	auto begin = std::chrono::high_resolution_clock::now();
+	PoseData::BonePawn pawn = PoseDataUtil::openFile(path);
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int CommandLine::runCompact(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --compact <input.csv|input.posq> <output.csv|output.posq> [max error degrees]\n";
+	if (args.size() != 2 && args.size() != 3) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	const std::string& input = args[0];
+	std::string output = PoseDataUtil::addExtension(args[1]);
+	QuatPack::Precision precision = QuatPack::Precision::Bits48;
+	if (args.size() == 3 && !QuatPack::choosePrecision(static_cast<float>(std::atof(args[2].c_str())), precision)) {
+		std::fprintf(stderr, "Compact: no precision keeps rotations within %s deg, the finest is %.4f deg.\n", args[2].c_str(),
+			QuatPack::maxError(QuatPack::Precision::Bits48));
+		return 1;
+	}
+	PoseData::BonePawn pawn = PoseDataUtil::openFile(input);
+	if (!pawn.loaded) {
+		std::fprintf(stderr, "Compact: could not open '%s'.\n", input.c_str());
+		return 1;
+	}
+	bool saved = PoseDataUtil::isCompactFile(output) ?
+		PoseDataUtil::saveCompactFile(pawn, output, precision) : PoseDataUtil::saveFile(pawn, output);
+	if (!saved) {
+		std::fprintf(stderr, "Compact: could not save '%s'.\n", output.c_str());
+		return 1;
+	}
+	/* compare against what the output reads back as */
+	PoseData::BonePawn written = PoseDataUtil::openFile(output);
+	float error = 0.0f;
+	for (size_t i = 0; i < pawn.bones.size() && i < written.bones.size(); i++)
+		error = std::max(error, QuatPack::angleBetween(glm::normalize(pawn.bones[i].quaternion), written.bones[i].quaternion));
+	std::printf("Compact: %zu bones, max error %.4f deg", pawn.bones.size(), error);
+	if (PoseDataUtil::isCompactFile(output))
+		std::printf(" (%d bit rotations, bound %.4f deg)", QuatPack::bytesPer(precision) * 8, QuatPack::maxError(precision));
+	std::printf("\n         %lld -> %lld bytes, loaded in %.3f -> %.3f ms\n", fileSize(input), fileSize(output),
+		poseLoadTime(input), poseLoadTime(output));
+	return 0;
+}
+
+int CommandLine::runLibrary(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --library <output.plib> <pose> [<pose> ...]\n"
+		"       --library <library.plib> --list\n"
+		"       --library <library.plib> --pose <index> <output>\n";
+	if (args.size() < 2) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	if (args[1] == "--list" || args[1] == "--pose") {
+		if ((args[1] == "--list" && args.size() != 2) || (args[1] == "--pose" && args.size() != 4)) {
+			std::fprintf(stderr, "%s", usage);
+			return 1;
+		}
+		/* nothing is searched or edited, the rows stay packed as in the file */
+		PoseLibrary::Library library = PoseLibrary::openLibrary(args[0], PoseData::RotationOrder::XYZ, true);
+		if (!library.getSkeleton().loaded) {
+			std::fprintf(stderr, "Library: could not open '%s'.\n", args[0].c_str());
+			return 1;
+		}
+		if (args[1] == "--list") {
+			std::printf("Library: %d poses, %d bones\n", library.getPoseCount(), library.getBoneCount());
+			for (int p = 0; p < library.getPoseCount(); p++)
+				std::printf("%d, %s\n", p, library.getName(p).c_str());
+			return 0;
+		}
+		int pose = std::atoi(args[2].c_str());
+		if (pose < 0 || pose >= library.getPoseCount()) {
+			std::fprintf(stderr, "Library: pose %d is not among the %d poses.\n", pose, library.getPoseCount());
+			return 1;
+		}
+		std::string output = PoseDataUtil::addExtension(args[3]);
+		if (!PoseDataUtil::saveFile(library.getPawn(pose), output)) {
+			std::fprintf(stderr, "Library: could not save '%s'.\n", output.c_str());
+			return 1;
+		}
+		return 0;
+	}
+	/* poses are opened one at a time, so building a library never holds more than one pawn */
+	PoseLibrary::Library library;
+	for (size_t i = 1; i < args.size(); i++) {
+		PoseData::BonePawn pawn = PoseDataUtil::openFile(args[i]);
+		if (!pawn.loaded) {
+			std::fprintf(stderr, "Library: could not open '%s'.\n", args[i].c_str());
+			return 1;
+		}
+		if (i == 1) {
+			library.reset(pawn);
+			library.reserve(args.size() - 1);
+		}
+		library.addPose(pawn, pawn.originalFileName);
+	}
+	std::string output = PoseLibrary::addExtension(args[0]);
+	if (!PoseLibrary::saveLibrary(library, output)) {
+		std::fprintf(stderr, "Library: could not save '%s'.\n", output.c_str());
+		return 1;
+	}
+	long long poseFiles = 0;
+	for (size_t i = 1; i < args.size(); i++)
+		poseFiles += fileSize(args[i]);
+	std::printf("Library: %d poses, %d bones, %lld bytes of pose files -> %lld bytes\n", library.getPoseCount(),
+		library.getBoneCount(), poseFiles, fileSize(output));
+	return 0;
+}
+
+int CommandLine::runSearch(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --search [--global] [--bones <id,id,...>] [--within <degrees>] <library.plib> <pose> [count]\n";
+	bool global = false;
+	std::vector<ID> boneids;
+	float radius = -1.0f;
+	size_t first = 0;
+	while (first < args.size() && (args[first] == "--global" || args[first] == "--bones" || args[first] == "--within")) {
+		if (args[first] == "--global") {
+			global = true;
+			first++;
+			continue;
+		}
+		if (first + 1 >= args.size()) {
+			std::fprintf(stderr, "%s", usage);
+			return 1;
+		}
+		if (args[first] == "--within") {
+			radius = static_cast<float>(std::atof(args[first + 1].c_str()));
+		}
+		else {
+			std::stringstream list(args[first + 1]);
+			std::string entry;
+			while (std::getline(list, entry, ','))
+				boneids.push_back(std::atoi(entry.c_str()));
+		}
+		first += 2;
+	}
+	if (args.size() != first + 2 && args.size() != first + 3) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	/* without a count a range query returns every pose within it */
+	int count = args.size() == first + 3 ? std::atoi(args[first + 2].c_str()) : (radius >= 0.0f ? 0 : 10);
+	Session session = createSession();
+	if (!session.controller->cmdOpenLibrary(args[first])) {
+		std::fprintf(stderr, "Search: could not open '%s'.\n", args[first].c_str());
+		return 1;
+	}
+	if (!session.controller->cmdOpenFile(args[first + 1])) {
+		std::fprintf(stderr, "Search: could not open '%s'.\n", args[first + 1].c_str());
+		return 1;
+	}
+	/* the first search builds the index, the second one only walks it */
+	auto begin = std::chrono::high_resolution_clock::now();
+	session.controller->cmdFindSimilarPoses(count, radius, global, boneids);
+	auto built = std::chrono::high_resolution_clock::now();
+	std::vector<PoseData::PoseMatch> matches = session.controller->cmdFindSimilarPoses(count, radius, global, boneids);
+	auto end = std::chrono::high_resolution_clock::now();
+	if (matches.empty() && count != 0) {
+		std::fprintf(stderr, "Search: no pose found, the library is empty or none of the bones is in it.\n");
+		return 1;
+	}
+	std::printf("Search: %zu poses found, index built in %.1f ms, query took %.3f ms\n", matches.size(),
+		std::chrono::duration<double, std::milli>(built - begin).count(), std::chrono::duration<double, std::milli>(end - built).count());
+	for (const PoseData::PoseMatch& match : matches)
+		std::printf("%d, %s, %.4f\n", match.pose, match.name.c_str(), match.distance);
+	return 0;
+}
+
+int CommandLine::runCluster(const std::vector<std::string>& args) {
+	const char* usage = "Usage: --cluster [--global] [--bones <id,id,...>] (--count <clusters> | --within <degrees>) <library.plib> <output.plib> <mapping.csv>\n";
+	bool global = false;
+	std::vector<ID> boneids;
+	int count = 0;
+	float threshold = -1.0f;
+	size_t first = 0;
+	while (first < args.size() && (args[first] == "--global" || args[first] == "--bones" || args[first] == "--count" || args[first] == "--within")) {
+		if (args[first] == "--global") {
+			global = true;
+			first++;
+			continue;
+		}
+		if (first + 1 >= args.size()) {
+			std::fprintf(stderr, "%s", usage);
+			return 1;
+		}
+		if (args[first] == "--count") {
+			count = std::atoi(args[first + 1].c_str());
+		}
+		else if (args[first] == "--within") {
+			threshold = static_cast<float>(std::atof(args[first + 1].c_str()));
+		}
+		else {
+			std::stringstream list(args[first + 1]);
+			std::string entry;
+			while (std::getline(list, entry, ','))
+				boneids.push_back(std::atoi(entry.c_str()));
+		}
+		first += 2;
+	}
+	/* exactly one of k-means and deduplication */
+	if (args.size() != first + 3 || (count > 0) == (threshold >= 0.0f)) {
+		std::fprintf(stderr, "%s", usage);
+		return 1;
+	}
+	Session session = createSession();
+	if (!session.controller->cmdOpenLibrary(args[first])) {
+		std::fprintf(stderr, "Cluster: could not open '%s'.\n", args[first].c_str());
+		return 1;
+	}
+	auto begin = std::chrono::high_resolution_clock::now();
+	PoseData::ClusterReport report = session.controller->cmdClusterLibrary(count, threshold, global, boneids, args[first + 2]);
+	auto end = std::chrono::high_resolution_clock::now();
+	if (report.posesAfter == 0) {
+		std::fprintf(stderr, "Cluster: nothing done, none of the bones is in the library or '%s' could not be written.\n", args[first + 2].c_str());
+		return 1;
+	}
+	if (!session.controller->cmdSaveLibrary(args[first + 1]))
+		return 1;
+	std::printf("Cluster: %d -> %d poses in %.1f ms", report.posesBefore, report.posesAfter, std::chrono::duration<double, std::milli>(end - begin).count());
+	if (count > 0)
+		std::printf(", %d iterations", report.iterations);
+	std::printf("\nDistance to representative: max %.4f deg, mean %.4f deg\n", report.maxDistance, report.meanDistance);
+	std::printf("Library: %lld bytes -> %lld bytes\n", fileSize(args[first]), fileSize(PoseLibrary::addExtension(args[first + 1])));
+	return 0;
+}
@@ -0,0 +1,132 @@
+/// <title>Command Line</title>
+/// <desc>
+///		Headless editing operations launched from the command line (see Launcher.cxx).
+///		They drive the same Model and Controller as the editor window, only without a View.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../PoseData.h"
+#include "../model/PoseDataModel.h"
+#include "../controller/PoseController.h"
+
+/// <summary>
+/// CommandLine holds the headless operations of the editor. Each run function takes the arguments following its switch,
+/// prints problems to stderr and returns the process exit code.
+/// </summary>
+namespace CommandLine {
+
+	/// <summary>
+	/// Model and Controller wired together without a View.
+	/// </summary>
+	struct Session {
+		std::shared_ptr<PoseModel::PoseModel> model;
+		std::shared_ptr<PoseController::PoseController> controller;
+	};
+
+	/// <summary>
+	/// Creates a Model and a Controller introduced to each other, the same way ApplicationInstance does.
+	/// </summary>
+	Session createSession();
+
+	/// <summary>
+	/// --blend [--mask &lt;mask.csv&gt;] &lt;pose.csv&gt; &lt;target.csv&gt; &lt;weight&gt; &lt;output.csv&gt; [slerp]
+	/// Blends pose toward target, scaling the weight per bone by the mask if given, and saves the result.
+	/// </summary>
+	int runBlend(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --difference &lt;base.csv&gt; &lt;target.csv&gt; &lt;output.csv&gt;
+	/// Saves the difference pose turning base into target.
+	/// </summary>
+	int runDifference(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --layer &lt;base.csv&gt; &lt;output.csv&gt; &lt;layer.csv&gt; &lt;weight&gt; [&lt;layer.csv&gt; &lt;weight&gt; ...]
+	/// Applies difference poses as weighted additive layers on top of base, in the given order, and saves the result.
+	/// </summary>
+	int runLayer(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --average &lt;output.csv&gt; &lt;pose.csv&gt; &lt;weight&gt; [&lt;pose.csv&gt; &lt;weight&gt; ...]
+	/// Saves the weighted mean of the poses, on the skeleton of the first one.
+	/// </summary>
+	int runAverage(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --mirror &lt;YZ|XZ|XY&gt; [--roots &lt;id,id,...&gt;] &lt;input.csv&gt; &lt;output.csv&gt; [&lt;input.csv&gt; &lt;output.csv&gt; ...]
+	/// Mirrors every input across the plane and saves it into the following output. Files sharing a skeleton share its symmetry map.
+	/// </summary>
+	int runMirror(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --retarget &lt;skeleton.csv&gt; [--map &lt;map.csv&gt;] [--rest &lt;source_rest.csv&gt;] &lt;input.csv&gt; &lt;output.csv&gt; [&lt;input.csv&gt; &lt;output.csv&gt; ...]
+	/// Moves every input onto the skeleton and saves it into the following output. The mapping is built once per source skeleton.
+	/// </summary>
+	int runRetarget(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --ik &lt;pose.csv&gt; &lt;root id&gt; &lt;tip id&gt; &lt;x,y,z&gt; &lt;output.csv&gt; [ccd|fabrik]
+	/// Rotates the chain from root to tip so the joint of tip reaches the target position and saves the result.
+	/// </summary>
+	int runIK(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --clip &lt;output.clip|output.clipb&gt; &lt;input.clip|input.clipb&gt;
+	/// --clip &lt;output.clip|output.clipb&gt; &lt;frame rate&gt; &lt;pose.csv&gt; [&lt;pose.csv&gt; ...]
+	/// Converts a clip between the text and the binary format, or builds a clip from poses, one frame per pose, and saves it.
+	/// </summary>
+	int runClip(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --reduce [--global] [--bones &lt;id:degrees,...&gt;] &lt;input clip&gt; &lt;output clip&gt; &lt;degrees&gt;
+	/// Removes the keys of the clip its interpolation reproduces within the tolerance and saves the result. Prints the
+	/// compression ratio, the largest error and the size and load time of both files.
+	/// </summary>
+	int runReduce(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --compact &lt;input.csv|input.posq&gt; &lt;output.csv|output.posq&gt; [max error degrees]
+	/// Converts a pose between the pose file and the compact pose file, whose rotations are packed at the smallest precision
+	/// within the max error (48 bits without it). Prints the error and the size and load time of both files.
+	/// </summary>
+	int runCompact(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --library &lt;output.plib&gt; &lt;pose&gt; [&lt;pose&gt; ...]
+	/// --library &lt;library.plib&gt; --list
+	/// --library &lt;library.plib&gt; --pose &lt;index&gt; &lt;output&gt;
+	/// Builds a pose library from poses sharing the skeleton of the first one, lists the poses of a library, or saves one
+	/// of its poses as a pose file.
+	/// </summary>
+	int runLibrary(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --search [--global] [--bones &lt;id,id,...&gt;] [--within &lt;degrees&gt;] &lt;library.plib&gt; &lt;pose&gt; [count]
+	/// Prints the poses of the library closest to the pose (10 by default, every one within the radius when only --within is
+	/// given) with their distance in degrees. --global compares global orientations, --bones only the listed key bones.
+	/// Reports the time of building the index and of a query.
+	/// </summary>
+	int runSearch(const std::vector<std::string>& args);
+
+	/// <summary>
+	/// --cluster [--global] [--bones &lt;id,id,...&gt;] (--count &lt;clusters&gt; | --within &lt;degrees&gt;) &lt;library.plib&gt; &lt;output.plib&gt; &lt;mapping.csv&gt;
+	/// Replaces the poses of the library by representatives of clusters of similar poses: --count splits them into that many
+	/// clusters by k-means, --within collapses the poses within the distance of an earlier pose. Saves the representatives as
+	/// a library and the cluster of every pose as csv. Reports the time, the distances to the representatives and the file sizes.
+	/// </summary>
+	int runCluster(const std::vector<std::string>& args);
+}
@@ -16,11 +16,20 @@ bool PoseController::PoseController::init() {
 }
 
 void PoseController::PoseController::update() {
+	PROFILE_SCOPE("PoseController::update");
 	m_Viewer->update();
 	// if the model changed, update view:
 	if (m_Model->isDelta()) {
+		m_Viewer->updateView(m_Model->getCurrentPawn(), m_Model->getDelta());
 		m_Model->resetDelta();
-		m_Viewer->updateView(m_Model->getCurrentPawn());
+	}
+	if (m_ClipDelta) {
+		m_Viewer->updateClip(m_ClipState);
+		m_ClipDelta = false;
+	}
+	if (m_LibraryDelta) {
+		m_Viewer->updateLibrary(m_LibraryState);
+		m_LibraryDelta = false;
 	}
 }
 
@@ -39,15 +48,18 @@ bool PoseController::PoseController::getApplicationActive() {
 }
 
 void PoseController::PoseController::cmdNewFile() {
+	PROFILE_SCOPE("PoseController::cmdNewFile");
 	PoseData::BonePawn blankPawn;
 	blankPawn.loaded = false;
 	blankPawn.originalFileName = "Untitled";
+	blankPawn.rotationOrder = m_Model->getCurrentPawn().rotationOrder;
 	m_Model->cmdSetPawn(blankPawn);
 	m_Model->cmdSetSaved(true); // a blank file doesn't need saving.
 }
 
 bool PoseController::PoseController::cmdOpenFile(std::string path) {
-	PoseData::BonePawn filePawn = PoseDataUtil::openFile(path);
+	PROFILE_SCOPE("PoseController::cmdOpenFile");
+	PoseData::BonePawn filePawn = PoseDataUtil::openFile(path, m_Model->getCurrentPawn().rotationOrder);
 	if (filePawn.loaded) {
 		m_Model->cmdSetPawn(filePawn);
 		m_Model->cmdSetSaved(true); // a newly loaded file is saved on the disk.
@@ -56,6 +68,7 @@ bool PoseController::PoseController::cmdOpenFile(std::string path) {
 }
 
 bool PoseController::PoseController::cmdSaveFile(std::string _path) {
+	PROFILE_SCOPE("PoseController::cmdSaveFile");
 	std::string path = PoseDataUtil::addExtension(_path);
 	if (PoseDataUtil::saveFile(m_Model->getCurrentPawn(), path)) {
 		// since the save succeeded update the model to reflect the new file path.
@@ -64,15 +77,510 @@ bool PoseController::PoseController::cmdSaveFile(std::string _path) {
 		m_Model->cmdSetLoaded(true);
 		m_Model->cmdSetSaved(true);
 		std::cout << "Saved filename: " << path << "\n";
+		return true;
 	}
 	return false;
 }
 
-void PoseController::PoseController::cmdBoneAdd(ID parentid) { m_Model->cmdBoneAdd(parentid); }
-void PoseController::PoseController::cmdBoneRemove(ID boneid) { m_Model->cmdBoneRemove(boneid); }
-void PoseController::PoseController::cmdBoneMoveUp(ID boneid) { m_Model->cmdBoneMoveUp(boneid); }
-void PoseController::PoseController::cmdBoneMoveDown(ID boneid) { m_Model->cmdBoneMoveDown(boneid); }
+void PoseController::PoseController::cmdSetRotationOrder(PoseData::RotationOrder order) {
+	PROFILE_SCOPE("PoseController::cmdSetRotationOrder");
+	m_Model->cmdSetRotationOrder(order);
+}
+
+bool PoseController::PoseController::cmdBlendFile(std::string path, float weight, bool slerp, std::string maskPath) {
+	PROFILE_SCOPE("PoseController::cmdBlendFile");
+	PoseData::BonePawn target = PoseDataUtil::openFile(path);
+	if (!target.loaded)
+		return false;
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	std::vector<float> mask;
+	if (!maskPath.empty() && !PoseBlend::openMask(maskPath, pawn, mask))
+		return false;
+	std::vector<glm::quat> rotations = PoseBlend::blendRotations(pawn, target, weight,
+		slerp ? PoseBlend::BlendMode::Slerp : PoseBlend::BlendMode::Nlerp, maskPath.empty() ? nullptr : &mask);
+	if (rotations.size() != pawn.bones.size())
+		return false;
+	m_Model->cmdPawnSetRotations(rotations);
+	return true;
+}
+
+bool PoseController::PoseController::cmdSaveDifferenceFile(std::string basePath, std::string path) {
+	PROFILE_SCOPE("PoseController::cmdSaveDifferenceFile");
+	PoseData::BonePawn base = PoseDataUtil::openFile(basePath, m_Model->getCurrentPawn().rotationOrder);
+	if (!base.loaded)
+		return false;
+	std::string differencePath = PoseDataUtil::addExtension(path);
+	if (!PoseDataUtil::saveFile(PoseLayers::difference(base, m_Model->getCurrentPawn()), differencePath))
+		return false;
+	std::cout << "Saved difference: " << differencePath << "\n";
+	return true;
+}
+
+void PoseController::PoseController::syncLayers() {
+	/* the model may clamp or drive what the stack applied, so the pawn is not compared with the stack's result */
+	if (m_Layers.size() > 0 && m_Model->getPoseRevision() == m_LayersRevision)
+		return;
+	m_Layers.clear();
+	m_Layers.setBase(m_Model->getCurrentPawn());
+}
+
+void PoseController::PoseController::applyLayers() {
+	m_Model->cmdPawnSetRotations(m_Layers.evaluate());
+	m_LayersRevision = m_Model->getPoseRevision();
+}
+
+int PoseController::PoseController::cmdAddLayerFile(std::string path, float weight) {
+	PROFILE_SCOPE("PoseController::cmdAddLayerFile");
+	PoseData::BonePawn layer = PoseDataUtil::openFile(path);
+	if (!layer.loaded)
+		return -1;
+	syncLayers();
+	int index = m_Layers.addLayer(layer, weight);
+	applyLayers();
+	return index;
+}
+
+void PoseController::PoseController::cmdSetLayerWeight(int index, float weight) {
+	PROFILE_SCOPE("PoseController::cmdSetLayerWeight");
+	syncLayers();
+	if (index < 0 || index >= m_Layers.size() || m_Layers.getWeight(index) == weight)
+		return;
+	m_Layers.setWeight(index, weight);
+	applyLayers();
+}
+
+void PoseController::PoseController::cmdClearLayers() {
+	PROFILE_SCOPE("PoseController::cmdClearLayers");
+	m_Layers.clear();
+}
+
+bool PoseController::PoseController::cmdAverageFiles(const std::vector<std::string>& paths, const std::vector<float>& weights) {
+	PROFILE_SCOPE("PoseController::cmdAverageFiles");
+	std::vector<PoseData::BonePawn> poses;
+	poses.reserve(paths.size());
+	for (const std::string& path : paths) {
+		poses.push_back(PoseDataUtil::openFile(path));
+		if (!poses.back().loaded)
+			return false;
+	}
+	m_Model->cmdPawnSetRotations(PoseAverage::averageRotations(m_Model->getCurrentPawn(), poses, weights));
+	return true;
+}
+
+void PoseController::PoseController::cmdMirror(PoseData::MirrorPlane plane, const std::vector<ID>& roots) {
+	PROFILE_SCOPE("PoseController::cmdMirror");
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	PoseMirror::mirrorRotations(pawn, m_Symmetry.get(pawn), plane, roots, m_MirrorRotations);
+	m_Model->cmdPawnSetRotations(m_MirrorRotations);
+}
+
+void PoseController::PoseController::cmdSetMirrorRules(const std::vector<PoseData::MirrorRule>& rules) {
+	m_Symmetry.setRules(rules);
+}
+
+bool PoseController::PoseController::cmdSetRetargetTarget(std::string skeletonPath, std::string mapPath, std::string sourceRestPath) {
+	PROFILE_SCOPE("PoseController::cmdSetRetargetTarget");
+	PoseData::BonePawn skeleton = PoseDataUtil::openFile(skeletonPath);
+	if (!skeleton.loaded)
+		return false;
+	std::vector<std::pair<std::string, std::string>> pairs;
+	if (!mapPath.empty() && !PoseRetarget::readMapFile(mapPath, pairs))
+		return false;
+	PoseData::BonePawn rest;
+	if (!sourceRestPath.empty()) {
+		rest = PoseDataUtil::openFile(sourceRestPath);
+		if (!rest.loaded)
+			return false;
+	}
+	m_Retargeter.setTarget(skeleton);
+	m_Retargeter.setManualMap(std::move(pairs));
+	m_Retargeter.setSourceRest(sourceRestPath.empty() ? nullptr : &rest);
+	return true;
+}
+
+bool PoseController::PoseController::cmdRetarget() {
+	PROFILE_SCOPE("PoseController::cmdRetarget");
+	if (!m_Retargeter.hasTarget())
+		return false;
+	const PoseData::BonePawn& source = m_Model->getCurrentPawn();
+	PoseData::BonePawn result = m_Retargeter.retarget(source);
+	result.originalFileName = source.originalFileName;
+	m_Model->cmdSetPawn(result);
+	return true;
+}
+
+float PoseController::PoseController::cmdSolveIK(ID rootid, ID tipid, glm::vec3 target, PoseData::IKSolver solver, int iterations, float tolerance) {
+	PROFILE_SCOPE("PoseController::cmdSolveIK");
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	if (!m_IKChain.matches(pawn, rootid, tipid) && !m_IKChain.setChain(pawn, rootid, tipid))
+		return -1.0f;
+	/* the chain starts from the global transform of its root, the parent of a root has the identity rotation */
+	ID parentid = pawn.bones[m_IKChain.getBones().front()].parent;
+	glm::quat parentGlobal = parentid == -1 ? glm::quat(1, 0, 0, 0) : m_Model->getGlobalRotation(parentid);
+	PoseIK::Settings settings;
+	settings.solver = solver;
+	settings.maxIterations = iterations;
+	settings.tolerance = tolerance;
+	PoseIK::Result result = m_IKChain.solve(pawn, parentGlobal, m_Model->getJointPosition(rootid), target, settings);
+	if (result.iterations > 0)
+		m_Model->cmdBonesSetRotations(m_IKChain.getBoneIds(), m_IKChain.getRotations());
+	return result.distance;
+}
+
+void PoseController::PoseController::matchSkeleton(SkeletonMatch& match, const PoseData::BonePawn& skeleton) {
+	unsigned long long revision = m_Model->getStructureRevision();
+	if (match.valid && match.revision == revision)
+		return;
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	match.toSkeleton = PoseBlend::matchBones(pawn, skeleton);
+	match.toPawn = PoseBlend::matchBones(skeleton, pawn);
+	match.revision = revision;
+	match.valid = true;
+}
+
+void PoseController::PoseController::updateClipState() {
+	m_ClipState.frameRate = m_Clip.getFrameRate();
+	m_ClipState.duration = m_Clip.getDuration();
+	m_ClipState.trackCount = m_Clip.getTrackCount();
+	m_ClipState.keyCount = m_Clip.getKeyCount();
+	m_ClipState.interpolation = m_ClipState.trackCount > 0 ? m_Clip.getInterpolation(0) : PoseData::Interpolation::Nlerp;
+	m_ClipState.mixedInterpolation = false;
+	for (int t = 1; t < m_ClipState.trackCount; t++)
+		m_ClipState.mixedInterpolation |= m_Clip.getInterpolation(t) != m_ClipState.interpolation;
+	m_ClipDelta = true;
+}
+
+void PoseController::PoseController::cmdNewClip(float frameRate) {
+	PROFILE_SCOPE("PoseController::cmdNewClip");
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	std::vector<std::vector<PoseClip::Key>> tracks(pawn.bones.size());
+	for (size_t i = 0; i < tracks.size(); i++)
+		tracks[i].push_back({ 0.0f, pawn.bones[i].quaternion });
+	m_Clip.build(pawn, tracks, frameRate);
+	m_ClipMatch.valid = false;
+	m_ClipState.loaded = true;
+	m_ClipState.filePath = "";
+	m_ClipState.fileName = "Untitled";
+	m_ClipState.saved = false;
+	m_ClipState.time = 0.0f;
+	updateClipState();
+}
+
+bool PoseController::PoseController::cmdOpenClip(std::string path) {
+	PROFILE_SCOPE("PoseController::cmdOpenClip");
+	PoseClip::Clip clip = PoseClip::openClip(path, m_Model->getCurrentPawn().rotationOrder);
+	if (!clip.getSkeleton().loaded)
+		return false;
+	m_Clip = std::move(clip);
+	m_ClipMatch.valid = false;
+	m_ClipState.loaded = true;
+	m_ClipState.filePath = path;
+	m_ClipState.fileName = PoseDataUtil::parseFilename(path);
+	m_ClipState.saved = true;
+	m_ClipState.time = 0.0f;
+	updateClipState();
+	/* the pawn takes the skeleton, as a new file showing the first frame */
+	PoseData::BonePawn pawn = m_Clip.getSkeleton();
+	m_ClipSampler.sample(0.0f, m_ClipPose);
+	for (size_t i = 0; i < pawn.bones.size(); i++)
+		pawn.bones[i].quaternion = m_ClipPose[i];
+	RotationBatch::pawnQuatToEuler(pawn);
+	pawn.originalFilePath = "";
+	pawn.originalFileName = PoseDataUtil::addExtension(m_ClipState.fileName);
+	pawn.loaded = false;
+	m_Model->cmdSetPawn(pawn);
+	m_Model->cmdSetSaved(true); // the pose is stored in the clip.
+	return true;
+}
+
+bool PoseController::PoseController::cmdSaveClip(std::string _path) {
+	PROFILE_SCOPE("PoseController::cmdSaveClip");
+	if (!m_ClipState.loaded)
+		return false;
+	PoseClip::ClipFormat format = PoseClip::formatOf(_path);
+	std::string path = PoseClip::addExtension(_path, format);
+	if (!PoseClip::saveClip(m_Clip, path, format))
+		return false;
+	m_ClipState.filePath = path;
+	m_ClipState.fileName = PoseDataUtil::parseFilename(path);
+	m_ClipState.saved = true;
+	m_ClipDelta = true;
+	std::cout << "Saved clip: " << path << "\n";
+	return true;
+}
+
+void PoseController::PoseController::cmdSetClipTime(float time) {
+	PROFILE_SCOPE("PoseController::cmdSetClipTime");
+	if (!m_ClipState.loaded)
+		return;
+	m_ClipState.time = std::min(std::max(time, 0.0f), m_Clip.getDuration());
+	m_ClipDelta = true;
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	matchSkeleton(m_ClipMatch, m_Clip.getSkeleton());
+	const std::vector<int>& match = m_ClipMatch.toSkeleton;
+	m_ClipSampler.sample(m_ClipState.time, m_ClipPose);
+	m_ClipRotations.resize(pawn.bones.size());
+	for (size_t i = 0; i < pawn.bones.size(); i++)
+		m_ClipRotations[i] = match[i] >= 0 ? m_ClipPose[match[i]] : pawn.bones[i].quaternion;
+	m_Model->cmdPawnPlayRotations(m_ClipRotations);
+}
+
+void PoseController::PoseController::cmdClipKeyPose(float time) {
+	PROFILE_SCOPE("PoseController::cmdClipKeyPose");
+	if (!m_ClipState.loaded)
+		return;
+	/* tracks without a bone in the pawn are keyed with the pose they already hold */
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	matchSkeleton(m_ClipMatch, m_Clip.getSkeleton());
+	const std::vector<int>& match = m_ClipMatch.toPawn;
+	float keyTime = std::max(time, 0.0f);
+	m_ClipSampler.sample(keyTime, m_ClipPose);
+	for (size_t t = 0; t < match.size(); t++) {
+		if (match[t] >= 0)
+			m_ClipPose[t] = pawn.bones[match[t]].quaternion;
+	}
+	m_Clip.setPoseKeys(keyTime, m_ClipPose);
+	m_ClipState.saved = false;
+	m_ClipState.time = keyTime;
+	updateClipState();
+}
+
+void PoseController::PoseController::cmdSetClipInterpolation(PoseData::Interpolation interpolation, const std::vector<ID>& boneids) {
+	PROFILE_SCOPE("PoseController::cmdSetClipInterpolation");
+	if (!m_ClipState.loaded)
+		return;
+	const PoseData::BonePawn& skeleton = m_Clip.getSkeleton();
+	for (int t = 0; t < m_Clip.getTrackCount(); t++) {
+		if (boneids.empty() || std::find(boneids.begin(), boneids.end(), skeleton.bones[t].id) != boneids.end())
+			m_Clip.setInterpolation(t, interpolation);
+	}
+	m_ClipState.saved = false;
+	updateClipState();
+	cmdSetClipTime(m_ClipState.time);
+}
+
+PoseData::KeyReduction PoseController::PoseController::cmdReduceClip(float tolerance, bool globalSpace, const std::vector<ID>& boneids,
+	const std::vector<float>& tolerances) {
+	PROFILE_SCOPE("PoseController::cmdReduceClip");
+	PoseData::KeyReduction report;
+	if (!m_ClipState.loaded)
+		return report;
+	PoseReduce::Settings settings;
+	settings.tolerance = tolerance;
+	settings.globalSpace = globalSpace;
+	const PoseData::BonePawn& skeleton = m_Clip.getSkeleton();
+	if (!boneids.empty()) {
+		settings.trackTolerance.assign(skeleton.bones.size(), -1.0f);
+		for (int t = 0; t < m_Clip.getTrackCount(); t++) {
+			auto found = std::find(boneids.begin(), boneids.end(), skeleton.bones[t].id);
+			if (found != boneids.end() && static_cast<size_t>(found - boneids.begin()) < tolerances.size())
+				settings.trackTolerance[t] = tolerances[found - boneids.begin()];
+		}
+	}
+	m_Clip = PoseReduce::reduce(m_Clip, settings, &report);
+	m_ClipMatch.valid = false;
+	if (report.keysAfter != report.keysBefore)
+		m_ClipState.saved = false;
+	updateClipState();
+	cmdSetClipTime(m_ClipState.time);
+	return report;
+}
+
+void PoseController::PoseController::updateLibraryState() {
+	m_LibraryState.poseCount = m_Library.getPoseCount();
+	m_LibraryState.boneCount = m_Library.getBoneCount();
+	bool shown = m_LibraryState.pose >= 0 && m_LibraryState.pose < m_LibraryState.poseCount;
+	m_LibraryState.poseName = shown ? m_Library.getName(m_LibraryState.pose) : "";
+	m_LibraryDelta = true;
+}
+
+void PoseController::PoseController::releaseReplacedLibrary() {
+	m_ReplacedLibrary = PoseLibrary::Library();
+	m_LibraryState.restorable = false;
+}
+
+void PoseController::PoseController::cmdNewLibrary() {
+	PROFILE_SCOPE("PoseController::cmdNewLibrary");
+	m_Library.reset(m_Model->getCurrentPawn());
+	m_LibraryMatch.valid = false;
+	releaseReplacedLibrary();
+	m_LibraryIndexed = false;
+	m_LibraryState.matches.clear();
+	m_LibraryState.loaded = true;
+	m_LibraryState.filePath = "";
+	m_LibraryState.fileName = "Untitled";
+	m_LibraryState.saved = false;
+	m_LibraryState.pose = -1;
+	updateLibraryState();
+}
+
+bool PoseController::PoseController::cmdOpenLibrary(std::string path) {
+	PROFILE_SCOPE("PoseController::cmdOpenLibrary");
+	PoseLibrary::Library library = PoseLibrary::openLibrary(path, m_Model->getCurrentPawn().rotationOrder);
+	if (!library.getSkeleton().loaded)
+		return false;
+	m_Library = std::move(library);
+	m_LibraryMatch.valid = false;
+	releaseReplacedLibrary();
+	m_LibraryIndexed = false;
+	m_LibraryState.matches.clear();
+	m_LibraryState.loaded = true;
+	m_LibraryState.filePath = path;
+	m_LibraryState.fileName = PoseDataUtil::parseFilename(path);
+	m_LibraryState.saved = true;
+	m_LibraryState.pose = -1;
+	updateLibraryState();
+	/* the pawn takes the skeleton, as a new file showing the first pose */
+	PoseData::BonePawn pawn = m_Library.getSkeleton();
+	pawn.originalFilePath = "";
+	pawn.originalFileName = PoseDataUtil::addExtension(m_LibraryState.fileName);
+	pawn.loaded = false;
+	m_Model->cmdSetPawn(pawn);
+	m_Model->cmdSetSaved(true); // the poses are stored in the library.
+	cmdShowLibraryPose(0);
+	return true;
+}
+
+bool PoseController::PoseController::cmdSaveLibrary(std::string _path) {
+	PROFILE_SCOPE("PoseController::cmdSaveLibrary");
+	if (!m_LibraryState.loaded)
+		return false;
+	std::string path = PoseLibrary::addExtension(_path);
+	if (!PoseLibrary::saveLibrary(m_Library, path))
+		return false;
+	m_LibraryState.filePath = path;
+	m_LibraryState.fileName = PoseDataUtil::parseFilename(path);
+	m_LibraryState.saved = true;
+	releaseReplacedLibrary();
+	m_LibraryDelta = true;
+	std::cout << "Saved library: " << path << "\n";
+	return true;
+}
+
+int PoseController::PoseController::cmdLibraryAddPose() {
+	PROFILE_SCOPE("PoseController::cmdLibraryAddPose");
+	if (!m_LibraryState.loaded)
+		return -1;
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	int pose = m_Library.addPose(pawn, pawn.originalFileName);
+	releaseReplacedLibrary();
+	m_LibraryIndexed = false;
+	m_LibraryState.saved = false;
+	m_LibraryState.pose = pose;
+	updateLibraryState();
+	return pose;
+}
+
+void PoseController::PoseController::cmdShowLibraryPose(int pose) {
+	PROFILE_SCOPE("PoseController::cmdShowLibraryPose");
+	if (!m_LibraryState.loaded || m_Library.getPoseCount() == 0)
+		return;
+	m_LibraryState.pose = std::min(std::max(pose, 0), m_Library.getPoseCount() - 1);
+	updateLibraryState();
+	/* only the column of the pose is read, bones of the pawn missing in the library keep their rotation */
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	matchSkeleton(m_LibraryMatch, m_Library.getSkeleton());
+	const std::vector<int>& match = m_LibraryMatch.toSkeleton;
+	m_Library.getPose(m_LibraryState.pose, m_LibraryPose);
+	m_LibraryRotations.resize(pawn.bones.size());
+	for (size_t i = 0; i < pawn.bones.size(); i++)
+		m_LibraryRotations[i] = match[i] >= 0 ? m_LibraryPose[match[i]] : pawn.bones[i].quaternion;
+	m_Model->cmdPawnPlayRotations(m_LibraryRotations);
+}
+
+std::vector<PoseData::PoseMatch> PoseController::PoseController::cmdFindSimilarPoses(int count, float radius, bool global, const std::vector<ID>& boneids) {
+	PROFILE_SCOPE("PoseController::cmdFindSimilarPoses");
+	std::vector<PoseData::PoseMatch> matches;
+	if (!m_LibraryState.loaded || m_Library.getPoseCount() == 0)
+		return matches;
+	PoseSearch::Settings settings;
+	settings.feature = global ? PoseSearch::Feature::Global : PoseSearch::Feature::Local;
+	settings.bones = boneids;
+	if (!m_LibraryIndexed || m_LibraryIndex.getSettings().feature != settings.feature || m_LibraryIndex.getSettings().bones != settings.bones) {
+		if (!m_LibraryIndex.build(m_Library, settings))
+			return matches;
+		m_LibraryIndexed = true;
+	}
+	/* the query is the pawn in the bones of the library, bones missing in the pawn take the rotation of the skeleton */
+	const PoseData::BonePawn& skeleton = m_Library.getSkeleton();
+	const PoseData::BonePawn& pawn = m_Model->getCurrentPawn();
+	matchSkeleton(m_LibraryMatch, skeleton);
+	const std::vector<int>& match = m_LibraryMatch.toPawn;
+	m_LibraryPose.resize(skeleton.bones.size());
+	for (size_t b = 0; b < skeleton.bones.size(); b++)
+		m_LibraryPose[b] = match[b] >= 0 ? pawn.bones[match[b]].quaternion : skeleton.bones[b].quaternion;
+	for (const PoseSearch::Match& found : m_LibraryIndex.search(m_LibraryPose, count, radius)) {
+		PoseData::PoseMatch result;
+		result.pose = found.pose;
+		result.name = m_Library.getName(found.pose);
+		result.distance = found.distance;
+		matches.push_back(result);
+	}
+	m_LibraryState.matches = matches;
+	m_LibraryDelta = true;
+	return matches;
+}
+
+PoseData::ClusterReport PoseController::PoseController::cmdClusterLibrary(int count, float threshold, bool global, const std::vector<ID>& boneids, std::string mappingPath) {
+	PROFILE_SCOPE("PoseController::cmdClusterLibrary");
+	if (!m_LibraryState.loaded || m_Library.getPoseCount() == 0)
+		return PoseData::ClusterReport();
+	PoseSearch::Settings settings;
+	settings.feature = global ? PoseSearch::Feature::Global : PoseSearch::Feature::Local;
+	settings.bones = boneids;
+	PoseCluster::Result result = count > 0 ? PoseCluster::kMeans(m_Library, settings, count) : PoseCluster::deduplicate(m_Library, settings, threshold);
+	if (result.representatives.empty())
+		return PoseData::ClusterReport();
+	if (!mappingPath.empty() && !PoseCluster::saveMapping(m_Library, result, mappingPath))
+		return PoseData::ClusterReport();
+	/* the poses before the first clustering are kept, so restoring undoes every clustering since */
+	PoseLibrary::Library reduced = PoseCluster::representatives(m_Library, result);
+	if (!m_LibraryState.restorable) {
+		m_ReplacedLibrary = std::move(m_Library);
+		m_ReplacedSaved = m_LibraryState.saved;
+		m_LibraryState.restorable = true;
+	}
+	m_Library = std::move(reduced);
+	m_LibraryMatch.valid = false;
+	m_LibraryIndexed = false;
+	m_LibraryState.matches.clear();
+	m_LibraryState.saved = false;
+	m_LibraryState.pose = -1;
+	updateLibraryState();
+	cmdShowLibraryPose(0);
+	return PoseCluster::summarize(result);
+}
+
+bool PoseController::PoseController::cmdRestoreLibrary() {
+	PROFILE_SCOPE("PoseController::cmdRestoreLibrary");
+	if (!m_LibraryState.restorable)
+		return false;
+	m_Library = std::move(m_ReplacedLibrary);
+	m_LibraryMatch.valid = false;
+	releaseReplacedLibrary();
+	m_LibraryIndexed = false;
+	m_LibraryState.matches.clear();
+	m_LibraryState.saved = m_ReplacedSaved;
+	m_LibraryState.pose = -1;
+	updateLibraryState();
+	cmdShowLibraryPose(0);
+	return true;
+}
+
+void PoseController::PoseController::cmdBeginEdit() { PROFILE_SCOPE("PoseController::cmdBeginEdit"); m_Model->cmdBeginEdit(); }
+void PoseController::PoseController::cmdCommitEdit() { PROFILE_SCOPE("PoseController::cmdCommitEdit"); m_Model->cmdCommitEdit(); }
+void PoseController::PoseController::cmdUndo() { PROFILE_SCOPE("PoseController::cmdUndo"); m_Model->cmdUndo(); }
+void PoseController::PoseController::cmdRedo() { PROFILE_SCOPE("PoseController::cmdRedo"); m_Model->cmdRedo(); }
+int PoseController::PoseController::cmdClampToLimits() { PROFILE_SCOPE("PoseController::cmdClampToLimits"); return m_Model->cmdClampToLimits(); }
+
+void PoseController::PoseController::cmdBoneAdd(ID parentid) { PROFILE_SCOPE("PoseController::cmdBoneAdd"); m_Model->cmdBoneAdd(parentid); }
+void PoseController::PoseController::cmdBoneRemove(ID boneid) { PROFILE_SCOPE("PoseController::cmdBoneRemove"); m_Model->cmdBoneRemove(boneid); }
+void PoseController::PoseController::cmdBoneMoveUp(ID boneid) { PROFILE_SCOPE("PoseController::cmdBoneMoveUp"); m_Model->cmdBoneMoveUp(boneid); }
+void PoseController::PoseController::cmdBoneMoveDown(ID boneid) { PROFILE_SCOPE("PoseController::cmdBoneMoveDown"); m_Model->cmdBoneMoveDown(boneid); }
 
-void PoseController::PoseController::cmdBoneSetRotation(ID boneid, glm::vec3 euler) { m_Model->cmdBoneSetRotation(boneid, euler); }
-void PoseController::PoseController::cmdBoneSetName(ID boneid, std::string name) { m_Model->cmdBoneSetName(boneid, name); }
-void PoseController::PoseController::cmdBoneSetParent(ID boneid, ID parentid) { m_Model->cmdBoneSetParent(boneid, parentid); }
\ No newline at end of file
+void PoseController::PoseController::cmdBoneSetRotation(ID boneid, glm::vec3 euler) { PROFILE_SCOPE("PoseController::cmdBoneSetRotation"); m_Model->cmdBoneSetRotation(boneid, euler); }
+void PoseController::PoseController::cmdBoneSetName(ID boneid, std::string name) { PROFILE_SCOPE("PoseController::cmdBoneSetName"); m_Model->cmdBoneSetName(boneid, name); }
+void PoseController::PoseController::cmdBoneSetParent(ID boneid, ID parentid) { PROFILE_SCOPE("PoseController::cmdBoneSetParent"); m_Model->cmdBoneSetParent(boneid, parentid); }
+void PoseController::PoseController::cmdBoneSetOffset(ID boneid, glm::vec3 offset) { PROFILE_SCOPE("PoseController::cmdBoneSetOffset"); m_Model->cmdBoneSetOffset(boneid, offset); }
+void PoseController::PoseController::cmdBoneSetLimit(ID boneid, PoseData::JointLimit limit) { PROFILE_SCOPE("PoseController::cmdBoneSetLimit"); m_Model->cmdBoneSetLimit(boneid, limit); }
+void PoseController::PoseController::cmdBoneSetConstraint(ID boneid, PoseData::BoneConstraint constraint) { PROFILE_SCOPE("PoseController::cmdBoneSetConstraint"); m_Model->cmdBoneSetConstraint(boneid, constraint); }
\ No newline at end of file
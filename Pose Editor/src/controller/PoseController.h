@@ -11,11 +11,24 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "../ControllerInterface.h"
 #include "../ModelInterface.h"
 #include "../ViewerInterface.h"
+#include "../model/PoseAverage.h"
+#include "../model/PoseBlend.h"
+#include "../model/PoseCluster.h"
+#include "../model/PoseClip.h"
 #include "../model/PoseDataUtil.h"
+#include "../model/PoseIK.h"
+#include "../model/PoseLayers.h"
+#include "../model/PoseLibrary.h"
+#include "../model/PoseMirror.h"
+#include "../model/PoseReduce.h"
+#include "../model/PoseRetarget.h"
+#include "../model/PoseSearch.h"
+#include "../profiler/Profiler.h"
 
 namespace PoseController {
 
@@ -32,6 +45,87 @@ namespace PoseController {
 		std::shared_ptr<PoseEditor::Model> m_Model;
 		/// <summary>Pointer to the Viewer application component to propagate model changes onto.</summary>
 		std::shared_ptr<PoseEditor::Viewer> m_Viewer;
+		/// <summary>Additive layers applied on the current pawn by cmdAddLayerFile().</summary>
+		PoseLayers::LayerStack m_Layers;
+		/// <summary>pose revision of the model right after the stack was last applied, see syncLayers().</summary>
+		unsigned long long m_LayersRevision = 0;
+		/// <summary>Symmetry maps of the skeletons mirrored by cmdMirror().</summary>
+		PoseMirror::SymmetryCache m_Symmetry;
+		/// <summary>Result buffer of cmdMirror(), kept to mirror batches of poses without reallocating.</summary>
+		std::vector<glm::quat> m_MirrorRotations;
+		/// <summary>Target skeleton and mapping tables of cmdRetarget().</summary>
+		PoseRetarget::Retargeter m_Retargeter;
+		/// <summary>Chain and scratch buffers of cmdSolveIK(), kept so repeated solves of a chain do not allocate.</summary>
+		PoseIK::ChainSolver m_IKChain;
+		/// <summary>Animation clip edited alongside the pawn, which shows its pose at m_ClipState.time.</summary>
+		PoseClip::Clip m_Clip;
+		/// <summary>Summary of m_Clip presented by the View.</summary>
+		PoseData::ClipState m_ClipState;
+		/// <summary>true if m_ClipState changed since the View was last updated.</summary>
+		bool m_ClipDelta = false;
+		/// <summary>Cursors of m_Clip, so playing forward does not search the tracks every frame.</summary>
+		PoseClip::Sampler m_ClipSampler{ m_Clip };
+		/// <summary>Pose sampled from m_Clip, indexed by track. Kept so scrubbing does not allocate.</summary>
+		std::vector<glm::quat> m_ClipPose;
+		/// <summary>Rotations sent to the Model, indexed the same as the pawn's bones.</summary>
+		std::vector<glm::quat> m_ClipRotations;
+		/// <summary>
+		/// Bones of the pawn matched to the bones of a clip or library skeleton, so showing its poses does not match them every time.
+		/// </summary>
+		struct SkeletonMatch {
+			/// <summary>offset into the skeleton for every bone of the pawn, -1 if the skeleton has no bone with its ID.</summary>
+			std::vector<int> toSkeleton;
+			/// <summary>offset into the pawn for every bone of the skeleton, -1 if the pawn has no bone with its ID.</summary>
+			std::vector<int> toPawn;
+			/// <summary>structure revision of the model the match was made for.</summary>
+			unsigned long long revision = 0;
+			/// <summary>false until made, and again once the skeleton is replaced.</summary>
+			bool valid = false;
+		};
+		/// <summary>Bones of the pawn matched to the tracks of m_Clip.</summary>
+		SkeletonMatch m_ClipMatch;
+		/// <summary>
+		/// Matches the bones of the pawn to the skeleton, unless match holds them for the current bone set of the pawn already.
+		/// </summary>
+		void matchSkeleton(SkeletonMatch& match, const PoseData::BonePawn& skeleton);
+		/// <summary>
+		/// Copies the summary of m_Clip into m_ClipState and marks it for the View.
+		/// </summary>
+		void updateClipState();
+		/// <summary>Pose library browsed alongside the pawn, which shows its pose m_LibraryState.pose.</summary>
+		PoseLibrary::Library m_Library;
+		/// <summary>Summary of m_Library presented by the View.</summary>
+		PoseData::LibraryState m_LibraryState;
+		/// <summary>true if m_LibraryState changed since the View was last updated.</summary>
+		bool m_LibraryDelta = false;
+		/// <summary>Pose taken from m_Library, indexed by its bones, and the rotations sent to the Model. Kept so browsing does not allocate.</summary>
+		std::vector<glm::quat> m_LibraryPose;
+		std::vector<glm::quat> m_LibraryRotations;
+		/// <summary>Bones of the pawn matched to the bones of m_Library.</summary>
+		SkeletonMatch m_LibraryMatch;
+		/// <summary>Similarity search over m_Library, and whether it indexes the current poses of m_Library.</summary>
+		PoseSearch::Index m_LibraryIndex;
+		bool m_LibraryIndexed = false;
+		/// <summary>Poses of m_Library replaced by clustering and whether it was saved then, kept while m_LibraryState.restorable.</summary>
+		PoseLibrary::Library m_ReplacedLibrary;
+		bool m_ReplacedSaved = true;
+		/// <summary>
+		/// Copies the summary of m_Library into m_LibraryState and marks it for the View.
+		/// </summary>
+		void updateLibraryState();
+		/// <summary>
+		/// Drops the poses kept for cmdRestoreLibrary(), once they can no longer come back.
+		/// </summary>
+		void releaseReplacedLibrary();
+
+		/// <summary>
+		/// Starts a new layer stack on the current pawn, unless the pose did not change since the stack was last applied.
+		/// </summary>
+		void syncLayers();
+		/// <summary>
+		/// Sets the pawn to the result of the layer stack and remembers the pose revision it left.
+		/// </summary>
+		void applyLayers();
 
 	public:
 
@@ -90,6 +184,223 @@ namespace PoseController {
 		/// </summary>
 		/// <returns>true if the saving succeeded</returns>
 		bool cmdSaveFile(std::string path) override;
+		/// <summary>
+		/// call when the UI logic determines the euler angles should be presented in a different rotation order.
+		/// Affects the current pawn and the files opened or created afterwards.
+		/// </summary>
+		/// <param name="order">new rotation order.</param>
+		void cmdSetRotationOrder(PoseData::RotationOrder order) override;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should be blended toward the pose stored in the provided file.
+		/// Bones are matched by ID, bones missing in the file keep their rotation. Forms a single undo step.
+		/// </summary>
+		/// <param name="path">file holding the target pose.</param>
+		/// <param name="weight">0 keeps the current pose, 1 takes the target pose.</param>
+		/// <param name="slerp">true to interpolate with slerp instead of nlerp.</param>
+		/// <param name="maskPath">file of per bone factors of weight (see PoseBlend::openMask()), every bone takes weight if empty.</param>
+		/// <returns>true if the files could be opened</returns>
+		bool cmdBlendFile(std::string path, float weight, bool slerp, std::string maskPath) override;
+		/// <summary>
+		/// call when the UI logic determines the difference from the pose stored in basePath to the current pawn should be saved
+		/// into path. Applying the saved file as a layer on top of the base pose gives the current pose again.
+		/// </summary>
+		/// <returns>true if the base could be opened and the difference saved</returns>
+		bool cmdSaveDifferenceFile(std::string basePath, std::string path) override;
+		/// <summary>
+		/// call when the UI logic determines the difference pose stored in the provided file should be applied as an additive layer
+		/// on top of the current pawn. The layers are kept, so their weights can be changed later. Editing the pawn in any other way
+		/// starts a new stack, on top of the edited pose. Forms a single undo step.
+		/// </summary>
+		/// <param name="path">file holding the difference pose.</param>
+		/// <param name="weight">0 disables the layer, 1 applies it fully.</param>
+		/// <returns>index of the new layer, -1 if the file could not be opened</returns>
+		int cmdAddLayerFile(std::string path, float weight) override;
+		/// <summary>
+		/// call when the UI logic determines the layer at index should be applied with a different weight.
+		/// Only that layer is recomputed. Forms a single undo step, wrap slider drags in cmdBeginEdit() and cmdCommitEdit().
+		/// </summary>
+		/// <param name="index">index returned by cmdAddLayerFile().</param>
+		/// <param name="weight">0 disables the layer, 1 applies it fully.</param>
+		void cmdSetLayerWeight(int index, float weight) override;
+		/// <summary>
+		/// call when the UI logic determines the current pose should be kept as it is and the layers forgotten.
+		/// </summary>
+		void cmdClearLayers() override;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should take the weighted mean pose of the provided files.
+		/// Bones are matched by ID, bones missing in every file keep their rotation. Forms a single undo step.
+		/// </summary>
+		/// <param name="paths">files holding the poses to average.</param>
+		/// <param name="weights">weight of every file, files without a weight get 1.</param>
+		/// <returns>true if all files could be opened</returns>
+		bool cmdAverageFiles(const std::vector<std::string>& paths, const std::vector<float>& weights) override;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should be mirrored across the plane. Every selected bone takes the
+		/// reflected rotation of its counterpart on the other side of the skeleton (found by the mirror rules), bones without one
+		/// reflect their own rotation. Forms a single undo step.
+		/// </summary>
+		/// <param name="plane">plane to mirror across.</param>
+		/// <param name="roots">bones whose subtrees are mirrored, all bones if empty.</param>
+		void cmdMirror(PoseData::MirrorPlane plane, const std::vector<ID>& roots) override;
+		/// <summary>
+		/// call when the UI logic determines the counterparts of bones should be found by different name patterns.
+		/// </summary>
+		/// <param name="rules">pairs of patterns, the first one contained in a bone name decides.</param>
+		void cmdSetMirrorRules(const std::vector<PoseData::MirrorRule>& rules) override;
+		/// <summary>
+		/// call when the UI logic determines poses should be retargeted onto the skeleton stored in the provided file.
+		/// The mapping of bones is built once per source skeleton and reused by every following cmdRetarget().
+		/// </summary>
+		/// <param name="skeletonPath">file holding the target skeleton in its rest pose.</param>
+		/// <param name="mapPath">optional file of "target name, source name" pairs overriding the name matching, empty for none.</param>
+		/// <param name="sourceRestPath">optional file holding the rest pose of the source rig, empty to copy the rotations without
+		/// correcting for the different rest orientations.</param>
+		/// <returns>true if all provided files could be read</returns>
+		bool cmdSetRetargetTarget(std::string skeletonPath, std::string mapPath, std::string sourceRestPath) override;
+		/// <summary>
+		/// call when the UI logic determines the current pawn should be replaced by its pose moved onto the retarget skeleton.
+		/// The result is a new unsaved pawn.
+		/// </summary>
+		/// <returns>false if no retarget skeleton was set</returns>
+		bool cmdRetarget() override;
+		/// <summary>
+		/// call when the UI logic determines the joint at the tip of a chain should reach the target. The bones from root down to
+		/// the parent of tip are rotated by inverse kinematics and written back as a single undo step (or as part of the open edit).
+		/// The chain is found once and reused while the same root and tip are solved.
+		/// </summary>
+		/// <param name="rootid">first bone of the chain.</param>
+		/// <param name="tipid">bone whose joint should reach the target, a descendant of root.</param>
+		/// <param name="target">world space position.</param>
+		/// <param name="solver">algorithm used.</param>
+		/// <param name="iterations">largest amount of passes over the chain.</param>
+		/// <param name="tolerance">distance from the target at which the solve stops.</param>
+		/// <returns>distance of the tip from the target after the solve, negative if tip is not a descendant of root</returns>
+		float cmdSolveIK(ID rootid, ID tipid, glm::vec3 target, PoseData::IKSolver solver, int iterations, float tolerance) override;
+		/// <summary>
+		/// call when the UI logic determines every bone should be brought back within its rotation limits.
+		/// </summary>
+		/// <returns>amount of bones clamped</returns>
+		int cmdClampToLimits() override;
+		/// <summary>
+		/// call when the UI logic determines a new animation clip should be started from the current pawn: the pawn becomes the
+		/// skeleton of the clip and its pose the key of every bone at time 0.
+		/// </summary>
+		/// <param name="frameRate">frames per second of the clip.</param>
+		void cmdNewClip(float frameRate) override;
+		/// <summary>
+		/// call when the UI logic determines an animation clip should be opened from the provided path (.clip or .clipb).
+		/// The pawn is replaced by the skeleton of the clip posed at time 0.
+		/// </summary>
+		/// <returns>true if the opening succeeded</returns>
+		bool cmdOpenClip(std::string path) override;
+		/// <summary>
+		/// call when the UI logic determines the animation clip should be saved to the provided path. Paths ending with .clipb
+		/// are written in the binary format, any other path is given the .clip extension of the text format.
+		/// </summary>
+		/// <returns>true if the saving succeeded</returns>
+		bool cmdSaveClip(std::string path) override;
+		/// <summary>
+		/// call when the UI logic determines the pawn should show the animation clip at a different time. Bones are matched to
+		/// the tracks by ID. The pose is not recorded for undo.
+		/// </summary>
+		/// <param name="time">seconds from the start of the clip, clamped to its duration.</param>
+		void cmdSetClipTime(float time) override;
+		/// <summary>
+		/// call when the UI logic determines the current pose of the pawn should be keyed into the animation clip. Every track
+		/// with a bone of the same ID in the pawn gets a key at time, replacing the key already there.
+		/// </summary>
+		/// <param name="time">seconds from the start of the clip.</param>
+		void cmdClipKeyPose(float time) override;
+		/// <summary>
+		/// call when the UI logic determines tracks of the animation clip should interpolate between their keys differently.
+		/// </summary>
+		/// <param name="boneids">bones whose tracks change, all tracks if empty.</param>
+		void cmdSetClipInterpolation(PoseData::Interpolation interpolation, const std::vector<ID>& boneids) override;
+		/// <summary>
+		/// call when the UI logic determines the keys of the animation clip which its interpolation reproduces within a tolerance
+		/// should be removed, such as after recording a key on every frame.
+		/// </summary>
+		/// <param name="tolerance">largest angle in degrees a removed key may lie from its reduced track.</param>
+		/// <param name="globalSpace">true to bound the global orientations of the bones instead of their local rotations.</param>
+		/// <param name="boneids">bones with their own tolerance, given in the same order by tolerances.</param>
+		/// <returns>key counts before and after, and the largest errors.</returns>
+		PoseData::KeyReduction cmdReduceClip(float tolerance, bool globalSpace, const std::vector<ID>& boneids, const std::vector<float>& tolerances) override;
+		/// <summary>
+		/// call when the UI logic determines a new pose library should be started on the skeleton of the current pawn, without poses.
+		/// </summary>
+		void cmdNewLibrary() override;
+		/// <summary>
+		/// call when the UI logic determines a pose library should be opened from the provided path (.plib).
+		/// The pawn is replaced by the skeleton of the library showing its first pose.
+		/// </summary>
+		/// <returns>true if the opening succeeded</returns>
+		bool cmdOpenLibrary(std::string path) override;
+		/// <summary>
+		/// call when the UI logic determines the pose library should be saved to the provided path, given the .plib extension.
+		/// </summary>
+		/// <returns>true if the saving succeeded</returns>
+		bool cmdSaveLibrary(std::string path) override;
+		/// <summary>
+		/// call when the UI logic determines the current pose of the pawn should be added to the pose library. Bones are matched
+		/// to the skeleton of the library by ID.
+		/// </summary>
+		/// <returns>index of the added pose, -1 if no library is open.</returns>
+		int cmdLibraryAddPose() override;
+		/// <summary>
+		/// call when the UI logic determines the pawn should show a different pose of the library. Bones are matched to the
+		/// skeleton of the library by ID. Takes the same time for any pose of any library. The pose is not recorded for undo.
+		/// </summary>
+		/// <param name="pose">index of the pose, clamped to the poses of the library.</param>
+		void cmdShowLibraryPose(int pose) override;
+		/// <summary>
+		/// call when the UI logic determines the poses of the library closest to the current pawn should be found. Bones are
+		/// matched to the skeleton of the library by ID. The search index is built by the first search and again once the library
+		/// or the compared bones change, after which a search takes milliseconds in a library of millions of poses.
+		/// </summary>
+		/// <param name="count">most poses found, the closest ones. 0 or less finds every pose within radius.</param>
+		/// <param name="radius">largest distance in degrees of a found pose (see PoseSearch), negative for any distance.</param>
+		/// <param name="global">compares the global orientations of the bones instead of their local rotations.</param>
+		/// <param name="boneids">key bones compared, every bone when empty.</param>
+		/// <returns>the poses found, closest first. The library state lists them too.</returns>
+		std::vector<PoseData::PoseMatch> cmdFindSimilarPoses(int count, float radius, bool global, const std::vector<ID>& boneids) override;
+		/// <summary>
+		/// call when the UI logic determines the poses of the library should be replaced by representatives of clusters of
+		/// similar poses (see PoseCluster). With a count the poses are split into that many clusters by k-means, otherwise the
+		/// poses within threshold of an earlier pose are collapsed into it. The library is left unsaved, showing its first pose.
+		/// The replaced poses are kept until the library is saved, so cmdRestoreLibrary() can bring them back.
+		/// </summary>
+		/// <param name="count">amount of clusters, 0 or less deduplicates instead.</param>
+		/// <param name="threshold">largest distance in degrees of a pose collapsed by deduplication.</param>
+		/// <param name="global">compares the global orientations of the bones instead of their local rotations.</param>
+		/// <param name="boneids">key bones compared, every bone when empty.</param>
+		/// <param name="mappingPath">file the cluster of every pose is written to as csv (see PoseCluster::saveMapping()), if not empty.</param>
+		/// <returns>amount of poses before and after, and their distances to the representatives. Zero poses if nothing was done.</returns>
+		PoseData::ClusterReport cmdClusterLibrary(int count, float threshold, bool global, const std::vector<ID>& boneids, std::string mappingPath) override;
+		/// <summary>
+		/// call when the UI logic determines the poses replaced by cmdClusterLibrary() should come back. Restores the library as
+		/// it was before its first clustering since it was last saved, opened or created. Adding a pose or saving the library
+		/// releases the replaced poses.
+		/// </summary>
+		/// <returns>true if the poses were restored.</returns>
+		bool cmdRestoreLibrary() override;
+
+		/// <summary>
+		/// call when the UI logic begins a continuous edit, such as dragging a slider. Commands issued until cmdCommitEdit()
+		/// form a single undo step, so the UI may send one command per frame while the user drags.
+		/// </summary>
+		void cmdBeginEdit() override;
+		/// <summary>
+		/// call when the UI logic finishes a continuous edit started by cmdBeginEdit().
+		/// </summary>
+		void cmdCommitEdit() override;
+		/// <summary>
+		/// call when the UI logic determines the last bone operation should be reverted.
+		/// </summary>
+		void cmdUndo() override;
+		/// <summary>
+		/// call when the UI logic determines the last reverted bone operation should be reapplied.
+		/// </summary>
+		void cmdRedo() override;
 
 		/// <summary>
 		/// call when the UI logic determines a new bone should be added.
@@ -135,5 +446,23 @@ namespace PoseController {
 		/// <param name="boneid">bone to be changed.</param>
 		/// <param name="parentid">new parent id, pass -1 to make the provided bone a root bone.</param>
 		void cmdBoneSetParent(ID boneid, ID parentid) override;
+		/// <summary>
+		/// call when the UI logic determines the given bone should sit at a different offset from its parent joint.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="offset">position of the joint relative to the parent joint, in the frame of the parent.</param>
+		void cmdBoneSetOffset(ID boneid, glm::vec3 offset) override;
+		/// <summary>
+		/// call when the UI logic determines the given bone should get new rotation limits. The current rotation is clamped to them.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="limit">swing and twist range in degrees.</param>
+		void cmdBoneSetLimit(ID boneid, PoseData::JointLimit limit) override;
+		/// <summary>
+		/// call when the UI logic determines the given bone should be driven by another bone, or no longer be driven.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="constraint">new constraint, ConstraintType::Free removes it.</param>
+		void cmdBoneSetConstraint(ID boneid, PoseData::BoneConstraint constraint) override;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+/// <title>Euler Order</title>
+/// <desc>
+///		Euler angle conversions specialized at compile time for every PoseData::RotationOrder.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include "EulerOrder.h"
+
+glm::quat EulerOrder::eulerToQuat(glm::vec3 euler, RotationOrder order) {
+	glm::quat result;
+	dispatch(order, [&](auto tag) { result = eulerToQuat<decltype(tag)::value>(euler); });
+	return result;
+}
+
+glm::vec3 EulerOrder::quatToEuler(glm::quat quat, RotationOrder order) {
+	glm::vec3 result;
+	dispatch(order, [&](auto tag) { result = quatToEuler<decltype(tag)::value>(quat); });
+	return result;
+}
+
+int EulerOrder::middleAxis(RotationOrder order) {
+	int axis = 1;
+	dispatch(order, [&](auto tag) { axis = Axes<decltype(tag)::value>::second; });
+	return axis;
+}
+
+const char* EulerOrder::orderName(RotationOrder order) {
+	switch (order) {
+	case RotationOrder::XYZ: return "XYZ";
+	case RotationOrder::XZY: return "XZY";
+	case RotationOrder::YXZ: return "YXZ";
+	case RotationOrder::YZX: return "YZX";
+	case RotationOrder::ZXY: return "ZXY";
+	case RotationOrder::ZYX: return "ZYX";
+	}
+	return "";
+}
@@ -0,0 +1,133 @@
+/// <title>Euler Order</title>
+/// <desc>
+///		Euler angle conversions specialized at compile time for every PoseData::RotationOrder.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+
+/// <summary>
+/// EulerOrder converts euler angles in degrees from and to quaternions in a given RotationOrder.
+/// The order is a template argument, so every order compiles into its own branch-free kernel. Bulk operations
+/// pick the order once through dispatch() instead of once per bone. The XYZ order gives exactly the results of GLM.
+/// </summary>
+namespace EulerOrder {
+
+	using PoseData::RotationOrder;
+
+	/// <summary>
+	/// Axes of a rotation order: first is applied first. Parity is 1 if (first, second, third) is a cyclic permutation of (x, y, z), -1 otherwise.
+	/// </summary>
+	template<RotationOrder Order>
+	struct Axes {
+		static constexpr int first = Order == RotationOrder::XYZ || Order == RotationOrder::XZY ? 0 :
+			Order == RotationOrder::YXZ || Order == RotationOrder::YZX ? 1 : 2;
+		static constexpr int second = Order == RotationOrder::YXZ || Order == RotationOrder::ZXY ? 0 :
+			Order == RotationOrder::XYZ || Order == RotationOrder::ZYX ? 1 : 2;
+		static constexpr int third = 3 - first - second;
+		static constexpr float parity = (second - first + 3) % 3 == 1 ? 1.0f : -1.0f;
+	};
+
+	/// <summary>
+	/// Calls function with std::integral_constant&lt;RotationOrder, order&gt;, turning the runtime order into a template argument.
+	/// </summary>
+	template<typename Function>
+	inline void dispatch(RotationOrder order, Function&& function) {
+		switch (order) {
+		case RotationOrder::XYZ: function(std::integral_constant<RotationOrder, RotationOrder::XYZ>()); break;
+		case RotationOrder::XZY: function(std::integral_constant<RotationOrder, RotationOrder::XZY>()); break;
+		case RotationOrder::YXZ: function(std::integral_constant<RotationOrder, RotationOrder::YXZ>()); break;
+		case RotationOrder::YZX: function(std::integral_constant<RotationOrder, RotationOrder::YZX>()); break;
+		case RotationOrder::ZXY: function(std::integral_constant<RotationOrder, RotationOrder::ZXY>()); break;
+		case RotationOrder::ZYX: function(std::integral_constant<RotationOrder, RotationOrder::ZYX>()); break;
+		}
+	}
+
+	/// <summary>
+	/// Converts euler angles in degrees into a quaternion: q = qThird * qSecond * qFirst.
+	/// </summary>
+	template<RotationOrder Order>
+	inline glm::quat eulerToQuat(glm::vec3 euler) {
+		using A = Axes<Order>;
+		constexpr float p = A::parity;
+		glm::vec3 half = glm::radians(euler) * 0.5f;
+		float sa = std::sin(half[A::first]), ca = std::cos(half[A::first]);
+		float sb = std::sin(half[A::second]), cb = std::cos(half[A::second]);
+		float sc = std::sin(half[A::third]), cc = std::cos(half[A::third]);
+		/* the products keep the operand order of glm::quat(glm::vec3), so XYZ is bit exact */
+		glm::vec3 v;
+		v[A::first] = sa * cb * cc - p * ca * sb * sc;
+		v[A::second] = ca * sb * cc + p * sa * cb * sc;
+		v[A::third] = ca * cb * sc - p * sa * sb * cc;
+		return glm::quat(ca * cb * cc + p * sa * sb * sc, v);
+	}
+
+	/// <summary>
+	/// Element [row][column] of the rotation matrix of a normalized quaternion, off diagonal elements only.
+	/// </summary>
+	template<int Row, int Column>
+	inline float matrixElement(const glm::quat& q) {
+		static_assert(Row != Column, "diagonal elements are computed by the caller");
+		constexpr int other = 3 - Row - Column;
+		constexpr float sign = (Row - Column + 3) % 3 == 1 ? 1.0f : -1.0f;
+		glm::vec3 v(q.x, q.y, q.z);
+		return 2.0f * (v[Row] * v[Column] + sign * q.w * v[other]);
+	}
+
+	/// <summary>
+	/// Converts a quaternion into euler angles in degrees. The middle angle is within [-90, 90].
+	/// Near gimbal lock the first angle takes the whole rotation and the last one is 0, as glm::eulerAngles does.
+	/// </summary>
+	template<RotationOrder Order>
+	inline glm::vec3 quatToEuler(glm::quat quat) {
+		if constexpr (Order == RotationOrder::XYZ) {
+			return glm::degrees(glm::eulerAngles(glm::normalize(quat)));
+		}
+		else {
+			using A = Axes<Order>;
+			constexpr float p = A::parity;
+			constexpr float epsilon = std::numeric_limits<float>::epsilon();
+			glm::quat q = glm::normalize(quat);
+			glm::vec3 v(q.x, q.y, q.z);
+			float ww = q.w * q.w, aa = v[A::first] * v[A::first], bb = v[A::second] * v[A::second], cc = v[A::third] * v[A::third];
+			glm::vec3 euler;
+			float firstY = p * matrixElement<A::third, A::second>(q);
+			float firstX = ww - aa - bb + cc;
+			euler[A::first] = std::abs(firstX) < epsilon && std::abs(firstY) < epsilon ?
+				2.0f * std::atan2(v[A::first], q.w) : std::atan2(firstY, firstX);
+			euler[A::second] = std::asin(glm::clamp(-p * matrixElement<A::third, A::first>(q), -1.0f, 1.0f));
+			float thirdY = p * matrixElement<A::second, A::first>(q);
+			float thirdX = ww + aa - bb - cc;
+			euler[A::third] = std::abs(thirdX) < epsilon && std::abs(thirdY) < epsilon ? 0.0f : std::atan2(thirdY, thirdX);
+			return glm::degrees(euler);
+		}
+	}
+
+	/// <summary>
+	/// Runtime order version of eulerToQuat for single rotations.
+	/// </summary>
+	glm::quat eulerToQuat(glm::vec3 euler, RotationOrder order);
+
+	/// <summary>
+	/// Runtime order version of quatToEuler for single rotations.
+	/// </summary>
+	glm::vec3 quatToEuler(glm::quat quat, RotationOrder order);
+
+	/// <returns>index (0 = x, 1 = y, 2 = z) of the middle axis of the order, the one limited to [-90, 90].</returns>
+	int middleAxis(RotationOrder order);
+
+	/// <returns>display name of the order, such as "XYZ".</returns>
+	const char* orderName(RotationOrder order);
+}
@@ -0,0 +1,131 @@
+/// <title>Pose Average</title>
+/// <desc>
+///		Weighted mean of the bone rotations of many pawns sharing a skeleton.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>least amount of bones per chunk of the thread pool. Every chunk reads all poses, small chunks spend their time on cache misses.</summary>
+#define AVERAGE_GRAIN 64
+/// <summary>the matrix is squared this many times, the principal eigenvector then dominates the others by (l2 / l1)^(2^n).</summary>
+#define AVERAGE_SQUARINGS 10
+
+#include "PoseAverage.h"
+
+/// <summary>
+/// Symmetric 4x4 matrix sum(weight * q * q^T) of one bone, (w, x, y, z) order.
+/// </summary>
+struct Scatter {
+	double m[4][4];
+};
+
+/// <returns>eigenvector of the largest eigenvalue of the symmetric positive semidefinite matrix, the fallback if the matrix is empty.</returns>
+static glm::quat principalEigenvector(const Scatter& scatter, const glm::quat& fallback) {
+	double a[4][4], b[4][4];
+	for (int r = 0; r < 4; r++)
+		for (int c = 0; c < 4; c++)
+			a[r][c] = scatter.m[r][c];
+	/* repeated squaring leaves (almost) only the principal component, scaled down every step so it can't overflow */
+	for (int s = 0; s < AVERAGE_SQUARINGS; s++) {
+		double largest = 0.0;
+		for (int r = 0; r < 4; r++) {
+			for (int c = 0; c < 4; c++) {
+				b[r][c] = a[r][0] * a[0][c] + a[r][1] * a[1][c] + a[r][2] * a[2][c] + a[r][3] * a[3][c];
+				largest = std::max(largest, std::abs(b[r][c]));
+			}
+		}
+		if (largest == 0.0)
+			return fallback;
+		for (int r = 0; r < 4; r++)
+			for (int c = 0; c < 4; c++)
+				a[r][c] = b[r][c] / largest;
+	}
+	/* the column with the largest diagonal element is closest to the eigenvector */
+	int column = 0;
+	for (int c = 1; c < 4; c++)
+		if (a[c][c] > a[column][column])
+			column = c;
+	double v[4] = { a[0][column], a[1][column], a[2][column], a[3][column] };
+	/* two power iterations on the original matrix remove the rounding of the squaring */
+	for (int i = 0; i < 2; i++) {
+		double next[4], length = 0.0;
+		for (int r = 0; r < 4; r++) {
+			next[r] = scatter.m[r][0] * v[0] + scatter.m[r][1] * v[1] + scatter.m[r][2] * v[2] + scatter.m[r][3] * v[3];
+			length += next[r] * next[r];
+		}
+		if (length == 0.0)
+			return fallback;
+		length = std::sqrt(length);
+		for (int r = 0; r < 4; r++)
+			v[r] = next[r] / length;
+	}
+	glm::quat result(static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2]), static_cast<float>(v[3]));
+	return glm::dot(result, fallback) < 0.0f ? -result : result;
+}
+
+std::vector<glm::quat> PoseAverage::averageRotations(const PoseData::BonePawn& skeleton, const std::vector<PoseData::BonePawn>& poses,
+	const std::vector<float>& weights, Parallel::ThreadPool& pool) {
+	PROFILE_SCOPE("PoseAverage::averageRotations");
+	size_t boneCount = skeleton.bones.size();
+	std::vector<ID> ids(boneCount);
+	for (size_t b = 0; b < boneCount; b++)
+		ids[b] = skeleton.bones[b].id;
+
+	/* bones of most poses are listed in the order of the skeleton, only the others get a match */
+	std::vector<std::vector<int>> matches(poses.size());
+	for (size_t k = 0; k < poses.size(); k++) {
+		const std::vector<PoseData::BoneData>& bones = poses[k].bones;
+		bool sameOrder = bones.size() >= boneCount;
+		for (size_t b = 0; sameOrder && b < boneCount; b++)
+			sameOrder = bones[b].id == ids[b];
+		if (!sameOrder) {
+			std::vector<ID> otherIds(bones.size());
+			for (size_t i = 0; i < bones.size(); i++)
+				otherIds[i] = bones[i].id;
+			matches[k] = PoseBlend::matchBones(ids, otherIds);
+		}
+	}
+
+	/* the chunks only decide which thread computes a bone, not how, so they may depend on the amount of threads */
+	size_t grain = std::max<size_t>(AVERAGE_GRAIN, (boneCount + pool.getThreadCount() - 1) / pool.getThreadCount());
+	std::vector<glm::quat> result(boneCount);
+	pool.parallelFor(boneCount, grain, [&](size_t begin, size_t end) {
+		std::vector<Scatter> scatter(end - begin, Scatter{});
+		/* pose by pose, so every thread reads a contiguous run of bones of each pose */
+		for (size_t k = 0; k < poses.size(); k++) {
+			double weight = k < weights.size() ? weights[k] : 1.0;
+			if (weight <= 0.0)
+				continue;
+			const std::vector<PoseData::BoneData>& bones = poses[k].bones;
+			const std::vector<int>& match = matches[k];
+			for (size_t b = begin; b < end; b++) {
+				int index = match.empty() ? static_cast<int>(b) : match[b];
+				if (index < 0)
+					continue;
+				const glm::quat& q = bones[index].quaternion;
+				double w = q.w, x = q.x, y = q.y, z = q.z;
+				double lengthSquared = w * w + x * x + y * y + z * z;
+				if (lengthSquared == 0.0)
+					continue;
+				/* dividing by the squared length normalizes both factors of q * q^T */
+				double scale = weight / lengthSquared;
+				double sw = scale * w, sx = scale * x, sy = scale * y, sz = scale * z;
+				double (&m)[4][4] = scatter[b - begin].m;
+				m[0][0] += sw * w; m[0][1] += sw * x; m[0][2] += sw * y; m[0][3] += sw * z;
+				m[1][1] += sx * x; m[1][2] += sx * y; m[1][3] += sx * z;
+				m[2][2] += sy * y; m[2][3] += sy * z;
+				m[3][3] += sz * z;
+			}
+		}
+		for (size_t b = begin; b < end; b++) {
+			Scatter& s = scatter[b - begin];
+			for (int r = 1; r < 4; r++)
+				for (int c = 0; c < r; c++)
+					s.m[r][c] = s.m[c][r];
+			result[b] = principalEigenvector(s, skeleton.bones[b].quaternion);
+		}
+	});
+	return result;
+}
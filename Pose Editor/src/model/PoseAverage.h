@@ -0,0 +1,38 @@
+/// <title>Pose Average</title>
+/// <desc>
+///		Weighted mean of the bone rotations of many pawns sharing a skeleton.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../parallel/ThreadPool.h"
+#include "../profiler/Profiler.h"
+#include "PoseBlend.h"
+
+/// <summary>
+/// PoseAverage computes mean poses, such as the rest pose of a capture session.
+/// The mean rotation of a bone is the eigenvector of the largest eigenvalue of sum(weight * q * q^T) over the poses.
+/// Unlike averaging the components it does not depend on the sign of the quaternions and stays valid for widely spread rotations.
+/// </summary>
+namespace PoseAverage {
+
+	/// <summary>
+	/// Averages the rotations of poses, bones matched by ID to the bones of skeleton. The bones are split among the threads
+	/// of pool, every bone is accumulated over the poses in their order, so the result does not depend on the amount of threads.
+	/// </summary>
+	/// <param name="skeleton">bones to compute the mean for. Bones missing in every pose with a positive weight keep their rotation.</param>
+	/// <param name="weights">weight of every pose, poses without a weight get 1. Poses with weight 0 or below are left out.</param>
+	/// <returns>normalized rotations indexed the same as skeleton.bones, in the hemisphere of the skeleton's rotations.</returns>
+	std::vector<glm::quat> averageRotations(const PoseData::BonePawn& skeleton, const std::vector<PoseData::BonePawn>& poses,
+		const std::vector<float>& weights, Parallel::ThreadPool& pool = Parallel::ThreadPool::shared());
+}
@@ -0,0 +1,193 @@
+/// <title>Pose Blend</title>
+/// <desc>
+///		Blending of bone rotations between two pawns sharing a skeleton.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>above this cosine of the angle between the quaternions slerp falls back to nlerp, sin(angle) is too small to divide by.</summary>
+#define SLERP_THRESHOLD 0.9995f
+
+#include "PoseBlend.h"
+
+#if QUAT_SIMD_SSE2
+/// <summary>
+/// Blends four quaternions held as one register per component, in place in the from registers.
+/// </summary>
+template<PoseBlend::BlendMode Mode>
+static inline void blend4(__m128 from[4], __m128 to[4], __m128 t) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(from[0], to[0]), _mm_mul_ps(from[1], to[1])),
+		_mm_add_ps(_mm_mul_ps(from[2], to[2]), _mm_mul_ps(from[3], to[3])));
+	/* flip the target into the hemisphere of the source */
+	__m128 flip = _mm_and_ps(d, QuatSimd::signMask());
+	for (int c = 0; c < 4; c++)
+		to[c] = _mm_xor_ps(to[c], flip);
+	d = _mm_xor_ps(d, flip);
+
+	__m128 scaleFrom = _mm_sub_ps(one, t), scaleTo = t;
+	if (Mode == PoseBlend::BlendMode::Slerp) {
+		/* angle = acos(d), the lanes close to 1 keep the linear weights */
+		__m128 sinAngle = _mm_sqrt_ps(_mm_max_ps(_mm_setzero_ps(), _mm_sub_ps(one, _mm_mul_ps(d, d))));
+		__m128 angle = QuatSimd::atan2(sinAngle, d);
+		__m128 sinFrom, sinTo, cosUnused;
+		QuatSimd::sinCos(_mm_mul_ps(scaleFrom, angle), sinFrom, cosUnused);
+		QuatSimd::sinCos(_mm_mul_ps(scaleTo, angle), sinTo, cosUnused);
+		__m128 linear = _mm_cmpgt_ps(d, _mm_set1_ps(SLERP_THRESHOLD));
+		__m128 inverse = _mm_div_ps(one, _mm_or_ps(_mm_andnot_ps(linear, sinAngle), _mm_and_ps(linear, one)));
+		scaleFrom = _mm_or_ps(_mm_andnot_ps(linear, _mm_mul_ps(sinFrom, inverse)), _mm_and_ps(linear, scaleFrom));
+		scaleTo = _mm_or_ps(_mm_andnot_ps(linear, _mm_mul_ps(sinTo, inverse)), _mm_and_ps(linear, scaleTo));
+	}
+	for (int c = 0; c < 4; c++)
+		from[c] = _mm_add_ps(_mm_mul_ps(from[c], scaleFrom), _mm_mul_ps(to[c], scaleTo));
+	__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(from[0], from[0]), _mm_mul_ps(from[1], from[1])),
+		_mm_add_ps(_mm_mul_ps(from[2], from[2]), _mm_mul_ps(from[3], from[3]))));
+	__m128 inverse = _mm_div_ps(one, length);
+	for (int c = 0; c < 4; c++)
+		from[c] = _mm_mul_ps(from[c], inverse);
+}
+#endif
+
+template<PoseBlend::BlendMode Mode>
+static void blendKernel(const float* const from[4], const float* const to[4], float weight, const float* mask, float* const result[4], size_t count) {
+	size_t i = 0;
+#if QUAT_SIMD_SSE2
+	__m128 q[4], p[4];
+	for (; i + 4 <= count; i += 4) {
+		for (int c = 0; c < 4; c++) {
+			q[c] = _mm_loadu_ps(from[c] + i);
+			p[c] = _mm_loadu_ps(to[c] + i);
+		}
+		__m128 t = _mm_set1_ps(weight);
+		if (mask)
+			t = _mm_mul_ps(t, _mm_loadu_ps(mask + i));
+		blend4<Mode>(q, p, t);
+		for (int c = 0; c < 4; c++)
+			_mm_storeu_ps(result[c] + i, q[c]);
+	}
+#endif
+	/* remainder (everything without SSE2) */
+	for (; i < count; i++) {
+		glm::quat a(from[0][i], from[1][i], from[2][i], from[3][i]);
+		glm::quat b(to[0][i], to[1][i], to[2][i], to[3][i]);
+		float t = mask ? weight * mask[i] : weight;
+		if (glm::dot(a, b) < 0.0f)
+			b = -b;
+		glm::quat r = Mode == PoseBlend::BlendMode::Slerp && glm::dot(a, b) <= SLERP_THRESHOLD ?
+			glm::slerp(a, b, t) : a * (1.0f - t) + b * t;
+		r = glm::normalize(r);
+		result[0][i] = r.w; result[1][i] = r.x; result[2][i] = r.y; result[3][i] = r.z;
+	}
+}
+
+std::vector<int> PoseBlend::matchBones(const PoseData::BonePawn& pawn, const PoseData::BonePawn& other) {
+	std::vector<ID> ids(pawn.bones.size()), otherIds(other.bones.size());
+	for (size_t i = 0; i < ids.size(); i++)
+		ids[i] = pawn.bones[i].id;
+	for (size_t i = 0; i < otherIds.size(); i++)
+		otherIds[i] = other.bones[i].id;
+	return matchBones(ids, otherIds);
+}
+
+std::vector<int> PoseBlend::matchBones(const std::vector<ID>& ids, const std::vector<ID>& otherIds) {
+	std::vector<int> match(ids.size(), -1);
+	/* the common case lists the bones in the same order, only build the index once that breaks */
+	size_t same = 0;
+	while (same < ids.size() && same < otherIds.size() && ids[same] == otherIds[same]) {
+		match[same] = static_cast<int>(same);
+		same++;
+	}
+	if (same == ids.size())
+		return match;
+	std::unordered_map<ID, int> index;
+	index.reserve(otherIds.size());
+	for (int i = 0; i < static_cast<int>(otherIds.size()); i++)
+		index.emplace(otherIds[i], i);
+	for (size_t i = 0; i < ids.size(); i++) {
+		auto found = index.find(ids[i]);
+		match[i] = found != index.end() ? found->second : -1;
+	}
+	return match;
+}
+
+void PoseBlend::blend(const RotationBatch::QuatLanes& from, const RotationBatch::QuatLanes& to, float weight, const float* mask,
+	RotationBatch::QuatLanes& result, BlendMode mode) {
+	PROFILE_SCOPE("PoseBlend::blend");
+	result.resize(from.size());
+	const float* const a[4] = { from.w.data(), from.x.data(), from.y.data(), from.z.data() };
+	const float* const b[4] = { to.w.data(), to.x.data(), to.y.data(), to.z.data() };
+	float* const r[4] = { result.w.data(), result.x.data(), result.y.data(), result.z.data() };
+	if (mode == BlendMode::Slerp)
+		blendKernel<BlendMode::Slerp>(a, b, weight, mask, r, from.size());
+	else
+		blendKernel<BlendMode::Nlerp>(a, b, weight, mask, r, from.size());
+}
+
+std::vector<glm::quat> PoseBlend::blendRotations(const PoseData::BonePawn& pawn, const PoseData::BonePawn& other, float weight,
+	BlendMode mode, const std::vector<float>* mask) {
+	PROFILE_SCOPE("PoseBlend::blendRotations");
+	size_t count = pawn.bones.size();
+	if (mask && mask->size() != count)
+		return std::vector<glm::quat>();
+	std::vector<int> match = matchBones(pawn, other);
+	RotationBatch::QuatLanes from, to, result;
+	from.resize(count);
+	to.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		const glm::quat& a = pawn.bones[i].quaternion;
+		/* bones missing in other blend toward themselves */
+		const glm::quat& b = match[i] >= 0 ? other.bones[match[i]].quaternion : a;
+		from.w[i] = a.w; from.x[i] = a.x; from.y[i] = a.y; from.z[i] = a.z;
+		to.w[i] = b.w; to.x[i] = b.x; to.y[i] = b.y; to.z[i] = b.z;
+	}
+	blend(from, to, weight, mask ? mask->data() : nullptr, result, mode);
+	std::vector<glm::quat> rotations(count);
+	for (size_t i = 0; i < count; i++)
+		rotations[i] = glm::quat(result.w[i], result.x[i], result.y[i], result.z[i]);
+	return rotations;
+}
+
+bool PoseBlend::openMask(const std::string& path, const PoseData::BonePawn& pawn, std::vector<float>& mask) {
+	PROFILE_SCOPE("PoseBlend::openMask");
+	std::ifstream ifile(path.c_str(), std::ios::in);
+	if (!ifile.is_open()) {
+		std::fprintf(stderr, "Trouble reading '%s': Could not open file.", path.c_str());
+		return false;
+	}
+	mask.assign(pawn.bones.size(), 0.0f);
+	std::string line;
+	int row_counter = 0;
+	while (std::getline(ifile, line)) {
+		row_counter++;
+		if (line.find_first_not_of(" \t\r") == std::string::npos)
+			continue;
+		size_t comma = line.find(',');
+		std::string key = comma == std::string::npos ? "" : line.substr(0, comma);
+		key.erase(0, key.find_first_not_of(" \t"));
+		key.erase(key.find_last_not_of(" \t\r") + 1);
+		char* end = nullptr;
+		float factor = comma == std::string::npos ? 0.0f : std::strtof(line.c_str() + comma + 1, &end);
+		if (key.empty() || end == line.c_str() + comma + 1) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d]: Expected a bone and a factor.", path.c_str(), row_counter);
+			return false;
+		}
+		/* an ID if the key is a number, a name otherwise */
+		char* idEnd = nullptr;
+		long id = std::strtol(key.c_str(), &idEnd, 10);
+		bool byId = *idEnd == '\0';
+		bool found = false;
+		for (size_t b = 0; b < pawn.bones.size(); b++) {
+			if (byId ? pawn.bones[b].id == id : pawn.bones[b].displayName == key) {
+				mask[b] = factor;
+				found = true;
+			}
+		}
+		if (!found) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d]: No bone '%s'.", path.c_str(), row_counter, key.c_str());
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,74 @@
+/// <title>Pose Blend</title>
+/// <desc>
+///		Blending of bone rotations between two pawns sharing a skeleton.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+#include "RotationBatch.h"
+
+/// <summary>
+/// PoseBlend interpolates the rotations of one pawn toward another. Bones are matched by ID, so the two pawns
+/// may list their bones in a different order. The kernels work on RotationBatch::QuatLanes, four quaternions per SSE2 step.
+/// </summary>
+namespace PoseBlend {
+
+	/// <summary>
+	/// Interpolation used by the blend. Both take the shorter path (the target is flipped into the hemisphere of the source).
+	/// Nlerp normalizes the linear interpolation, it is cheaper but not constant in angular speed. Slerp is.
+	/// </summary>
+	enum class BlendMode { Nlerp, Slerp };
+
+	/// <summary>
+	/// Matches the bones of pawn to the bones of other by ID. When other lists an ID several times, its first bone is used.
+	/// </summary>
+	/// <returns>offset into other.bones for every bone of pawn, -1 if other has no bone with that ID.</returns>
+	std::vector<int> matchBones(const PoseData::BonePawn& pawn, const PoseData::BonePawn& other);
+
+	/// <summary>
+	/// Same as matchBones for pawns, on the bone IDs alone.
+	/// </summary>
+	/// <returns>offset into otherIds for every element of ids, -1 if otherIds does not hold that ID.</returns>
+	std::vector<int> matchBones(const std::vector<ID>& ids, const std::vector<ID>& otherIds);
+
+	/// <summary>
+	/// Blends every quaternion of from toward the same element of to: weight 0 gives from, weight 1 gives to.
+	/// </summary>
+	/// <param name="weight">blend weight applied to every element.</param>
+	/// <param name="mask">optional per element factor of weight, nullptr to use weight alone. Has to hold from.size() elements.</param>
+	/// <param name="result">resized to from.size(), may not alias the inputs.</param>
+	void blend(const RotationBatch::QuatLanes& from, const RotationBatch::QuatLanes& to, float weight, const float* mask,
+		RotationBatch::QuatLanes& result, BlendMode mode = BlendMode::Nlerp);
+
+	/// <summary>
+	/// Blends the rotations of pawn toward the bones of other with the same ID. Bones missing in other keep their rotation.
+	/// </summary>
+	/// <param name="mask">optional per bone factor of weight, indexed the same as pawn.bones.</param>
+	/// <returns>blended rotations indexed the same as pawn.bones. Empty if the mask does not hold a factor for every bone.</returns>
+	std::vector<glm::quat> blendRotations(const PoseData::BonePawn& pawn, const PoseData::BonePawn& other, float weight,
+		BlendMode mode = BlendMode::Nlerp, const std::vector<float>* mask = nullptr);
+
+	/// <summary>
+	/// Reads a blend mask: a line per bone holding its ID or name and the factor of the blend weight, such as "12, 0.5".
+	/// Bones of the pawn not listed take factor 0, so the mask names the bones blended. Empty lines are skipped.
+	/// </summary>
+	/// <param name="mask">receives the factor of every bone, indexed the same as pawn.bones.</param>
+	/// <returns>true if the file was read and every line names a bone of the pawn.</returns>
+	bool openMask(const std::string& path, const PoseData::BonePawn& pawn, std::vector<float>& mask);
+}
@@ -0,0 +1,709 @@
+/// <title>Pose Clip</title>
+/// <desc>
+///		Animation clips: one skeleton shared by a track of rotation keys for each of its bones, and the clip files.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>frame rate of clips which do not provide a valid one.</summary>
+#define CLIP_DEFAULT_FRAME_RATE 30.0f
+/// <summary>first bytes of a binary clip file.</summary>
+#define CLIP_BINARY_MAGIC "PCLB"
+/// <summary>version written, 1 lacks the interpolation of the tracks and is still read.</summary>
+#define CLIP_BINARY_VERSION 2u
+/// <summary>fields of a key line: "key", bone id, time and the quaternion.</summary>
+#define CLIP_KEY_FIELDS 7
+#define CLIP_LOAD_FAILED Clip()
+/// <summary>most bones and keys a binary clip may hold, and the bytes of a bone before its name.</summary>
+#define MAX_BONE_LIMIT 1000000
+#define MAX_KEY_LIMIT 100000000
+#define CLIP_BINARY_BONE_BYTES 64
+/// <summary>keys a sampler cursor walks forward before it falls back to a binary search.</summary>
+#define SAMPLER_CURSOR_STEPS 4
+
+#include <atomic>
+
+#include "PoseClip.h"
+
+/// <summary>source of Clip revisions, shared so no two layouts of any clips get the same one.</summary>
+static std::atomic<unsigned> s_Revisions(0);
+
+void PoseClip::Clip::layout(const std::vector<int>& trackSizes, std::vector<float>&& times, std::vector<glm::quat>&& rotations) {
+	size_t tracks = trackSizes.size();
+	m_TrackStart.resize(tracks + 1);
+	m_TrackStart[0] = 0;
+	for (size_t t = 0; t < tracks; t++)
+		m_TrackStart[t + 1] = m_TrackStart[t] + trackSizes[t];
+	m_Duration = 0.0f;
+	for (float time : times)
+		m_Duration = std::max(m_Duration, time);
+	m_Revision = ++s_Revisions;
+#if CLIP_TIME_MAJOR
+	/* order the keys by time, ties by track (the sort is stable), and remember where every key of a track went */
+	size_t count = times.size();
+	std::vector<int> order(count);
+	for (size_t i = 0; i < count; i++)
+		order[i] = static_cast<int>(i);
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return times[a] < times[b]; });
+	m_Times.resize(count);
+	m_Rotations.resize(count);
+	m_TrackKeys.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		m_Times[i] = times[order[i]];
+		m_Rotations[i] = rotations[order[i]];
+		m_TrackKeys[order[i]] = static_cast<int>(i);
+	}
+#else
+	m_Times = std::move(times);
+	m_Rotations = std::move(rotations);
+#endif
+}
+
+void PoseClip::Clip::build(const PoseData::BonePawn& skeleton, const std::vector<std::vector<Key>>& tracks, float frameRate) {
+	std::vector<int> sizes(skeleton.bones.size(), 0);
+	size_t count = 0;
+	for (size_t t = 0; t < sizes.size() && t < tracks.size(); t++)
+		count += tracks[t].size();
+	std::vector<float> times;
+	std::vector<glm::quat> rotations;
+	times.reserve(count);
+	rotations.reserve(count);
+	for (size_t t = 0; t < sizes.size() && t < tracks.size(); t++) {
+		for (const Key& key : tracks[t]) {
+			times.push_back(key.time);
+			rotations.push_back(key.rotation);
+		}
+		sizes[t] = static_cast<int>(tracks[t].size());
+	}
+	build(skeleton, sizes, std::move(times), std::move(rotations), frameRate);
+}
+
+void PoseClip::Clip::build(const PoseData::BonePawn& skeleton, const std::vector<int>& trackSizes, std::vector<float> times,
+	std::vector<glm::quat> rotations, float frameRate) {
+	PROFILE_SCOPE("PoseClip::build");
+	m_Skeleton = skeleton;
+	m_FrameRate = frameRate > 0.0f ? frameRate : CLIP_DEFAULT_FRAME_RATE;
+	m_Interpolation.assign(skeleton.bones.size(), PoseData::Interpolation::Nlerp);
+	std::vector<int> sizes(trackSizes);
+	sizes.resize(skeleton.bones.size(), 0);
+	/* sort every track that needs it, the last of the keys sharing a time wins */
+	size_t begin = 0, kept = 0;
+	std::vector<int> order;
+	for (size_t t = 0; t < sizes.size(); t++) {
+		size_t end = std::min(begin + sizes[t], times.size());
+		bool sorted = std::is_sorted(times.begin() + begin, times.begin() + end) &&
+			std::adjacent_find(times.begin() + begin, times.begin() + end) == times.begin() + end;
+		size_t first = kept;
+		if (sorted) {
+			for (size_t i = begin; i < end; i++, kept++) {
+				times[kept] = times[i];
+				rotations[kept] = rotations[i];
+			}
+		}
+		else {
+			order.resize(end - begin);
+			for (size_t i = 0; i < order.size(); i++)
+				order[i] = static_cast<int>(begin + i);
+			std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return times[a] < times[b]; });
+			std::vector<float> trackTimes(order.size());
+			std::vector<glm::quat> trackRotations(order.size());
+			size_t n = 0;
+			for (size_t i = 0; i < order.size(); i++) {
+				if (n > 0 && trackTimes[n - 1] == times[order[i]])
+					n--;
+				trackTimes[n] = times[order[i]];
+				trackRotations[n] = rotations[order[i]];
+				n++;
+			}
+			for (size_t i = 0; i < n; i++, kept++) {
+				times[kept] = trackTimes[i];
+				rotations[kept] = trackRotations[i];
+			}
+		}
+		sizes[t] = static_cast<int>(kept - first);
+		begin = end;
+	}
+	times.resize(kept);
+	rotations.resize(kept);
+	layout(sizes, std::move(times), std::move(rotations));
+}
+
+const PoseData::BonePawn& PoseClip::Clip::getSkeleton() const {
+	return m_Skeleton;
+}
+
+int PoseClip::Clip::getTrackCount() const {
+	return static_cast<int>(m_Skeleton.bones.size());
+}
+
+int PoseClip::Clip::getKeyCount() const {
+	return static_cast<int>(m_Times.size());
+}
+
+int PoseClip::Clip::getKeyCount(int track) const {
+	return m_TrackStart[track + 1] - m_TrackStart[track];
+}
+
+float PoseClip::Clip::getFrameRate() const {
+	return m_FrameRate;
+}
+
+float PoseClip::Clip::getDuration() const {
+	return m_Duration;
+}
+
+std::vector<PoseClip::Key> PoseClip::Clip::getTrack(int track) const {
+	std::vector<Key> keys(getKeyCount(track));
+	for (int k = 0; k < static_cast<int>(keys.size()); k++)
+		keys[k] = { getKeyTime(track, k), getKeyRotation(track, k) };
+	return keys;
+}
+
+int PoseClip::Clip::findKey(int track, float time) const {
+	int low = 0, high = getKeyCount(track);
+	/* first key after time, the one before it is the answer */
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (getKeyTime(track, middle) <= time)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low - 1;
+}
+
+void PoseClip::Clip::samplePose(float time, std::vector<glm::quat>& rotations) const {
+	PROFILE_SCOPE("PoseClip::samplePose");
+	int tracks = getTrackCount();
+	rotations.resize(tracks);
+	for (int t = 0; t < tracks; t++) {
+		if (getKeyCount(t) == 0) {
+			rotations[t] = m_Skeleton.bones[t].quaternion;
+			continue;
+		}
+		rotations[t] = getKeyRotation(t, std::max(findKey(t, time), 0));
+	}
+}
+
+void PoseClip::Clip::setPoseKeys(float time, const std::vector<glm::quat>& rotations) {
+	PROFILE_SCOPE("PoseClip::setPoseKeys");
+	int tracks = getTrackCount();
+	if (static_cast<int>(rotations.size()) != tracks)
+		return;
+	std::vector<int> sizes(tracks);
+	std::vector<float> times;
+	std::vector<glm::quat> keys;
+	times.reserve(m_Times.size() + tracks);
+	keys.reserve(m_Times.size() + tracks);
+	for (int t = 0; t < tracks; t++) {
+		size_t before = times.size();
+		int count = getKeyCount(t), k = 0;
+		for (; k < count && getKeyTime(t, k) < time; k++) {
+			times.push_back(getKeyTime(t, k));
+			keys.push_back(getKeyRotation(t, k));
+		}
+		times.push_back(time);
+		keys.push_back(rotations[t]);
+		if (k < count && getKeyTime(t, k) == time)
+			k++; // replaced
+		for (; k < count; k++) {
+			times.push_back(getKeyTime(t, k));
+			keys.push_back(getKeyRotation(t, k));
+		}
+		sizes[t] = static_cast<int>(times.size() - before);
+	}
+	layout(sizes, std::move(times), std::move(keys));
+}
+
+void PoseClip::Clip::setFrameRate(float frameRate) {
+	if (frameRate > 0.0f)
+		m_FrameRate = frameRate;
+}
+
+PoseData::Interpolation PoseClip::Clip::getInterpolation(int track) const {
+	return m_Interpolation[track];
+}
+
+void PoseClip::Clip::setInterpolation(int track, PoseData::Interpolation interpolation) {
+	m_Interpolation[track] = interpolation;
+}
+
+unsigned PoseClip::Clip::getRevision() const {
+	return m_Revision;
+}
+
+PoseClip::Sampler::Sampler(const Clip& clip) {
+	bind(clip);
+}
+
+void PoseClip::Sampler::bind(const Clip& clip) {
+	m_Clip = &clip;
+	reset();
+}
+
+void PoseClip::Sampler::reset() {
+	m_Revision = m_Clip ? m_Clip->getRevision() : 0;
+	m_Cursors.assign(m_Clip ? m_Clip->getTrackCount() : 0, -1);
+	m_Searches = 0;
+}
+
+int PoseClip::Sampler::seek(int track, float time) {
+	int& cursor = m_Cursors[track];
+	int count = m_Clip->getKeyCount(track);
+	/* the cursor holds while time does not go back before its key, then the next few keys are checked in order */
+	if (cursor < 0 || m_Clip->getKeyTime(track, cursor) <= time) {
+		for (int step = 0; ; step++) {
+			if (cursor + 1 >= count || m_Clip->getKeyTime(track, cursor + 1) > time)
+				return cursor;
+			if (step == SAMPLER_CURSOR_STEPS)
+				break;
+			cursor++;
+		}
+	}
+	m_Searches++;
+	cursor = m_Clip->findKey(track, time);
+	return cursor;
+}
+
+void PoseClip::Sampler::blendTracks(const std::vector<int>& tracks, RotationBatch::QuatLanes& from, RotationBatch::QuatLanes& to,
+	const std::vector<float>& alpha, RotationBatch::QuatLanes& result, PoseBlend::BlendMode mode, std::vector<glm::quat>& pose) {
+	size_t count = tracks.size();
+	if (count == 0)
+		return;
+	from.resize(count);
+	to.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		int k = m_Cursors[tracks[i]];
+		const glm::quat& a = m_Clip->getKeyRotation(tracks[i], k);
+		const glm::quat& b = m_Clip->getKeyRotation(tracks[i], k + 1);
+		from.w[i] = a.w; from.x[i] = a.x; from.y[i] = a.y; from.z[i] = a.z;
+		to.w[i] = b.w; to.x[i] = b.x; to.y[i] = b.y; to.z[i] = b.z;
+	}
+	/* the fraction between the keys goes in as the mask, so every lane gets its own weight */
+	PoseBlend::blend(from, to, 1.0f, alpha.data(), result, mode);
+	for (size_t i = 0; i < count; i++)
+		pose[tracks[i]] = glm::quat(result.w[i], result.x[i], result.y[i], result.z[i]);
+}
+
+void PoseClip::Sampler::sample(float time, std::vector<glm::quat>& pose) {
+	PROFILE_SCOPE("PoseClip::Sampler::sample");
+	if (!m_Clip)
+		return;
+	int tracks = m_Clip->getTrackCount();
+	/* a rebuilt clip invalidates the key indices of the cursors */
+	if (m_Revision != m_Clip->getRevision() || static_cast<int>(m_Cursors.size()) != tracks) {
+		m_Revision = m_Clip->getRevision();
+		m_Cursors.assign(tracks, -1);
+	}
+	if (static_cast<int>(pose.size()) != tracks)
+		pose.resize(tracks);
+	m_NlerpTracks.clear();
+	m_SlerpTracks.clear();
+	m_NlerpAlpha.clear();
+	m_SlerpAlpha.clear();
+	const PoseData::BonePawn& skeleton = m_Clip->getSkeleton();
+	for (int t = 0; t < tracks; t++) {
+		int count = m_Clip->getKeyCount(t);
+		if (count == 0) {
+			pose[t] = skeleton.bones[t].quaternion;
+			continue;
+		}
+		int k = seek(t, time);
+		PoseData::Interpolation interpolation = m_Clip->getInterpolation(t);
+		if (k < 0 || k + 1 >= count || interpolation == PoseData::Interpolation::Step) {
+			pose[t] = m_Clip->getKeyRotation(t, std::max(k, 0));
+			continue;
+		}
+		/* keys of a track never share a time, so the span is positive */
+		float start = m_Clip->getKeyTime(t, k);
+		float alpha = (time - start) / (m_Clip->getKeyTime(t, k + 1) - start);
+		if (interpolation == PoseData::Interpolation::Slerp) {
+			m_SlerpTracks.push_back(t);
+			m_SlerpAlpha.push_back(alpha);
+		}
+		else {
+			m_NlerpTracks.push_back(t);
+			m_NlerpAlpha.push_back(alpha);
+		}
+	}
+	blendTracks(m_NlerpTracks, m_NlerpFrom, m_NlerpTo, m_NlerpAlpha, m_NlerpResult, PoseBlend::BlendMode::Nlerp, pose);
+	blendTracks(m_SlerpTracks, m_SlerpFrom, m_SlerpTo, m_SlerpAlpha, m_SlerpResult, PoseBlend::BlendMode::Slerp, pose);
+}
+
+long long PoseClip::Sampler::getSearches() const {
+	return m_Searches;
+}
+
+const char* PoseClip::interpolationName(PoseData::Interpolation interpolation) {
+	switch (interpolation) {
+	case PoseData::Interpolation::Step: return "step";
+	case PoseData::Interpolation::Nlerp: return "nlerp";
+	case PoseData::Interpolation::Slerp: return "slerp";
+	}
+	return "";
+}
+
+bool PoseClip::parseInterpolation(const std::string& name, PoseData::Interpolation& interpolation) {
+	size_t begin = name.find_first_not_of(" \t\r\n"), end = name.find_last_not_of(" \t\r\n");
+	std::string trimmed = begin == std::string::npos ? "" : name.substr(begin, end - begin + 1);
+	for (PoseData::Interpolation candidate : { PoseData::Interpolation::Step, PoseData::Interpolation::Nlerp, PoseData::Interpolation::Slerp }) {
+		if (trimmed == interpolationName(candidate)) {
+			interpolation = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+PoseClip::ClipFormat PoseClip::formatOf(const std::string& path) {
+	size_t last = path.find_last_of('.');
+	return last != std::string::npos && path.substr(last) == ".clipb" ? ClipFormat::Binary : ClipFormat::Text;
+}
+
+std::string PoseClip::addExtension(std::string path, ClipFormat format) {
+	size_t last = path.find_last_of('.');
+	if (last != std::string::npos && last > path.find_last_of("/\\") + 1) {
+		std::string extension = path.substr(last);
+		if (extension == ".clip" || extension == ".clipb")
+			return path;
+		path = path.substr(0, last);
+	}
+	return path.append(format == ClipFormat::Binary ? ".clipb" : ".clip");
+}
+
+/// <summary>
+/// Reads the text format, see PoseClip::openClip().
+/// </summary>
+static bool readClipText(std::ifstream& ifile, const std::string& path, PoseData::BonePawn& skeleton, std::vector<int>& trackSizes,
+	std::vector<float>& times, std::vector<glm::quat>& rotations, std::vector<PoseData::Interpolation>& interpolation, float& frameRate) {
+	std::string line, field, problem;
+	int row = 0, column = 0;
+	/* header */
+	if (!std::getline(ifile, line) || line.compare(0, 4, "clip") != 0) {
+		std::fprintf(stderr, "Trouble reading '%s' [row 0]: Missing the clip header.", path.c_str());
+		return false;
+	}
+	std::stringstream header(line);
+	std::getline(header, field, ',');
+	if (!std::getline(header, field, ',') || (frameRate = std::strtof(field.c_str(), nullptr)) <= 0.0f) {
+		std::fprintf(stderr, "Trouble reading '%s' [row 0, col 1]: Invalid frame rate.", path.c_str());
+		return false;
+	}
+	/* skeleton rows until the first key or track line */
+	std::vector<int> keyTracks;
+	std::unordered_map<ID, int> index;
+	auto isKeyLine = [](const std::string& line) { return line.compare(0, 3, "key") == 0 || line.compare(0, 5, "track") == 0; };
+	bool key = false; // true while line holds a key or track line not read yet
+	while (std::getline(ifile, line)) {
+		row++;
+		if (isKeyLine(line)) {
+			key = true;
+			break;
+		}
+		PoseData::BoneData bone;
+		if (!PoseDataUtil::boneParseCSVLine(bone, line, column, problem)) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d, col %d]: %s", path.c_str(), row, column, problem.c_str());
+			return false;
+		}
+		index.emplace(bone.id, static_cast<int>(skeleton.bones.size()));
+		skeleton.bones.push_back(bone);
+	}
+	/* keys, in any order, they are grouped by track below */
+	interpolation.assign(skeleton.bones.size(), PoseData::Interpolation::Nlerp);
+	while (key) {
+		std::stringstream lineStream(line);
+		if (line.compare(0, 5, "track") == 0) {
+			std::string id, name;
+			std::getline(lineStream, field, ',');
+			std::getline(lineStream, id, ',');
+			std::getline(lineStream, name, ',');
+			auto found = index.find(static_cast<ID>(std::strtol(id.c_str(), nullptr, 10)));
+			PoseData::Interpolation mode;
+			if (found == index.end() || !PoseClip::parseInterpolation(name, mode)) {
+				std::fprintf(stderr, "Trouble reading '%s' [row %d]: Expected \"track, [BoneID], [step|nlerp|slerp]\".", path.c_str(), row);
+				return false;
+			}
+			interpolation[found->second] = mode;
+			key = static_cast<bool>(std::getline(ifile, line));
+			row++;
+			if (key && !isKeyLine(line)) {
+				std::fprintf(stderr, "Trouble reading '%s' [row %d]: Expected a key, bones have to come before the keys.", path.c_str(), row);
+				return false;
+			}
+			continue;
+		}
+		float values[CLIP_KEY_FIELDS] = {};
+		int count = 0;
+		try {
+			for (; count < CLIP_KEY_FIELDS && std::getline(lineStream, field, ','); count++)
+				values[count] = count == 0 ? 0.0f : std::stof(field);
+		}
+		catch (const std::exception&) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d, col %d]: Value could not be parsed.", path.c_str(), row, count);
+			return false;
+		}
+		if (count < CLIP_KEY_FIELDS) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d, col %d]: Premature end of line. Expected %d items.", path.c_str(), row, count, CLIP_KEY_FIELDS);
+			return false;
+		}
+		auto found = index.find(static_cast<ID>(values[1]));
+		if (found == index.end()) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d, col 1]: Key of an unknown bone.", path.c_str(), row);
+			return false;
+		}
+		glm::quat rotation;
+		for (int c = 0; c < 4; c++)
+			rotation[c] = values[3 + c];
+		keyTracks.push_back(found->second);
+		times.push_back(values[2]);
+		rotations.push_back(rotation);
+		key = static_cast<bool>(std::getline(ifile, line));
+		row++;
+		if (key && !isKeyLine(line)) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d]: Expected a key, bones have to come before the keys.", path.c_str(), row);
+			return false;
+		}
+	}
+	/* group the keys track after track, keeping their order within a track */
+	trackSizes.assign(skeleton.bones.size(), 0);
+	for (int track : keyTracks)
+		trackSizes[track]++;
+	std::vector<int> next(skeleton.bones.size(), 0);
+	for (size_t t = 1; t < next.size(); t++)
+		next[t] = next[t - 1] + trackSizes[t - 1];
+	std::vector<float> groupedTimes(times.size());
+	std::vector<glm::quat> groupedRotations(times.size());
+	for (size_t i = 0; i < keyTracks.size(); i++) {
+		int at = next[keyTracks[i]]++;
+		groupedTimes[at] = times[i];
+		groupedRotations[at] = rotations[i];
+	}
+	times = std::move(groupedTimes);
+	rotations = std::move(groupedRotations);
+	return true;
+}
+
+/// <summary>
+/// Reads the binary format, see PoseClip::saveClip().
+/// </summary>
+static bool readClipBinary(std::ifstream& ifile, const std::string& path, PoseData::BonePawn& skeleton, std::vector<int>& trackSizes,
+	std::vector<float>& times, std::vector<glm::quat>& rotations, std::vector<PoseData::Interpolation>& interpolation, float& frameRate) {
+	std::streampos start = ifile.tellg();
+	ifile.seekg(0, std::ios::end);
+	uint64_t fileSize = static_cast<uint64_t>(ifile.tellg());
+	ifile.seekg(start);
+	char magic[4] = {};
+	uint32_t version = 0, boneCount = 0, keyCount = 0;
+	ifile.read(magic, 4);
+	ifile.read(reinterpret_cast<char*>(&version), sizeof(version));
+	ifile.read(reinterpret_cast<char*>(&frameRate), sizeof(frameRate));
+	ifile.read(reinterpret_cast<char*>(&boneCount), sizeof(boneCount));
+	ifile.read(reinterpret_cast<char*>(&keyCount), sizeof(keyCount));
+	if (!ifile || std::string(magic, 4) != CLIP_BINARY_MAGIC || version < 1u || version > CLIP_BINARY_VERSION ||
+		boneCount > MAX_BONE_LIMIT || keyCount > MAX_KEY_LIMIT) {
+		std::fprintf(stderr, "Trouble reading '%s': Not a binary clip of version %u or older.", path.c_str(), CLIP_BINARY_VERSION);
+		return false;
+	}
+	/* the counts are checked against the rest of the file before anything is allocated for them, names are checked as they come */
+	uint64_t trackBytes = sizeof(uint32_t) + (version >= 2u ? sizeof(uint8_t) : 0);
+	uint64_t leastSize = static_cast<uint64_t>(ifile.tellg()) + static_cast<uint64_t>(boneCount) * (CLIP_BINARY_BONE_BYTES + trackBytes) +
+		static_cast<uint64_t>(keyCount) * (sizeof(float) + sizeof(glm::quat));
+	if (leastSize > fileSize) {
+		std::fprintf(stderr, "Trouble reading '%s': %u keys of %u bones do not fit the file.", path.c_str(), keyCount, boneCount);
+		return false;
+	}
+	skeleton.bones.resize(boneCount);
+	for (PoseData::BoneData& bone : skeleton.bones) {
+		int32_t ids[2], type;
+		float values[10];
+		uint32_t nameLength = 0;
+		ifile.read(reinterpret_cast<char*>(ids), sizeof(ids));
+		ifile.read(reinterpret_cast<char*>(values), sizeof(values));
+		ifile.read(reinterpret_cast<char*>(&type), sizeof(type));
+		ifile.read(reinterpret_cast<char*>(&bone.constraint.driver), sizeof(int32_t));
+		ifile.read(reinterpret_cast<char*>(&bone.constraint.factor), sizeof(float));
+		ifile.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+		if (!ifile || type < 0 || type > static_cast<int32_t>(PoseData::ConstraintType::AimAt) ||
+			static_cast<uint64_t>(ifile.tellg()) + nameLength > fileSize) {
+			std::fprintf(stderr, "Trouble reading '%s': Truncated or invalid bone.", path.c_str());
+			return false;
+		}
+		bone.displayName.resize(nameLength);
+		ifile.read(&bone.displayName[0], nameLength);
+		bone.id = ids[0];
+		bone.parent = ids[1];
+		for (int c = 0; c < 4; c++)
+			bone.quaternion[c] = values[c];
+		bone.offset = glm::vec3(values[4], values[5], values[6]);
+		bone.limit = PoseLimits::sanitize({ values[7], values[8], values[9] });
+		bone.constraint.type = static_cast<PoseData::ConstraintType>(type);
+	}
+	std::vector<uint32_t> sizes(boneCount);
+	times.resize(keyCount);
+	rotations.resize(keyCount);
+	ifile.read(reinterpret_cast<char*>(sizes.data()), sizes.size() * sizeof(uint32_t));
+	std::vector<uint8_t> modes(boneCount, static_cast<uint8_t>(PoseData::Interpolation::Nlerp));
+	if (version >= 2u)
+		ifile.read(reinterpret_cast<char*>(modes.data()), modes.size());
+	ifile.read(reinterpret_cast<char*>(times.data()), times.size() * sizeof(float));
+	ifile.read(reinterpret_cast<char*>(rotations.data()), rotations.size() * sizeof(glm::quat));
+	uint64_t total = 0;
+	for (uint32_t size : sizes)
+		total += size;
+	bool modesValid = std::all_of(modes.begin(), modes.end(), [](uint8_t mode) { return mode <= static_cast<uint8_t>(PoseData::Interpolation::Slerp); });
+	if (!ifile || total != keyCount || !modesValid) {
+		std::fprintf(stderr, "Trouble reading '%s': Truncated or invalid keys.", path.c_str());
+		return false;
+	}
+	trackSizes.assign(sizes.begin(), sizes.end());
+	interpolation.resize(boneCount);
+	for (uint32_t t = 0; t < boneCount; t++)
+		interpolation[t] = static_cast<PoseData::Interpolation>(modes[t]);
+	return true;
+}
+
+PoseClip::Clip PoseClip::openClip(const std::string& path, PoseData::RotationOrder order) {
+	PROFILE_SCOPE("PoseClip::openClip");
+	ClipFormat format = formatOf(path);
+	std::ifstream ifile(path.c_str(), format == ClipFormat::Binary ? std::ios::in | std::ios::binary : std::ios::in);
+	if (!ifile.is_open()) {
+		std::fprintf(stderr, "Trouble reading '%s': Could not open file.", path.c_str());
+		return CLIP_LOAD_FAILED;
+	}
+	PoseData::BonePawn skeleton;
+	std::vector<int> trackSizes;
+	std::vector<float> times;
+	std::vector<glm::quat> rotations;
+	std::vector<PoseData::Interpolation> interpolation;
+	float frameRate = CLIP_DEFAULT_FRAME_RATE;
+	bool read = format == ClipFormat::Binary ?
+		readClipBinary(ifile, path, skeleton, trackSizes, times, rotations, interpolation, frameRate) :
+		readClipText(ifile, path, skeleton, trackSizes, times, rotations, interpolation, frameRate);
+	ifile.close();
+	if (!read)
+		return CLIP_LOAD_FAILED;
+	skeleton.originalFilePath = path;
+	skeleton.originalFileName = PoseDataUtil::parseFilename(path);
+	skeleton.rotationOrder = order;
+	skeleton.loaded = true;
+	skeleton.saved = true;
+	RotationBatch::pawnQuatToEuler(skeleton);
+	Clip clip;
+	clip.build(skeleton, trackSizes, std::move(times), std::move(rotations), frameRate);
+	for (int t = 0; t < clip.getTrackCount(); t++)
+		clip.setInterpolation(t, interpolation[t]);
+	return clip;
+}
+
+bool PoseClip::saveClip(const Clip& clip, const std::string& path, ClipFormat format) {
+	PROFILE_SCOPE("PoseClip::saveClip");
+	std::ofstream ofile(path.c_str(), format == ClipFormat::Binary ? std::ios::out | std::ios::binary : std::ios::out);
+	if (!ofile.is_open()) {
+		std::fprintf(stderr, "Trouble writing to '%s': Could not open file.", path.c_str());
+		return false;
+	}
+	const PoseData::BonePawn& skeleton = clip.getSkeleton();
+	int tracks = clip.getTrackCount();
+	if (format == ClipFormat::Text) {
+		ofile << "clip, " << clip.getFrameRate() << "\n";
+		int columns = PoseDataUtil::pawnCSVColumns(skeleton);
+		for (const PoseData::BoneData& bone : skeleton.bones) {
+			PoseDataUtil::boneWriteCSVLine(ofile, bone, columns);
+			ofile << "\n";
+		}
+		for (int t = 0; t < tracks; t++) {
+			if (clip.getInterpolation(t) != PoseData::Interpolation::Nlerp)
+				ofile << "track, " << skeleton.bones[t].id << ", " << interpolationName(clip.getInterpolation(t)) << "\n";
+			for (int k = 0; k < clip.getKeyCount(t); k++) {
+				const glm::quat& rotation = clip.getKeyRotation(t, k);
+				/* times keep every digit, so keys on the frames of the clip read back on the same frames */
+				ofile << "key, " << skeleton.bones[t].id << ", " << std::setprecision(9) << clip.getKeyTime(t, k) << std::setprecision(6) << ", " <<
+					rotation[0] << ", " << rotation[1] << ", " << rotation[2] << ", " << rotation[3] << "\n";
+			}
+		}
+	}
+	else {
+		/* header, bones, key count and interpolation of every track, then the times and rotations of the keys track after track */
+		uint32_t version = CLIP_BINARY_VERSION, boneCount = static_cast<uint32_t>(tracks), keyCount = static_cast<uint32_t>(clip.getKeyCount());
+		float frameRate = clip.getFrameRate();
+		ofile.write(CLIP_BINARY_MAGIC, 4);
+		ofile.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		ofile.write(reinterpret_cast<const char*>(&frameRate), sizeof(frameRate));
+		ofile.write(reinterpret_cast<const char*>(&boneCount), sizeof(boneCount));
+		ofile.write(reinterpret_cast<const char*>(&keyCount), sizeof(keyCount));
+		for (const PoseData::BoneData& bone : skeleton.bones) {
+			int32_t ids[2] = { bone.id, bone.parent }, type = static_cast<int32_t>(bone.constraint.type), driver = bone.constraint.driver;
+			float values[10] = { bone.quaternion[0], bone.quaternion[1], bone.quaternion[2], bone.quaternion[3],
+				bone.offset.x, bone.offset.y, bone.offset.z, bone.limit.swing, bone.limit.twistMin, bone.limit.twistMax };
+			uint32_t nameLength = static_cast<uint32_t>(bone.displayName.size());
+			ofile.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+			ofile.write(reinterpret_cast<const char*>(values), sizeof(values));
+			ofile.write(reinterpret_cast<const char*>(&type), sizeof(type));
+			ofile.write(reinterpret_cast<const char*>(&driver), sizeof(driver));
+			ofile.write(reinterpret_cast<const char*>(&bone.constraint.factor), sizeof(float));
+			ofile.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+			ofile.write(bone.displayName.data(), nameLength);
+		}
+		std::vector<uint32_t> sizes(tracks);
+		std::vector<uint8_t> modes(tracks);
+		std::vector<float> times;
+		std::vector<glm::quat> rotations;
+		times.reserve(keyCount);
+		rotations.reserve(keyCount);
+		for (int t = 0; t < tracks; t++) {
+			sizes[t] = static_cast<uint32_t>(clip.getKeyCount(t));
+			modes[t] = static_cast<uint8_t>(clip.getInterpolation(t));
+			for (int k = 0; k < clip.getKeyCount(t); k++) {
+				times.push_back(clip.getKeyTime(t, k));
+				rotations.push_back(clip.getKeyRotation(t, k));
+			}
+		}
+		ofile.write(reinterpret_cast<const char*>(sizes.data()), sizes.size() * sizeof(uint32_t));
+		ofile.write(reinterpret_cast<const char*>(modes.data()), modes.size());
+		ofile.write(reinterpret_cast<const char*>(times.data()), times.size() * sizeof(float));
+		ofile.write(reinterpret_cast<const char*>(rotations.data()), rotations.size() * sizeof(glm::quat));
+	}
+	bool written = static_cast<bool>(ofile);
+	ofile.close();
+	if (!written)
+		std::fprintf(stderr, "Trouble writing to '%s': Write failed.", path.c_str());
+	return written;
+}
+
+PoseClip::Clip PoseClip::fromPoses(const std::vector<PoseData::BonePawn>& poses, float frameRate) {
+	PROFILE_SCOPE("PoseClip::fromPoses");
+	Clip clip;
+	if (poses.empty())
+		return clip;
+	const PoseData::BonePawn& skeleton = poses.front();
+	float rate = frameRate > 0.0f ? frameRate : CLIP_DEFAULT_FRAME_RATE;
+	std::vector<ID> ids(skeleton.bones.size());
+	for (size_t i = 0; i < ids.size(); i++)
+		ids[i] = skeleton.bones[i].id;
+	/* keys are gathered track after track, every track is filled in frame order */
+	std::vector<std::vector<int>> matches(poses.size());
+	std::vector<int> sizes(ids.size(), 0);
+	std::vector<ID> otherIds;
+	for (size_t f = 0; f < poses.size(); f++) {
+		otherIds.resize(poses[f].bones.size());
+		for (size_t i = 0; i < otherIds.size(); i++)
+			otherIds[i] = poses[f].bones[i].id;
+		matches[f] = PoseBlend::matchBones(ids, otherIds);
+		for (size_t t = 0; t < ids.size(); t++)
+			sizes[t] += matches[f][t] >= 0 ? 1 : 0;
+	}
+	std::vector<float> times;
+	std::vector<glm::quat> rotations;
+	for (size_t t = 0; t < ids.size(); t++) {
+		for (size_t f = 0; f < poses.size(); f++) {
+			if (matches[f][t] < 0)
+				continue;
+			times.push_back(static_cast<float>(f) / rate);
+			rotations.push_back(poses[f].bones[matches[f][t]].quaternion);
+		}
+	}
+	clip.build(skeleton, sizes, std::move(times), std::move(rotations), rate);
+	return clip;
+}
@@ -0,0 +1,253 @@
+/// <title>Pose Clip</title>
+/// <desc>
+///		Animation clips: one skeleton shared by a track of rotation keys for each of its bones, and the clip files.
+///		CLIP_TIME_MAJOR selects the order in which the keys are stored, the files do not depend on it.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "PoseBlend.h"
+#include "PoseDataUtil.h"
+#include "RotationBatch.h"
+
+/// <summary>
+/// Storage order of the keys of PoseClip::Clip. 0 keeps the keys of every track together (bone-major), which suits work on
+/// single tracks such as sampling one bone or reducing keys. 1 sorts all keys by time with the tracks interleaved (time-major),
+/// so the keys of one frame are adjacent, which suits playing the whole skeleton forward. Override from the build settings.
+/// </summary>
+#ifndef CLIP_TIME_MAJOR
+#define CLIP_TIME_MAJOR 0
+#endif
+
+/// <summary>
+/// PoseClip stores sequences of poses. A clip holds its skeleton (ids, parents, names, offsets, limits and constraints) once,
+/// the frames only add rotation keys, so nothing of the skeleton is repeated per frame the way a pawn per frame would.
+/// </summary>
+namespace PoseClip {
+
+	/// <summary>
+	/// Single rotation key of a track.
+	/// </summary>
+	struct Key {
+		/// <summary>seconds from the start of the clip.</summary>
+		float time = 0.0f;
+		glm::quat rotation = glm::quat(1, 0, 0, 0);
+	};
+
+	/// <summary>
+	/// Format of a clip file. Text is a pose file of the skeleton followed by a line per key, Binary holds the same data
+	/// as raw arrays, which load without parsing.
+	/// </summary>
+	enum class ClipFormat { Text, Binary };
+
+	/// <summary>
+	/// Clip holds a skeleton and a track of rotation keys for every bone of it, tracks are indexed the same as skeleton.bones.
+	/// Bones with an empty track keep the rotation stored in the skeleton. All keys of the clip share two contiguous arrays,
+	/// ordered by CLIP_TIME_MAJOR. Keys of a track are reached in time order through keyIndex() in either layout.
+	/// </summary>
+	class Clip {
+	private:
+		/// <summary>bones of the clip. Their rotations are used by tracks without keys.</summary>
+		PoseData::BonePawn m_Skeleton;
+		/// <summary>frames per second the clip was recorded at, the timeline steps by its frames.</summary>
+		float m_FrameRate = 30.0f;
+		/// <summary>time of the last key of the clip.</summary>
+		float m_Duration = 0.0f;
+		/// <summary>first key of every track in time order, followed by the total amount of keys.</summary>
+		std::vector<int> m_TrackStart;
+		/// <summary>time of every key in storage order.</summary>
+		std::vector<float> m_Times;
+		/// <summary>rotation of every key in storage order.</summary>
+		std::vector<glm::quat> m_Rotations;
+#if CLIP_TIME_MAJOR
+		/// <summary>storage index of the keys of every track in time order, the ranges are given by m_TrackStart.</summary>
+		std::vector<int> m_TrackKeys;
+#endif
+		/// <summary>interpolation between the keys of every track.</summary>
+		std::vector<PoseData::Interpolation> m_Interpolation;
+		/// <summary>counts the rebuilds of the key arrays, samplers holding cursors into them compare it.</summary>
+		unsigned m_Revision = 0;
+
+		/// <summary>
+		/// Lays out keys listed track after track, each track sorted by time, in the storage order of CLIP_TIME_MAJOR.
+		/// </summary>
+		void layout(const std::vector<int>& trackSizes, std::vector<float>&& times, std::vector<glm::quat>&& rotations);
+
+	public:
+		/// <summary>
+		/// Replaces the clip by the skeleton and its tracks.
+		/// </summary>
+		/// <param name="tracks">keys of every bone of the skeleton in any order. Of keys sharing a time the last one is kept.</param>
+		/// <param name="frameRate">frames per second, non positive values are replaced by 30.</param>
+		void build(const PoseData::BonePawn& skeleton, const std::vector<std::vector<Key>>& tracks, float frameRate);
+		/// <summary>
+		/// Same as build() from tracks, with the keys listed track after track in flat arrays. Tracks not sorted by time are sorted.
+		/// </summary>
+		/// <param name="trackSizes">amount of keys of every bone of the skeleton.</param>
+		void build(const PoseData::BonePawn& skeleton, const std::vector<int>& trackSizes, std::vector<float> times,
+			std::vector<glm::quat> rotations, float frameRate);
+
+		/// <returns>bones of the clip.</returns>
+		const PoseData::BonePawn& getSkeleton() const;
+		/// <returns>amount of tracks, the same as the amount of bones of the skeleton.</returns>
+		int getTrackCount() const;
+		/// <returns>amount of keys of all tracks.</returns>
+		int getKeyCount() const;
+		/// <returns>amount of keys of the track.</returns>
+		int getKeyCount(int track) const;
+		/// <returns>frames per second.</returns>
+		float getFrameRate() const;
+		/// <returns>time of the last key, 0 for clips without keys.</returns>
+		float getDuration() const;
+		/// <returns>copy of the keys of the track in time order.</returns>
+		std::vector<Key> getTrack(int track) const;
+
+		/// <returns>storage index of the k-th key of the track in time order.</returns>
+		inline int keyIndex(int track, int k) const {
+#if CLIP_TIME_MAJOR
+			return m_TrackKeys[m_TrackStart[track] + k];
+#else
+			return m_TrackStart[track] + k;
+#endif
+		}
+		/// <returns>time of the k-th key of the track.</returns>
+		inline float getKeyTime(int track, int k) const { return m_Times[keyIndex(track, k)]; }
+		/// <returns>rotation of the k-th key of the track.</returns>
+		inline const glm::quat& getKeyRotation(int track, int k) const { return m_Rotations[keyIndex(track, k)]; }
+
+		/// <summary>
+		/// Finds the last key of the track at or before time by binary search.
+		/// </summary>
+		/// <returns>k of the key, -1 if the track is empty or its first key comes after time.</returns>
+		int findKey(int track, float time) const;
+		/// <summary>
+		/// Writes the pose held at time into rotations: every bone takes its last key at or before time (its first key before
+		/// the track starts) and bones without keys take the skeleton rotation. Sampler interpolates between the keys.
+		/// </summary>
+		/// <param name="rotations">resized to the track count, indexed the same as the skeleton's bones.</param>
+		void samplePose(float time, std::vector<glm::quat>& rotations) const;
+		/// <summary>
+		/// Keys every bone at time, replacing the keys already at that time. Rebuilds the key arrays.
+		/// </summary>
+		/// <param name="rotations">rotation of every bone, indexed the same as the skeleton's bones. Ignored if the sizes differ.</param>
+		void setPoseKeys(float time, const std::vector<glm::quat>& rotations);
+		/// <param name="frameRate">frames per second, non positive values are ignored.</param>
+		void setFrameRate(float frameRate);
+		/// <returns>interpolation between the keys of the track, Nlerp unless set.</returns>
+		PoseData::Interpolation getInterpolation(int track) const;
+		void setInterpolation(int track, PoseData::Interpolation interpolation);
+		/// <returns>changes whenever the key arrays are rebuilt, so the key indices held by a Sampler no longer apply.</returns>
+		unsigned getRevision() const;
+	};
+
+	/// <summary>
+	/// Sampler evaluates a clip at any time, interpolating every track by its own interpolation.
+	/// It keeps the key reached on every track (its cursor), a time past it is first looked for among the next few keys,
+	/// so playing forward costs a constant amount of work per track. Other jumps fall back to Clip::findKey().
+	/// The tracks to interpolate are gathered into preallocated lanes and blended with PoseBlend::blend, four per SSE2 step.
+	/// </summary>
+	class Sampler {
+	private:
+		const Clip* m_Clip = nullptr;
+		/// <summary>Clip::getRevision() the cursors were set for.</summary>
+		unsigned m_Revision = 0;
+		/// <summary>last key at or before the last sampled time for every track, -1 before the first key.</summary>
+		std::vector<int> m_Cursors;
+		/// <summary>binary searches done since the last reset().</summary>
+		long long m_Searches = 0;
+		/// <summary>tracks blended by each mode, with the keys around the time and the fraction between them.</summary>
+		std::vector<int> m_NlerpTracks, m_SlerpTracks;
+		RotationBatch::QuatLanes m_NlerpFrom, m_NlerpTo, m_NlerpResult, m_SlerpFrom, m_SlerpTo, m_SlerpResult;
+		std::vector<float> m_NlerpAlpha, m_SlerpAlpha;
+
+		/// <summary>
+		/// Moves the cursor of the track to the last key at or before time.
+		/// </summary>
+		int seek(int track, float time);
+		/// <summary>
+		/// Blends the gathered tracks of one mode into pose.
+		/// </summary>
+		void blendTracks(const std::vector<int>& tracks, RotationBatch::QuatLanes& from, RotationBatch::QuatLanes& to,
+			const std::vector<float>& alpha, RotationBatch::QuatLanes& result, PoseBlend::BlendMode mode, std::vector<glm::quat>& pose);
+
+	public:
+		Sampler() = default;
+		/// <param name="clip">has to outlive the sampler or the next bind().</param>
+		explicit Sampler(const Clip& clip);
+
+		/// <summary>
+		/// Samples clip from now on, the cursors start over.
+		/// </summary>
+		void bind(const Clip& clip);
+		/// <summary>
+		/// Forgets the cursors, the next sample searches every track.
+		/// </summary>
+		void reset();
+		/// <summary>
+		/// Writes the pose at time into pose. Tracks hold their first key before it and their last key after it,
+		/// bones without keys take the skeleton rotation. Nothing is allocated once the buffers have grown to the clip.
+		/// </summary>
+		/// <param name="pose">resized only if it does not hold the track count, indexed the same as the skeleton's bones.</param>
+		void sample(float time, std::vector<glm::quat>& pose);
+		/// <returns>binary searches done since the last bind() or reset().</returns>
+		long long getSearches() const;
+	};
+
+	/// <returns>lowercase name of the interpolation, as written in clip files.</returns>
+	const char* interpolationName(PoseData::Interpolation interpolation);
+	/// <summary>
+	/// Parses an interpolation name, ignoring surrounding spaces.
+	/// </summary>
+	/// <returns>true if name is one of the interpolationName() values.</returns>
+	bool parseInterpolation(const std::string& name, PoseData::Interpolation& interpolation);
+
+	// === File IO ===
+
+	/// <returns>Binary for paths ending with .clipb, Text otherwise.</returns>
+	ClipFormat formatOf(const std::string& path);
+
+	/// <summary>
+	/// Replaces the extension of path by the one of the format (.clip or .clipb), unless it already has one of them.
+	/// </summary>
+	std::string addExtension(std::string path, ClipFormat format);
+
+	/// <summary>
+	/// Reads a clip file in the format given by its extension.
+	/// Text files start with a "clip, [Frame Rate]" line, then list the skeleton in the pose file format, then the keys as
+	/// "key, [BoneID], [Time], [Quaternion X], [Quaternion Y], [Quaternion Z], [Quaternion W]" lines. Tracks not interpolated
+	/// by nlerp have a "track, [BoneID], [step|nlerp|slerp]" line among the keys.
+	/// </summary>
+	/// <param name="order">rotation order of the skeleton, its euler angles are derived in this order.</param>
+	/// <returns>parsed clip. When an error occurs, the skeleton of the returned clip has loaded set to false.</returns>
+	Clip openClip(const std::string& path, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
+
+	/// <summary>
+	/// Writes the clip into path in the given format. Keys are written track after track, in either layout.
+	/// </summary>
+	/// <returns>true if successful.</returns>
+	bool saveClip(const Clip& clip, const std::string& path, ClipFormat format);
+
+	/// <summary>
+	/// Builds a clip from a sequence of poses, frame k holding poses[k] at k / frameRate. The skeleton is taken from the first
+	/// pose, bones of the other poses are matched to it by ID. Bones missing in a pose get no key on its frame.
+	/// </summary>
+	Clip fromPoses(const std::vector<PoseData::BonePawn>& poses, float frameRate);
+}
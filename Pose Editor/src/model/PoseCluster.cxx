@@ -0,0 +1,346 @@
+/// <title>Pose Cluster</title>
+/// <desc>
+///		Clustering and deduplication of the poses of a library by their similarity.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>poses per parallel chunk when assigning poses to clusters, and clusters per chunk when moving the centers.</summary>
+#define ASSIGN_GRAIN 1024
+#define CENTER_GRAIN 4
+/// <summary>poses of the k-means++ sample per cluster, and the smallest sample.</summary>
+#define SEED_FACTOR 16
+#define SEED_MINIMUM 4096
+/// <summary>range queries of deduplication run at once per thread. More queries waste work on poses an earlier one takes.</summary>
+#define DEDUP_QUERIES_PER_THREAD 2
+#define MAPPING_SUFFIX "_clusters.csv"
+
+#include "PoseCluster.h"
+
+/// <summary>
+/// Picks the initial centers by k-means++ among a sample of poses spread evenly over the library: every next center is drawn
+/// with a probability proportional to the squared distance from the centers so far.
+/// </summary>
+/// <param name="centers">receives the feature block of every center.</param>
+static void seedCenters(const PoseSearch::Features& features, const std::vector<float>& blocks, int poseCount, int clusterCount, std::vector<float>& centers) {
+	int stride = features.getStride();
+	int sampleCount = std::min(poseCount, std::max(clusterCount * SEED_FACTOR, SEED_MINIMUM));
+	std::vector<int> sample(sampleCount);
+	for (int s = 0; s < sampleCount; s++)
+		sample[s] = static_cast<int>(static_cast<long long>(s) * poseCount / sampleCount);
+	unsigned int seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) * (1.0 / 16777216.0);
+	};
+
+	centers.assign(static_cast<size_t>(clusterCount) * stride, 0.0f);
+	std::vector<float> nearest(sampleCount, std::numeric_limits<float>::infinity());
+	std::vector<char> taken(sampleCount, 0);
+	int chosen = static_cast<int>(random() * sampleCount);
+	for (int c = 0; c < clusterCount; c++) {
+		taken[chosen] = 1;
+		float* center = centers.data() + static_cast<size_t>(c) * stride;
+		std::copy(blocks.begin() + static_cast<size_t>(sample[chosen]) * stride, blocks.begin() + static_cast<size_t>(sample[chosen] + 1) * stride, center);
+		Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(sampleCount), ASSIGN_GRAIN, [&](size_t begin, size_t end) {
+			for (size_t s = begin; s < end; s++)
+				nearest[s] = std::min(nearest[s], features.chordSum(blocks.data() + static_cast<size_t>(sample[s]) * stride, center));
+		});
+		double total = 0.0;
+		for (float squared : nearest)
+			total += squared;
+		/* once every sampled pose sits on a center, the remaining centers take the next sampled poses */
+		if (total <= 0.0) {
+			chosen = static_cast<int>(std::find(taken.begin(), taken.end(), 0) - taken.begin());
+			if (chosen == sampleCount)
+				chosen = 0;
+			continue;
+		}
+		double target = random() * total, cumulative = 0.0;
+		chosen = sampleCount - 1;
+		for (int s = 0; s < sampleCount; s++) {
+			cumulative += nearest[s];
+			if (cumulative > target) {
+				chosen = s;
+				break;
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Numbers the non-empty clusters in the order of their representatives and measures the distance of every pose to its representative.
+/// </summary>
+/// <param name="closest">distance of every pose to its cluster's center, the representative is the closest pose.</param>
+static PoseCluster::Result finishClusters(const PoseSearch::Features& features, const std::vector<float>& blocks, std::vector<int>& clusters,
+	const std::vector<float>& closest, int clusterCount, int iterations) {
+	int stride = features.getStride();
+	std::vector<int> representative(clusterCount, -1);
+	for (int p = 0; p < static_cast<int>(clusters.size()); p++) {
+		int& current = representative[clusters[p]];
+		if (current < 0 || closest[p] < closest[current])
+			current = p;
+	}
+	PoseCluster::Result result;
+	result.iterations = iterations;
+	for (int pose : representative) {
+		if (pose >= 0)
+			result.representatives.push_back(pose);
+	}
+	std::sort(result.representatives.begin(), result.representatives.end());
+	std::vector<int> number(clusterCount, -1);
+	for (int c = 0; c < static_cast<int>(result.representatives.size()); c++)
+		number[clusters[result.representatives[c]]] = c;
+	result.clusters.resize(clusters.size());
+	result.distances.resize(clusters.size());
+	Parallel::ThreadPool::shared().parallelFor(clusters.size(), ASSIGN_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; p++) {
+			result.clusters[p] = number[clusters[p]];
+			int pose = result.representatives[result.clusters[p]];
+			result.distances[p] = PoseSearch::toDegrees(features.distance(blocks.data() + p * stride, blocks.data() + static_cast<size_t>(pose) * stride));
+		}
+	});
+	return result;
+}
+
+PoseCluster::Result PoseCluster::kMeans(const PoseLibrary::Library& library, const PoseSearch::Settings& settings, int clusterCount, int maxIterations) {
+	PROFILE_SCOPE("PoseCluster::kMeans");
+	PoseSearch::Features features;
+	int poseCount = library.getPoseCount();
+	if (poseCount == 0 || clusterCount <= 0 || !features.setup(library.getSkeleton(), settings))
+		return Result();
+	int count = std::min(clusterCount, poseCount), stride = features.getStride();
+	std::vector<int> poses(poseCount);
+	for (int p = 0; p < poseCount; p++)
+		poses[p] = p;
+	std::vector<float> blocks, centers, moved(static_cast<size_t>(count) * stride);
+	features.extract(library, poses, blocks);
+	seedCenters(features, blocks, poseCount, count, centers);
+	auto block = [&](int pose) { return blocks.data() + static_cast<size_t>(pose) * stride; };
+	auto center = [&](int cluster) { return centers.data() + static_cast<size_t>(cluster) * stride; };
+
+	/* upper bounds the distance to the own center, lower the distance to any other center */
+	std::vector<int> clusters(poseCount, 0), members, first(count + 1);
+	std::vector<float> upper(poseCount, std::numeric_limits<float>::infinity()), lower(poseCount, 0.0f), half(count), shift(count);
+	int iterations = 0;
+	while (iterations < maxIterations) {
+		iterations++;
+		/* a center closer than half the distance to every other center is the closest one */
+		Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(count), CENTER_GRAIN, [&](size_t begin, size_t end) {
+			for (size_t c = begin; c < end; c++) {
+				float smallest = std::numeric_limits<float>::infinity();
+				for (int other = 0; other < count; other++) {
+					if (other != static_cast<int>(c))
+						smallest = std::min(smallest, features.distance(center(static_cast<int>(c)), center(other)));
+				}
+				half[c] = smallest * 0.5f;
+			}
+		});
+		std::atomic<int> changed{ 0 };
+		Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(poseCount), ASSIGN_GRAIN, [&](size_t begin, size_t end) {
+			int changes = 0;
+			for (size_t p = begin; p < end; p++) {
+				int own = clusters[p];
+				float bound = std::max(half[own], lower[p]);
+				if (upper[p] <= bound)
+					continue;
+				upper[p] = features.distance(block(static_cast<int>(p)), center(own));
+				if (upper[p] <= bound)
+					continue;
+				int best = own;
+				float bestDistance = upper[p], second = std::numeric_limits<float>::infinity();
+				for (int c = 0; c < count; c++) {
+					if (c == own)
+						continue;
+					float distance = features.distance(block(static_cast<int>(p)), center(c));
+					if (distance < bestDistance) {
+						second = bestDistance;
+						bestDistance = distance;
+						best = c;
+					}
+					else if (distance < second) {
+						second = distance;
+					}
+				}
+				changes += best != own;
+				clusters[p] = best;
+				upper[p] = bestDistance;
+				lower[p] = second;
+			}
+			changed += changes;
+		});
+		if (changed == 0 && iterations > 1)
+			break;
+
+		/* the poses of every cluster side by side, so a cluster's center is averaged by one thread in pose order */
+		std::fill(first.begin(), first.end(), 0);
+		for (int cluster : clusters)
+			first[cluster + 1]++;
+		for (int c = 0; c < count; c++)
+			first[c + 1] += first[c];
+		members.resize(poseCount);
+		std::vector<int> next(first.begin(), first.end() - 1);
+		for (int p = 0; p < poseCount; p++)
+			members[next[clusters[p]]++] = p;
+		Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(count), CENTER_GRAIN, [&](size_t begin, size_t end) {
+			std::vector<double> sum(stride);
+			for (size_t c = begin; c < end; c++) {
+				const float* old = center(static_cast<int>(c));
+				float* updated = moved.data() + c * stride;
+				std::copy(old, old + stride, updated);
+				if (first[c] == first[c + 1])
+					continue;
+				std::fill(sum.begin(), sum.end(), 0.0);
+				for (int m = first[c]; m < first[c + 1]; m++) {
+					const float* pose = block(members[m]);
+					for (int g = 0; g < stride; g += 16) {
+						for (int l = 0; l < 4; l++) {
+							float dot = old[g + l] * pose[g + l] + old[g + 4 + l] * pose[g + 4 + l] + old[g + 8 + l] * pose[g + 8 + l] + old[g + 12 + l] * pose[g + 12 + l];
+							double sign = dot < 0.0f ? -1.0 : 1.0;
+							for (int component = l; component < 16; component += 4)
+								sum[g + component] += sign * pose[g + component];
+						}
+					}
+				}
+				for (int g = 0; g < stride; g += 16) {
+					for (int l = 0; l < 4; l++) {
+						double length = std::sqrt(sum[g + l] * sum[g + l] + sum[g + 4 + l] * sum[g + 4 + l] + sum[g + 8 + l] * sum[g + 8 + l] + sum[g + 12 + l] * sum[g + 12 + l]);
+						if (length <= 0.0)
+							continue;
+						for (int component = l; component < 16; component += 4)
+							updated[g + component] = static_cast<float>(sum[g + component] / length);
+					}
+				}
+			}
+		});
+		for (int c = 0; c < count; c++)
+			shift[c] = features.distance(center(c), moved.data() + static_cast<size_t>(c) * stride);
+		centers.swap(moved);
+
+		/* centers moved by shift, the bounds widen by as much */
+		int farthest = static_cast<int>(std::max_element(shift.begin(), shift.end()) - shift.begin());
+		float largest = shift[farthest], secondLargest = 0.0f;
+		for (int c = 0; c < count; c++) {
+			if (c != farthest)
+				secondLargest = std::max(secondLargest, shift[c]);
+		}
+		Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(poseCount), ASSIGN_GRAIN, [&](size_t begin, size_t end) {
+			for (size_t p = begin; p < end; p++) {
+				upper[p] += shift[clusters[p]];
+				lower[p] = std::max(lower[p] - (clusters[p] == farthest ? secondLargest : largest), 0.0f);
+			}
+		});
+	}
+
+	std::vector<float> closest(poseCount);
+	Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(poseCount), ASSIGN_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; p++)
+			closest[p] = features.distance(block(static_cast<int>(p)), center(clusters[p]));
+	});
+	return finishClusters(features, blocks, clusters, closest, count, iterations);
+}
+
+PoseCluster::Result PoseCluster::deduplicate(const PoseLibrary::Library& library, const PoseSearch::Settings& settings, float threshold) {
+	PROFILE_SCOPE("PoseCluster::deduplicate");
+	PoseSearch::Index index;
+	int poseCount = library.getPoseCount();
+	if (poseCount == 0 || !index.build(library, settings))
+		return Result();
+	/* clusters are numbered as their representatives start them, in library order, and the distances to a representative
+	   come from its query */
+	Result result;
+	result.iterations = 1;
+	std::vector<int>& clusters = result.clusters;
+	clusters.assign(poseCount, -1);
+	result.distances.assign(poseCount, 0.0f);
+	int batch = Parallel::ThreadPool::shared().getThreadCount() * DEDUP_QUERIES_PER_THREAD;
+	std::vector<int> candidates;
+	std::vector<std::vector<PoseSearch::Match>> found(batch);
+	int clusterCount = 0, cursor = 0;
+	while (true) {
+		candidates.clear();
+		for (; cursor < poseCount && static_cast<int>(candidates.size()) < batch; cursor++) {
+			if (clusters[cursor] < 0)
+				candidates.push_back(cursor);
+		}
+		if (candidates.empty())
+			break;
+		Parallel::ThreadPool::shared().parallelFor(candidates.size(), 1, [&](size_t begin, size_t end) {
+			std::vector<glm::quat> rotations;
+			for (size_t i = begin; i < end; i++) {
+				library.getPose(candidates[i], rotations);
+				found[i] = index.search(rotations, 0, threshold);
+			}
+		});
+		/* a candidate taken by an earlier one of the batch drops its query */
+		for (size_t i = 0; i < candidates.size(); i++) {
+			if (clusters[candidates[i]] >= 0)
+				continue;
+			clusters[candidates[i]] = clusterCount;
+			result.representatives.push_back(candidates[i]);
+			for (const PoseSearch::Match& match : found[i]) {
+				if (clusters[match.pose] < 0) {
+					clusters[match.pose] = clusterCount;
+					result.distances[match.pose] = match.distance;
+				}
+			}
+			clusterCount++;
+		}
+	}
+	return result;
+}
+
+PoseLibrary::Library PoseCluster::representatives(const PoseLibrary::Library& library, const Result& result) {
+	PROFILE_SCOPE("PoseCluster::representatives");
+	PoseLibrary::Library reduced;
+	reduced.reset(library.getSkeleton());
+	reduced.reserve(result.representatives.size());
+	std::vector<glm::quat> rotations;
+	for (int pose : result.representatives) {
+		library.getPose(pose, rotations);
+		reduced.addPose(rotations, library.getName(pose));
+	}
+	return reduced;
+}
+
+PoseData::ClusterReport PoseCluster::summarize(const Result& result) {
+	PoseData::ClusterReport report;
+	report.posesBefore = static_cast<int>(result.clusters.size());
+	report.posesAfter = static_cast<int>(result.representatives.size());
+	report.iterations = result.iterations;
+	double sum = 0.0;
+	for (float distance : result.distances) {
+		report.maxDistance = std::max(report.maxDistance, distance);
+		sum += distance;
+	}
+	report.meanDistance = result.distances.empty() ? 0.0f : static_cast<float>(sum / result.distances.size());
+	return report;
+}
+
+bool PoseCluster::saveMapping(const PoseLibrary::Library& library, const Result& result, const std::string& path) {
+	PROFILE_SCOPE("PoseCluster::saveMapping");
+	std::ofstream ofile(path.c_str(), std::ios::out);
+	if (!ofile.is_open()) {
+		std::fprintf(stderr, "Trouble writing to '%s': Could not open file.", path.c_str());
+		return false;
+	}
+	char line[64];
+	for (size_t p = 0; p < result.clusters.size(); p++) {
+		int cluster = result.clusters[p];
+		std::snprintf(line, sizeof(line), "%zu, %d, %d, %.4f, ", p, cluster, result.representatives[cluster], result.distances[p]);
+		ofile << line << library.getName(static_cast<int>(p)) << "\n";
+	}
+	ofile.close();
+	return static_cast<bool>(ofile);
+}
+
+std::string PoseCluster::mappingPath(std::string libraryPath) {
+	if (libraryPath.empty())
+		return libraryPath;
+	size_t last = libraryPath.find_last_of('.');
+	if (last != std::string::npos && last > libraryPath.find_last_of("/\\") + 1)
+		libraryPath = libraryPath.substr(0, last);
+	return libraryPath.append(MAPPING_SUFFIX);
+}
@@ -0,0 +1,86 @@
+/// <title>Pose Cluster</title>
+/// <desc>
+///		Clustering and deduplication of the poses of a library by their similarity.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../parallel/ThreadPool.h"
+#include "../profiler/Profiler.h"
+#include "PoseLibrary.h"
+#include "PoseSearch.h"
+
+/// <summary>
+/// PoseCluster groups the poses of a library, so a few representative poses can stand in for many similar ones. Poses are
+/// compared by the features and distance of PoseSearch. Every cluster is represented by one of its own poses, so the
+/// representatives are captured poses rather than averages.
+/// </summary>
+namespace PoseCluster {
+
+	/// <summary>
+	/// Poses of a library grouped into clusters, numbered in the order of their representatives.
+	/// </summary>
+	struct Result {
+		/// <summary>library pose representing every cluster, ascending.</summary>
+		std::vector<int> representatives;
+		/// <summary>cluster of every pose of the library.</summary>
+		std::vector<int> clusters;
+		/// <summary>distance in degrees from every pose to the representative of its cluster, see PoseSearch::toDegrees().</summary>
+		std::vector<float> distances;
+		/// <summary>passes of k-means, 1 for deduplication.</summary>
+		int iterations = 0;
+	};
+
+	/// <summary>
+	/// Splits the poses into clusters by k-means on their features. A cluster's center averages every rotation of the feature
+	/// over its poses, flipping the quaternions to the side of the previous center, which is the mean minimizing the squared
+	/// chords. Centers start by k-means++ on a sample of the poses. Poses are assigned in parallel, skipping the poses whose
+	/// bounds (Hamerly's) show their center is still the closest after the centers moved. A cluster is represented by its pose
+	/// closest to the center. Gives the same result for any amount of threads.
+	/// </summary>
+	/// <param name="clusterCount">amount of clusters, at most the amount of poses. Clusters left without poses are dropped.</param>
+	/// <param name="maxIterations">most passes, fewer when no pose changes its cluster.</param>
+	/// <returns>the clusters, empty if the library is or none of the key bones is in the skeleton.</returns>
+	Result kMeans(const PoseLibrary::Library& library, const PoseSearch::Settings& settings, int clusterCount, int maxIterations = 100);
+
+	/// <summary>
+	/// Collapses the poses within threshold of each other. Poses are taken in library order, a pose not yet in a cluster
+	/// starts one and takes every free pose within threshold of it, found by a PoseSearch::Index. Range queries of the next
+	/// free poses run in parallel and are applied in order, which gives the same result as taking them one at a time.
+	/// </summary>
+	/// <param name="threshold">largest distance in degrees from a pose to its representative.</param>
+	/// <returns>the clusters, empty if the library is or none of the key bones is in the skeleton.</returns>
+	Result deduplicate(const PoseLibrary::Library& library, const PoseSearch::Settings& settings, float threshold);
+
+	/// <returns>library of the representative poses in cluster order, on the same skeleton and under the same names.</returns>
+	PoseLibrary::Library representatives(const PoseLibrary::Library& library, const Result& result);
+
+	/// <returns>amount of poses and clusters, and the distances of the poses to their representatives.</returns>
+	PoseData::ClusterReport summarize(const Result& result);
+
+	/// <summary>
+	/// Writes the cluster of every pose as csv, a line per pose of the library: pose, cluster, representative pose, distance
+	/// in degrees, name.
+	/// </summary>
+	/// <returns>true if successful.</returns>
+	bool saveMapping(const PoseLibrary::Library& library, const Result& result, const std::string& path);
+
+	/// <returns>path of the mapping kept next to the library at the path, its extension replaced by _clusters.csv. Empty for an empty path.</returns>
+	std::string mappingPath(std::string libraryPath);
+}
@@ -0,0 +1,251 @@
+/// <title>Pose Constraints</title>
+/// <desc>
+///		Dependency graph of bone constraints, evaluated incrementally downstream of edited bones.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>length of the twist part below which a rotation is a pure half turn swing and has no defined twist.</summary>
+#define TWIST_EPSILON 1e-6f
+
+#include "PoseConstraints.h"
+
+/// <summary>
+/// Splits a rotation into twist about the local Y axis and the swing of that axis, rotation = swing * twist.
+/// </summary>
+/// <returns>twist half angle in radians, within [-pi/2, pi/2].</returns>
+static float splitTwist(glm::quat rotation, glm::quat* swing) {
+	rotation = glm::normalize(rotation);
+	if (rotation.w < 0.0f)
+		rotation = -rotation;
+	float length = std::sqrt(rotation.w * rotation.w + rotation.y * rotation.y);
+	glm::quat twist = length < TWIST_EPSILON ? glm::quat(1, 0, 0, 0) : glm::quat(rotation.w / length, 0, rotation.y / length, 0);
+	if (swing)
+		*swing = QuatSimd::mul(rotation, glm::conjugate(twist));
+	return std::atan2(twist.y, twist.w);
+}
+
+const char* PoseConstraints::typeName(ConstraintType type) {
+	switch (type) {
+	case ConstraintType::Free: return "free";
+	case ConstraintType::CopyRotation: return "copy";
+	case ConstraintType::Twist: return "twist";
+	case ConstraintType::AimAt: return "aim";
+	}
+	return "";
+}
+
+bool PoseConstraints::parseType(const std::string& name, ConstraintType& type) {
+	size_t begin = name.find_first_not_of(" \t\r\n"), end = name.find_last_not_of(" \t\r\n");
+	std::string trimmed = begin == std::string::npos ? "" : name.substr(begin, end - begin + 1);
+	for (ConstraintType candidate : { ConstraintType::Free, ConstraintType::CopyRotation, ConstraintType::Twist, ConstraintType::AimAt }) {
+		if (trimmed == typeName(candidate)) {
+			type = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+void PoseConstraints::ConstraintGraph::build(const PoseData::BonePawn& pawn, const PoseKinematics::FKOrder& order) {
+	PROFILE_SCOPE("PoseConstraints::build");
+	int count = static_cast<int>(pawn.bones.size());
+	m_Driven.clear();
+	m_Driver.clear();
+	m_Level.clear();
+	m_Rejected.clear();
+	m_DependentStart.assign(count + 1, 0);
+	m_Dependents.clear();
+
+	std::unordered_map<ID, int> index;
+	index.reserve(count);
+	for (int i = 0; i < count; i++)
+		index.emplace(pawn.bones[i].id, i);
+
+	/* candidate nodes in pawn order with the bones every one of them reads */
+	std::vector<int> driven, drivers, inputStart(1, 0), inputs;
+	for (int coord = 0; coord < count; coord++) {
+		const PoseData::BoneConstraint& constraint = pawn.bones[coord].constraint;
+		if (constraint.type == ConstraintType::Free)
+			continue;
+		auto found = index.find(constraint.driver);
+		if (found == index.end() || found->second == coord) {
+			m_Rejected.push_back(pawn.bones[coord].id);
+			continue;
+		}
+		int driver = found->second;
+		size_t first = inputs.size();
+		inputs.push_back(driver);
+		inputs.push_back(coord);
+		if (constraint.type == ConstraintType::AimAt) {
+			/* joint positions follow from the rotations of all ancestors, an aim at its own descendant would chase itself */
+			bool below = false;
+			for (int slot = order.parents[order.slots[driver]]; slot >= 0; slot = order.parents[slot]) {
+				inputs.push_back(order.bones[slot]);
+				below = below || order.bones[slot] == coord;
+			}
+			for (int slot = order.parents[order.slots[coord]]; slot >= 0; slot = order.parents[slot])
+				inputs.push_back(order.bones[slot]);
+			if (below) {
+				inputs.resize(first);
+				m_Rejected.push_back(pawn.bones[coord].id);
+				continue;
+			}
+			std::sort(inputs.begin() + first, inputs.end());
+			inputs.erase(std::unique(inputs.begin() + first, inputs.end()), inputs.end());
+		}
+		driven.push_back(coord);
+		drivers.push_back(driver);
+		inputStart.push_back(static_cast<int>(inputs.size()));
+	}
+
+	/* Kahn's algorithm: a node is ready once every node driving a bone it reads is placed */
+	int nodes = static_cast<int>(driven.size());
+	std::vector<int> nodeOf(count, -1), readers(count + 1, 0), reader(inputs.size()), pending(nodes, 0), level(nodes, 0);
+	for (int n = 0; n < nodes; n++)
+		nodeOf[driven[n]] = n;
+	for (int n = 0; n < nodes; n++) {
+		for (int k = inputStart[n]; k < inputStart[n + 1]; k++) {
+			readers[inputs[k] + 1]++;
+			if (nodeOf[inputs[k]] >= 0 && nodeOf[inputs[k]] != n)
+				pending[n]++;
+		}
+	}
+	for (int i = 0; i < count; i++)
+		readers[i + 1] += readers[i];
+	{
+		std::vector<int> fill(readers.begin(), readers.end() - 1);
+		for (int n = 0; n < nodes; n++)
+			for (int k = inputStart[n]; k < inputStart[n + 1]; k++)
+				reader[fill[inputs[k]]++] = n;
+	}
+	std::vector<int> ready, placed;
+	for (int n = 0; n < nodes; n++)
+		if (pending[n] == 0)
+			ready.push_back(n);
+	while (!ready.empty()) {
+		int n = ready.back();
+		ready.pop_back();
+		placed.push_back(n);
+		for (int k = readers[driven[n]]; k < readers[driven[n] + 1]; k++) {
+			int next = reader[k];
+			if (next == n)
+				continue;
+			level[next] = std::max(level[next], level[n] + 1);
+			if (--pending[next] == 0)
+				ready.push_back(next);
+		}
+	}
+	/* whatever was never placed is part of a cycle or reads from one */
+	for (int n = 0; n < nodes; n++)
+		if (pending[n] > 0)
+			m_Rejected.push_back(pawn.bones[driven[n]].id);
+
+	/* number the nodes by level, keeping the pawn order within a level */
+	std::sort(placed.begin(), placed.end(), [&](int a, int b) { return level[a] != level[b] ? level[a] < level[b] : a < b; });
+	m_Driven.resize(placed.size());
+	m_Driver.resize(placed.size());
+	m_Level.resize(placed.size());
+	for (size_t i = 0; i < placed.size(); i++) {
+		int n = placed[i];
+		m_Driven[i] = driven[n];
+		m_Driver[i] = drivers[n];
+		m_Level[i] = level[n];
+		for (int k = inputStart[n]; k < inputStart[n + 1]; k++)
+			m_DependentStart[inputs[k] + 1]++;
+	}
+	for (int i = 0; i < count; i++)
+		m_DependentStart[i + 1] += m_DependentStart[i];
+	m_Dependents.resize(m_DependentStart[count]);
+	std::vector<int> fill(m_DependentStart.begin(), m_DependentStart.end() - 1);
+	for (size_t i = 0; i < placed.size(); i++) {
+		int n = placed[i];
+		for (int k = inputStart[n]; k < inputStart[n + 1]; k++)
+			m_Dependents[fill[inputs[k]]++] = static_cast<int>(i);
+	}
+	m_Mark.assign(placed.size(), 0);
+	m_Stamp = 0;
+}
+
+size_t PoseConstraints::ConstraintGraph::size() const {
+	return m_Driven.size();
+}
+
+const std::vector<ID>& PoseConstraints::ConstraintGraph::getRejected() const {
+	return m_Rejected;
+}
+
+void PoseConstraints::ConstraintGraph::collect(const std::vector<int>& edited, std::vector<int>& nodes) {
+	nodes.clear();
+	if (m_Driven.empty())
+		return;
+	if (++m_Stamp == 0) {
+		std::fill(m_Mark.begin(), m_Mark.end(), 0);
+		m_Stamp = 1;
+	}
+	int count = static_cast<int>(m_DependentStart.size()) - 1;
+	m_Queue.assign(edited.begin(), edited.end());
+	while (!m_Queue.empty()) {
+		int coord = m_Queue.back();
+		m_Queue.pop_back();
+		if (coord < 0 || coord >= count)
+			continue;
+		for (int k = m_DependentStart[coord]; k < m_DependentStart[coord + 1]; k++) {
+			int node = m_Dependents[k];
+			if (m_Mark[node] == m_Stamp)
+				continue;
+			m_Mark[node] = m_Stamp;
+			nodes.push_back(node);
+			m_Queue.push_back(m_Driven[node]);
+		}
+	}
+	std::sort(nodes.begin(), nodes.end());
+}
+
+void PoseConstraints::ConstraintGraph::collectAll(std::vector<int>& nodes) const {
+	nodes.resize(m_Driven.size());
+	for (size_t i = 0; i < nodes.size(); i++)
+		nodes[i] = static_cast<int>(i);
+}
+
+int PoseConstraints::ConstraintGraph::getDriven(int node) const {
+	return m_Driven[node];
+}
+
+int PoseConstraints::ConstraintGraph::getLevel(int node) const {
+	return m_Level[node];
+}
+
+glm::quat PoseConstraints::ConstraintGraph::evaluate(int node, const PoseData::BonePawn& pawn, const PoseKinematics::FKOrder& order,
+	const std::vector<glm::quat>& global, const PoseKinematics::JointPositions& positions) const {
+	int coord = m_Driven[node];
+	const PoseData::BoneData& bone = pawn.bones[coord];
+	const PoseData::BoneData& driver = pawn.bones[m_Driver[node]];
+	float factor = bone.constraint.factor;
+	switch (bone.constraint.type) {
+	case ConstraintType::CopyRotation: {
+		glm::quat rotation = glm::normalize(driver.quaternion);
+		if (rotation.w < 0.0f)
+			rotation = -rotation;
+		return factor == 1.0f ? rotation : glm::normalize(glm::slerp(glm::quat(1, 0, 0, 0), rotation, factor));
+	}
+	case ConstraintType::Twist: {
+		float half = splitTwist(driver.quaternion, nullptr) * factor;
+		glm::quat swing;
+		splitTwist(bone.quaternion, &swing);
+		return glm::normalize(QuatSimd::mul(swing, glm::quat(std::cos(half), 0, std::sin(half), 0)));
+	}
+	case ConstraintType::AimAt: {
+		int slot = order.slots[coord], parent = order.parents[slot];
+		glm::quat parentGlobal = parent >= 0 ? global[parent] : glm::quat(1, 0, 0, 0);
+		glm::quat current = glm::normalize(QuatSimd::mul(parentGlobal, bone.quaternion));
+		glm::vec3 direction = positions.get(order.slots[m_Driver[node]]) - positions.get(slot);
+		glm::quat turn = PoseIK::rotationBetween(QuatSimd::rotate(current, glm::vec3(0, 1, 0)), direction);
+		return glm::normalize(QuatSimd::mul(glm::conjugate(parentGlobal), QuatSimd::mul(turn, current)));
+	}
+	default:
+		return bone.quaternion;
+	}
+}
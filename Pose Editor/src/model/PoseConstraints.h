@@ -0,0 +1,110 @@
+/// <title>Pose Constraints</title>
+/// <desc>
+///		Dependency graph of bone constraints, evaluated incrementally downstream of edited bones.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+#include "PoseKinematics.h"
+#include "PoseIK.h"
+
+/// <summary>
+/// PoseConstraints orders the constrained bones of a pawn so that every constraint is evaluated after everything it reads.
+/// A constraint reads the rotation of its driver and of its own bone, an aim also reads the joint positions of both, which
+/// depend on all their ancestors. Constraints are grouped into levels: a constraint only reads bones driven by lower levels,
+/// so the constraints of one level can be evaluated at the same time.
+/// </summary>
+namespace PoseConstraints {
+
+	using PoseData::ConstraintType;
+	using PoseData::BoneConstraint;
+
+	/// <returns>name of the type as written in the pose file.</returns>
+	const char* typeName(ConstraintType type);
+
+	/// <summary>
+	/// Reads a type written by typeName(), surrounding whitespace is ignored.
+	/// </summary>
+	/// <returns>false if the name is not known.</returns>
+	bool parseType(const std::string& name, ConstraintType& type);
+
+	/// <summary>
+	/// Constrained bones of a pawn in evaluation order (nodes) along with the bones each of them reads.
+	/// Offsets into pawn.bones are called coords, same as in the Model.
+	/// </summary>
+	class ConstraintGraph {
+	private:
+		/// <summary>constrained bone of every node. Nodes are sorted by level.</summary>
+		std::vector<int> m_Driven;
+		/// <summary>driver of every node.</summary>
+		std::vector<int> m_Driver;
+		/// <summary>level of every node, one more than the highest level of the nodes it reads from.</summary>
+		std::vector<int> m_Level;
+		/// <summary>nodes reading every bone, m_Dependents[m_DependentStart[coord] .. m_DependentStart[coord + 1]).</summary>
+		std::vector<int> m_DependentStart;
+		std::vector<int> m_Dependents;
+		/// <summary>IDs of constrained bones left out of the graph.</summary>
+		std::vector<ID> m_Rejected;
+		/// <summary>m_Mark[node] == m_Stamp for the nodes already collected by the running collect().</summary>
+		std::vector<unsigned> m_Mark;
+		unsigned m_Stamp = 0;
+		/// <summary>bones whose dependents collect() has yet to visit.</summary>
+		std::vector<int> m_Queue;
+
+	public:
+		/// <summary>
+		/// Builds the graph of all constraints of the pawn. Constraints with a missing driver, driving themselves, aiming at
+		/// their own descendant or taking part in (or reading from) a cycle are rejected and never evaluated.
+		/// </summary>
+		/// <param name="order">evaluation order of the pawn's hierarchy, used to find the ancestors read by aims.</param>
+		void build(const PoseData::BonePawn& pawn, const PoseKinematics::FKOrder& order);
+
+		/// <returns>amount of nodes.</returns>
+		size_t size() const;
+
+		/// <returns>IDs of the constrained bones rejected by the last build().</returns>
+		const std::vector<ID>& getRejected() const;
+
+		/// <summary>
+		/// Collects the nodes to re-evaluate after the given bones changed, which are all nodes reading them directly or through
+		/// other nodes. Takes time proportional to the nodes collected and the bones they read.
+		/// </summary>
+		/// <param name="edited">coords of the changed bones.</param>
+		/// <param name="nodes">receives the nodes in evaluation order.</param>
+		void collect(const std::vector<int>& edited, std::vector<int>& nodes);
+
+		/// <param name="nodes">receives every node in evaluation order.</param>
+		void collectAll(std::vector<int>& nodes) const;
+
+		/// <returns>coord of the bone the node constrains.</returns>
+		int getDriven(int node) const;
+
+		/// <returns>level of the node. The nodes of a level only read bones that no node of that level writes.</returns>
+		int getLevel(int node) const;
+
+		/// <summary>
+		/// Evaluates the constraint of a node. Reads but does not change the pawn, so all nodes of a level may be evaluated
+		/// concurrently. Joint limits are not applied.
+		/// </summary>
+		/// <param name="global">global rotations in slot order, up to date for the ancestors of aiming bones.</param>
+		/// <param name="positions">joint positions in slot order, up to date for aiming bones and their drivers.</param>
+		/// <returns>new local rotation of the constrained bone.</returns>
+		glm::quat evaluate(int node, const PoseData::BonePawn& pawn, const PoseKinematics::FKOrder& order,
+			const std::vector<glm::quat>& global, const PoseKinematics::JointPositions& positions) const;
+	};
+}
@@ -8,6 +8,10 @@
 /// <author>David Hrusa</author>
 /// <email>hrusadav@gmail.com</email>
 
+#define UNDO_LIMIT 32
+/// <summary>constraints of one level evaluated per task, smaller levels are evaluated on the calling thread.</summary>
+#define CONSTRAINT_GRAIN 256
+
 #include "PoseDataModel.h"
 
 inline void PoseModel::PoseModel::delta() {
@@ -15,6 +19,288 @@ inline void PoseModel::PoseModel::delta() {
 	m_BonePawn.saved = false;
 }
 
+inline void PoseModel::PoseModel::deltaStructure() {
+	delta();
+	m_PoseRevision++;
+	m_StructureRevision++;
+	m_PawnDelta.structure = true;
+	m_BoneIndexValid = false;
+	m_FKValid = false;
+	m_ConstraintsValid = false;
+}
+
+inline void PoseModel::PoseModel::deltaLabel(ID boneid) {
+	delta();
+	m_PawnDelta.labels.push_back(boneid);
+}
+
+inline void PoseModel::PoseModel::deltaRotation(ID boneid) {
+	delta();
+	m_PoseRevision++;
+	m_PawnDelta.rotations.push_back(boneid);
+}
+
+inline void PoseModel::PoseModel::deltaOffset(ID boneid) {
+	delta();
+	m_PawnDelta.offsets.push_back(boneid);
+}
+
+inline void PoseModel::PoseModel::deltaLimit(ID boneid) {
+	delta();
+	m_PawnDelta.limits.push_back(boneid);
+}
+
+inline void PoseModel::PoseModel::deltaConstraint(ID boneid) {
+	delta();
+	m_PawnDelta.constraints.push_back(boneid);
+}
+
+/// <returns>true if every field of the bones is the same.</returns>
+static bool sameBone(const PoseData::BoneData& a, const PoseData::BoneData& b) {
+	return a.id == b.id && a.parent == b.parent && a.quaternion == b.quaternion && a.eulerRotation == b.eulerRotation &&
+		a.displayName == b.displayName && a.offset == b.offset && a.limit.swing == b.limit.swing && a.limit.twistMin == b.limit.twistMin &&
+		a.limit.twistMax == b.limit.twistMax && a.constraint.type == b.constraint.type && a.constraint.driver == b.constraint.driver &&
+		a.constraint.factor == b.constraint.factor;
+}
+
+void PoseModel::PoseModel::openStep() {
+	if (m_StepOpen)
+		return; // the transaction already holds the state from before its first command.
+	m_Step = UndoStep();
+	m_StepOpen = true;
+}
+
+void PoseModel::PoseModel::recordBone(int coord) {
+	recordBone(coord, m_BonePawn.bones[coord]);
+}
+
+void PoseModel::PoseModel::recordBone(int coord, const PoseData::BoneData& before) {
+	if (!m_StepOpen || m_Step.structure)
+		return;
+	if (m_StepMarked.size() < m_BonePawn.bones.size())
+		m_StepMarked.resize(m_BonePawn.bones.size(), false);
+	if (m_StepMarked[coord])
+		return;
+	m_StepMarked[coord] = true;
+	m_Step.coords.push_back(coord);
+	m_Step.bones.push_back(before);
+}
+
+void PoseModel::PoseModel::recordStructure() {
+	if (!m_StepOpen || m_Step.structure)
+		return;
+	/* the whole pawn as it was when the step opened: the bones recorded so far hold their state from then */
+	std::vector<PoseData::BoneData> bones = m_BonePawn.bones;
+	for (size_t i = 0; i < m_Step.coords.size(); i++) {
+		bones[m_Step.coords[i]] = std::move(m_Step.bones[i]);
+		m_StepMarked[m_Step.coords[i]] = false;
+	}
+	m_Step.structure = true;
+	m_Step.coords.clear();
+	m_Step.bones = std::move(bones);
+}
+
+void PoseModel::PoseModel::snapshotRotations() {
+	m_StepRotations.resize(m_BonePawn.bones.size());
+	m_StepEulers.resize(m_BonePawn.bones.size());
+	for (size_t i = 0; i < m_BonePawn.bones.size(); i++) {
+		m_StepRotations[i] = m_BonePawn.bones[i].quaternion;
+		m_StepEulers[i] = m_BonePawn.bones[i].eulerRotation;
+	}
+}
+
+void PoseModel::PoseModel::recordRotations() {
+	for (size_t i = 0; i < m_BonePawn.bones.size(); i++) {
+		const PoseData::BoneData& bone = m_BonePawn.bones[i];
+		if (bone.quaternion == m_StepRotations[i] && bone.eulerRotation == m_StepEulers[i])
+			continue;
+		PoseData::BoneData before = bone;
+		before.quaternion = m_StepRotations[i];
+		before.eulerRotation = m_StepEulers[i];
+		recordBone(static_cast<int>(i), before);
+	}
+}
+
+bool PoseModel::PoseModel::closeStep() {
+	if (!m_StepOpen || m_EditDepth > 0)
+		return false;
+	m_StepOpen = false;
+	for (int coord : m_Step.coords)
+		m_StepMarked[coord] = false;
+	if (!dropUnchanged(m_Step))
+		return false;
+	m_UndoStack.push_back(std::move(m_Step));
+	if (m_UndoStack.size() > UNDO_LIMIT)
+		m_UndoStack.pop_front();
+	m_RedoStack.clear();
+	return true;
+}
+
+bool PoseModel::PoseModel::dropUnchanged(UndoStep& step) {
+	if (step.structure) {
+		return step.bones.size() != m_BonePawn.bones.size() ||
+			!std::equal(step.bones.begin(), step.bones.end(), m_BonePawn.bones.begin(), sameBone);
+	}
+	size_t kept = 0;
+	for (size_t i = 0; i < step.coords.size(); i++) {
+		if (sameBone(step.bones[i], m_BonePawn.bones[step.coords[i]]))
+			continue;
+		if (kept != i) {
+			step.coords[kept] = step.coords[i];
+			step.bones[kept] = std::move(step.bones[i]);
+		}
+		kept++;
+	}
+	step.coords.resize(kept);
+	step.bones.resize(kept);
+	return kept > 0;
+}
+
+void PoseModel::PoseModel::swapStep(UndoStep& step) {
+	if (step.structure) {
+		std::swap(m_BonePawn.bones, step.bones);
+		return;
+	}
+	for (size_t i = 0; i < step.coords.size(); i++)
+		std::swap(m_BonePawn.bones[step.coords[i]], step.bones[i]);
+}
+
+void PoseModel::PoseModel::clearUndo() {
+	m_UndoStack.clear();
+	m_RedoStack.clear();
+	m_EditDepth = 0;
+	m_Step = UndoStep();
+	m_StepOpen = false;
+	m_StepMarked.clear();
+	m_EditBones.clear();
+}
+
+int PoseModel::PoseModel::findBone(ID boneid) {
+	if (!m_BoneIndexValid) {
+		m_BoneIndex.clear();
+		m_BoneIndex.reserve(m_BonePawn.bones.size());
+		// emplace keeps the first bone with a given id, same as PoseDataUtil::pawnFindBoneId
+		for (int i = 0; i < m_BonePawn.bones.size(); i++)
+			m_BoneIndex.emplace(m_BonePawn.bones[i].id, i);
+		m_BoneIndexValid = true;
+	}
+	auto found = m_BoneIndex.find(boneid);
+	return found != m_BoneIndex.end() ? found->second : -1;
+}
+
+void PoseModel::PoseModel::dirtyKinematics(int coord) {
+	if (!m_FKValid)
+		return; // the next update rebuilds everything anyway
+	int slot = m_FKOrder.slots[coord];
+	m_FKLocal[slot] = m_BonePawn.bones[coord].quaternion;
+	m_FKOffsets.set(slot, m_BonePawn.bones[coord].offset);
+	if (!m_FKDirtyFlag[slot]) {
+		m_FKDirtyFlag[slot] = true;
+		m_FKDirty.push_back(slot);
+	}
+}
+
+void PoseModel::PoseModel::dirtyKinematicsAll() {
+	if (!m_FKValid)
+		return;
+	PoseKinematics::gatherLocal(m_BonePawn, m_FKOrder, m_FKLocal);
+	PoseKinematics::gatherOffsets(m_BonePawn, m_FKOrder, m_FKOffsets);
+	for (int slot = 0; slot < static_cast<int>(m_FKOrder.parents.size()); slot++) {
+		if (m_FKOrder.parents[slot] < 0 && !m_FKDirtyFlag[slot]) {
+			m_FKDirtyFlag[slot] = true;
+			m_FKDirty.push_back(slot);
+		}
+	}
+}
+
+int PoseModel::PoseModel::updateKinematics() {
+	if (!m_FKValid) {
+		m_FKOrder = PoseKinematics::buildOrder(m_BonePawn);
+		PoseKinematics::gatherLocal(m_BonePawn, m_FKOrder, m_FKLocal);
+		PoseKinematics::evaluate(m_FKOrder, m_FKLocal, m_FKGlobal);
+		PoseKinematics::gatherOffsets(m_BonePawn, m_FKOrder, m_FKOffsets);
+		PoseKinematics::evaluatePositions(m_FKOrder, m_FKGlobal, m_FKOffsets, m_FKPositions);
+		m_FKDirty.clear();
+		m_FKDirtyFlag.assign(m_FKOrder.bones.size(), false);
+		m_FKValid = true;
+		return static_cast<int>(m_FKOrder.bones.size());
+	}
+	if (m_FKDirty.empty())
+		return 0;
+	/* in slot order a dirty bone either lies inside the subtree evaluated last or starts a new one */
+	std::sort(m_FKDirty.begin(), m_FKDirty.end());
+	int covered = 0, updated = 0;
+	for (int slot : m_FKDirty) {
+		m_FKDirtyFlag[slot] = false;
+		if (slot < covered)
+			continue;
+		covered = m_FKOrder.subtreeEnd[slot];
+		PoseKinematics::evaluate(m_FKOrder, m_FKLocal, m_FKGlobal, slot, covered);
+		PoseKinematics::evaluatePositions(m_FKOrder, m_FKGlobal, m_FKOffsets, m_FKPositions, slot, covered);
+		updated += covered - slot;
+	}
+	m_FKDirty.clear();
+	return updated;
+}
+
+void PoseModel::PoseModel::evaluateConstraints(const std::vector<int>& edited) {
+	if (!m_ConstraintsValid) {
+		updateKinematics(); // the graph follows the hierarchy of the FK order
+		m_Constraints.build(m_BonePawn, m_FKOrder);
+		m_ConstraintsValid = true;
+	}
+	m_Constraints.collect(edited, m_ConstraintNodes);
+	evaluateConstraintNodes();
+}
+
+void PoseModel::PoseModel::evaluateConstraints() {
+	if (!m_ConstraintsValid) {
+		updateKinematics();
+		m_Constraints.build(m_BonePawn, m_FKOrder);
+		m_ConstraintsValid = true;
+	}
+	m_Constraints.collectAll(m_ConstraintNodes);
+	evaluateConstraintNodes();
+}
+
+void PoseModel::PoseModel::evaluateConstraintNodes() {
+	m_ConstraintsEvaluated = static_cast<int>(m_ConstraintNodes.size());
+	if (m_ConstraintNodes.empty())
+		return;
+	PROFILE_SCOPE("PoseModel::evaluateConstraints");
+	size_t begin = 0;
+	while (begin < m_ConstraintNodes.size()) {
+		int level = m_Constraints.getLevel(m_ConstraintNodes[begin]);
+		size_t end = begin;
+		bool aims = false;
+		for (; end < m_ConstraintNodes.size() && m_Constraints.getLevel(m_ConstraintNodes[end]) == level; end++)
+			aims = aims || m_BonePawn.bones[m_Constraints.getDriven(m_ConstraintNodes[end])].constraint.type == PoseData::ConstraintType::AimAt;
+		/* aims read joint positions, which have to include what the lower levels wrote */
+		if (aims)
+			updateKinematics();
+		size_t count = end - begin;
+		m_ConstraintResults.resize(count);
+		Parallel::ThreadPool::shared().parallelFor(count, CONSTRAINT_GRAIN, [&](size_t first, size_t last) {
+			for (size_t k = first; k < last; k++)
+				m_ConstraintResults[k] = m_Constraints.evaluate(m_ConstraintNodes[begin + k], m_BonePawn, m_FKOrder, m_FKGlobal, m_FKPositions);
+		});
+		/* written back on this thread, the nodes of a level never read each other's bones */
+		for (size_t k = 0; k < count; k++) {
+			int coord = m_Constraints.getDriven(m_ConstraintNodes[begin + k]);
+			PoseData::BoneData& bone = m_BonePawn.bones[coord];
+			glm::quat rotation = PoseLimits::clamp(m_ConstraintResults[k], bone.limit);
+			if (rotation == bone.quaternion)
+				continue;
+			recordBone(coord);
+			deltaRotation(bone.id);
+			bone.quaternion = rotation;
+			bone.eulerRotation = PoseDataUtil::quatToEuler(rotation, m_BonePawn.rotationOrder);
+			dirtyKinematics(coord);
+		}
+		begin = end;
+	}
+}
+
 bool PoseModel::PoseModel::boneInRange(int boneid) {
 	return boneid < m_BonePawn.bones.size() && boneid >= 0;
 }
@@ -24,15 +310,71 @@ bool PoseModel::PoseModel::isDelta() {
 }
 void PoseModel::PoseModel::resetDelta() {
 	m_Delta = false;
+	m_PawnDelta.structure = false;
+	m_PawnDelta.labels.clear();
+	m_PawnDelta.rotations.clear();
+	m_PawnDelta.offsets.clear();
+	m_PawnDelta.limits.clear();
+	m_PawnDelta.constraints.clear();
+}
+
+const PoseData::PawnDelta& PoseModel::PoseModel::getDelta() {
+	return m_PawnDelta;
+}
+
+unsigned long long PoseModel::PoseModel::getPoseRevision() {
+	return m_PoseRevision;
+}
+
+unsigned long long PoseModel::PoseModel::getStructureRevision() {
+	return m_StructureRevision;
 }
 
 const PoseData::BonePawn& PoseModel::PoseModel::getCurrentPawn() {
 	return m_BonePawn;
 }
 
+glm::quat PoseModel::PoseModel::getGlobalRotation(ID boneid) {
+	updateKinematics();
+	int coord = findBone(boneid);
+	return coord >= 0 ? m_FKGlobal[m_FKOrder.slots[coord]] : glm::quat(1, 0, 0, 0);
+}
+
+glm::vec3 PoseModel::PoseModel::getJointPosition(ID boneid) {
+	updateKinematics();
+	int coord = findBone(boneid);
+	return coord >= 0 ? m_FKPositions.get(m_FKOrder.slots[coord]) : glm::vec3(0, 0, 0);
+}
+
+const PoseKinematics::JointPositions& PoseModel::PoseModel::getJointPositions() {
+	updateKinematics();
+	return m_FKPositions;
+}
+
+const PoseKinematics::FKOrder& PoseModel::PoseModel::getKinematicOrder() {
+	updateKinematics();
+	return m_FKOrder;
+}
+
+const std::vector<ID>& PoseModel::PoseModel::getRejectedConstraints() {
+	if (!m_ConstraintsValid) {
+		updateKinematics();
+		m_Constraints.build(m_BonePawn, m_FKOrder);
+		m_ConstraintsValid = true;
+	}
+	return m_Constraints.getRejected();
+}
+
+int PoseModel::PoseModel::getConstraintsEvaluated() const {
+	return m_ConstraintsEvaluated;
+}
+
 void PoseModel::PoseModel::cmdSetPawn(PoseData::BonePawn pawn) {
 	m_BonePawn = pawn;
-	delta();
+	PoseLimits::clampPawn(m_BonePawn); // rotations coming from elsewhere may break the limits of the pawn.
+	clearUndo(); // a different pawn does not share history with the previous one.
+	deltaStructure();
+	evaluateConstraints();
 }
 
 void PoseModel::PoseModel::cmdSetFilePath(std::string path) {
@@ -55,84 +397,303 @@ void PoseModel::PoseModel::cmdSetSaved(bool arg) {
 	m_Delta = true;
 }
 
+void PoseModel::PoseModel::cmdSetRotationOrder(PoseData::RotationOrder order) {
+	if (order == m_BonePawn.rotationOrder)
+		return;
+	if (m_EditDepth > 0) {
+		m_EditDepth = 1;
+		cmdCommitEdit();
+	}
+	m_BonePawn.rotationOrder = order;
+	RotationBatch::pawnQuatToEuler(m_BonePawn);
+	/* bones of the history are restored as they are, they have to present the same angles */
+	for (UndoStep& step : m_UndoStack)
+		RotationBatch::bonesQuatToEuler(step.bones, order);
+	for (UndoStep& step : m_RedoStack)
+		RotationBatch::bonesQuatToEuler(step.bones, order);
+	/* every euler angle changed, but neither the quaternions nor the file contents did */
+	m_Delta = true;
+	m_PawnDelta.structure = true;
+}
+
+void PoseModel::PoseModel::cmdBeginEdit() {
+	if (m_EditDepth++ == 0) {
+		openStep();
+		m_EditSaved = m_BonePawn.saved;
+		m_EditBones.clear();
+	}
+}
+
+void PoseModel::PoseModel::cmdCommitEdit() {
+	if (m_EditDepth == 0 || --m_EditDepth > 0)
+		return;
+	/* an edit ending where it began leaves neither an undo step nor an unsaved pawn behind */
+	if (!closeStep()) {
+		m_BonePawn.saved = m_EditSaved;
+		m_Delta = true;
+		m_EditBones.clear();
+		return;
+	}
+	/* observers may have skipped the bones being edited, so report their final state once more */
+	for (ID boneid : m_EditBones)
+		deltaRotation(boneid);
+	m_EditBones.clear();
+}
+
+void PoseModel::PoseModel::cmdUndo() {
+	if (m_UndoStack.empty() || m_EditDepth > 0)
+		return;
+	UndoStep step = std::move(m_UndoStack.back());
+	m_UndoStack.pop_back();
+	swapStep(step);
+	m_RedoStack.push_back(std::move(step));
+	deltaStructure();
+}
+
+void PoseModel::PoseModel::cmdRedo() {
+	if (m_RedoStack.empty() || m_EditDepth > 0)
+		return;
+	UndoStep step = std::move(m_RedoStack.back());
+	m_RedoStack.pop_back();
+	swapStep(step);
+	m_UndoStack.push_back(std::move(step));
+	deltaStructure();
+}
+
 void PoseModel::PoseModel::cmdBoneAdd(ID parentid) {
-	delta();
+	openStep();
+	recordStructure();
 	PoseData::BoneData bone;
 	bone.id = PoseDataUtil::getUniqueBoneId(m_BonePawn);
 	bone.parent = parentid;
 	bone.displayName = PoseDataUtil::getUniqueBoneName(m_BonePawn);
-	if (parentid > 0) {
-		int parentCoord = PoseDataUtil::pawnFindBoneId(m_BonePawn, parentid);
-		if (parentCoord >= 0) {
-			parentCoord += parentCoord < m_BonePawn.bones.size() ? 1 : 0;
-			m_BonePawn.bones.insert(m_BonePawn.bones.begin() + parentCoord, bone);
-			return;
-		}
+	int parentCoord = parentid > 0 ? findBone(parentid) : -1;
+	if (parentCoord >= 0) {
+		parentCoord += parentCoord < m_BonePawn.bones.size() ? 1 : 0;
+		m_BonePawn.bones.insert(m_BonePawn.bones.begin() + parentCoord, bone);
 	}
-	m_BonePawn.bones.push_back(bone);
+	else {
+		m_BonePawn.bones.push_back(bone);
+	}
+	deltaStructure(); // after the insertion, so the bone index is rebuilt with the new bone.
+	closeStep();
 }
 void PoseModel::PoseModel::cmdBoneRemove(ID boneid) {
-	int coord = PoseDataUtil::pawnFindBoneId(m_BonePawn, boneid);
+	int coord = findBone(boneid);
 	if (coord >= 0) { // found
+		openStep();
+		recordStructure();
 		/* first set any child node's parent to the deleted node's parent */
 		auto children = PoseDataUtil::pawnGetBoneChildren(m_BonePawn, boneid);
 		for (auto child : children) {
 			m_BonePawn.bones[child].parent = m_BonePawn.bones[coord].parent;
 		}
 		m_BonePawn.bones.erase(m_BonePawn.bones.begin() + coord);
-		m_Delta = true;
+		deltaStructure();
+		closeStep();
 	}
 }
 void PoseModel::PoseModel::cmdBoneMoveUp(ID boneid) {
-	int coord = PoseDataUtil::pawnFindBoneId(m_BonePawn, boneid);
+	int coord = findBone(boneid);
 	if (coord > 0) { // not the first element
+		openStep();
+		recordStructure();
 		PoseData::BoneData tmp = m_BonePawn.bones[coord];
 		m_BonePawn.bones[coord] = m_BonePawn.bones[coord - 1];
 		m_BonePawn.bones[coord - 1] = tmp;
-		delta();
+		deltaStructure();
+		closeStep();
 	}
 }
 void PoseModel::PoseModel::cmdBoneMoveDown(ID boneid) {
-	int coord = PoseDataUtil::pawnFindBoneId(m_BonePawn, boneid);
+	int coord = findBone(boneid);
 	if (coord >= 0 && coord < (m_BonePawn.bones.size() - 1)) { // not the last element
+		openStep();
+		recordStructure();
 		PoseData::BoneData tmp = m_BonePawn.bones[coord];
 		m_BonePawn.bones[coord] = m_BonePawn.bones[coord + 1];
 		m_BonePawn.bones[coord + 1] = tmp;
-		delta();
+		deltaStructure();
+		closeStep();
 	}
 }
 
 void PoseModel::PoseModel::cmdBoneSetRotation(ID boneid, glm::vec3 euler) {
-	int coord = PoseDataUtil::pawnFindBoneId(m_BonePawn, boneid);
+	int coord = findBone(boneid);
 	if (coord >= 0) { // found
-		delta();
+		openStep();
+		recordBone(coord);
+		deltaRotation(boneid);
+		if (m_EditDepth > 0 && std::find(m_EditBones.begin(), m_EditBones.end(), boneid) == m_EditBones.end())
+			m_EditBones.push_back(boneid);
 		m_BonePawn.bones[coord].eulerRotation = euler;
-		m_BonePawn.bones[coord].quaternion = PoseDataUtil::eulerToQuat(m_BonePawn.bones[coord].eulerRotation);
+		m_BonePawn.bones[coord].quaternion = PoseLimits::clamp(PoseDataUtil::eulerToQuat(m_BonePawn.bones[coord].eulerRotation, m_BonePawn.rotationOrder),
+			m_BonePawn.bones[coord].limit);
 		/* The next steo is a little redundant, but the idea is to expose any edge cases in quaternion/euler conversion
 		instead of concealing them and saving corrupt data into the file. This way it will propagate back to UI immediately.*/
-		m_BonePawn.bones[coord].eulerRotation = PoseDataUtil::quatToEuler(m_BonePawn.bones[coord].quaternion);
+		m_BonePawn.bones[coord].eulerRotation = PoseDataUtil::quatToEuler(m_BonePawn.bones[coord].quaternion, m_BonePawn.rotationOrder);
+		dirtyKinematics(coord);
+		evaluateConstraints({ coord });
+		closeStep();
 	}
 }
 void PoseModel::PoseModel::cmdBoneSetName(ID boneid, std::string name) {
-	int coord = PoseDataUtil::pawnFindBoneId(m_BonePawn, boneid);
+	int coord = findBone(boneid);
 	int nameCoord = PoseDataUtil::pawnFindBoneName(m_BonePawn, name);
 	if (coord >= 0 && nameCoord < 0) { // found && name not used
-		delta();
+		openStep();
+		recordBone(coord);
+		deltaLabel(boneid);
 		m_BonePawn.bones[coord].displayName = name;
+		closeStep();
 	}
 }
 
 void PoseModel::PoseModel::cmdBoneSetParent(ID boneid, ID parentid) {
-	int coord = PoseDataUtil::pawnFindBoneId(m_BonePawn, boneid);
+	int coord = findBone(boneid);
 	if (coord >= 0) { // found
 		/* only set it if it won't create an infinite loop */
 		auto originalParent = m_BonePawn.bones[coord].parent;
 		m_BonePawn.bones[coord].parent = parentid;
-		if (PoseDataUtil::pawnTestBoneParentLoop(m_BonePawn, boneid)) {
-			delta();
+		bool valid = PoseDataUtil::pawnTestBoneParentLoop(m_BonePawn, boneid);
+		m_BonePawn.bones[coord].parent = originalParent;
+		if (valid) {
+			openStep();
+			recordBone(coord);
+			m_BonePawn.bones[coord].parent = parentid;
+			deltaLabel(boneid);
+			m_FKValid = false; // the evaluation order follows the hierarchy
+			m_ConstraintsValid = false; // so do the dependencies of aims
+			evaluateConstraints({ coord });
+			closeStep();
 		}
-		else {
-			m_BonePawn.bones[coord].parent = originalParent;
+	}
+}
+
+void PoseModel::PoseModel::cmdBoneSetOffset(ID boneid, glm::vec3 offset) {
+	int coord = findBone(boneid);
+	if (coord >= 0 && m_BonePawn.bones[coord].offset != offset) { // found && moved
+		openStep();
+		recordBone(coord);
+		deltaOffset(boneid);
+		m_BonePawn.bones[coord].offset = offset;
+		dirtyKinematics(coord);
+		evaluateConstraints({ coord });
+		closeStep();
+	}
+}
+
+void PoseModel::PoseModel::cmdPawnSetRotations(const std::vector<glm::quat>& rotations) {
+	if (rotations.empty() || rotations.size() != m_BonePawn.bones.size())
+		return;
+	openStep();
+	snapshotRotations();
+	for (size_t i = 0; i < rotations.size(); i++) {
+		m_BonePawn.bones[i].quaternion = rotations[i];
+		deltaRotation(m_BonePawn.bones[i].id);
+	}
+	PoseLimits::clampPawn(m_BonePawn);
+	RotationBatch::pawnQuatToEuler(m_BonePawn);
+	recordRotations();
+	dirtyKinematicsAll();
+	evaluateConstraints();
+	closeStep();
+}
+
+void PoseModel::PoseModel::cmdPawnPlayRotations(const std::vector<glm::quat>& rotations) {
+	if (rotations.empty() || rotations.size() != m_BonePawn.bones.size() || m_EditDepth > 0)
+		return;
+	bool saved = m_BonePawn.saved;
+	for (size_t i = 0; i < rotations.size(); i++) {
+		if (m_BonePawn.bones[i].quaternion == rotations[i])
+			continue;
+		m_BonePawn.bones[i].quaternion = rotations[i];
+		deltaRotation(m_BonePawn.bones[i].id);
+	}
+	RotationBatch::pawnQuatToEuler(m_BonePawn);
+	dirtyKinematicsAll();
+	evaluateConstraints();
+	m_BonePawn.saved = saved;
+}
+
+void PoseModel::PoseModel::cmdBonesSetRotations(const std::vector<ID>& boneids, const std::vector<glm::quat>& rotations) {
+	if (boneids.empty() || boneids.size() != rotations.size())
+		return;
+	openStep();
+	std::vector<int> edited;
+	edited.reserve(boneids.size());
+	for (size_t i = 0; i < boneids.size(); i++) {
+		int coord = findBone(boneids[i]);
+		if (coord < 0)
+			continue;
+		edited.push_back(coord);
+		recordBone(coord);
+		deltaRotation(boneids[i]);
+		if (m_EditDepth > 0 && std::find(m_EditBones.begin(), m_EditBones.end(), boneids[i]) == m_EditBones.end())
+			m_EditBones.push_back(boneids[i]);
+		m_BonePawn.bones[coord].quaternion = PoseLimits::clamp(rotations[i], m_BonePawn.bones[coord].limit);
+		m_BonePawn.bones[coord].eulerRotation = PoseDataUtil::quatToEuler(m_BonePawn.bones[coord].quaternion, m_BonePawn.rotationOrder);
+		dirtyKinematics(coord);
+	}
+	evaluateConstraints(edited);
+	closeStep();
+}
+
+void PoseModel::PoseModel::cmdBoneSetLimit(ID boneid, PoseData::JointLimit limit) {
+	int coord = findBone(boneid);
+	if (coord < 0)
+		return;
+	limit = PoseLimits::sanitize(limit);
+	PoseData::BoneData& bone = m_BonePawn.bones[coord];
+	if (bone.limit.swing != limit.swing || bone.limit.twistMin != limit.twistMin || bone.limit.twistMax != limit.twistMax) { // changed
+		openStep();
+		recordBone(coord);
+		deltaLimit(boneid);
+		bone.limit = limit;
+		/* the current rotation has to respect the new limit right away */
+		bool clamped;
+		glm::quat rotation = PoseLimits::clamp(bone.quaternion, limit, &clamped);
+		if (clamped) {
+			deltaRotation(boneid);
+			bone.quaternion = rotation;
+			bone.eulerRotation = PoseDataUtil::quatToEuler(rotation, m_BonePawn.rotationOrder);
+			dirtyKinematics(coord);
+			evaluateConstraints({ coord });
 		}
+		closeStep();
+	}
+}
+
+int PoseModel::PoseModel::cmdClampToLimits() {
+	/* the pass clamps in place, only the rotations from before it are kept for the clamped bones */
+	snapshotRotations();
+	std::vector<int> changed;
+	if (PoseLimits::clampPawn(m_BonePawn, &changed) == 0)
+		return 0;
+	openStep();
+	recordRotations();
+	for (int coord : changed) {
+		deltaRotation(m_BonePawn.bones[coord].id);
+		dirtyKinematics(coord);
 	}
-}
\ No newline at end of file
+	evaluateConstraints(changed);
+	closeStep();
+	return static_cast<int>(changed.size());
+}
+
+void PoseModel::PoseModel::cmdBoneSetConstraint(ID boneid, PoseData::BoneConstraint constraint) {
+	int coord = findBone(boneid);
+	if (coord < 0)
+		return;
+	PoseData::BoneConstraint& current = m_BonePawn.bones[coord].constraint;
+	if (current.type != constraint.type || current.driver != constraint.driver || current.factor != constraint.factor) { // changed
+		openStep();
+		recordBone(coord);
+		deltaConstraint(boneid);
+		current = constraint;
+		m_ConstraintsValid = false;
+		/* the bone reads itself, so its own constraint is evaluated along with everything reading the bone */
+		evaluateConstraints({ coord });
+		closeStep();
+	}
+}
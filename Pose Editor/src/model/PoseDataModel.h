@@ -13,6 +13,14 @@
 #include "../ModelInterface.h"
 #include "../PoseData.h"
 #include "PoseDataUtil.h"
+#include "PoseKinematics.h"
+#include "PoseConstraints.h"
+#include "../parallel/ThreadPool.h"
+
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 #include <glm/vec3.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -29,10 +37,145 @@ namespace PoseModel {
 		PoseData::BonePawn m_BonePawn = { {}, "","", false };
 		/// <summary>true if model values have changed.</summary>
 		bool m_Delta = false;
+		/// <summary>which bones changed since the last resetDelta().</summary>
+		PoseData::PawnDelta m_PawnDelta;
+		/// <summary>count of the changes to the bones or rotations, see getPoseRevision().</summary>
+		unsigned long long m_PoseRevision = 0;
+		/// <summary>count of the changes to the bone set, see getStructureRevision().</summary>
+		unsigned long long m_StructureRevision = 0;
+		/// <summary>
+		/// Bones changed by an undoable command or transaction, as they were before it. Undoing swaps them with the bones of
+		/// the pawn, which turns the step into its redo step.
+		/// </summary>
+		struct UndoStep {
+			/// <summary>true if bones were added, removed or reordered. bones then holds the whole pawn and coords is empty.</summary>
+			bool structure = false;
+			/// <summary>offset in the pawn of every bone in bones.</summary>
+			std::vector<int> coords;
+			std::vector<PoseData::BoneData> bones;
+		};
+		/// <summary>steps of the undoable commands and transactions. The newest step is at the back.</summary>
+		std::deque<UndoStep> m_UndoStack;
+		/// <summary>steps reverted by cmdUndo(). Cleared by any new undoable command.</summary>
+		std::vector<UndoStep> m_RedoStack;
+		/// <summary>step recorded by the command or transaction in progress, while m_StepOpen.</summary>
+		UndoStep m_Step;
+		bool m_StepOpen = false;
+		/// <summary>true for the offsets of the bones already in m_Step, indexed by offset in the pawn.</summary>
+		std::vector<bool> m_StepMarked;
+		/// <summary>rotations and euler angles of every bone before a command changing many of them, see recordRotations().</summary>
+		std::vector<glm::quat> m_StepRotations;
+		std::vector<glm::vec3> m_StepEulers;
+		/// <summary>nesting depth of cmdBeginEdit() transactions. 0 when no transaction is open.</summary>
+		int m_EditDepth = 0;
+		/// <summary>saved flag of the pawn when the outermost transaction began, kept if the transaction changes nothing.</summary>
+		bool m_EditSaved = false;
+		/// <summary>bones rotated during the open transaction. Reported in the delta once more on commit.</summary>
+		std::vector<ID> m_EditBones;
+		/// <summary>maps bone ID to its offset in the pawn. Rebuilt on demand after structural changes.</summary>
+		std::unordered_map<ID, int> m_BoneIndex;
+		/// <summary>false if m_BoneIndex has to be rebuilt before use.</summary>
+		bool m_BoneIndexValid = false;
+		/// <summary>evaluation order of the cached forward kinematics.</summary>
+		PoseKinematics::FKOrder m_FKOrder;
+		/// <summary>false if the hierarchy changed and the whole FK cache has to be rebuilt.</summary>
+		bool m_FKValid = false;
+		/// <summary>local rotations of the bones in FK slot order.</summary>
+		std::vector<glm::quat> m_FKLocal;
+		/// <summary>global rotations of the bones in FK slot order. Stale within the subtrees of m_FKDirty.</summary>
+		std::vector<glm::quat> m_FKGlobal;
+		/// <summary>offsets of the bones in FK slot order.</summary>
+		PoseKinematics::JointPositions m_FKOffsets;
+		/// <summary>world space joint positions in FK slot order. Stale within the subtrees of m_FKDirty.</summary>
+		PoseKinematics::JointPositions m_FKPositions;
+		/// <summary>slots whose rotation or offset changed since the last updateKinematics(). Their whole subtree is stale.</summary>
+		std::vector<int> m_FKDirty;
+		/// <summary>true for slots already listed in m_FKDirty.</summary>
+		std::vector<bool> m_FKDirtyFlag;
+		/// <summary>evaluation order of the constraints of the pawn.</summary>
+		PoseConstraints::ConstraintGraph m_Constraints;
+		/// <summary>false if the hierarchy or a constraint changed and m_Constraints has to be rebuilt.</summary>
+		bool m_ConstraintsValid = false;
+		/// <summary>nodes of m_Constraints to evaluate, reused between commands.</summary>
+		std::vector<int> m_ConstraintNodes;
+		/// <summary>rotations computed for the nodes of a single level.</summary>
+		std::vector<glm::quat> m_ConstraintResults;
+		/// <summary>amount of constraints evaluated by the last command.</summary>
+		int m_ConstraintsEvaluated = 0;
 		/// <returns>true if pawn contains given bone.</returns>
 		bool boneInRange(int boneid);
 		/// <summary>marks dirty bits for delta and saved.</summary>
 		inline void delta();
+		/// <summary>marks dirty bits and records that bones were replaced, added, removed or reordered.</summary>
+		inline void deltaStructure();
+		/// <summary>marks dirty bits and records that the given bone's id, name or parent changed.</summary>
+		inline void deltaLabel(ID boneid);
+		/// <summary>marks dirty bits and records that the given bone's rotation changed.</summary>
+		inline void deltaRotation(ID boneid);
+		/// <summary>marks dirty bits and records that the given bone's offset changed.</summary>
+		inline void deltaOffset(ID boneid);
+		/// <summary>marks dirty bits and records that the given bone's rotation limits changed.</summary>
+		inline void deltaLimit(ID boneid);
+		/// <summary>marks dirty bits and records that the given bone's constraint changed.</summary>
+		inline void deltaConstraint(ID boneid);
+		/// <summary>
+		/// Call when an undoable command begins changing the pawn. Opens m_Step, unless the open transaction holds it already.
+		/// </summary>
+		void openStep();
+		/// <summary>
+		/// Call right before the open step's command changes the bone at the offset. Stores the bone once per step, later
+		/// changes of the bone within the step keep its first state. Does nothing while no step is open.
+		/// </summary>
+		void recordBone(int coord);
+		/// <summary>
+		/// Same as recordBone(), for a bone which changed already: stores before as the bone at the offset.
+		/// </summary>
+		void recordBone(int coord, const PoseData::BoneData& before);
+		/// <summary>
+		/// Call right before the open step's command adds, removes or reorders bones. The step then holds the whole pawn.
+		/// </summary>
+		void recordStructure();
+		/// <summary>
+		/// Keeps the rotation and euler angles of every bone, for a command about to change many of them at once.
+		/// </summary>
+		void snapshotRotations();
+		/// <summary>
+		/// Records every bone whose rotation or euler angles differ from snapshotRotations(), as it was then.
+		/// Call before the constraints are evaluated, they record the bones they drive themselves.
+		/// </summary>
+		void recordRotations();
+		/// <summary>
+		/// Call when an undoable command is done. Pushes m_Step to the undo stack, without the bones it left as they were,
+		/// unless a transaction holds the step open. A step left without bones is dropped.
+		/// </summary>
+		/// <returns>true if the step was pushed.</returns>
+		bool closeStep();
+		/// <summary>
+		/// Removes the bones of the step equal to the bones of the pawn.
+		/// </summary>
+		/// <returns>true if anything of the step differs from the pawn.</returns>
+		bool dropUnchanged(UndoStep& step);
+		/// <summary>swaps the bones of the step with the bones of the pawn.</summary>
+		void swapStep(UndoStep& step);
+		/// <summary>discards all undo and redo steps as well as any open transaction.</summary>
+		void clearUndo();
+		/// <returns>offset of the bone with the provided ID in the pawn or -1 if not found. Same as PoseDataUtil::pawnFindBoneId, but O(1).</returns>
+		int findBone(ID boneid);
+		/// <summary>marks the bone at the given offset as rotated or moved. Its subtree is re-evaluated by the next updateKinematics().</summary>
+		void dirtyKinematics(int coord);
+		/// <summary>marks every bone as rotated, the next updateKinematics() re-evaluates all subtrees without rebuilding the order.</summary>
+		void dirtyKinematicsAll();
+		/// <summary>
+		/// Re-evaluates the constraints reading the given bones, directly or through other constraints, one level at a time.
+		/// The constraints of a level are evaluated in parallel, the results are clamped to the joint limits and written back
+		/// like any other rotation change.
+		/// </summary>
+		/// <param name="edited">coords of the bones that changed.</param>
+		void evaluateConstraints(const std::vector<int>& edited);
+		/// <summary>re-evaluates every constraint of the pawn.</summary>
+		void evaluateConstraints();
+		/// <summary>evaluates the nodes collected in m_ConstraintNodes.</summary>
+		void evaluateConstraintNodes();
 	public:
 
 		/// <returns>
@@ -43,10 +186,50 @@ namespace PoseModel {
 		/// Resets delta to false once updates have been propagated.
 		/// </summary>
 		void resetDelta() override;
+		/// <returns>
+		/// details on which bones changed since the last resetDelta().
+		/// </returns>
+		const PoseData::PawnDelta& getDelta() override;
+		/// <returns>
+		/// count of the changes to the bones or rotations of the pawn so far. Equal values mean the pose did not change in between.
+		/// </returns>
+		unsigned long long getPoseRevision() override;
+		/// <returns>
+		/// count of the changes to the bone set of the pawn so far: bones added, removed or reordered, or a new pawn.
+		/// Equal values mean the pawn holds the same bones in the same order.
+		/// </returns>
+		unsigned long long getStructureRevision() override;
 		/// <summary>
 		/// Provides a const reference to the current pawn for other parts of the program.
 		/// </summary>
 		const PoseData::BonePawn& getCurrentPawn() override;
+		/// <summary>
+		/// Provides the global rotation (parent_global * local) of the given bone. Brings the FK cache up to date first.
+		/// </summary>
+		/// <returns>global rotation or identity if the bone does not exist.</returns>
+		glm::quat getGlobalRotation(ID boneid) override;
+		/// <summary>
+		/// Provides the world space position of the joint of the given bone. Brings the FK cache up to date first.
+		/// </summary>
+		/// <returns>joint position or the origin if the bone does not exist.</returns>
+		glm::vec3 getJointPosition(ID boneid) override;
+		/// <summary>
+		/// Provides the world space positions of all joints at once, for picking and other spatial queries. Brings the FK cache up to date first.
+		/// </summary>
+		/// <returns>joint positions in the slot order of getKinematicOrder(). Valid until the next command.</returns>
+		const PoseKinematics::JointPositions& getJointPositions();
+		/// <returns>evaluation order of the FK cache, maps the slots of getJointPositions() to the bones of the pawn. Valid until the next command.</returns>
+		const PoseKinematics::FKOrder& getKinematicOrder();
+		/// <summary>
+		/// Brings the cached global rotations and joint positions up to date. Rotated or moved bones only re-evaluate their subtree,
+		/// which is a contiguous range of the FK order. Changes of the hierarchy rebuild the whole cache.
+		/// </summary>
+		/// <returns>amount of bones recomputed.</returns>
+		int updateKinematics();
+		/// <returns>IDs of the constrained bones left out of the constraint graph, because of a missing driver or a dependency cycle.</returns>
+		const std::vector<ID>& getRejectedConstraints();
+		/// <returns>amount of constraints evaluated by the last command.</returns>
+		int getConstraintsEvaluated() const;
 
 		/// <summary>
 		/// called by Controller when new BonePawn is to be inserted into the model.
@@ -68,6 +251,31 @@ namespace PoseModel {
 		/// called by Controller to set whether the current BonePawn has been saved. This value will be dirtied by any transformative opearation.
 		/// </summary>
 		void cmdSetSaved(bool arg) override;
+		/// <summary>
+		/// called by Controller to change the order in which the euler angles of the pawn are applied. The quaternions are kept,
+		/// euler angles of all bones (including the undo history) are derived anew in the given order. An open edit is
+		/// committed first, so its step is converted with the rest of the history.
+		/// </summary>
+		/// <param name="order">new rotation order.</param>
+		void cmdSetRotationOrder(PoseData::RotationOrder order) override;
+
+		/// <summary>
+		/// called by Controller when a continuous edit (such as dragging a slider) begins. All commands until the matching
+		/// cmdCommitEdit() form a single undo step. Transactions may nest, only the outermost one records the undo step.
+		/// </summary>
+		void cmdBeginEdit() override;
+		/// <summary>
+		/// called by Controller when a continuous edit ends. Closes the transaction opened by cmdBeginEdit().
+		/// </summary>
+		void cmdCommitEdit() override;
+		/// <summary>
+		/// called by Controller to revert the bones to the state before the last undoable command or transaction.
+		/// </summary>
+		void cmdUndo() override;
+		/// <summary>
+		/// called by Controller to reapply the last command or transaction reverted by cmdUndo().
+		/// </summary>
+		void cmdRedo() override;
 
 		/// <summary>
 		/// called by Controller to add a new bone.
@@ -113,6 +321,50 @@ namespace PoseModel {
 		/// <param name="boneid">bone to be changed.</param>
 		/// <param name="parentid">new parent id, pass -1 to make the provided bone a root bone.</param>
 		void cmdBoneSetParent(ID boneid, ID parentid) override;
+		/// <summary>
+		/// called by Controller to move a joint relative to its parent joint. The joints of the whole subtree follow.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="offset">position of the joint relative to the parent joint, in the frame of the parent.</param>
+		void cmdBoneSetOffset(ID boneid, glm::vec3 offset) override;
+		/// <summary>
+		/// called by Controller to replace the rotation of every bone at once, such as with the result of a blend.
+		/// The euler angles are derived from the new quaternions. Forms a single undo step.
+		/// </summary>
+		/// <param name="rotations">new quaternions indexed the same as the pawn's bones. Ignored if the sizes differ.</param>
+		void cmdPawnSetRotations(const std::vector<glm::quat>& rotations) override;
+		/// <summary>
+		/// called by Controller to show a frame of an animation clip or a pose of a library. Same as cmdPawnSetRotations(), except the
+		/// rotations are not clamped, the change is not recorded for undo and does not mark the pawn unsaved: the pose is stored there.
+		/// Ignored during an open edit.
+		/// </summary>
+		/// <param name="rotations">new quaternions indexed the same as the pawn's bones. Ignored if the sizes differ.</param>
+		void cmdPawnPlayRotations(const std::vector<glm::quat>& rotations) override;
+		/// <summary>
+		/// called by Controller to set the rotations of several bones at once, such as the result of an inverse kinematics solve.
+		/// Every bone is updated the same as by cmdBoneSetRotation(), but from a quaternion. Forms a single undo step.
+		/// </summary>
+		/// <param name="boneids">bones to be changed, bones not found are skipped.</param>
+		/// <param name="rotations">new quaternion of every bone in boneids. Ignored if the sizes differ.</param>
+		void cmdBonesSetRotations(const std::vector<ID>& boneids, const std::vector<glm::quat>& rotations) override;
+		/// <summary>
+		/// called by Controller to change the rotation limits of a bone. The limit is sanitized first and the current rotation
+		/// is clamped to it.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="limit">new limit in degrees.</param>
+		void cmdBoneSetLimit(ID boneid, PoseData::JointLimit limit) override;
+		/// <summary>
+		/// called by Controller to clamp the rotation of every bone to its limits. Forms a single undo step if anything was clamped.
+		/// </summary>
+		/// <returns>amount of bones clamped.</returns>
+		int cmdClampToLimits() override;
+		/// <summary>
+		/// called by Controller to change the constraint of a bone. The bone and every constraint reading it are re-evaluated.
+		/// </summary>
+		/// <param name="boneid">bone to be changed.</param>
+		/// <param name="constraint">new constraint, ConstraintType::Free removes it.</param>
+		void cmdBoneSetConstraint(ID boneid, PoseData::BoneConstraint constraint) override;
 	};
 
 }
\ No newline at end of file
@@ -9,53 +9,52 @@
 
 #define LOAD_FAILED { {}, path, parseFilename(path), false }
 #define ARG_COUNT 7
+#define ARG_COUNT_OFFSETS 10
+#define ARG_COUNT_LIMITS 13
+#define ARG_COUNT_CONSTRAINTS 16
 #define MAX_BONE_LIMIT 1000000
 #define STR(X) #X
+#define STR_VALUE(X) STR(X)
+/// <summary>first bytes of a compact pose file.</summary>
+#define COMPACT_MAGIC "POSQ"
+#define COMPACT_VERSION 1u
+#define COMPACT_EXTENSION ".posq"
 
 #include "PoseDataUtil.h"
 
-PoseData::BonePawn PoseDataUtil::openFile(std::string path) {
+PoseData::BonePawn PoseDataUtil::openFile(std::string path, PoseData::RotationOrder order) {
+	PROFILE_SCOPE("PoseDataUtil::openFile");
+	if (isCompactFile(path))
+		return openCompactFile(path, order);
 	std::ifstream ifile;
 	ifile.open(path.c_str(), std::ios::in);
 
 	if (ifile.is_open()) {
 		std::string line;
-		std::string field;
 		PoseData::BonePawn pawn = {};
 		pawn.originalFilePath = path;
 		pawn.originalFileName = parseFilename(path);
 		pawn.loaded = true;
+		pawn.rotationOrder = order;
 		PoseData::BoneData bone;
-		std::stringstream lineStream;
+		std::string problem;
 		int row_counter = 0; // index of the current row.
-		int line_counter = 0; // number of fields read on current line.
+		int column = 0; // column of the problem on the current row.
 
 		while (std::getline(ifile, line)) {
-			// parse line (create a new Bone and start reading into it):
-			lineStream = std::stringstream(line);
-			line_counter = 0;
 			bone = {};
-			while (lineStream.good() && line_counter < ARG_COUNT) {
-				std::getline(lineStream, field, ',');
-				if (!boneParseCSVField(bone, line_counter, field)) {
-					std::fprintf(stderr, "Trouble reading '%s' [row %d, col %d]: Value could not be parsed.", path.c_str(), row_counter, line_counter);
-					ifile.close();
-					return LOAD_FAILED;
-				}
-				line_counter++;
-			}
-			if (line_counter < ARG_COUNT) {
-				std::fprintf(stderr, "Trouble reading '%s' [row %d, col %d]: Premature end of line. Expected %d items.", path.c_str(), row_counter, line_counter, ARG_COUNT);
+			if (!boneParseCSVLine(bone, line, column, problem)) {
+				std::fprintf(stderr, "Trouble reading '%s' [row %d, col %d]: %s", path.c_str(), row_counter, column, problem.c_str());
 				ifile.close();
 				return LOAD_FAILED;
 			}
-			// the bone was read successfuly: Add it to the pawn.
-			bone.eulerRotation = quatToEuler(bone.quaternion);
+			// the bone was read successfuly: Add it to the pawn. (euler angles are converted for all bones at once below)
 			PoseDataUtil::pawnInsertBone(pawn, bone);
 			row_counter++;
 		}
 		// all lines read, return pawn:
 		ifile.close();
+		RotationBatch::pawnQuatToEuler(pawn);
 		pawn.saved = true;
 		return pawn;
 	}
@@ -65,20 +64,18 @@ PoseData::BonePawn PoseDataUtil::openFile(std::string path) {
 	}
 }
 
-bool PoseDataUtil::saveFile(const PoseData::BonePawn pawn, std::string path) {
+bool PoseDataUtil::saveFile(const PoseData::BonePawn& pawn, std::string path) {
+	PROFILE_SCOPE("PoseDataUtil::saveFile");
+	if (isCompactFile(path))
+		return saveCompactFile(pawn, path);
 	std::ofstream ofile;
 	ofile.open(path.c_str(), std::ios::out);
 
 	if (ofile.is_open()) {
+		int columns = pawnCSVColumns(pawn);
 		for (int i = 0; i < pawn.bones.size(); i++) {
-			const PoseData::BoneData& bone = pawn.bones[i];
-			ofile << bone.id << ", " << bone.parent << ", " <<
-				bone.quaternion[0] << ", " <<
-				bone.quaternion[1] << ", " <<
-				bone.quaternion[2] << ", " <<
-				bone.quaternion[3] << ", " <<
-				bone.displayName <<
-				(i < (pawn.bones.size() - 1) ? "\n" : "");
+			boneWriteCSVLine(ofile, pawn.bones[i], columns);
+			ofile << (i < (pawn.bones.size() - 1) ? "\n" : "");
 		}
 		ofile.close();
 		return true;
@@ -89,13 +86,97 @@ bool PoseDataUtil::saveFile(const PoseData::BonePawn pawn, std::string path) {
 	}
 }
 
+bool PoseDataUtil::isCompactFile(const std::string& path) {
+	size_t last = path.find_last_of('.');
+	return last != std::string::npos && path.substr(last) == COMPACT_EXTENSION;
+}
 
-glm::quat PoseDataUtil::eulerToQuat(glm::vec3 euler) {
-	return glm::quat(glm::radians(euler));
+PoseData::BonePawn PoseDataUtil::openCompactFile(std::string path, PoseData::RotationOrder order) {
+	PROFILE_SCOPE("PoseDataUtil::openCompactFile");
+	std::ifstream ifile(path.c_str(), std::ios::in | std::ios::binary);
+	if (!ifile.is_open()) {
+		std::fprintf(stderr, "Trouble reading '%s': Could not open file.", path.c_str());
+		return LOAD_FAILED;
+	}
+	char magic[4] = {};
+	uint32_t version = 0, precision = 0, columns = 0, boneCount = 0;
+	ifile.read(magic, 4);
+	ifile.read(reinterpret_cast<char*>(&version), sizeof(version));
+	ifile.read(reinterpret_cast<char*>(&precision), sizeof(precision));
+	ifile.read(reinterpret_cast<char*>(&columns), sizeof(columns));
+	ifile.read(reinterpret_cast<char*>(&boneCount), sizeof(boneCount));
+	if (!ifile || std::string(magic, 4) != COMPACT_MAGIC || version != COMPACT_VERSION ||
+		precision > static_cast<uint32_t>(QuatPack::Precision::Bits48) || columns > ARG_COUNT_CONSTRAINTS || boneCount > MAX_BONE_LIMIT) {
+		std::fprintf(stderr, "Trouble reading '%s': Not a compact pose file of version %u.", path.c_str(), COMPACT_VERSION);
+		return LOAD_FAILED;
+	}
+	PoseData::BonePawn pawn = {};
+	pawn.originalFilePath = path;
+	pawn.originalFileName = parseFilename(path);
+	pawn.loaded = true;
+	pawn.rotationOrder = order;
+	pawn.bones.resize(boneCount);
+	for (PoseData::BoneData& bone : pawn.bones) {
+		if (!boneReadBinary(ifile, bone, static_cast<int>(columns))) {
+			std::fprintf(stderr, "Trouble reading '%s': Truncated or invalid bone.", path.c_str());
+			return LOAD_FAILED;
+		}
+	}
+	QuatPack::Precision packing = static_cast<QuatPack::Precision>(precision);
+	std::vector<uint8_t> packed(boneCount * QuatPack::bytesPer(packing));
+	ifile.read(reinterpret_cast<char*>(packed.data()), packed.size());
+	if (!ifile) {
+		std::fprintf(stderr, "Trouble reading '%s': Truncated rotations.", path.c_str());
+		return LOAD_FAILED;
+	}
+	ifile.close();
+	RotationBatch::QuatLanes lanes;
+	QuatPack::unpack(packed.data(), boneCount, packing, lanes);
+	for (uint32_t i = 0; i < boneCount; i++)
+		pawn.bones[i].quaternion = glm::quat(lanes.w[i], lanes.x[i], lanes.y[i], lanes.z[i]);
+	RotationBatch::pawnQuatToEuler(pawn);
+	pawn.saved = true;
+	return pawn;
 }
 
-glm::vec3 PoseDataUtil::quatToEuler(glm::quat quat) {
-	return glm::degrees(glm::eulerAngles(glm::normalize(quat)));
+bool PoseDataUtil::saveCompactFile(const PoseData::BonePawn& pawn, std::string path, QuatPack::Precision precision) {
+	PROFILE_SCOPE("PoseDataUtil::saveCompactFile");
+	std::ofstream ofile(path.c_str(), std::ios::out | std::ios::binary);
+	if (!ofile.is_open()) {
+		std::fprintf(stderr, "Trouble writing to '%s': Could not open file.", path.c_str());
+		return false;
+	}
+	/* header, bones without their rotations, then the rotations of every bone packed. Bones hold the optional fields the
+	pose file would write as columns. */
+	uint32_t version = COMPACT_VERSION, packing = static_cast<uint32_t>(precision), boneCount = static_cast<uint32_t>(pawn.bones.size());
+	uint32_t columns = static_cast<uint32_t>(pawnCSVColumns(pawn));
+	ofile.write(COMPACT_MAGIC, 4);
+	ofile.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	ofile.write(reinterpret_cast<const char*>(&packing), sizeof(packing));
+	ofile.write(reinterpret_cast<const char*>(&columns), sizeof(columns));
+	ofile.write(reinterpret_cast<const char*>(&boneCount), sizeof(boneCount));
+	RotationBatch::QuatLanes lanes;
+	lanes.resize(boneCount);
+	for (uint32_t i = 0; i < boneCount; i++) {
+		const PoseData::BoneData& bone = pawn.bones[i];
+		boneWriteBinary(ofile, bone, static_cast<int>(columns));
+		/* the packing assumes unit quaternions, the editor keeps them normalized but files may not */
+		glm::quat q = glm::normalize(bone.quaternion);
+		lanes.w[i] = q.w; lanes.x[i] = q.x; lanes.y[i] = q.y; lanes.z[i] = q.z;
+	}
+	std::vector<uint8_t> packed(boneCount * QuatPack::bytesPer(precision));
+	QuatPack::pack(lanes, precision, packed.data());
+	ofile.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+	ofile.close();
+	return static_cast<bool>(ofile);
+}
+
+glm::quat PoseDataUtil::eulerToQuat(glm::vec3 euler, PoseData::RotationOrder order) {
+	return EulerOrder::eulerToQuat(euler, order);
+}
+
+glm::vec3 PoseDataUtil::quatToEuler(glm::quat quat, PoseData::RotationOrder order) {
+	return EulerOrder::quatToEuler(quat, order);
 }
 
 std::string PoseDataUtil::parseFilename(std::string arg) {
@@ -106,13 +187,15 @@ std::string PoseDataUtil::parseFilename(std::string arg) {
 }
 
 std::string PoseDataUtil::addExtension(std::string arg) {
+	if (isCompactFile(arg))
+		return arg;
 	size_t last = arg.find_last_of(".");
 	if (last != std::string::npos)
 		return arg.substr(0, last).append(".csv");
 	return arg.append(".csv");
 }
 
-std::string PoseDataUtil::getUniqueBoneName(const PoseData::BonePawn pawn) {
+std::string PoseDataUtil::getUniqueBoneName(const PoseData::BonePawn& pawn) {
 	for (int id = 1; id < MAX_BONE_LIMIT; id++) {
 		std::string name = "bone (" + std::to_string(id) + ")";
 		if (pawnFindBoneName(pawn, name) < 0) { //not foud
@@ -124,7 +207,7 @@ std::string PoseDataUtil::getUniqueBoneName(const PoseData::BonePawn pawn) {
 	throw std::runtime_error("getUniqueBoneName() found more than" STR(MAX_BONE_LIMIT) "bones with default names.");
 }
 
-ID PoseDataUtil::getUniqueBoneId(const PoseData::BonePawn pawn) {
+ID PoseDataUtil::getUniqueBoneId(const PoseData::BonePawn& pawn) {
 	for (int id = 1; id < MAX_BONE_LIMIT; id++) {
 		if (pawnFindBoneId(pawn, id) < 0) { //not foud
 			return id;
@@ -135,9 +218,9 @@ ID PoseDataUtil::getUniqueBoneId(const PoseData::BonePawn pawn) {
 	throw std::runtime_error("getUniqueBoneId() found more than" STR(MAX_BONE_LIMIT) "bones.");
 }
 
-int PoseDataUtil::pawnFindBoneName(const PoseData::BonePawn pawn, std::string boneName) {
+int PoseDataUtil::pawnFindBoneName(const PoseData::BonePawn& pawn, std::string boneName) {
 	int pos = 0;
-	for (PoseData::BoneData bone : pawn.bones) {
+	for (const PoseData::BoneData& bone : pawn.bones) {
 		if (boneName.compare(bone.displayName) == 0)
 			return pos;
 		pos++;
@@ -145,9 +228,9 @@ int PoseDataUtil::pawnFindBoneName(const PoseData::BonePawn pawn, std::string bo
 	return -1;
 }
 
-int PoseDataUtil::pawnFindBoneId(const PoseData::BonePawn pawn, ID id) {
+int PoseDataUtil::pawnFindBoneId(const PoseData::BonePawn& pawn, ID id) {
 	int pos = 0;
-	for (PoseData::BoneData bone : pawn.bones) {
+	for (const PoseData::BoneData& bone : pawn.bones) {
 		if (bone.id == id) {
 			return pos;
 		}
@@ -156,7 +239,7 @@ int PoseDataUtil::pawnFindBoneId(const PoseData::BonePawn pawn, ID id) {
 	return -1;
 }
 
-bool PoseDataUtil::pawnTestBoneParentLoop(const PoseData::BonePawn pawn, ID startBone) {
+bool PoseDataUtil::pawnTestBoneParentLoop(const PoseData::BonePawn& pawn, ID startBone) {
 	/* if we keep finding parents for more than the count of elements, there is a loop.*/
 	ID current = startBone;
 	for (int i = 0; i <= pawn.bones.size(); ++i) {
@@ -168,10 +251,10 @@ bool PoseDataUtil::pawnTestBoneParentLoop(const PoseData::BonePawn pawn, ID star
 	return false;
 }
 
-std::vector<int> PoseDataUtil::pawnGetBoneChildren(const PoseData::BonePawn pawn, ID parent) {
+std::vector<int> PoseDataUtil::pawnGetBoneChildren(const PoseData::BonePawn& pawn, ID parent) {
 	auto list = std::vector<int>();
 	int pos = 0;
-	for (PoseData::BoneData bone : pawn.bones) {
+	for (const PoseData::BoneData& bone : pawn.bones) {
 		if (bone.parent == parent) {
 			list.push_back(pos);
 		}
@@ -180,6 +263,121 @@ std::vector<int> PoseDataUtil::pawnGetBoneChildren(const PoseData::BonePawn pawn
 	return list;
 }
 
+bool PoseDataUtil::boneParseCSVLine(PoseData::BoneData& bone, const std::string& line, int& column, std::string& problem) {
+	std::stringstream lineStream(line);
+	std::string field;
+	int line_counter = 0; // number of fields read on the line.
+	while (lineStream.good() && line_counter < ARG_COUNT_CONSTRAINTS) {
+		std::getline(lineStream, field, ',');
+		if (!boneParseCSVField(bone, line_counter, field)) {
+			column = line_counter;
+			problem = "Value could not be parsed.";
+			return false;
+		}
+		line_counter++;
+	}
+	column = line_counter;
+	if (line_counter < ARG_COUNT) {
+		problem = "Premature end of line. Expected " STR_VALUE(ARG_COUNT) " items.";
+		return false;
+	}
+	// the offset columns are optional, but come as a whole:
+	if (line_counter > ARG_COUNT && line_counter < ARG_COUNT_OFFSETS) {
+		problem = "Incomplete offset. Expected " STR_VALUE(ARG_COUNT) " or " STR_VALUE(ARG_COUNT_OFFSETS) " items.";
+		return false;
+	}
+	// so do the limit columns, which also require the offset:
+	if (line_counter > ARG_COUNT_OFFSETS && line_counter < ARG_COUNT_LIMITS) {
+		problem = "Incomplete limit. Expected " STR_VALUE(ARG_COUNT_LIMITS) " items.";
+		return false;
+	}
+	// and the constraint columns, which require the limit:
+	if (line_counter > ARG_COUNT_LIMITS && line_counter < ARG_COUNT_CONSTRAINTS) {
+		problem = "Incomplete constraint. Expected " STR_VALUE(ARG_COUNT_CONSTRAINTS) " items.";
+		return false;
+	}
+	bone.limit = PoseLimits::sanitize(bone.limit);
+	return true;
+}
+
+bool PoseDataUtil::boneReadBinary(std::istream& stream, PoseData::BoneData& bone, int columns) {
+	int32_t ids[2], type = 0;
+	uint16_t nameLength = 0;
+	stream.read(reinterpret_cast<char*>(ids), sizeof(ids));
+	stream.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+	bone.displayName.resize(nameLength);
+	stream.read(&bone.displayName[0], nameLength);
+	if (columns >= ARG_COUNT_OFFSETS)
+		stream.read(reinterpret_cast<char*>(&bone.offset[0]), 3 * sizeof(float));
+	if (columns >= ARG_COUNT_LIMITS) {
+		stream.read(reinterpret_cast<char*>(&bone.limit.swing), sizeof(float));
+		stream.read(reinterpret_cast<char*>(&bone.limit.twistMin), sizeof(float));
+		stream.read(reinterpret_cast<char*>(&bone.limit.twistMax), sizeof(float));
+		bone.limit = PoseLimits::sanitize(bone.limit);
+	}
+	if (columns >= ARG_COUNT_CONSTRAINTS) {
+		stream.read(reinterpret_cast<char*>(&type), sizeof(type));
+		stream.read(reinterpret_cast<char*>(&bone.constraint.driver), sizeof(int32_t));
+		stream.read(reinterpret_cast<char*>(&bone.constraint.factor), sizeof(float));
+	}
+	if (!stream || type < 0 || type > static_cast<int32_t>(PoseData::ConstraintType::AimAt))
+		return false;
+	bone.id = ids[0];
+	bone.parent = ids[1];
+	bone.constraint.type = static_cast<PoseData::ConstraintType>(type);
+	return true;
+}
+
+void PoseDataUtil::boneWriteBinary(std::ostream& stream, const PoseData::BoneData& bone, int columns) {
+	int32_t ids[2] = { bone.id, bone.parent }, type = static_cast<int32_t>(bone.constraint.type), driver = bone.constraint.driver;
+	uint16_t nameLength = static_cast<uint16_t>(std::min<size_t>(bone.displayName.size(), UINT16_MAX));
+	stream.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+	stream.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+	stream.write(bone.displayName.data(), nameLength);
+	if (columns >= ARG_COUNT_OFFSETS)
+		stream.write(reinterpret_cast<const char*>(&bone.offset[0]), 3 * sizeof(float));
+	if (columns >= ARG_COUNT_LIMITS) {
+		float limit[3] = { bone.limit.swing, bone.limit.twistMin, bone.limit.twistMax };
+		stream.write(reinterpret_cast<const char*>(limit), sizeof(limit));
+	}
+	if (columns >= ARG_COUNT_CONSTRAINTS) {
+		stream.write(reinterpret_cast<const char*>(&type), sizeof(type));
+		stream.write(reinterpret_cast<const char*>(&driver), sizeof(driver));
+		stream.write(reinterpret_cast<const char*>(&bone.constraint.factor), sizeof(float));
+	}
+}
+
+int PoseDataUtil::pawnCSVColumns(const PoseData::BonePawn& pawn) {
+	// pawns without any offset are written in the original 7 column format, the limit columns are only added when a bone is limited
+	// and the constraint columns when a bone is constrained.
+	bool offsets = false, limits = false, constraints = false;
+	for (const PoseData::BoneData& bone : pawn.bones) {
+		offsets = offsets || bone.offset != glm::vec3(0, 0, 0);
+		limits = limits || PoseLimits::isLimited(bone.limit);
+		constraints = constraints || bone.constraint.type != PoseData::ConstraintType::Free;
+	}
+	if (constraints)
+		return ARG_COUNT_CONSTRAINTS;
+	if (limits)
+		return ARG_COUNT_LIMITS;
+	return offsets ? ARG_COUNT_OFFSETS : ARG_COUNT;
+}
+
+void PoseDataUtil::boneWriteCSVLine(std::ostream& stream, const PoseData::BoneData& bone, int columns) {
+	stream << bone.id << ", " << bone.parent << ", " <<
+		bone.quaternion[0] << ", " <<
+		bone.quaternion[1] << ", " <<
+		bone.quaternion[2] << ", " <<
+		bone.quaternion[3] << ", " <<
+		bone.displayName;
+	if (columns >= ARG_COUNT_OFFSETS)
+		stream << ", " << bone.offset.x << ", " << bone.offset.y << ", " << bone.offset.z;
+	if (columns >= ARG_COUNT_LIMITS)
+		stream << ", " << bone.limit.swing << ", " << bone.limit.twistMin << ", " << bone.limit.twistMax;
+	if (columns >= ARG_COUNT_CONSTRAINTS)
+		stream << ", " << PoseConstraints::typeName(bone.constraint.type) << ", " << bone.constraint.driver << ", " << bone.constraint.factor;
+}
+
 bool PoseDataUtil::boneParseCSVField(PoseData::BoneData& bone, int line_counter, std::string value) {
 	try {
 		switch (line_counter) {
@@ -198,6 +396,28 @@ bool PoseDataUtil::boneParseCSVField(PoseData::BoneData& bone, int line_counter,
 		case 6: //name
 			bone.displayName = value.substr(1);
 			return true;
+		case 7: //offset X
+		case 8: //offset Y
+		case 9: //offset Z
+			bone.offset[line_counter - 7] = std::stof(value);
+			return true;
+		case 10: //swing limit
+			bone.limit.swing = std::stof(value);
+			return true;
+		case 11: //twist limit min
+			bone.limit.twistMin = std::stof(value);
+			return true;
+		case 12: //twist limit max
+			bone.limit.twistMax = std::stof(value);
+			return true;
+		case 13: //constraint type
+			return PoseConstraints::parseType(value, bone.constraint.type);
+		case 14: //constraint driver
+			bone.constraint.driver = std::stoi(value);
+			return true;
+		case 15: //constraint factor
+			bone.constraint.factor = std::stof(value);
+			return true;
 		default:
 			// this index doesn't have a corresponding bone field.
 			return false;
@@ -218,6 +438,9 @@ PoseData::BoneData PoseDataUtil::boneDeepCopy(const PoseData::BoneData& source)
 	bone.quaternion = source.quaternion;
 	bone.eulerRotation = source.eulerRotation;
 	bone.displayName = source.displayName;
+	bone.offset = source.offset;
+	bone.limit = source.limit;
+	bone.constraint = source.constraint;
 	return bone;
 }
 
@@ -237,5 +460,6 @@ PoseData::BonePawn PoseDataUtil::pawnDeepCopy(const PoseData::BonePawn& source)
 	pawn.originalFileName = source.originalFileName;
 	pawn.loaded = source.loaded;
 	pawn.saved = source.saved;
+	pawn.rotationOrder = source.rotationOrder;
 	return pawn;
 }
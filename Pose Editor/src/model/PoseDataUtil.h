@@ -20,6 +20,12 @@
 
 #include "../ModelInterface.h"
 #include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "EulerOrder.h"
+#include "RotationBatch.h"
+#include "PoseLimits.h"
+#include "PoseConstraints.h"
+#include "QuatPack.h"
 
 /// <summary>
 /// PoseDataUtil holds a combination of utility functions for running more elaborate tests on BonePawn, file IO
@@ -31,26 +37,48 @@ namespace PoseDataUtil {
 
 	/// <summary>
 	/// Safe file opener. Atempts to parse the provided file into a proper BonePawn.
+	/// Every line holds 7 fields (id, parent, quaternion, name), optionally followed by the 3 fields of the bone offset.
+	/// Paths ending with .posq are read by openCompactFile().
 	/// </summary>
+	/// <param name="order">rotation order of the returned pawn, the euler angles are derived in this order.</param>
 	/// <returns>parsed file. When an error occurs, the returned file has loaded set to false.</returns>
-	PoseData::BonePawn openFile(std::string path);
+	PoseData::BonePawn openFile(std::string path, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
 
 	/// <summary>
 	/// Encodes the pawn into the provided path. If the path is empty, path from pawn is used.
+	/// The offset columns are only written when some bone has a nonzero offset.
+	/// Paths ending with .posq are written by saveCompactFile() at 48 bits.
 	/// </summary>
 	/// <returns>true if successful.</returns>
-	bool saveFile(PoseData::BonePawn pawn, std::string path = "");
+	bool saveFile(const PoseData::BonePawn& pawn, std::string path = "");
+
+	/// <returns>true if the path ends with .posq, the extension of the compact pose files.</returns>
+	bool isCompactFile(const std::string& path);
+
+	/// <summary>
+	/// Reads a compact pose file, see saveCompactFile().
+	/// </summary>
+	/// <returns>parsed file. When an error occurs, the returned file has loaded set to false.</returns>
+	PoseData::BonePawn openCompactFile(std::string path, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
+
+	/// <summary>
+	/// Encodes the pawn into a compact binary pose file: the bones hold the same fields as the pose file, but their quaternions
+	/// are packed by QuatPack after the last bone.
+	/// </summary>
+	/// <param name="precision">size of the packed quaternions, see QuatPack::maxError() for the error it brings.</param>
+	/// <returns>true if successful.</returns>
+	bool saveCompactFile(const PoseData::BonePawn& pawn, std::string path, QuatPack::Precision precision = QuatPack::Precision::Bits48);
 
 	// === MISC ===
 
 	/// <summary>
 	/// converts euler angles in degrees into a quaternion.
 	/// </summary>
-	glm::quat eulerToQuat(glm::vec3 euler);
+	glm::quat eulerToQuat(glm::vec3 euler, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
 	/// <summary>
 	/// converts quaternion into euler angles in degrees.
 	/// </summary>
-	glm::vec3 quatToEuler(glm::quat quat);
+	glm::vec3 quatToEuler(glm::quat quat, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
 
 	/// <summary>
 	/// Helper function to parse out filename from a full path.
@@ -58,38 +86,38 @@ namespace PoseDataUtil {
 	std::string parseFilename(std::string arg);
 
 	/// <summary>
-	/// Helper function to add .csv at the end of file paths.
+	/// Helper function to add .csv at the end of file paths. Paths ending with .posq keep their extension.
 	/// </summary>
 	std::string addExtension(std::string arg);
 
 	/// <returns>generates a unique bone name, not yet present in the pawn.</returns>
-	std::string getUniqueBoneName(const PoseData::BonePawn pawn);
+	std::string getUniqueBoneName(const PoseData::BonePawn& pawn);
 
 	/// <returns>generates a unique bone id, not yet present in the pawn.</returns>
-	ID getUniqueBoneId(const PoseData::BonePawn pawn);
+	ID getUniqueBoneId(const PoseData::BonePawn& pawn);
 
 	/// <summary>
 	/// Finds the offset in the pawn's bone array of a bone with the provided name.
 	/// </summary>
 	/// <returns>offset or -1 if not found</returns>
-	int pawnFindBoneName(const PoseData::BonePawn pawn, std::string boneName);
+	int pawnFindBoneName(const PoseData::BonePawn& pawn, std::string boneName);
 
 	/// <summary>
 	/// Finds the offset in the pawn's bone array of a bone with the provided ID.
 	/// </summary>
 	/// <returns>offset or -1 if not found</returns>
-	int pawnFindBoneId(const PoseData::BonePawn pawn, ID id);
+	int pawnFindBoneId(const PoseData::BonePawn& pawn, ID id);
 
 	/// <summary>
 	/// tests whether startBone has an infinite loop of parents within pawn.
 	/// </summary>
 	/// <returns>false if the an infinite loop is found.</returns>
-	bool pawnTestBoneParentLoop(const PoseData::BonePawn pawn, ID startBone);
+	bool pawnTestBoneParentLoop(const PoseData::BonePawn& pawn, ID startBone);
 
 	/// <summary>
 	/// Provides a list of all bones which have the given bone ID as aparent
 	/// </summary>
-	std::vector<int> pawnGetBoneChildren(const PoseData::BonePawn pawn, ID parent);
+	std::vector<int> pawnGetBoneChildren(const PoseData::BonePawn& pawn, ID parent);
 
 	// === Bone Operations ===
 
@@ -102,6 +130,37 @@ namespace PoseDataUtil {
 	/// <returns>false if unparsable</returns>
 	bool boneParseCSVField(PoseData::BoneData& bone, int line_counter, std::string value);
 
+	/// <summary>
+	/// Parses a whole line of a pose file into bone, the same way openFile() reads every line. Also used by the clip files,
+	/// which store their skeleton in the same format.
+	/// </summary>
+	/// <param name="column">receives the column of the problem when the line is rejected.</param>
+	/// <param name="problem">receives the description of the problem when the line is rejected.</param>
+	/// <returns>false if the line does not hold a valid bone.</returns>
+	bool boneParseCSVLine(PoseData::BoneData& bone, const std::string& line, int& column, std::string& problem);
+
+	/// <summary>
+	/// Writes bone as a single line of a pose file, without the line break.
+	/// </summary>
+	/// <param name="columns">amount of columns written, as returned by pawnCSVColumns().</param>
+	void boneWriteCSVLine(std::ostream& stream, const PoseData::BoneData& bone, int columns);
+
+	/// <summary>
+	/// Reads a bone written by boneWriteBinary() with the same columns. The rotation is not part of it.
+	/// </summary>
+	/// <returns>false if the stream ended or the bone is invalid.</returns>
+	bool boneReadBinary(std::istream& stream, PoseData::BoneData& bone, int columns);
+
+	/// <summary>
+	/// Writes the fields of a bone except its rotation in binary: id, parent, name and the optional columns of the pose file,
+	/// as many as columns selects. Used by the compact pose files and the pose libraries.
+	/// </summary>
+	/// <param name="columns">amount of columns of the pose file, as returned by pawnCSVColumns().</param>
+	void boneWriteBinary(std::ostream& stream, const PoseData::BoneData& bone, int columns);
+
+	/// <returns>amount of columns needed to write every bone of the pawn: the optional columns are only written when some bone uses them.</returns>
+	int pawnCSVColumns(const PoseData::BonePawn& pawn);
+
 	/// <summary>
 	/// Creates a proper deep copy.
 	/// </summary>
@@ -0,0 +1,200 @@
+/// <title>Pose IK</title>
+/// <desc>
+///		Inverse kinematics solvers for chains of bones.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>squared length below which a vector has no usable direction.</summary>
+#define IK_EPSILON 1e-12f
+/// <summary>a pass improving the distance by less than this fraction of the tolerance makes no progress.</summary>
+#define IK_STALL_FACTOR 1e-2f
+/// <summary>passes in a row without progress which end the solve, the chain is stuck.</summary>
+#define IK_STALL_PASSES 64
+
+#include "PoseIK.h"
+
+glm::quat PoseIK::rotationBetween(const glm::vec3& a, const glm::vec3& b) {
+	float aa = glm::dot(a, a), bb = glm::dot(b, b);
+	if (aa < IK_EPSILON || bb < IK_EPSILON)
+		return glm::quat(1, 0, 0, 0);
+	float norm = std::sqrt(aa * bb);
+	float w = norm + glm::dot(a, b);
+	glm::vec3 axis;
+	if (w < 1e-6f * norm) {
+		/* opposite directions, half a turn about any axis perpendicular to a */
+		w = 0.0f;
+		axis = std::abs(a.x) > std::abs(a.z) ? glm::vec3(-a.y, a.x, 0.0f) : glm::vec3(0.0f, -a.z, a.y);
+	}
+	else {
+		axis = glm::cross(a, b);
+	}
+	return glm::normalize(glm::quat(w, axis.x, axis.y, axis.z));
+}
+
+bool PoseIK::ChainSolver::setChain(const PoseData::BonePawn& pawn, ID root, ID tip) {
+	m_Bones.clear();
+	std::unordered_map<ID, int> index;
+	index.reserve(pawn.bones.size());
+	for (int i = 0; i < static_cast<int>(pawn.bones.size()); i++)
+		index.emplace(pawn.bones[i].id, i);
+
+	/* climb from the tip, the step limit keeps parent loops finite */
+	auto found = index.find(tip);
+	while (found != index.end() && m_Bones.size() <= pawn.bones.size()) {
+		m_Bones.push_back(found->second);
+		if (found->first == root)
+			break;
+		found = index.find(pawn.bones[found->second].parent);
+	}
+	if (m_Bones.size() < 2 || pawn.bones[m_Bones.back()].id != root) {
+		m_Bones.clear();
+		m_Ids.clear();
+		return false;
+	}
+	std::reverse(m_Bones.begin(), m_Bones.end());
+
+	size_t count = m_Bones.size();
+	m_Ids.resize(count - 1);
+	for (size_t j = 0; j + 1 < count; j++)
+		m_Ids[j] = pawn.bones[m_Bones[j]].id;
+	m_Offsets.resize(count);
+	m_Lengths.resize(count);
+	m_Global.resize(count);
+	m_Positions.resize(count);
+	m_Turns.resize(count);
+	m_Rotations.resize(count - 1);
+	return true;
+}
+
+bool PoseIK::ChainSolver::matches(const PoseData::BonePawn& pawn, ID root, ID tip) const {
+	if (m_Bones.empty())
+		return false;
+	int size = static_cast<int>(pawn.bones.size());
+	for (size_t j = 0; j < m_Bones.size(); j++) {
+		if (m_Bones[j] >= size)
+			return false;
+		if (j > 0 && pawn.bones[m_Bones[j]].parent != pawn.bones[m_Bones[j - 1]].id)
+			return false;
+	}
+	return pawn.bones[m_Bones.front()].id == root && pawn.bones[m_Bones.back()].id == tip;
+}
+
+void PoseIK::ChainSolver::placeJoints() {
+	for (size_t j = 1; j < m_Bones.size(); j++)
+		m_Positions[j] = m_Positions[j - 1] + QuatSimd::rotate(m_Global[j - 1], m_Offsets[j]);
+}
+
+void PoseIK::ChainSolver::passCCD(const glm::vec3& target, float maxTurn) {
+	/* turns beyond the limit keep their axis, cos(limit / 2) is the smallest w allowed */
+	float limitCos = std::cos(maxTurn * 0.5f), limitSin = std::sin(maxTurn * 0.5f);
+	size_t tip = m_Bones.size() - 1;
+	/* the joints above the one being turned are not moved yet, only the tip has to follow every turn */
+	glm::vec3 effector = m_Positions[tip];
+	for (size_t j = tip; j-- > 0;) {
+		glm::vec3 reach = effector - m_Positions[j];
+		glm::quat turn = rotationBetween(reach, target - m_Positions[j]);
+		if (maxTurn > 0.0f && turn.w < limitCos) {
+			glm::vec3 axis = glm::normalize(glm::vec3(turn.x, turn.y, turn.z)) * limitSin;
+			turn = glm::quat(limitCos, axis.x, axis.y, axis.z);
+		}
+		m_Turns[j] = turn;
+		effector = m_Positions[j] + QuatSimd::rotate(turn, reach);
+	}
+	/* every turn applies to its joint and all joints below, so the global rotations take the product of the turns above them */
+	glm::quat accumulated(1, 0, 0, 0);
+	for (size_t j = 0; j <= tip; j++) {
+		if (j < tip)
+			accumulated = QuatSimd::mul(accumulated, m_Turns[j]);
+		m_Global[j] = glm::normalize(QuatSimd::mul(accumulated, m_Global[j]));
+	}
+	placeJoints();
+}
+
+void PoseIK::ChainSolver::passFABRIK(const glm::vec3& target) {
+	size_t tip = m_Bones.size() - 1;
+	glm::vec3 root = m_Positions[0];
+	/* backward: pin the tip to the target, every joint keeps its distance to the next one */
+	m_Positions[tip] = target;
+	for (size_t j = tip; j-- > 0;) {
+		glm::vec3 direction = m_Positions[j] - m_Positions[j + 1];
+		float length = glm::dot(direction, direction);
+		if (length > IK_EPSILON)
+			m_Positions[j] = m_Positions[j + 1] + direction * (m_Lengths[j + 1] / std::sqrt(length));
+	}
+	/* forward: pin the root back to its place */
+	m_Positions[0] = root;
+	for (size_t j = 1; j <= tip; j++) {
+		glm::vec3 direction = m_Positions[j] - m_Positions[j - 1];
+		float length = glm::dot(direction, direction);
+		m_Positions[j] = length > IK_EPSILON ? m_Positions[j - 1] + direction * (m_Lengths[j] / std::sqrt(length)) :
+			m_Positions[j - 1] + QuatSimd::rotate(m_Global[j - 1], m_Offsets[j]);
+	}
+	/* turn every joint so its offset points at the moved next joint, the turn carries over to the joints below */
+	glm::quat accumulated(1, 0, 0, 0);
+	for (size_t j = 0; j <= tip; j++) {
+		m_Global[j] = glm::normalize(QuatSimd::mul(accumulated, m_Global[j]));
+		if (j == tip)
+			break;
+		glm::quat turn = rotationBetween(QuatSimd::rotate(m_Global[j], m_Offsets[j + 1]), m_Positions[j + 1] - m_Positions[j]);
+		m_Global[j] = glm::normalize(QuatSimd::mul(turn, m_Global[j]));
+		accumulated = QuatSimd::mul(turn, accumulated);
+	}
+	placeJoints();
+}
+
+PoseIK::Result PoseIK::ChainSolver::solve(const PoseData::BonePawn& pawn, const glm::quat& parentGlobal, const glm::vec3& rootPosition,
+	const glm::vec3& target, const Settings& settings) {
+	PROFILE_SCOPE("PoseIK::solve");
+	Result result;
+	if (m_Bones.empty())
+		return result;
+	size_t tip = m_Bones.size() - 1;
+
+	/* forward kinematics along the chain from the current pose */
+	glm::quat parent = glm::normalize(parentGlobal);
+	for (size_t j = 0; j <= tip; j++) {
+		const PoseData::BoneData& bone = pawn.bones[m_Bones[j]];
+		m_Offsets[j] = bone.offset;
+		m_Lengths[j] = glm::length(bone.offset);
+		m_Global[j] = glm::normalize(QuatSimd::mul(j == 0 ? parent : m_Global[j - 1], bone.quaternion));
+	}
+	m_Positions[0] = rootPosition;
+	placeJoints();
+
+	result.distance = glm::length(target - m_Positions[tip]);
+	int stalled = 0;
+	while (result.distance > settings.tolerance && result.iterations < settings.maxIterations) {
+		if (settings.solver == IKSolver::FABRIK)
+			passFABRIK(target);
+		else
+			passCCD(target, settings.maxTurn);
+		result.iterations++;
+		float previous = result.distance;
+		result.distance = glm::length(target - m_Positions[tip]);
+		/* long CCD chains creep through single slow passes, only a run of them means the chain is stuck */
+		stalled = previous - result.distance < settings.tolerance * IK_STALL_FACTOR ? stalled + 1 : 0;
+		if (stalled >= IK_STALL_PASSES)
+			break;
+	}
+	result.reached = result.distance <= settings.tolerance;
+
+	/* local rotation = inverse(parent global) * global, the globals are normalized so the conjugate inverts them */
+	for (size_t j = 0; j < tip; j++)
+		m_Rotations[j] = glm::normalize(QuatSimd::mul(glm::conjugate(j == 0 ? parent : m_Global[j - 1]), m_Global[j]));
+	return result;
+}
+
+const std::vector<ID>& PoseIK::ChainSolver::getBoneIds() const {
+	return m_Ids;
+}
+
+const std::vector<glm::quat>& PoseIK::ChainSolver::getRotations() const {
+	return m_Rotations;
+}
+
+const std::vector<int>& PoseIK::ChainSolver::getBones() const {
+	return m_Bones;
+}
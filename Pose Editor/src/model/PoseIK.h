@@ -0,0 +1,123 @@
+/// <title>Pose IK</title>
+/// <desc>
+///		Inverse kinematics solvers for chains of bones.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+
+/// <summary>
+/// PoseIK rotates the bones of a chain, so that the joint at its tip reaches a target position. A chain runs from a root bone down
+/// the parent links to a tip bone. The tip only marks the end effector, its own rotation is kept.
+/// </summary>
+namespace PoseIK {
+
+	using PoseData::IKSolver;
+
+	/// <summary>
+	/// Limits of a solve.
+	/// </summary>
+	struct Settings {
+		IKSolver solver = IKSolver::CCD;
+		/// <summary>largest amount of passes over the chain.</summary>
+		int maxIterations = 64;
+		/// <summary>distance between the tip and the target at which the solve stops.</summary>
+		float tolerance = 1e-3f;
+		/// <summary>
+		/// largest angle in radians a CCD pass turns a single joint by, 0 for no limit. Long chains converge faster with a small limit,
+		/// because the joints near the tip can no longer take the whole bend.
+		/// </summary>
+		float maxTurn = 0.0f;
+	};
+
+	/// <summary>
+	/// Shortest rotation turning the direction of a into the direction of b. Identity if either has no direction.
+	/// </summary>
+	glm::quat rotationBetween(const glm::vec3& a, const glm::vec3& b);
+
+	/// <summary>
+	/// Outcome of a solve.
+	/// </summary>
+	struct Result {
+		/// <summary>amount of passes made over the chain, 0 if the tip already was within the tolerance.</summary>
+		int iterations = 0;
+		/// <summary>distance between the tip and the target after the solve.</summary>
+		float distance = 0.0f;
+		/// <summary>true if the distance is within the tolerance. Targets out of reach leave the chain stretched toward them.</summary>
+		bool reached = false;
+	};
+
+	/// <summary>
+	/// Solves one chain repeatedly. The buffers are sized by setChain(), after which solve() does not allocate,
+	/// so a chain can follow a dragged target every frame.
+	/// </summary>
+	class ChainSolver {
+	private:
+		/// <summary>offset into pawn.bones of every joint, root first and tip last.</summary>
+		std::vector<int> m_Bones;
+		/// <summary>IDs of the rotated bones: every joint but the tip.</summary>
+		std::vector<ID> m_Ids;
+		/// <summary>offset of every joint from the previous one, in the frame of the previous one.</summary>
+		std::vector<glm::vec3> m_Offsets;
+		/// <summary>length of every offset.</summary>
+		std::vector<float> m_Lengths;
+		/// <summary>global rotation of every joint, updated by the solve.</summary>
+		std::vector<glm::quat> m_Global;
+		/// <summary>world space position of every joint, updated by the solve.</summary>
+		std::vector<glm::vec3> m_Positions;
+		/// <summary>rotation applied to every joint during a CCD pass.</summary>
+		std::vector<glm::quat> m_Turns;
+		/// <summary>solved local rotations of m_Ids.</summary>
+		std::vector<glm::quat> m_Rotations;
+
+		/// <summary>recomputes the joint positions from the root, the offsets and the global rotations.</summary>
+		void placeJoints();
+		/// <summary>one CCD pass from the tip to the root.</summary>
+		void passCCD(const glm::vec3& target, float maxTurn);
+		/// <summary>one FABRIK pass: the joints are pulled to the target and back to the root, then the rotations follow.</summary>
+		void passFABRIK(const glm::vec3& target);
+
+	public:
+		/// <summary>
+		/// Finds the chain from root to tip along the parent links of the pawn and sizes the buffers.
+		/// </summary>
+		/// <returns>false if tip is not a descendant of root. The solver holds no chain then.</returns>
+		bool setChain(const PoseData::BonePawn& pawn, ID root, ID tip);
+
+		/// <returns>true if the chain set last runs from root to tip and is still connected the same way in the pawn.</returns>
+		bool matches(const PoseData::BonePawn& pawn, ID root, ID tip) const;
+
+		/// <summary>
+		/// Rotates the chain toward the target, starting from the rotations of the pawn. The pawn is not changed, see getRotations().
+		/// </summary>
+		/// <param name="parentGlobal">global rotation of the parent of the root, identity for a root without parent.</param>
+		/// <param name="rootPosition">world space position of the root joint.</param>
+		/// <param name="target">world space position the tip should reach.</param>
+		Result solve(const PoseData::BonePawn& pawn, const glm::quat& parentGlobal, const glm::vec3& rootPosition,
+			const glm::vec3& target, const Settings& settings);
+
+		/// <returns>IDs of the bones rotated by the solve, from the root down. Empty without a chain.</returns>
+		const std::vector<ID>& getBoneIds() const;
+
+		/// <returns>local rotations found by the last solve, indexed the same as getBoneIds().</returns>
+		const std::vector<glm::quat>& getRotations() const;
+
+		/// <returns>offsets into pawn.bones of the joints of the chain, root first and tip last.</returns>
+		const std::vector<int>& getBones() const;
+	};
+}
@@ -0,0 +1,221 @@
+/// <title>Pose Kinematics</title>
+/// <desc>
+///		Forward kinematics over BonePawn. The pawn only stores local rotations and offsets,
+///		global orientations and joint positions are derived here in linear passes.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include "PoseKinematics.h"
+
+/// <summary>
+/// Depth first walk assigning slots in preorder. Children already holding a slot are skipped, which keeps parent loops finite.
+/// </summary>
+static void visitSubtree(PoseKinematics::FKOrder& order, int root,
+	const std::vector<int>& childStart, const std::vector<int>& childList, std::vector<int>& stack) {
+	int slot = static_cast<int>(order.bones.size());
+	order.slots[root] = slot;
+	order.bones.push_back(root);
+	order.parents.push_back(-1);
+	order.subtreeEnd.push_back(slot + 1);
+	/* the stack holds pairs of (bone offset, position of its next child in childList) */
+	stack.clear();
+	stack.push_back(root);
+	stack.push_back(childStart[root]);
+	while (!stack.empty()) {
+		int bone = stack[stack.size() - 2];
+		int& cursor = stack.back();
+		if (cursor < childStart[bone + 1]) {
+			int child = childList[cursor++];
+			if (order.slots[child] != -1)
+				continue;
+			int childSlot = static_cast<int>(order.bones.size());
+			order.slots[child] = childSlot;
+			order.bones.push_back(child);
+			order.parents.push_back(order.slots[bone]);
+			order.subtreeEnd.push_back(childSlot + 1);
+			stack.push_back(child);
+			stack.push_back(childStart[child]);
+		}
+		else {
+			order.subtreeEnd[order.slots[bone]] = static_cast<int>(order.bones.size());
+			stack.pop_back();
+			stack.pop_back();
+		}
+	}
+}
+
+PoseKinematics::FKOrder PoseKinematics::buildOrder(const PoseData::BonePawn& pawn) {
+	PROFILE_SCOPE("PoseKinematics::buildOrder");
+	FKOrder order;
+	int count = static_cast<int>(pawn.bones.size());
+	order.bones.reserve(count);
+	order.parents.reserve(count);
+	order.subtreeEnd.reserve(count);
+	order.slots.assign(count, -1);
+
+	std::unordered_map<ID, int> index;
+	index.reserve(count);
+	for (int i = 0; i < count; i++)
+		index.emplace(pawn.bones[i].id, i);
+
+	/* offset of the parent of every bone, -1 for roots and orphans */
+	std::vector<int> parentOffset(count, -1);
+	for (int i = 0; i < count; i++) {
+		ID parent = pawn.bones[i].parent;
+		if (parent == -1)
+			continue;
+		auto found = index.find(parent);
+		if (found == index.end())
+			order.orphans.push_back(pawn.bones[i].id);
+		else
+			parentOffset[i] = found->second;
+	}
+
+	/* children of every bone as one flat list: childList[childStart[bone] .. childStart[bone + 1]) */
+	std::vector<int> childStart(count + 1, 0);
+	for (int i = 0; i < count; i++)
+		if (parentOffset[i] != -1)
+			childStart[parentOffset[i] + 1]++;
+	for (int i = 0; i < count; i++)
+		childStart[i + 1] += childStart[i];
+	std::vector<int> childList(childStart[count]);
+	std::vector<int> fill(childStart.begin(), childStart.end() - 1);
+	for (int i = 0; i < count; i++)
+		if (parentOffset[i] != -1)
+			childList[fill[parentOffset[i]]++] = i;
+
+	std::vector<int> stack;
+	for (int i = 0; i < count; i++)
+		if (parentOffset[i] == -1)
+			visitSubtree(order, i, childStart, childList, stack);
+
+	/* whatever is left hangs on a parent loop, climb to the loop and break it at the first bone found there */
+	if (static_cast<int>(order.bones.size()) < count) {
+		std::vector<int> climbed(count, -1);
+		for (int i = 0; i < count; i++) {
+			if (order.slots[i] != -1)
+				continue;
+			int bone = i;
+			while (climbed[bone] != i) {
+				climbed[bone] = i;
+				bone = parentOffset[bone];
+			}
+			int firstSlot = static_cast<int>(order.bones.size());
+			visitSubtree(order, bone, childStart, childList, stack);
+			for (int slot = firstSlot; slot < static_cast<int>(order.bones.size()); slot++)
+				order.cyclic.push_back(pawn.bones[order.bones[slot]].id);
+		}
+	}
+	return order;
+}
+
+void PoseKinematics::gatherLocal(const PoseData::BonePawn& pawn, const FKOrder& order, std::vector<glm::quat>& local) {
+	local.resize(order.bones.size());
+	for (size_t slot = 0; slot < order.bones.size(); slot++)
+		local[slot] = pawn.bones[order.bones[slot]].quaternion;
+}
+
+void PoseKinematics::evaluate(const FKOrder& order, const std::vector<glm::quat>& local, std::vector<glm::quat>& global, int begin, int end) {
+	PROFILE_SCOPE("PoseKinematics::evaluate");
+	int count = static_cast<int>(order.parents.size());
+	if (end < 0 || end > count)
+		end = count;
+	if (global.size() < static_cast<size_t>(count))
+		global.resize(count);
+	const int* parents = order.parents.data();
+	const glm::quat* in = local.data();
+	glm::quat* out = global.data();
+	for (int slot = begin; slot < end; slot++) {
+		int parent = parents[slot];
+		if (parent < 0) {
+			out[slot] = in[slot];
+			continue;
+		}
+#if QUAT_SIMD_SSE2
+		QuatSimd::store(out[slot], QuatSimd::mul(QuatSimd::load(out[parent]), QuatSimd::load(in[slot])));
+#else
+		out[slot] = QuatSimd::mul(out[parent], in[slot]);
+#endif
+	}
+}
+
+void PoseKinematics::gatherOffsets(const PoseData::BonePawn& pawn, const FKOrder& order, JointPositions& offsets) {
+	offsets.resize(order.bones.size());
+	for (size_t slot = 0; slot < order.bones.size(); slot++)
+		offsets.set(slot, pawn.bones[order.bones[slot]].offset);
+}
+
+void PoseKinematics::evaluatePositions(const FKOrder& order, const std::vector<glm::quat>& global, const JointPositions& offsets,
+	JointPositions& positions, int begin, int end) {
+	PROFILE_SCOPE("PoseKinematics::evaluatePositions");
+	int count = static_cast<int>(order.parents.size());
+	if (end < 0 || end > count)
+		end = count;
+	if (positions.size() < static_cast<size_t>(count))
+		positions.resize(count);
+	const int* parents = order.parents.data();
+	const float* ox = offsets.x.data(), * oy = offsets.y.data(), * oz = offsets.z.data();
+	float* px = positions.x.data(), * py = positions.y.data(), * pz = positions.z.data();
+
+	/* every offset is rotated into the frame of its parent first, which doesn't depend on the other slots */
+	int slot = begin;
+#if QUAT_SIMD_SSE2
+	const __m128 identity = _mm_set_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	for (; slot + 4 <= end; slot += 4) {
+		__m128 q[4], v[3], rotated[3];
+		for (int i = 0; i < 4; i++)
+			q[i] = parents[slot + i] < 0 ? identity : QuatSimd::load(global[parents[slot + i]]);
+		_MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+		v[0] = _mm_loadu_ps(ox + slot);
+		v[1] = _mm_loadu_ps(oy + slot);
+		v[2] = _mm_loadu_ps(oz + slot);
+		QuatSimd::rotate(q, v, rotated);
+		_mm_storeu_ps(px + slot, rotated[0]);
+		_mm_storeu_ps(py + slot, rotated[1]);
+		_mm_storeu_ps(pz + slot, rotated[2]);
+	}
+#endif
+	/* remainder (everything without SSE2) */
+	for (; slot < end; slot++) {
+		glm::vec3 offset(ox[slot], oy[slot], oz[slot]);
+		glm::vec3 rotated = parents[slot] < 0 ? offset : QuatSimd::rotate(global[parents[slot]], offset);
+		px[slot] = rotated.x; py[slot] = rotated.y; pz[slot] = rotated.z;
+	}
+	/* then the parent positions are accumulated, parents always precede their children */
+	for (slot = begin; slot < end; slot++) {
+		int parent = parents[slot];
+		if (parent < 0)
+			continue;
+		px[slot] += px[parent];
+		py[slot] += py[parent];
+		pz[slot] += pz[parent];
+	}
+}
+
+std::vector<glm::quat> PoseKinematics::computeGlobal(const PoseData::BonePawn& pawn) {
+	FKOrder order = buildOrder(pawn);
+	std::vector<glm::quat> local, global;
+	gatherLocal(pawn, order, local);
+	evaluate(order, local, global);
+	std::vector<glm::quat> result(pawn.bones.size());
+	for (size_t slot = 0; slot < order.bones.size(); slot++)
+		result[order.bones[slot]] = global[slot];
+	return result;
+}
+
+PoseKinematics::JointPositions PoseKinematics::computePositions(const PoseData::BonePawn& pawn) {
+	FKOrder order = buildOrder(pawn);
+	std::vector<glm::quat> local, global;
+	JointPositions offsets, positions, result;
+	gatherLocal(pawn, order, local);
+	evaluate(order, local, global);
+	gatherOffsets(pawn, order, offsets);
+	evaluatePositions(order, global, offsets, positions);
+	result.resize(pawn.bones.size());
+	for (size_t slot = 0; slot < order.bones.size(); slot++)
+		result.set(order.bones[slot], positions.get(slot));
+	return result;
+}
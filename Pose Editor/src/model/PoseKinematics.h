@@ -0,0 +1,111 @@
+/// <title>Pose Kinematics</title>
+/// <desc>
+///		Forward kinematics over BonePawn. The pawn only stores local rotations and offsets,
+///		global orientations and joint positions are derived here in linear passes.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+
+/// <summary>
+/// PoseKinematics computes global bone orientations (parent_global * local) and world space joint positions of a BonePawn.
+/// The hierarchy is flattened once into an FKOrder, after which every evaluation is a linear walk over contiguous arrays.
+/// </summary>
+namespace PoseKinematics {
+
+	/// <summary>
+	/// Parent-before-child evaluation order of a pawn. Positions in this order are called slots.
+	/// Bones are laid out in depth first preorder, so every subtree occupies the slot range [slot, subtreeEnd[slot]).
+	/// </summary>
+	struct FKOrder {
+		/// <summary>offset into pawn.bones for every slot.</summary>
+		std::vector<int> bones;
+		/// <summary>slot of the parent for every slot, -1 for roots. Always smaller than the slot itself.</summary>
+		std::vector<int> parents;
+		/// <summary>one past the last slot of the subtree starting at every slot.</summary>
+		std::vector<int> subtreeEnd;
+		/// <summary>slot for every offset into pawn.bones. Inverse of bones.</summary>
+		std::vector<int> slots;
+		/// <summary>IDs of bones whose parent ID is not present in the pawn. They are evaluated as roots.</summary>
+		std::vector<ID> orphans;
+		/// <summary>
+		/// IDs of bones which can't be reached from any root because they are part of (or hang below) a parent loop.
+		/// The first bone of every loop found is evaluated as a root to break it.
+		/// </summary>
+		std::vector<ID> cyclic;
+	};
+
+	/// <summary>
+	/// Joint positions (or offsets) stored as one array per axis, so they can be processed four at a time and scanned by spatial queries.
+	/// </summary>
+	struct JointPositions {
+		std::vector<float> x, y, z;
+		void resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); }
+		size_t size() const { return x.size(); }
+		glm::vec3 get(size_t i) const { return glm::vec3(x[i], y[i], z[i]); }
+		void set(size_t i, const glm::vec3& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+	};
+
+	/// <summary>
+	/// Flattens the hierarchy of the pawn into a parent-before-child order.
+	/// Roots (parent -1 and orphans) keep their order from the pawn, so do the children of every bone.
+	/// When several bones share an ID, the first one is used as the parent of its children.
+	/// </summary>
+	FKOrder buildOrder(const PoseData::BonePawn& pawn);
+
+	/// <summary>
+	/// Copies the local rotations of the pawn into slot order.
+	/// </summary>
+	/// <param name="local">resized to the bone count.</param>
+	void gatherLocal(const PoseData::BonePawn& pawn, const FKOrder& order, std::vector<glm::quat>& local);
+
+	/// <summary>
+	/// Computes global[slot] = global[parent] * local[slot] for the slots in [begin, end).
+	/// Parents outside of the range must already hold their global rotation.
+	/// </summary>
+	/// <param name="local">local rotations in slot order (see gatherLocal).</param>
+	/// <param name="global">resized to the bone count if smaller, receives the global rotations in slot order.</param>
+	/// <param name="end">one past the last slot evaluated, -1 for all remaining slots.</param>
+	void evaluate(const FKOrder& order, const std::vector<glm::quat>& local, std::vector<glm::quat>& global, int begin = 0, int end = -1);
+
+	/// <summary>
+	/// Copies the offsets of the pawn into slot order.
+	/// </summary>
+	/// <param name="offsets">resized to the bone count.</param>
+	void gatherOffsets(const PoseData::BonePawn& pawn, const FKOrder& order, JointPositions& offsets);
+
+	/// <summary>
+	/// Computes positions[slot] = positions[parent] + global[parent] * offsets[slot] for the slots in [begin, end). Roots are placed at their offset.
+	/// Parents outside of the range must already hold their position, global has to be up to date for the parents of the whole range.
+	/// </summary>
+	/// <param name="global">global rotations in slot order (see evaluate).</param>
+	/// <param name="offsets">offsets in slot order (see gatherOffsets).</param>
+	/// <param name="positions">resized to the bone count if smaller, receives the world space joint positions in slot order.</param>
+	/// <param name="end">one past the last slot evaluated, -1 for all remaining slots.</param>
+	void evaluatePositions(const FKOrder& order, const std::vector<glm::quat>& global, const JointPositions& offsets,
+		JointPositions& positions, int begin = 0, int end = -1);
+
+	/// <summary>
+	/// Convenience wrapper building the order and evaluating the whole pawn.
+	/// </summary>
+	/// <returns>global rotations indexed the same as pawn.bones.</returns>
+	std::vector<glm::quat> computeGlobal(const PoseData::BonePawn& pawn);
+
+	/// <summary>
+	/// Convenience wrapper building the order and computing the world space position of every joint.
+	/// </summary>
+	/// <returns>joint positions indexed the same as pawn.bones.</returns>
+	JointPositions computePositions(const PoseData::BonePawn& pawn);
+}
@@ -0,0 +1,163 @@
+/// <title>Pose Layers</title>
+/// <desc>
+///		Difference poses and stacks of weighted additive layers applied on top of a base pawn.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include "PoseLayers.h"
+
+/// <summary>
+/// Multiplies count base rotations by the weighted rotations of every layer in order and normalizes the products.
+/// </summary>
+static void composeKernel(const float* const base[4], const std::vector<const float*>& layers, glm::quat* result, size_t count) {
+	size_t i = 0;
+	const size_t layerCount = layers.size() / 4;
+#if QUAT_SIMD_SSE2
+	__m128 accumulator[4], weighted[4], product[4];
+	alignas(16) float lanes[4][4];
+	for (; i + 4 <= count; i += 4) {
+		for (int c = 0; c < 4; c++)
+			accumulator[c] = _mm_loadu_ps(base[c] + i);
+		for (size_t l = 0; l < layerCount; l++) {
+			for (int c = 0; c < 4; c++)
+				weighted[c] = _mm_loadu_ps(layers[l * 4 + c] + i);
+			QuatSimd::mul(accumulator, weighted, product);
+			for (int c = 0; c < 4; c++)
+				accumulator[c] = product[c];
+		}
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(accumulator[0], accumulator[0]), _mm_mul_ps(accumulator[1], accumulator[1])),
+			_mm_add_ps(_mm_mul_ps(accumulator[2], accumulator[2]), _mm_mul_ps(accumulator[3], accumulator[3]))));
+		__m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), length);
+		for (int c = 0; c < 4; c++)
+			_mm_store_ps(lanes[c], _mm_mul_ps(accumulator[c], inverse));
+		for (int k = 0; k < 4; k++)
+			result[i + k] = glm::quat(lanes[0][k], lanes[1][k], lanes[2][k], lanes[3][k]);
+	}
+#endif
+	/* remainder (everything without SSE2) */
+	for (; i < count; i++) {
+		glm::quat q(base[0][i], base[1][i], base[2][i], base[3][i]);
+		for (size_t l = 0; l < layerCount; l++)
+			q = QuatSimd::mul(q, glm::quat(layers[l * 4][i], layers[l * 4 + 1][i], layers[l * 4 + 2][i], layers[l * 4 + 3][i]));
+		result[i] = glm::normalize(q);
+	}
+}
+
+PoseData::BonePawn PoseLayers::difference(const PoseData::BonePawn& base, const PoseData::BonePawn& target) {
+	PROFILE_SCOPE("PoseLayers::difference");
+	PoseData::BonePawn result = base;
+	result.loaded = false;
+	result.saved = false;
+	std::vector<int> match = PoseBlend::matchBones(base, target);
+	for (size_t i = 0; i < result.bones.size(); i++) {
+		glm::quat& q = result.bones[i].quaternion;
+		q = match[i] >= 0 ? glm::normalize(glm::inverse(q) * target.bones[match[i]].quaternion) : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+	}
+	RotationBatch::pawnQuatToEuler(result);
+	return result;
+}
+
+void PoseLayers::LayerStack::matchLayer(Layer& layer) {
+	std::vector<int> match = PoseBlend::matchBones(m_BoneIds, layer.ids);
+	layer.delta.resize(m_BoneIds.size());
+	for (size_t i = 0; i < m_BoneIds.size(); i++) {
+		glm::quat q = match[i] >= 0 ? layer.source[match[i]] : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		layer.delta.w[i] = q.w; layer.delta.x[i] = q.x; layer.delta.y[i] = q.y; layer.delta.z[i] = q.z;
+	}
+	layer.dirty = true;
+}
+
+void PoseLayers::LayerStack::setBase(const PoseData::BonePawn& base) {
+	PROFILE_SCOPE("PoseLayers::LayerStack::setBase");
+	size_t count = base.bones.size();
+	bool sameBones = count == m_BoneIds.size();
+	for (size_t i = 0; sameBones && i < count; i++)
+		sameBones = base.bones[i].id == m_BoneIds[i];
+	if (!sameBones) {
+		m_BoneIds.resize(count);
+		for (size_t i = 0; i < count; i++)
+			m_BoneIds[i] = base.bones[i].id;
+		m_Identity.resize(0);
+		m_Identity.w.resize(count, 1.0f);
+		m_Identity.x.resize(count, 0.0f);
+		m_Identity.y.resize(count, 0.0f);
+		m_Identity.z.resize(count, 0.0f);
+		for (Layer& layer : m_Layers)
+			matchLayer(layer);
+	}
+	m_Base.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		const glm::quat& q = base.bones[i].quaternion;
+		m_Base.w[i] = q.w; m_Base.x[i] = q.x; m_Base.y[i] = q.y; m_Base.z[i] = q.z;
+	}
+	m_ResultValid = false;
+}
+
+int PoseLayers::LayerStack::addLayer(const PoseData::BonePawn& difference, float weight) {
+	Layer layer;
+	layer.ids.resize(difference.bones.size());
+	layer.source.resize(difference.bones.size());
+	for (size_t i = 0; i < difference.bones.size(); i++) {
+		layer.ids[i] = difference.bones[i].id;
+		layer.source[i] = difference.bones[i].quaternion;
+	}
+	layer.weight = weight;
+	matchLayer(layer);
+	m_Layers.push_back(std::move(layer));
+	m_ResultValid = false;
+	return static_cast<int>(m_Layers.size()) - 1;
+}
+
+void PoseLayers::LayerStack::removeLayer(int index) {
+	if (index < 0 || index >= size())
+		return;
+	m_Layers.erase(m_Layers.begin() + index);
+	m_ResultValid = false;
+}
+
+void PoseLayers::LayerStack::clear() {
+	m_Layers.clear();
+	m_ResultValid = false;
+}
+
+void PoseLayers::LayerStack::setWeight(int index, float weight) {
+	if (index < 0 || index >= size() || m_Layers[index].weight == weight)
+		return;
+	m_Layers[index].weight = weight;
+	m_Layers[index].dirty = true;
+	m_ResultValid = false;
+}
+
+float PoseLayers::LayerStack::getWeight(int index) const {
+	return index >= 0 && index < size() ? m_Layers[index].weight : 0.0f;
+}
+
+int PoseLayers::LayerStack::size() const {
+	return static_cast<int>(m_Layers.size());
+}
+
+const std::vector<glm::quat>& PoseLayers::LayerStack::evaluate() {
+	PROFILE_SCOPE("PoseLayers::LayerStack::evaluate");
+	if (m_ResultValid)
+		return m_Result;
+	std::vector<const float*> layers;
+	layers.reserve(m_Layers.size() * 4);
+	for (Layer& layer : m_Layers) {
+		/* a layer without weight is the identity, leave it out of the product */
+		if (layer.weight == 0.0f)
+			continue;
+		if (layer.dirty) {
+			PoseBlend::blend(m_Identity, layer.delta, layer.weight, nullptr, layer.weighted, PoseBlend::BlendMode::Slerp);
+			layer.dirty = false;
+		}
+		layers.insert(layers.end(), { layer.weighted.w.data(), layer.weighted.x.data(), layer.weighted.y.data(), layer.weighted.z.data() });
+	}
+	const float* const base[4] = { m_Base.w.data(), m_Base.x.data(), m_Base.y.data(), m_Base.z.data() };
+	m_Result.resize(m_Base.size());
+	composeKernel(base, layers, m_Result.data(), m_Base.size());
+	m_ResultValid = true;
+	return m_Result;
+}
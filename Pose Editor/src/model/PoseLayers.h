@@ -0,0 +1,105 @@
+/// <title>Pose Layers</title>
+/// <desc>
+///		Difference poses and stacks of weighted additive layers applied on top of a base pawn.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+#include "RotationBatch.h"
+#include "PoseBlend.h"
+
+/// <summary>
+/// PoseLayers builds pose variations out of small differences instead of full copies of a pose.
+/// A difference pose holds inverse(base) * target for every bone, applying it with weight 1 on top of base gives target again.
+/// Bones are matched by ID, as in PoseBlend.
+/// </summary>
+namespace PoseLayers {
+
+	/// <summary>
+	/// Computes the difference pose turning base into target. Bones missing in target get the identity rotation.
+	/// </summary>
+	/// <returns>pawn with the bones, hierarchy and rotation order of base, not loaded from any file.</returns>
+	PoseData::BonePawn difference(const PoseData::BonePawn& base, const PoseData::BonePawn& target);
+
+	/// <summary>
+	/// Stack of difference poses applied on top of a base pawn, in the order they were added:
+	/// result = base * layer0^weight0 * layer1^weight1 * ... per bone.
+	/// The weighted rotation of every layer is cached, so changing the weight of one layer only recomputes that layer
+	/// before composing the stack. Composing is a single pass over the bones, multiplying four bones by all layers at a time.
+	/// </summary>
+	class LayerStack {
+	private:
+		struct Layer {
+			/// <summary>bone IDs and rotations of the difference pose as added, kept to match them against a new base.</summary>
+			std::vector<ID> ids;
+			std::vector<glm::quat> source;
+			/// <summary>difference rotations indexed the same as the base bones.</summary>
+			RotationBatch::QuatLanes delta;
+			/// <summary>delta raised to weight, valid unless dirty.</summary>
+			RotationBatch::QuatLanes weighted;
+			float weight = 1.0f;
+			bool dirty = true;
+		};
+
+		std::vector<ID> m_BoneIds;
+		RotationBatch::QuatLanes m_Base;
+		/// <summary>identity rotations, the weight 0 end of every layer.</summary>
+		RotationBatch::QuatLanes m_Identity;
+		std::vector<Layer> m_Layers;
+		std::vector<glm::quat> m_Result;
+		bool m_ResultValid = false;
+
+		void matchLayer(Layer& layer);
+
+	public:
+		/// <summary>
+		/// Sets the pawn the layers are applied on. Keeps the layers, they are matched anew if the bones differ from the previous base.
+		/// </summary>
+		void setBase(const PoseData::BonePawn& base);
+
+		/// <summary>
+		/// Adds a difference pose on top of the stack. Bones of the base missing in the difference are not affected.
+		/// </summary>
+		/// <param name="weight">0 disables the layer, 1 applies it fully. Other values interpolate (or extrapolate) along the shorter arc.</param>
+		/// <returns>index of the new layer.</returns>
+		int addLayer(const PoseData::BonePawn& difference, float weight = 1.0f);
+
+		/// <summary>
+		/// Removes the layer at index, the layers above it move down by one.
+		/// </summary>
+		void removeLayer(int index);
+
+		/// <summary>
+		/// Removes all layers, keeping the base.
+		/// </summary>
+		void clear();
+
+		/// <summary>
+		/// Changes the weight of the layer at index. Only that layer is recomputed by the next evaluate().
+		/// </summary>
+		void setWeight(int index, float weight);
+
+		/// <returns>weight of the layer at index.</returns>
+		float getWeight(int index) const;
+
+		/// <returns>amount of layers.</returns>
+		int size() const;
+
+		/// <summary>
+		/// Applies the layers on the base. Returns the cached result if nothing changed since the last call.
+		/// </summary>
+		/// <returns>rotations indexed the same as the base bones, valid until the next change of the stack.</returns>
+		const std::vector<glm::quat>& evaluate();
+	};
+}
@@ -0,0 +1,366 @@
+/// <title>Pose Library</title>
+/// <desc>
+///		Collections of poses sharing one skeleton, stored a column of rotations per pose, and the library files.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>first bytes of a library file.</summary>
+#define LIBRARY_MAGIC "PLIB"
+#define LIBRARY_VERSION 1u
+#define LIBRARY_EXTENSION ".plib"
+#define LIBRARY_LOAD_FAILED Library()
+#define MAX_BONE_LIMIT 1000000
+#define MAX_POSE_LIMIT 100000000
+
+#include "PoseLibrary.h"
+
+void PoseLibrary::Library::reset(const PoseData::BonePawn& skeleton) {
+	m_Skeleton = skeleton;
+	m_Rows.assign(skeleton.bones.size(), RotationBatch::QuatLanes());
+	m_PackedRows.clear();
+	m_Packed = false;
+	m_Names.clear();
+}
+
+void PoseLibrary::Library::build(const PoseData::BonePawn& skeleton, std::vector<RotationBatch::QuatLanes> rows, std::vector<std::string> names) {
+	reset(skeleton);
+	if (rows.size() != skeleton.bones.size())
+		return;
+	for (const RotationBatch::QuatLanes& row : rows) {
+		if (row.size() != names.size())
+			return;
+	}
+	m_Rows = std::move(rows);
+	m_Names = std::move(names);
+}
+
+void PoseLibrary::Library::build(const PoseData::BonePawn& skeleton, std::vector<QuatPack::PackedRotations> rows, std::vector<std::string> names) {
+	reset(skeleton);
+	if (rows.size() != skeleton.bones.size())
+		return;
+	for (const QuatPack::PackedRotations& row : rows) {
+		if (row.size() != names.size() || row.getPrecision() != rows.front().getPrecision())
+			return;
+	}
+	m_Rows.clear();
+	m_PackedRows = std::move(rows);
+	m_Packed = true;
+	m_Names = std::move(names);
+}
+
+int PoseLibrary::Library::addPose(const std::vector<glm::quat>& rotations, const std::string& name) {
+	if (rotations.size() != m_Skeleton.bones.size())
+		return -1;
+	if (m_Packed) {
+		for (size_t b = 0; b < m_PackedRows.size(); b++)
+			m_PackedRows[b].append(glm::normalize(rotations[b]));
+		m_Names.push_back(name);
+		return static_cast<int>(m_Names.size()) - 1;
+	}
+	for (size_t b = 0; b < m_Rows.size(); b++) {
+		RotationBatch::QuatLanes& row = m_Rows[b];
+		row.w.push_back(rotations[b].w);
+		row.x.push_back(rotations[b].x);
+		row.y.push_back(rotations[b].y);
+		row.z.push_back(rotations[b].z);
+	}
+	m_Names.push_back(name);
+	return static_cast<int>(m_Names.size()) - 1;
+}
+
+int PoseLibrary::Library::addPose(const PoseData::BonePawn& pawn, const std::string& name) {
+	std::vector<glm::quat> rotations(m_Skeleton.bones.size());
+	/* poses saved from the same skeleton list the bones in the same order, which needs no lookup */
+	bool aligned = pawn.bones.size() == m_Skeleton.bones.size();
+	for (size_t b = 0; b < pawn.bones.size() && aligned; b++)
+		aligned = pawn.bones[b].id == m_Skeleton.bones[b].id;
+	if (aligned) {
+		for (size_t b = 0; b < rotations.size(); b++)
+			rotations[b] = pawn.bones[b].quaternion;
+	}
+	else {
+		std::vector<int> match = PoseBlend::matchBones(m_Skeleton, pawn);
+		for (size_t b = 0; b < rotations.size(); b++)
+			rotations[b] = match[b] >= 0 ? pawn.bones[match[b]].quaternion : m_Skeleton.bones[b].quaternion;
+	}
+	return addPose(rotations, name);
+}
+
+void PoseLibrary::Library::reserve(size_t poseCount) {
+	for (RotationBatch::QuatLanes& row : m_Rows) {
+		row.w.reserve(poseCount);
+		row.x.reserve(poseCount);
+		row.y.reserve(poseCount);
+		row.z.reserve(poseCount);
+	}
+	for (QuatPack::PackedRotations& row : m_PackedRows)
+		row.reserve(poseCount);
+	m_Names.reserve(poseCount);
+}
+
+void PoseLibrary::Library::pack(QuatPack::Precision precision) {
+	PROFILE_SCOPE("PoseLibrary::Library::pack");
+	if (m_Packed && (m_PackedRows.empty() || m_PackedRows.front().getPrecision() == precision))
+		return;
+	/* the packing assumes unit quaternions, every row is normalized on the way and released once packed */
+	std::vector<QuatPack::PackedRotations> packedRows(m_Skeleton.bones.size());
+	RotationBatch::QuatLanes normalized;
+	normalized.resize(m_Names.size());
+	for (size_t b = 0; b < packedRows.size(); b++) {
+		if (m_Packed) {
+			m_PackedRows[b].decode(0, m_Names.size(), normalized);
+		}
+		else {
+			const RotationBatch::QuatLanes& row = m_Rows[b];
+			for (size_t p = 0; p < m_Names.size(); p++) {
+				float inverse = 1.0f / std::sqrt(row.w[p] * row.w[p] + row.x[p] * row.x[p] + row.y[p] * row.y[p] + row.z[p] * row.z[p]);
+				normalized.w[p] = row.w[p] * inverse;
+				normalized.x[p] = row.x[p] * inverse;
+				normalized.y[p] = row.y[p] * inverse;
+				normalized.z[p] = row.z[p] * inverse;
+			}
+			m_Rows[b] = RotationBatch::QuatLanes();
+		}
+		packedRows[b].reset(precision);
+		packedRows[b].append(normalized);
+		packedRows[b].shrink();
+	}
+	m_PackedRows = std::move(packedRows);
+	m_Packed = true;
+}
+
+bool PoseLibrary::Library::isPacked() const {
+	return m_Packed;
+}
+
+const PoseData::BonePawn& PoseLibrary::Library::getSkeleton() const {
+	return m_Skeleton;
+}
+
+int PoseLibrary::Library::getPoseCount() const {
+	return static_cast<int>(m_Names.size());
+}
+
+int PoseLibrary::Library::getBoneCount() const {
+	return static_cast<int>(m_Skeleton.bones.size());
+}
+
+const std::string& PoseLibrary::Library::getName(int pose) const {
+	return m_Names[pose];
+}
+
+void PoseLibrary::Library::getPose(int pose, std::vector<glm::quat>& rotations) const {
+	if (rotations.size() != m_Skeleton.bones.size())
+		rotations.resize(m_Skeleton.bones.size());
+	for (size_t b = 0; b < rotations.size(); b++)
+		rotations[b] = getRotation(pose, static_cast<int>(b));
+}
+
+PoseData::BonePawn PoseLibrary::Library::getPawn(int pose) const {
+	PoseData::BonePawn pawn = m_Skeleton;
+	for (size_t b = 0; b < pawn.bones.size(); b++)
+		pawn.bones[b].quaternion = getRotation(pose, static_cast<int>(b));
+	RotationBatch::pawnQuatToEuler(pawn);
+	pawn.originalFilePath = "";
+	pawn.originalFileName = PoseDataUtil::addExtension(m_Names[pose]);
+	pawn.loaded = false;
+	return pawn;
+}
+
+size_t PoseLibrary::Library::getRotationBytes() const {
+	if (!m_Packed)
+		return m_Rows.size() * m_Names.size() * 4 * sizeof(float);
+	size_t bytes = 0;
+	for (const QuatPack::PackedRotations& row : m_PackedRows)
+		bytes += row.getByteSize();
+	return bytes;
+}
+
+bool PoseLibrary::isLibraryFile(const std::string& path) {
+	size_t last = path.find_last_of('.');
+	return last != std::string::npos && path.substr(last) == LIBRARY_EXTENSION;
+}
+
+std::string PoseLibrary::addExtension(std::string path) {
+	size_t last = path.find_last_of('.');
+	if (last != std::string::npos && last > path.find_last_of("/\\") + 1) {
+		if (path.substr(last) == LIBRARY_EXTENSION)
+			return path;
+		path = path.substr(0, last);
+	}
+	return path.append(LIBRARY_EXTENSION);
+}
+
+PoseLibrary::Library PoseLibrary::openLibrary(const std::string& path, PoseData::RotationOrder order, bool packed) {
+	PROFILE_SCOPE("PoseLibrary::openLibrary");
+	std::ifstream ifile(path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!ifile.is_open()) {
+		std::fprintf(stderr, "Trouble reading '%s': Could not open file.", path.c_str());
+		return LIBRARY_LOAD_FAILED;
+	}
+	uint64_t fileSize = static_cast<uint64_t>(ifile.tellg());
+	ifile.seekg(0);
+	char magic[4] = {};
+	uint32_t version = 0, precision = 0, columns = 0, boneCount = 0, poseCount = 0;
+	ifile.read(magic, 4);
+	ifile.read(reinterpret_cast<char*>(&version), sizeof(version));
+	ifile.read(reinterpret_cast<char*>(&precision), sizeof(precision));
+	ifile.read(reinterpret_cast<char*>(&columns), sizeof(columns));
+	ifile.read(reinterpret_cast<char*>(&boneCount), sizeof(boneCount));
+	ifile.read(reinterpret_cast<char*>(&poseCount), sizeof(poseCount));
+	if (!ifile || std::string(magic, 4) != LIBRARY_MAGIC || version != LIBRARY_VERSION ||
+		precision > static_cast<uint32_t>(QuatPack::Precision::Bits48) || boneCount > MAX_BONE_LIMIT || poseCount > MAX_POSE_LIMIT) {
+		std::fprintf(stderr, "Trouble reading '%s': Not a pose library of version %u.", path.c_str(), LIBRARY_VERSION);
+		return LIBRARY_LOAD_FAILED;
+	}
+	/* the counts are checked against the rest of the file before anything is allocated for them */
+	QuatPack::Precision packing = static_cast<QuatPack::Precision>(precision);
+	uint64_t leastSize = static_cast<uint64_t>(ifile.tellg()) + static_cast<uint64_t>(boneCount) * QuatPack::bytesPer(packing) +
+		static_cast<uint64_t>(poseCount) * sizeof(uint16_t) + static_cast<uint64_t>(boneCount) * poseCount * QuatPack::bytesPer(packing);
+	if (leastSize > fileSize) {
+		std::fprintf(stderr, "Trouble reading '%s': %u poses of %u bones do not fit the file.", path.c_str(), poseCount, boneCount);
+		return LIBRARY_LOAD_FAILED;
+	}
+	PoseData::BonePawn skeleton;
+	skeleton.bones.resize(boneCount);
+	for (PoseData::BoneData& bone : skeleton.bones) {
+		if (!PoseDataUtil::boneReadBinary(ifile, bone, static_cast<int>(columns))) {
+			std::fprintf(stderr, "Trouble reading '%s': Truncated or invalid bone.", path.c_str());
+			return LIBRARY_LOAD_FAILED;
+		}
+	}
+	/* rotations of the skeleton, which bones missing in added poses take */
+	std::vector<uint8_t> bytes(static_cast<size_t>(std::max(boneCount, poseCount)) * QuatPack::bytesPer(packing));
+	RotationBatch::QuatLanes rest;
+	ifile.read(reinterpret_cast<char*>(bytes.data()), static_cast<size_t>(boneCount) * QuatPack::bytesPer(packing));
+	if (!ifile) {
+		std::fprintf(stderr, "Trouble reading '%s': Truncated rotations.", path.c_str());
+		return LIBRARY_LOAD_FAILED;
+	}
+	QuatPack::unpack(bytes.data(), boneCount, packing, rest);
+	for (uint32_t b = 0; b < boneCount; b++)
+		skeleton.bones[b].quaternion = glm::quat(rest.w[b], rest.x[b], rest.y[b], rest.z[b]);
+	std::vector<std::string> names(poseCount);
+	for (std::string& name : names) {
+		uint16_t length = 0;
+		ifile.read(reinterpret_cast<char*>(&length), sizeof(length));
+		name.resize(length);
+		ifile.read(&name[0], length);
+		if (!ifile) {
+			std::fprintf(stderr, "Trouble reading '%s': Truncated pose names.", path.c_str());
+			return LIBRARY_LOAD_FAILED;
+		}
+	}
+	/* a packed row becomes the lanes of the row without any reordering, or is kept as it is */
+	std::vector<RotationBatch::QuatLanes> rows(packed ? 0 : boneCount);
+	std::vector<QuatPack::PackedRotations> packedRows(packed ? boneCount : 0);
+	for (uint32_t b = 0; b < boneCount; b++) {
+		ifile.read(reinterpret_cast<char*>(bytes.data()), static_cast<size_t>(poseCount) * QuatPack::bytesPer(packing));
+		if (!ifile) {
+			std::fprintf(stderr, "Trouble reading '%s': Truncated rotations.", path.c_str());
+			return LIBRARY_LOAD_FAILED;
+		}
+		if (packed) {
+			packedRows[b].reset(packing);
+			packedRows[b].appendPacked(bytes.data(), poseCount);
+		}
+		else {
+			QuatPack::unpack(bytes.data(), poseCount, packing, rows[b]);
+		}
+	}
+	ifile.close();
+	skeleton.originalFilePath = path;
+	skeleton.originalFileName = PoseDataUtil::parseFilename(path);
+	skeleton.rotationOrder = order;
+	skeleton.loaded = true;
+	skeleton.saved = true;
+	RotationBatch::pawnQuatToEuler(skeleton);
+	Library library;
+	if (packed)
+		library.build(skeleton, std::move(packedRows), std::move(names));
+	else
+		library.build(skeleton, std::move(rows), std::move(names));
+	return library;
+}
+
+bool PoseLibrary::saveLibrary(const Library& library, const std::string& path, QuatPack::Precision precision) {
+	PROFILE_SCOPE("PoseLibrary::saveLibrary");
+	std::ofstream ofile(path.c_str(), std::ios::out | std::ios::binary);
+	if (!ofile.is_open()) {
+		std::fprintf(stderr, "Trouble writing to '%s': Could not open file.", path.c_str());
+		return false;
+	}
+	/* header, bones, their rotations, names of the poses, then the rotations of every bone in all poses */
+	const PoseData::BonePawn& skeleton = library.getSkeleton();
+	uint32_t version = LIBRARY_VERSION, packing = static_cast<uint32_t>(precision), columns = static_cast<uint32_t>(PoseDataUtil::pawnCSVColumns(skeleton));
+	uint32_t boneCount = static_cast<uint32_t>(library.getBoneCount()), poseCount = static_cast<uint32_t>(library.getPoseCount());
+	ofile.write(LIBRARY_MAGIC, 4);
+	ofile.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	ofile.write(reinterpret_cast<const char*>(&packing), sizeof(packing));
+	ofile.write(reinterpret_cast<const char*>(&columns), sizeof(columns));
+	ofile.write(reinterpret_cast<const char*>(&boneCount), sizeof(boneCount));
+	ofile.write(reinterpret_cast<const char*>(&poseCount), sizeof(poseCount));
+	for (const PoseData::BoneData& bone : skeleton.bones)
+		PoseDataUtil::boneWriteBinary(ofile, bone, static_cast<int>(columns));
+	RotationBatch::QuatLanes rest;
+	rest.resize(boneCount);
+	for (uint32_t b = 0; b < boneCount; b++) {
+		glm::quat q = glm::normalize(skeleton.bones[b].quaternion);
+		rest.w[b] = q.w;
+		rest.x[b] = q.x;
+		rest.y[b] = q.y;
+		rest.z[b] = q.z;
+	}
+	std::vector<uint8_t> packed(static_cast<size_t>(std::max(boneCount, poseCount)) * QuatPack::bytesPer(precision));
+	QuatPack::pack(rest, precision, packed.data());
+	ofile.write(reinterpret_cast<const char*>(packed.data()), static_cast<size_t>(boneCount) * QuatPack::bytesPer(precision));
+	for (uint32_t p = 0; p < poseCount; p++) {
+		const std::string& name = library.getName(static_cast<int>(p));
+		uint16_t length = static_cast<uint16_t>(std::min<size_t>(name.size(), UINT16_MAX));
+		ofile.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		ofile.write(name.data(), length);
+	}
+	/* the packing assumes unit quaternions, rows are normalized on the way. Rows packed at the precision are written as they are */
+	RotationBatch::QuatLanes normalized;
+	normalized.resize(poseCount);
+	for (uint32_t b = 0; b < boneCount; b++) {
+		if (library.isPacked()) {
+			const QuatPack::PackedRotations& packedRow = library.getPackedRow(static_cast<int>(b));
+			if (packedRow.getPrecision() == precision) {
+				ofile.write(reinterpret_cast<const char*>(packedRow.data()), packedRow.getByteSize());
+				continue;
+			}
+			packedRow.decode(0, poseCount, normalized);
+			QuatPack::pack(normalized, precision, packed.data());
+			ofile.write(reinterpret_cast<const char*>(packed.data()), static_cast<size_t>(poseCount) * QuatPack::bytesPer(precision));
+			continue;
+		}
+		const RotationBatch::QuatLanes& row = library.getRow(static_cast<int>(b));
+		for (uint32_t p = 0; p < poseCount; p++) {
+			float inverse = 1.0f / std::sqrt(row.w[p] * row.w[p] + row.x[p] * row.x[p] + row.y[p] * row.y[p] + row.z[p] * row.z[p]);
+			normalized.w[p] = row.w[p] * inverse;
+			normalized.x[p] = row.x[p] * inverse;
+			normalized.y[p] = row.y[p] * inverse;
+			normalized.z[p] = row.z[p] * inverse;
+		}
+		QuatPack::pack(normalized, precision, packed.data());
+		ofile.write(reinterpret_cast<const char*>(packed.data()), static_cast<size_t>(poseCount) * QuatPack::bytesPer(precision));
+	}
+	ofile.close();
+	return static_cast<bool>(ofile);
+}
+
+PoseLibrary::Library PoseLibrary::fromPoses(const std::vector<PoseData::BonePawn>& poses) {
+	PROFILE_SCOPE("PoseLibrary::fromPoses");
+	Library library;
+	if (poses.empty())
+		return library;
+	library.reset(poses.front());
+	library.reserve(poses.size());
+	for (const PoseData::BonePawn& pose : poses)
+		library.addPose(pose, pose.originalFileName);
+	return library;
+}
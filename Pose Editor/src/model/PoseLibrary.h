@@ -0,0 +1,159 @@
+/// <title>Pose Library</title>
+/// <desc>
+///		Collections of poses sharing one skeleton, stored a column of rotations per pose, and the library files.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "PoseBlend.h"
+#include "PoseDataUtil.h"
+#include "QuatPack.h"
+#include "RotationBatch.h"
+
+/// <summary>
+/// PoseLibrary stores large numbers of poses of one skeleton. The skeleton (ids, parents, names, offsets, limits and
+/// constraints) is held once, a pose only adds a rotation per bone, unlike a pose file per pose repeating the skeleton.
+/// </summary>
+namespace PoseLibrary {
+
+	/// <summary>
+	/// Library holds a skeleton and any number of poses of it. The rotations form a table with a row per bone and a column per
+	/// pose. Every row is stored as quaternion lanes, so scanning one bone across all poses reads four contiguous arrays,
+	/// and pose N is gathered from position N of every row, in time independent of the amount of poses. Optionally the rows
+	/// are kept packed by QuatPack instead (see pack()), at 4 or 6 bytes per rotation instead of 16.
+	/// </summary>
+	class Library {
+	private:
+		/// <summary>bones of the library. Their rotations are given to the bones missing in pawns added as poses.</summary>
+		PoseData::BonePawn m_Skeleton;
+		/// <summary>rotations of every pose, a row per bone indexed the same as the skeleton's bones.</summary>
+		std::vector<RotationBatch::QuatLanes> m_Rows;
+		/// <summary>the same rotations packed, a row per bone, used instead of m_Rows while packed.</summary>
+		std::vector<QuatPack::PackedRotations> m_PackedRows;
+		bool m_Packed = false;
+		/// <summary>name of every pose, such as the file it was added from.</summary>
+		std::vector<std::string> m_Names;
+
+	public:
+		/// <summary>
+		/// Empties the library and sets the skeleton of the poses added from now on. The library is no longer packed.
+		/// </summary>
+		void reset(const PoseData::BonePawn& skeleton);
+		/// <summary>
+		/// Replaces the library by the skeleton and the rows of its rotations.
+		/// </summary>
+		/// <param name="rows">rotations of every bone of the skeleton, each holding a rotation per name. Ignored if the sizes differ.</param>
+		/// <param name="names">name of every pose.</param>
+		void build(const PoseData::BonePawn& skeleton, std::vector<RotationBatch::QuatLanes> rows, std::vector<std::string> names);
+		/// <summary>
+		/// Replaces the library by the skeleton and the packed rows of its rotations, which it keeps packed.
+		/// </summary>
+		/// <param name="rows">packed rotations of every bone of the skeleton at the same precision, each holding a rotation per name. Ignored if the sizes differ.</param>
+		/// <param name="names">name of every pose.</param>
+		void build(const PoseData::BonePawn& skeleton, std::vector<QuatPack::PackedRotations> rows, std::vector<std::string> names);
+		/// <summary>
+		/// Adds a pose at the end of the library.
+		/// </summary>
+		/// <param name="rotations">rotation of every bone, indexed the same as the skeleton's bones. Ignored if the sizes differ.</param>
+		/// <returns>index of the pose, -1 if it was ignored.</returns>
+		int addPose(const std::vector<glm::quat>& rotations, const std::string& name);
+		/// <summary>
+		/// Adds a pawn as a pose, its bones are matched to the skeleton by ID. Bones missing in the pawn take the rotation of
+		/// the skeleton.
+		/// </summary>
+		/// <returns>index of the pose.</returns>
+		int addPose(const PoseData::BonePawn& pawn, const std::string& name);
+		/// <summary>
+		/// Preallocates the rows for the amount of poses.
+		/// </summary>
+		void reserve(size_t poseCount);
+		/// <summary>
+		/// Packs the rows at the precision and keeps them packed, poses added later are packed as they come. Reading a
+		/// rotation then unpacks it, which costs a few nanoseconds, and rotations are within QuatPack::maxError() of the
+		/// ones added. A library opened packed (see openLibrary()) skips the unpacking of the file altogether.
+		/// </summary>
+		void pack(QuatPack::Precision precision);
+		/// <returns>true if the rows are packed.</returns>
+		bool isPacked() const;
+
+		/// <returns>bones of the library.</returns>
+		const PoseData::BonePawn& getSkeleton() const;
+		/// <returns>amount of poses.</returns>
+		int getPoseCount() const;
+		/// <returns>amount of bones of every pose.</returns>
+		int getBoneCount() const;
+		/// <returns>name of the pose.</returns>
+		const std::string& getName(int pose) const;
+
+		/// <returns>rotation of the bone in the pose.</returns>
+		inline glm::quat getRotation(int pose, int bone) const {
+			if (m_Packed)
+				return m_PackedRows[bone].get(pose);
+			const RotationBatch::QuatLanes& row = m_Rows[bone];
+			return glm::quat(row.w[pose], row.x[pose], row.y[pose], row.z[pose]);
+		}
+		/// <returns>row of the bone: its rotation in every pose, indexed by pose. Empty while packed.</returns>
+		inline const RotationBatch::QuatLanes& getRow(int bone) const { return m_Rows[bone]; }
+		/// <returns>packed row of the bone, see pack(). Empty while not packed.</returns>
+		inline const QuatPack::PackedRotations& getPackedRow(int bone) const { return m_PackedRows[bone]; }
+
+		/// <summary>
+		/// Writes the rotations of the pose into rotations. Costs the same for any pose of any library.
+		/// </summary>
+		/// <param name="rotations">resized only if it does not hold the bone count, indexed the same as the skeleton's bones.</param>
+		void getPose(int pose, std::vector<glm::quat>& rotations) const;
+		/// <returns>the skeleton posed by the pose, named after it.</returns>
+		PoseData::BonePawn getPawn(int pose) const;
+
+		/// <returns>bytes held by the rotations of all poses, packed or not.</returns>
+		size_t getRotationBytes() const;
+	};
+
+	// === File IO ===
+
+	/// <returns>true if the path ends with .plib, the extension of the library files.</returns>
+	bool isLibraryFile(const std::string& path);
+
+	/// <summary>
+	/// Replaces the extension of path by .plib, unless it already has it.
+	/// </summary>
+	std::string addExtension(std::string path);
+
+	/// <summary>
+	/// Reads a library file, see saveLibrary().
+	/// </summary>
+	/// <param name="order">rotation order of the skeleton, its euler angles are derived in this order.</param>
+	/// <param name="packed">keeps the rows packed as in the file, see Library::pack().</param>
+	/// <returns>parsed library. When an error occurs, the skeleton of the returned library has loaded set to false.</returns>
+	Library openLibrary(const std::string& path, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ, bool packed = false);
+
+	/// <summary>
+	/// Writes the library in binary: the header, the skeleton in the format of the compact pose files, the names of the poses,
+	/// then the rotations row after row, packed by QuatPack. A row unpacks straight into the lanes of the library.
+	/// </summary>
+	/// <param name="precision">size of the packed rotations, see QuatPack::maxError() for the error it brings.</param>
+	/// <returns>true if successful.</returns>
+	bool saveLibrary(const Library& library, const std::string& path, QuatPack::Precision precision = QuatPack::Precision::Bits48);
+
+	/// <summary>
+	/// Builds a library from poses. The skeleton is taken from the first pose, bones of the other poses are matched to it by ID.
+	/// Poses are named after their files.
+	/// </summary>
+	Library fromPoses(const std::vector<PoseData::BonePawn>& poses);
+}
@@ -0,0 +1,194 @@
+/// <title>Pose Limits</title>
+/// <desc>
+///		Clamping of bone rotations to their joint limits.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>amount of limited bones clamped at once by the pawn pass, keeps the lanes on the stack.</summary>
+#define LIMIT_BLOCK 256
+/// <summary>half angle in radians a rotation may exceed its limit by without being clamped, keeps a clamped pose stable on the next pass.</summary>
+#define LIMIT_SLACK 1e-5f
+/// <summary>length of the twist part below which the rotation is a pure half turn swing and has no defined twist.</summary>
+#define LIMIT_EPSILON 1e-6f
+/// <summary>degrees to radians of the half angle.</summary>
+#define HALF_RADIANS 0.00872664625997165f
+
+#include "PoseLimits.h"
+
+#if QUAT_SIMD_SSE2
+/// <summary>
+/// Clamps four rotations held as one register per component, in place. Limits are given as half angles in radians,
+/// swing as its cosine and sine.
+/// </summary>
+/// <returns>all bits set in the lanes that were clamped, the other lanes keep their input.</returns>
+static inline __m128 clamp4(__m128 q[4], __m128 swingCos, __m128 swingSin, __m128 twistMin, __m128 twistMax) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	/* normalize and move into the w >= 0 hemisphere */
+	__m128 length = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q[0], q[0]), _mm_mul_ps(q[1], q[1])),
+		_mm_add_ps(_mm_mul_ps(q[2], q[2]), _mm_mul_ps(q[3], q[3])));
+	__m128 scale = _mm_xor_ps(_mm_div_ps(one, _mm_sqrt_ps(length)), _mm_and_ps(q[0], QuatSimd::signMask()));
+	__m128 w = _mm_mul_ps(q[0], scale), x = _mm_mul_ps(q[1], scale), y = _mm_mul_ps(q[2], scale), z = _mm_mul_ps(q[3], scale);
+
+	/* twist = (c, 0, t, 0), the projection onto the Y axis */
+	__m128 twistLength = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(w, w), _mm_mul_ps(y, y)));
+	__m128 degenerate = _mm_cmplt_ps(twistLength, _mm_set1_ps(LIMIT_EPSILON));
+	__m128 inverse = _mm_div_ps(one, _mm_or_ps(_mm_andnot_ps(degenerate, twistLength), _mm_and_ps(degenerate, one)));
+	__m128 c = _mm_or_ps(_mm_andnot_ps(degenerate, _mm_mul_ps(w, inverse)), _mm_and_ps(degenerate, one));
+	__m128 t = _mm_andnot_ps(degenerate, _mm_mul_ps(y, inverse));
+	/* swing = q * conjugate(twist), it has no Y component */
+	__m128 sw = _mm_add_ps(_mm_mul_ps(w, c), _mm_mul_ps(y, t));
+	__m128 sx = _mm_add_ps(_mm_mul_ps(x, c), _mm_mul_ps(z, t));
+	__m128 sz = _mm_sub_ps(_mm_mul_ps(z, c), _mm_mul_ps(x, t));
+
+	__m128 half = QuatSimd::atan2(t, c);
+	__m128 twistClamped = _mm_or_ps(_mm_cmplt_ps(half, _mm_sub_ps(twistMin, _mm_set1_ps(LIMIT_SLACK))),
+		_mm_cmpgt_ps(half, _mm_add_ps(twistMax, _mm_set1_ps(LIMIT_SLACK))));
+	__m128 clampedSin, clampedCos;
+	QuatSimd::sinCos(_mm_min_ps(_mm_max_ps(half, twistMin), twistMax), clampedSin, clampedCos);
+	c = _mm_or_ps(_mm_and_ps(twistClamped, clampedCos), _mm_andnot_ps(twistClamped, c));
+	t = _mm_or_ps(_mm_and_ps(twistClamped, clampedSin), _mm_andnot_ps(twistClamped, t));
+
+	/* a swing beyond the cone keeps its axis, the angle is set to the limit */
+	__m128 swingClamped = _mm_cmplt_ps(sw, _mm_sub_ps(swingCos, _mm_set1_ps(LIMIT_SLACK)));
+	__m128 axisLength = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(sx, sx), _mm_mul_ps(sz, sz)));
+	__m128 axisScale = _mm_div_ps(swingSin, _mm_max_ps(axisLength, _mm_set1_ps(LIMIT_EPSILON)));
+	sw = _mm_or_ps(_mm_and_ps(swingClamped, swingCos), _mm_andnot_ps(swingClamped, sw));
+	sx = _mm_or_ps(_mm_and_ps(swingClamped, _mm_mul_ps(sx, axisScale)), _mm_andnot_ps(swingClamped, sx));
+	sz = _mm_or_ps(_mm_and_ps(swingClamped, _mm_mul_ps(sz, axisScale)), _mm_andnot_ps(swingClamped, sz));
+
+	/* swing * twist */
+	__m128 changed = _mm_or_ps(twistClamped, swingClamped);
+	__m128 result[4] = {
+		_mm_mul_ps(sw, c),
+		_mm_sub_ps(_mm_mul_ps(sx, c), _mm_mul_ps(sz, t)),
+		_mm_mul_ps(sw, t),
+		_mm_add_ps(_mm_mul_ps(sx, t), _mm_mul_ps(sz, c)) };
+	for (int k = 0; k < 4; k++)
+		q[k] = _mm_or_ps(_mm_and_ps(changed, result[k]), _mm_andnot_ps(changed, q[k]));
+	return changed;
+}
+#endif
+
+PoseLimits::JointLimit PoseLimits::sanitize(const JointLimit& limit) {
+	JointLimit result;
+	result.swing = glm::clamp(limit.swing, 0.0f, 180.0f);
+	result.twistMin = glm::clamp(std::min(limit.twistMin, limit.twistMax), -180.0f, 180.0f);
+	result.twistMax = glm::clamp(std::max(limit.twistMin, limit.twistMax), -180.0f, 180.0f);
+	return result;
+}
+
+bool PoseLimits::isLimited(const JointLimit& limit) {
+	return limit.swing < 180.0f || limit.twistMin > -180.0f || limit.twistMax < 180.0f;
+}
+
+glm::quat PoseLimits::clamp(const glm::quat& rotation, const JointLimit& limit, bool* changed) {
+	if (changed)
+		*changed = false;
+	if (!isLimited(limit))
+		return rotation;
+	glm::quat q = glm::normalize(rotation);
+	if (q.w < 0.0f)
+		q = -q;
+
+	float twistLength = std::sqrt(q.w * q.w + q.y * q.y);
+	float c = 1.0f, t = 0.0f;
+	if (twistLength >= LIMIT_EPSILON) {
+		c = q.w / twistLength;
+		t = q.y / twistLength;
+	}
+	float sw = q.w * c + q.y * t, sx = q.x * c + q.z * t, sz = q.z * c - q.x * t;
+
+	float half = std::atan2(t, c), twistMin = limit.twistMin * HALF_RADIANS, twistMax = limit.twistMax * HALF_RADIANS;
+	bool twistClamped = half < twistMin - LIMIT_SLACK || half > twistMax + LIMIT_SLACK;
+	if (twistClamped) {
+		half = glm::clamp(half, twistMin, twistMax);
+		c = std::cos(half);
+		t = std::sin(half);
+	}
+	float swingCos = std::cos(limit.swing * HALF_RADIANS);
+	bool swingClamped = sw < swingCos - LIMIT_SLACK;
+	if (swingClamped) {
+		float axisScale = std::sin(limit.swing * HALF_RADIANS) / std::max(std::sqrt(sx * sx + sz * sz), LIMIT_EPSILON);
+		sw = swingCos;
+		sx *= axisScale;
+		sz *= axisScale;
+	}
+	if (!twistClamped && !swingClamped)
+		return rotation;
+	if (changed)
+		*changed = true;
+	return glm::quat(sw * c, sx * c - sz * t, sw * t, sx * t + sz * c);
+}
+
+int PoseLimits::clampPawn(PoseData::BonePawn& pawn, std::vector<int>* changed) {
+	PROFILE_SCOPE("PoseLimits::clampPawn");
+	float q[4][LIMIT_BLOCK], swingCos[LIMIT_BLOCK], swingSin[LIMIT_BLOCK], twistMin[LIMIT_BLOCK], twistMax[LIMIT_BLOCK], e[3][LIMIT_BLOCK];
+	int lane[LIMIT_BLOCK];
+	int clamped = 0;
+	size_t i = 0, size = pawn.bones.size();
+	while (i < size) {
+		/* gather the next block of limited bones */
+		int count = 0;
+		for (; i < size && count < LIMIT_BLOCK; i++) {
+			const PoseData::BoneData& bone = pawn.bones[i];
+			if (!isLimited(bone.limit))
+				continue;
+			lane[count] = static_cast<int>(i);
+			q[0][count] = bone.quaternion.w; q[1][count] = bone.quaternion.x; q[2][count] = bone.quaternion.y; q[3][count] = bone.quaternion.z;
+			swingCos[count] = std::cos(bone.limit.swing * HALF_RADIANS);
+			swingSin[count] = std::sin(bone.limit.swing * HALF_RADIANS);
+			twistMin[count] = bone.limit.twistMin * HALF_RADIANS;
+			twistMax[count] = bone.limit.twistMax * HALF_RADIANS;
+			count++;
+		}
+
+		/* clamp, then move the clamped lanes to the front so only those get scattered back */
+		int moved = 0, k = 0;
+#if QUAT_SIMD_SSE2
+		__m128 r[4];
+		for (; k + 4 <= count; k += 4) {
+			for (int c = 0; c < 4; c++)
+				r[c] = _mm_loadu_ps(q[c] + k);
+			int mask = _mm_movemask_ps(clamp4(r, _mm_loadu_ps(swingCos + k), _mm_loadu_ps(swingSin + k),
+				_mm_loadu_ps(twistMin + k), _mm_loadu_ps(twistMax + k)));
+			if (!mask)
+				continue;
+			float out[4][4];
+			for (int c = 0; c < 4; c++)
+				_mm_storeu_ps(out[c], r[c]);
+			for (int j = 0; j < 4; j++) {
+				if (!(mask & (1 << j)))
+					continue;
+				for (int c = 0; c < 4; c++)
+					q[c][moved] = out[c][j];
+				lane[moved++] = lane[k + j];
+			}
+		}
+#endif
+		/* remainder (everything without SSE2) */
+		for (; k < count; k++) {
+			bool clampedBone;
+			glm::quat result = clamp(glm::quat(q[0][k], q[1][k], q[2][k], q[3][k]), pawn.bones[lane[k]].limit, &clampedBone);
+			if (!clampedBone)
+				continue;
+			q[0][moved] = result.w; q[1][moved] = result.x; q[2][moved] = result.y; q[3][moved] = result.z;
+			lane[moved++] = lane[k];
+		}
+		if (moved == 0)
+			continue;
+
+		RotationBatch::quatToEuler(q[0], q[1], q[2], q[3], e[0], e[1], e[2], moved, pawn.rotationOrder);
+		for (int j = 0; j < moved; j++) {
+			PoseData::BoneData& bone = pawn.bones[lane[j]];
+			bone.quaternion = glm::quat(q[0][j], q[1][j], q[2][j], q[3][j]);
+			bone.eulerRotation = glm::vec3(e[0][j], e[1][j], e[2][j]);
+			if (changed)
+				changed->push_back(lane[j]);
+		}
+		clamped += moved;
+	}
+	return clamped;
+}
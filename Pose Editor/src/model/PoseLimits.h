@@ -0,0 +1,48 @@
+/// <title>Pose Limits</title>
+/// <desc>
+///		Clamping of bone rotations to their joint limits.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+#include "RotationBatch.h"
+
+/// <summary>
+/// PoseLimits keeps local rotations within PoseData::JointLimit. A rotation is split into the twist about the local Y axis
+/// and the swing moving that axis, each part is clamped separately and the two are put back together.
+/// The pawn pass gathers only the limited bones and clamps four of them per SSE2 step.
+/// </summary>
+namespace PoseLimits {
+
+	using PoseData::JointLimit;
+
+	/// <returns>the limit with every angle moved into its valid range and twistMin no larger than twistMax.</returns>
+	JointLimit sanitize(const JointLimit& limit);
+
+	/// <returns>true if the limit restricts any rotation.</returns>
+	bool isLimited(const JointLimit& limit);
+
+	/// <summary>
+	/// Clamps a single rotation. Rotations within the limit are returned unchanged, clamped ones are normalized.
+	/// </summary>
+	/// <param name="changed">optionally set to whether the rotation had to be clamped.</param>
+	glm::quat clamp(const glm::quat& rotation, const JointLimit& limit, bool* changed = nullptr);
+
+	/// <summary>
+	/// Clamps the rotation of every limited bone of the pawn in one pass. Euler angles are rederived for the clamped bones only.
+	/// </summary>
+	/// <param name="changed">optionally receives the offsets into pawn.bones of the clamped bones, appended in ascending order.</param>
+	/// <returns>amount of bones clamped.</returns>
+	int clampPawn(PoseData::BonePawn& pawn, std::vector<int>* changed = nullptr);
+}
@@ -0,0 +1,150 @@
+/// <title>Pose Mirror</title>
+/// <desc>
+///		Mirroring of poses between the left and right side of a skeleton.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include "PoseMirror.h"
+
+std::vector<PoseMirror::MirrorRule> PoseMirror::defaultRules() {
+	return { { "Left", "Right" }, { "left", "right" }, { "LEFT", "RIGHT" } };
+}
+
+/// <returns>the name with the first occurrence of pattern replaced, empty if the name does not contain pattern.</returns>
+static std::string replaceFirst(const std::string& name, const std::string& pattern, const std::string& replacement) {
+	size_t at = pattern.empty() ? std::string::npos : name.find(pattern);
+	if (at == std::string::npos)
+		return std::string();
+	return name.substr(0, at) + replacement + name.substr(at + pattern.size());
+}
+
+PoseMirror::SymmetryMap PoseMirror::buildMap(const PoseData::BonePawn& pawn, const std::vector<MirrorRule>& rules) {
+	PROFILE_SCOPE("PoseMirror::buildMap");
+	SymmetryMap map;
+	size_t count = pawn.bones.size();
+	map.counterparts.resize(count);
+	std::unordered_map<std::string, int> byName;
+	byName.reserve(count);
+	for (int i = 0; i < static_cast<int>(count); i++)
+		byName.emplace(pawn.bones[i].displayName, i);
+	for (int i = 0; i < static_cast<int>(count); i++) {
+		const std::string& name = pawn.bones[i].displayName;
+		map.counterparts[i] = i;
+		for (const MirrorRule& rule : rules) {
+			std::string mirrored = replaceFirst(name, rule.left, rule.right);
+			if (mirrored.empty())
+				mirrored = replaceFirst(name, rule.right, rule.left);
+			if (mirrored.empty())
+				continue;
+			auto found = byName.find(mirrored);
+			if (found != byName.end() && found->second != i) {
+				map.counterparts[i] = found->second;
+				map.pairedCount++;
+			}
+			break;
+		}
+	}
+	map.order = PoseKinematics::buildOrder(pawn);
+	return map;
+}
+
+PoseMirror::SymmetryCache::SymmetryCache(std::vector<MirrorRule> rules) : m_Rules(std::move(rules)) {}
+
+void PoseMirror::SymmetryCache::setRules(std::vector<MirrorRule> rules) {
+	m_Rules = std::move(rules);
+	m_Entries.clear();
+}
+
+const std::vector<PoseMirror::MirrorRule>& PoseMirror::SymmetryCache::getRules() const {
+	return m_Rules;
+}
+
+const PoseMirror::SymmetryMap& PoseMirror::SymmetryCache::get(const PoseData::BonePawn& pawn) {
+	const std::vector<PoseData::BoneData>& bones = pawn.bones;
+	/* the names are left out of the hash, comparing them is cheaper than hashing them */
+	size_t hash = bones.size();
+	for (const PoseData::BoneData& bone : bones) {
+		hash = hash * 31 + std::hash<ID>()(bone.id);
+		hash = hash * 31 + std::hash<ID>()(bone.parent);
+	}
+	for (const Entry& entry : m_Entries) {
+		if (entry.hash != hash || entry.ids.size() != bones.size())
+			continue;
+		bool same = true;
+		for (size_t i = 0; same && i < bones.size(); i++)
+			same = entry.ids[i] == bones[i].id && entry.parents[i] == bones[i].parent && entry.names[i] == bones[i].displayName;
+		if (same)
+			return entry.map;
+	}
+	Entry entry;
+	entry.hash = hash;
+	entry.ids.reserve(bones.size());
+	entry.parents.reserve(bones.size());
+	entry.names.reserve(bones.size());
+	for (const PoseData::BoneData& bone : bones) {
+		entry.ids.push_back(bone.id);
+		entry.parents.push_back(bone.parent);
+		entry.names.push_back(bone.displayName);
+	}
+	entry.map = buildMap(pawn, m_Rules);
+	m_Entries.push_back(std::move(entry));
+	return m_Entries.back().map;
+}
+
+int PoseMirror::SymmetryCache::size() const {
+	return static_cast<int>(m_Entries.size());
+}
+
+/// <returns>sign of the (w, x, y, z) components reflecting a rotation across the plane: the components along the plane's axes flip.</returns>
+static glm::quat reflectionSigns(PoseData::MirrorPlane plane) {
+	switch (plane) {
+	case PoseData::MirrorPlane::YZ: return glm::quat(1.0f, 1.0f, -1.0f, -1.0f);
+	case PoseData::MirrorPlane::XZ: return glm::quat(1.0f, -1.0f, 1.0f, -1.0f);
+	case PoseData::MirrorPlane::XY: return glm::quat(1.0f, -1.0f, -1.0f, 1.0f);
+	}
+	return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void PoseMirror::mirrorRotations(const PoseData::BonePawn& pawn, const SymmetryMap& map, PoseData::MirrorPlane plane,
+	const std::vector<ID>& roots, std::vector<glm::quat>& result) {
+	PROFILE_SCOPE("PoseMirror::mirrorRotations");
+	const std::vector<PoseData::BoneData>& bones = pawn.bones;
+	size_t count = bones.size();
+	result.resize(count);
+	if (map.counterparts.size() != count) {
+		for (size_t i = 0; i < count; i++)
+			result[i] = bones[i].quaternion;
+		return;
+	}
+	glm::quat signs = reflectionSigns(plane);
+	/* one pass over all bones, bones outside the selection are restored afterwards */
+#if QUAT_SIMD_SSE2
+	__m128 signMask = _mm_and_ps(QuatSimd::load(signs), QuatSimd::signMask());
+	for (size_t i = 0; i < count; i++)
+		QuatSimd::store(result[i], _mm_xor_ps(QuatSimd::load(bones[map.counterparts[i]].quaternion), signMask));
+#else
+	for (size_t i = 0; i < count; i++) {
+		const glm::quat& q = bones[map.counterparts[i]].quaternion;
+		result[i] = glm::quat(q.w * signs.w, q.x * signs.x, q.y * signs.y, q.z * signs.z);
+	}
+#endif
+	if (roots.empty())
+		return;
+	std::vector<char> selected(count, 0);
+	for (ID root : roots) {
+		for (size_t i = 0; i < count; i++) {
+			if (bones[i].id != root)
+				continue;
+			int slot = map.order.slots[i];
+			for (int s = slot; s < map.order.subtreeEnd[slot]; s++)
+				selected[map.order.bones[s]] = 1;
+			break;
+		}
+	}
+	for (size_t i = 0; i < count; i++)
+		if (!selected[i])
+			result[i] = bones[i].quaternion;
+}
@@ -0,0 +1,104 @@
+/// <title>Pose Mirror</title>
+/// <desc>
+///		Mirroring of poses between the left and right side of a skeleton.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+#include "PoseKinematics.h"
+
+/// <summary>
+/// PoseMirror reflects poses across a plane. Every bone takes the reflected rotation of its counterpart on the other side,
+/// bones without one (such as the spine) reflect their own rotation. Counterparts are found once per skeleton from the
+/// bone names, by MirrorRules such as Left_Arm / Right_Arm, and kept in a SymmetryCache.
+/// </summary>
+namespace PoseMirror {
+
+	/// <summary>
+	/// A bone whose name contains rule.left is paired with the bone named the same with the first occurrence of rule.left
+	/// replaced by rule.right, and the other way around.
+	/// </summary>
+	using PoseData::MirrorRule;
+
+	/// <returns>rules of the Left_ / Right_ naming of our skeletons, in capitalized, lower and upper case.</returns>
+	std::vector<MirrorRule> defaultRules();
+
+	/// <summary>
+	/// Counterparts of the bones of one skeleton.
+	/// </summary>
+	struct SymmetryMap {
+		/// <summary>offset into pawn.bones of the counterpart of every bone, the bone itself if it has none.</summary>
+		std::vector<int> counterparts;
+		/// <summary>amount of bones with a counterpart.</summary>
+		int pairedCount = 0;
+		/// <summary>hierarchy of the skeleton, its subtree ranges select the bones when mirroring subtrees.</summary>
+		PoseKinematics::FKOrder order;
+	};
+
+	/// <summary>
+	/// Finds the counterparts of the bones of the pawn. The first rule matching a name decides, a bone stays unpaired
+	/// if no bone carries the name it maps to.
+	/// </summary>
+	SymmetryMap buildMap(const PoseData::BonePawn& pawn, const std::vector<MirrorRule>& rules);
+
+	/// <summary>
+	/// SymmetryMaps by skeleton, so mirroring many poses of the same skeleton builds the map once.
+	/// A skeleton is identified by the IDs, parents and names of its bones in their order.
+	/// </summary>
+	class SymmetryCache {
+	private:
+		struct Entry {
+			size_t hash = 0;
+			std::vector<ID> ids;
+			std::vector<ID> parents;
+			std::vector<std::string> names;
+			SymmetryMap map;
+		};
+		std::vector<MirrorRule> m_Rules;
+		/// <summary>one entry per distinct skeleton, there are few of them. A deque keeps the maps in place as entries are added.</summary>
+		std::deque<Entry> m_Entries;
+
+	public:
+		explicit SymmetryCache(std::vector<MirrorRule> rules = defaultRules());
+
+		/// <summary>
+		/// Replaces the rules and forgets all maps built with the previous ones.
+		/// </summary>
+		void setRules(std::vector<MirrorRule> rules);
+
+		/// <returns>the current rules.</returns>
+		const std::vector<MirrorRule>& getRules() const;
+
+		/// <returns>map of the skeleton of the pawn, built on the first request. Valid until the next call of setRules().</returns>
+		const SymmetryMap& get(const PoseData::BonePawn& pawn);
+
+		/// <returns>amount of skeletons with a map.</returns>
+		int size() const;
+	};
+
+	/// <summary>
+	/// Mirrors the rotations of the pawn across the plane: every bone selected takes the reflected rotation of its counterpart.
+	/// Selecting one side only copies the other side onto it.
+	/// </summary>
+	/// <param name="map">map of the pawn's skeleton.</param>
+	/// <param name="roots">bones whose subtrees are mirrored, all bones if empty.</param>
+	/// <param name="result">resized to the bone count, receives the rotations indexed the same as pawn.bones.
+	/// Bones outside the selected subtrees keep their rotation.</param>
+	void mirrorRotations(const PoseData::BonePawn& pawn, const SymmetryMap& map, PoseData::MirrorPlane plane,
+		const std::vector<ID>& roots, std::vector<glm::quat>& result);
+}
@@ -0,0 +1,213 @@
+/// <title>Pose Reduce</title>
+/// <desc>
+///		Error bounded keyframe reduction of animation clips.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>above this cosine of the angle between the keys slerp falls back to nlerp, the same as the PoseBlend kernel.</summary>
+#define SLERP_THRESHOLD 0.9995f
+/// <summary>tracks reduced per parallel chunk.</summary>
+#define REDUCE_GRAIN 8
+
+#include "PoseReduce.h"
+
+glm::quat PoseReduce::interpolate(const glm::quat& a, const glm::quat& b, float alpha, PoseData::Interpolation interpolation) {
+	if (interpolation == PoseData::Interpolation::Step)
+		return a;
+	glm::quat to = glm::dot(a, b) < 0.0f ? -b : b;
+	if (interpolation == PoseData::Interpolation::Slerp && glm::dot(a, to) <= SLERP_THRESHOLD)
+		return glm::normalize(glm::slerp(a, to, alpha));
+	return glm::normalize(a * (1.0f - alpha) + to * alpha);
+}
+
+std::vector<float> PoseReduce::splitTolerances(const PoseData::BonePawn& skeleton, const std::vector<float>& tolerance) {
+	PoseKinematics::FKOrder order = PoseKinematics::buildOrder(skeleton);
+	int count = static_cast<int>(order.bones.size());
+	std::vector<int> depth(count);
+	std::vector<float> local(count);
+	for (int slot = 0; slot < count; slot++) {
+		depth[slot] = order.parents[slot] < 0 ? 1 : depth[order.parents[slot]] + 1;
+		local[slot] = tolerance[order.bones[slot]] / depth[slot];
+	}
+	/* children come after their parents, walking back hands the minimum of every subtree up to its root */
+	for (int slot = count - 1; slot >= 0; slot--) {
+		if (order.parents[slot] >= 0)
+			local[order.parents[slot]] = std::min(local[order.parents[slot]], local[slot]);
+	}
+	std::vector<float> result(skeleton.bones.size());
+	for (int slot = 0; slot < count; slot++)
+		result[order.bones[slot]] = local[slot];
+	return result;
+}
+
+/// <summary>
+/// Checks that interpolating the keys first and last of the track reproduces every key between them within minDot.
+/// </summary>
+/// <param name="lowest">receives the smallest |dot| between a key and the interpolation, when the segment fits.</param>
+static bool segmentFits(const PoseClip::Clip& clip, int track, int first, int last, float minDot, float& lowest) {
+	const glm::quat& a = clip.getKeyRotation(track, first);
+	const glm::quat& b = clip.getKeyRotation(track, last);
+	PoseData::Interpolation interpolation = clip.getInterpolation(track);
+	float start = clip.getKeyTime(track, first), span = clip.getKeyTime(track, last) - start;
+	float smallest = 1.0f;
+	for (int k = first + 1; k < last; k++) {
+		glm::quat q = PoseReduce::interpolate(a, b, (clip.getKeyTime(track, k) - start) / span, interpolation);
+		float dot = std::abs(glm::dot(q, clip.getKeyRotation(track, k)));
+		if (dot < minDot)
+			return false;
+		smallest = std::min(smallest, dot);
+	}
+	lowest = smallest;
+	return true;
+}
+
+/// <summary>
+/// Picks the keys of the track to keep, see PoseReduce::reduce().
+/// </summary>
+/// <param name="kept">receives the indices of the kept keys in time order.</param>
+/// <returns>smallest |dot| between a removed key and the reduced track, 1 if nothing was removed.</returns>
+static float reduceTrack(const PoseClip::Clip& clip, int track, float tolerance, std::vector<int>& kept) {
+	kept.clear();
+	int count = clip.getKeyCount(track);
+	if (count == 0)
+		return 1.0f;
+	/* |dot| of two unit quaternions is the cosine of half the angle between them */
+	float minDot = std::cos(glm::radians(std::max(tolerance, 0.0f)) * 0.5f);
+	float worst = 1.0f, lowest = 1.0f;
+
+	/* a track the first key holds throughout, typical of the bones recorded motion leaves alone */
+	const glm::quat& first = clip.getKeyRotation(track, 0);
+	bool held = true;
+	for (int k = 1; k < count && held; k++) {
+		float dot = std::abs(glm::dot(first, clip.getKeyRotation(track, k)));
+		held = dot >= minDot;
+		lowest = std::min(lowest, dot);
+	}
+	kept.push_back(0);
+	if (held)
+		return lowest;
+
+	int anchor = 0;
+	while (anchor < count - 1) {
+		/* the next key always ends a segment, double the length until it no longer fits, then bisect */
+		int good = anchor + 1, bad = count;
+		float goodLowest = 1.0f;
+		for (int end = anchor + 2; end < count; end = anchor + 2 * (end - anchor)) {
+			if (!segmentFits(clip, track, anchor, end, minDot, lowest)) {
+				bad = end;
+				break;
+			}
+			good = end;
+			goodLowest = lowest;
+		}
+		if (bad == count && good < count - 1) {
+			if (segmentFits(clip, track, anchor, count - 1, minDot, lowest)) {
+				good = count - 1;
+				goodLowest = lowest;
+			}
+			else {
+				bad = count - 1;
+			}
+		}
+		while (bad - good > 1) {
+			int middle = (good + bad) / 2;
+			if (segmentFits(clip, track, anchor, middle, minDot, lowest)) {
+				good = middle;
+				goodLowest = lowest;
+			}
+			else {
+				bad = middle;
+			}
+		}
+		worst = std::min(worst, goodLowest);
+		kept.push_back(good);
+		anchor = good;
+	}
+	return worst;
+}
+
+float PoseReduce::measureGlobalError(const PoseClip::Clip& original, const PoseClip::Clip& reduced) {
+	PROFILE_SCOPE("PoseReduce::measureGlobalError");
+	const PoseData::BonePawn& skeleton = original.getSkeleton();
+	std::vector<float> times;
+	times.reserve(original.getKeyCount());
+	for (int t = 0; t < original.getTrackCount(); t++) {
+		for (int k = 0; k < original.getKeyCount(t); k++)
+			times.push_back(original.getKeyTime(t, k));
+	}
+	std::sort(times.begin(), times.end());
+	times.erase(std::unique(times.begin(), times.end()), times.end());
+
+	/* playing both clips forward keeps the sampler cursors moving by a key at a time */
+	PoseKinematics::FKOrder order = PoseKinematics::buildOrder(skeleton);
+	PoseClip::Sampler originalSampler(original), reducedSampler(reduced);
+	std::vector<glm::quat> originalPose, reducedPose, originalLocal(order.bones.size()), reducedLocal(order.bones.size()),
+		originalGlobal, reducedGlobal;
+	float lowest = 1.0f;
+	for (float time : times) {
+		originalSampler.sample(time, originalPose);
+		reducedSampler.sample(time, reducedPose);
+		for (size_t slot = 0; slot < order.bones.size(); slot++) {
+			originalLocal[slot] = originalPose[order.bones[slot]];
+			reducedLocal[slot] = reducedPose[order.bones[slot]];
+		}
+		PoseKinematics::evaluate(order, originalLocal, originalGlobal);
+		PoseKinematics::evaluate(order, reducedLocal, reducedGlobal);
+		for (size_t slot = 0; slot < order.bones.size(); slot++)
+			lowest = std::min(lowest, std::abs(glm::dot(glm::normalize(originalGlobal[slot]), glm::normalize(reducedGlobal[slot]))));
+	}
+	return glm::degrees(2.0f * std::acos(std::min(lowest, 1.0f)));
+}
+
+PoseClip::Clip PoseReduce::reduce(const PoseClip::Clip& clip, const Settings& settings, PoseData::KeyReduction* report) {
+	PROFILE_SCOPE("PoseReduce::reduce");
+	const PoseData::BonePawn& skeleton = clip.getSkeleton();
+	int tracks = clip.getTrackCount();
+	std::vector<float> tolerance(tracks, settings.tolerance);
+	for (int t = 0; t < tracks && t < static_cast<int>(settings.trackTolerance.size()); t++) {
+		if (settings.trackTolerance[t] >= 0.0f)
+			tolerance[t] = settings.trackTolerance[t];
+	}
+	if (settings.globalSpace)
+		tolerance = splitTolerances(skeleton, tolerance);
+
+	/* every track writes only its own kept keys and error */
+	std::vector<std::vector<int>> kept(tracks);
+	std::vector<float> lowest(tracks, 1.0f);
+	Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(tracks), REDUCE_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; t++)
+			lowest[t] = reduceTrack(clip, static_cast<int>(t), tolerance[t], kept[t]);
+	});
+
+	std::vector<int> sizes(tracks);
+	std::vector<float> times;
+	std::vector<glm::quat> rotations;
+	size_t count = 0;
+	for (int t = 0; t < tracks; t++)
+		count += kept[t].size();
+	times.reserve(count);
+	rotations.reserve(count);
+	for (int t = 0; t < tracks; t++) {
+		sizes[t] = static_cast<int>(kept[t].size());
+		for (int k : kept[t]) {
+			times.push_back(clip.getKeyTime(t, k));
+			rotations.push_back(clip.getKeyRotation(t, k));
+		}
+	}
+	PoseClip::Clip reduced;
+	reduced.build(skeleton, sizes, std::move(times), std::move(rotations), clip.getFrameRate());
+	for (int t = 0; t < tracks; t++)
+		reduced.setInterpolation(t, clip.getInterpolation(t));
+
+	if (report) {
+		report->keysBefore = clip.getKeyCount();
+		report->keysAfter = reduced.getKeyCount();
+		float smallest = lowest.empty() ? 1.0f : *std::min_element(lowest.begin(), lowest.end());
+		report->maxError = glm::degrees(2.0f * std::acos(std::min(smallest, 1.0f)));
+		report->maxGlobalError = settings.globalSpace ? measureGlobalError(clip, reduced) : -1.0f;
+	}
+	return reduced;
+}
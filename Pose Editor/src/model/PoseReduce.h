@@ -0,0 +1,78 @@
+/// <title>Pose Reduce</title>
+/// <desc>
+///		Error bounded keyframe reduction of animation clips.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../parallel/ThreadPool.h"
+#include "../profiler/Profiler.h"
+#include "PoseClip.h"
+#include "PoseKinematics.h"
+
+/// <summary>
+/// PoseReduce removes the keys of a clip which the interpolation of their track reproduces within an angular tolerance,
+/// as recorded motion keys every bone on every frame. Tracks are reduced independently, in parallel.
+/// </summary>
+namespace PoseReduce {
+
+	/// <summary>
+	/// Tolerances of the reduction, in degrees.
+	/// </summary>
+	struct Settings {
+		/// <summary>largest angle a removed key may lie from its reduced track, for tracks without their own tolerance.</summary>
+		float tolerance = 0.5f;
+		/// <summary>optional tolerance of every track, indexed the same as the skeleton's bones. Negative values use tolerance.</summary>
+		std::vector<float> trackTolerance;
+		/// <summary>
+		/// true to bound the global orientation of every bone instead of its local rotation. The errors of a chain add up, so
+		/// the tolerance of a bone is split among it and its ancestors, and the result is measured by forward kinematics.
+		/// </summary>
+		bool globalSpace = false;
+	};
+
+	/// <returns>angle in degrees between the orientations of two unit quaternions, either sign of them being the same.</returns>
+	inline float angleBetween(const glm::quat& a, const glm::quat& b) {
+		return glm::degrees(2.0f * std::acos(std::min(std::abs(glm::dot(a, b)), 1.0f)));
+	}
+
+	/// <summary>
+	/// Interpolates between two keys the way PoseClip::Sampler does, one quaternion at a time. Step holds a.
+	/// </summary>
+	glm::quat interpolate(const glm::quat& a, const glm::quat& b, float alpha, PoseData::Interpolation interpolation);
+
+	/// <summary>
+	/// Splits global tolerances into local ones: a bone gets the smallest tolerance / depth of itself and its descendants,
+	/// so the local tolerances along the chain from any bone up to its root add up to at most the tolerance of that bone.
+	/// </summary>
+	/// <param name="tolerance">global tolerance of every bone, indexed the same as skeleton.bones.</param>
+	/// <returns>local tolerance of every bone, indexed the same as skeleton.bones.</returns>
+	std::vector<float> splitTolerances(const PoseData::BonePawn& skeleton, const std::vector<float>& tolerance);
+
+	/// <summary>
+	/// Samples both clips at every key time of original and compares the global orientations of their bones.
+	/// The clips have to share the skeleton.
+	/// </summary>
+	/// <returns>largest angle in degrees between the global orientation of a bone in original and in reduced.</returns>
+	float measureGlobalError(const PoseClip::Clip& original, const PoseClip::Clip& reduced);
+
+	/// <summary>
+	/// Reduces every track of clip to the fewest keys the greedy search finds, such that sampling the reduced track at the time
+	/// of every removed key stays within the tolerance of that key. A track keeps its first key, the last one unless the first
+	/// holds the whole track, and the key starting every segment. Segments grow by doubling, then by bisection.
+	/// </summary>
+	/// <param name="report">optional, receives the key counts and the errors.</param>
+	/// <returns>reduced clip with the skeleton, frame rate and interpolations of clip.</returns>
+	PoseClip::Clip reduce(const PoseClip::Clip& clip, const Settings& settings, PoseData::KeyReduction* report = nullptr);
+}
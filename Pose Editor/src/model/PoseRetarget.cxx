@@ -0,0 +1,229 @@
+/// <title>Pose Retarget</title>
+/// <desc>
+///		Transfer of poses between skeletons with different bone sets, names and orderings.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include "PoseRetarget.h"
+
+std::vector<PoseRetarget::AliasGroup> PoseRetarget::defaultAliases() {
+	return {
+		{ "Pelvis", "Hips", "Hip", "Root" },
+		{ "Spine", "Spine1", "Torso", "Chest" },
+		{ "Right_Shoulder", "RightShoulder", "R_Clavicle", "Right_Clavicle" },
+		{ "Right_Arm", "RightArm", "R_UpperArm", "Right_UpperArm" },
+		{ "Left_Shoulder", "LeftShoulder", "L_Clavicle", "Left_Clavicle" },
+		{ "Left_Arm", "LeftArm", "L_UpperArm", "Left_UpperArm" },
+		{ "Right_Leg", "RightUpLeg", "R_Thigh", "Right_Thigh" },
+		{ "Left_Leg", "LeftUpLeg", "L_Thigh", "Left_Thigh" },
+	};
+}
+
+std::string PoseRetarget::normalizeName(const std::string& name) {
+	size_t prefix = name.find_last_of(':');
+	std::string result;
+	result.reserve(name.size());
+	for (size_t i = prefix == std::string::npos ? 0 : prefix + 1; i < name.size(); i++) {
+		char c = name[i];
+		if (c == '_' || c == '-' || c == '.' || c == ' ')
+			continue;
+		result.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+	}
+	return result;
+}
+
+/// <returns>the text without leading and trailing whitespace.</returns>
+static std::string trim(const std::string& text) {
+	size_t begin = text.find_first_not_of(" \t\r\n");
+	if (begin == std::string::npos)
+		return std::string();
+	return text.substr(begin, text.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+bool PoseRetarget::readMapFile(const std::string& path, std::vector<std::pair<std::string, std::string>>& pairs) {
+	std::ifstream ifile(path.c_str(), std::ios::in);
+	if (!ifile.is_open()) {
+		std::fprintf(stderr, "Trouble reading '%s': Could not open file.", path.c_str());
+		return false;
+	}
+	std::string line;
+	int row_counter = 0;
+	while (std::getline(ifile, line)) {
+		row_counter++;
+		std::string text = trim(line);
+		if (text.empty() || text[0] == '#')
+			continue;
+		size_t comma = text.find(',');
+		if (comma == std::string::npos) {
+			std::fprintf(stderr, "Trouble reading '%s' [row %d]: Expected \"target name, source name\".", path.c_str(), row_counter - 1);
+			return false;
+		}
+		pairs.emplace_back(trim(text.substr(0, comma)), trim(text.substr(comma + 1)));
+	}
+	return true;
+}
+
+void PoseRetarget::transfer(const PoseData::BonePawn& source, const MappingTable& table, std::vector<glm::quat>& rotations) {
+	PROFILE_SCOPE("PoseRetarget::transfer");
+	size_t count = table.sources.size();
+	rotations.resize(count);
+	const std::vector<PoseData::BoneData>& bones = source.bones;
+	if (!table.restCorrection) {
+		for (size_t i = 0; i < count; i++) {
+			int s = table.sources[i];
+			rotations[i] = s >= 0 ? bones[s].quaternion : table.targetRest[i];
+		}
+		return;
+	}
+	for (size_t i = 0; i < count; i++) {
+		int s = table.sources[i];
+		if (s < 0) {
+			rotations[i] = table.targetRest[i];
+			continue;
+		}
+#if QUAT_SIMD_SSE2
+		__m128 delta = QuatSimd::mul(QuatSimd::load(table.inverseSourceRest[i]), QuatSimd::load(bones[s].quaternion));
+		QuatSimd::store(rotations[i], QuatSimd::mul(QuatSimd::load(table.targetRest[i]), delta));
+#else
+		rotations[i] = QuatSimd::mul(table.targetRest[i], QuatSimd::mul(table.inverseSourceRest[i], bones[s].quaternion));
+#endif
+	}
+}
+
+PoseRetarget::MappingTable PoseRetarget::Retargeter::buildTable(const PoseData::BonePawn& source) const {
+	PROFILE_SCOPE("PoseRetarget::Retargeter::buildTable");
+	const std::vector<PoseData::BoneData>& targetBones = m_Target.bones;
+	std::unordered_map<std::string, int> exact, normalized;
+	for (int i = 0; i < static_cast<int>(source.bones.size()); i++) {
+		exact.emplace(source.bones[i].displayName, i);
+		normalized.emplace(normalizeName(source.bones[i].displayName), i);
+	}
+	/* alias groups by normalized name, and the source bone of every group */
+	std::unordered_map<std::string, int> groups;
+	std::vector<int> groupSources(m_Aliases.size(), -1);
+	for (int g = 0; g < static_cast<int>(m_Aliases.size()); g++) {
+		for (const std::string& alias : m_Aliases[g]) {
+			std::string key = normalizeName(alias);
+			groups.emplace(key, g);
+			auto found = normalized.find(key);
+			if (groupSources[g] < 0 && found != normalized.end())
+				groupSources[g] = found->second;
+		}
+	}
+	std::unordered_map<std::string, std::string> manual(m_Manual.begin(), m_Manual.end());
+	std::unordered_map<std::string, int> rest;
+	for (int i = 0; i < static_cast<int>(m_SourceRest.bones.size()); i++)
+		rest.emplace(m_SourceRest.bones[i].displayName, i);
+
+	MappingTable table;
+	table.sources.assign(targetBones.size(), -1);
+	table.restCorrection = m_HasSourceRest;
+	table.targetRest.resize(targetBones.size());
+	table.inverseSourceRest.assign(targetBones.size(), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+	for (size_t i = 0; i < targetBones.size(); i++) {
+		const std::string& name = targetBones[i].displayName;
+		table.targetRest[i] = targetBones[i].quaternion;
+		int s = -1;
+		auto manualFound = manual.find(name);
+		if (manualFound != manual.end()) {
+			auto found = exact.find(manualFound->second);
+			if (found != exact.end())
+				s = found->second;
+		}
+		if (s < 0) {
+			auto found = exact.find(name);
+			if (found != exact.end())
+				s = found->second;
+		}
+		std::string key = s < 0 ? normalizeName(name) : std::string();
+		if (s < 0) {
+			auto found = normalized.find(key);
+			if (found != normalized.end())
+				s = found->second;
+		}
+		if (s < 0) {
+			auto found = groups.find(key);
+			if (found != groups.end())
+				s = groupSources[found->second];
+		}
+		table.sources[i] = s;
+		if (s < 0)
+			continue;
+		table.mappedCount++;
+		auto restFound = rest.find(source.bones[s].displayName);
+		if (restFound != rest.end())
+			table.inverseSourceRest[i] = glm::inverse(m_SourceRest.bones[restFound->second].quaternion);
+	}
+	return table;
+}
+
+void PoseRetarget::Retargeter::setTarget(const PoseData::BonePawn& skeleton) {
+	m_Target = skeleton;
+	m_HasTarget = true;
+	m_Tables.clear();
+}
+
+bool PoseRetarget::Retargeter::hasTarget() const {
+	return m_HasTarget;
+}
+
+const PoseData::BonePawn& PoseRetarget::Retargeter::getTarget() const {
+	return m_Target;
+}
+
+void PoseRetarget::Retargeter::setManualMap(std::vector<std::pair<std::string, std::string>> pairs) {
+	m_Manual = std::move(pairs);
+	m_Tables.clear();
+}
+
+void PoseRetarget::Retargeter::setAliases(std::vector<AliasGroup> aliases) {
+	m_Aliases = std::move(aliases);
+	m_Tables.clear();
+}
+
+void PoseRetarget::Retargeter::setSourceRest(const PoseData::BonePawn* rest) {
+	m_HasSourceRest = rest != nullptr;
+	m_SourceRest = rest ? *rest : PoseData::BonePawn();
+	m_Tables.clear();
+}
+
+const PoseRetarget::MappingTable& PoseRetarget::Retargeter::table(const PoseData::BonePawn& source) {
+	const std::vector<PoseData::BoneData>& bones = source.bones;
+	for (const Entry& entry : m_Tables) {
+		if (entry.names.size() != bones.size())
+			continue;
+		bool same = true;
+		for (size_t i = 0; same && i < bones.size(); i++)
+			same = entry.names[i] == bones[i].displayName;
+		if (same)
+			return entry.table;
+	}
+	Entry entry;
+	entry.names.reserve(bones.size());
+	for (const PoseData::BoneData& bone : bones)
+		entry.names.push_back(bone.displayName);
+	entry.table = buildTable(source);
+	m_Tables.push_back(std::move(entry));
+	return m_Tables.back().table;
+}
+
+int PoseRetarget::Retargeter::tableCount() const {
+	return static_cast<int>(m_Tables.size());
+}
+
+PoseData::BonePawn PoseRetarget::Retargeter::retarget(const PoseData::BonePawn& source) {
+	PROFILE_SCOPE("PoseRetarget::Retargeter::retarget");
+	std::vector<glm::quat> rotations;
+	transfer(source, table(source), rotations);
+	PoseData::BonePawn result = m_Target;
+	result.loaded = false;
+	result.saved = false;
+	result.rotationOrder = source.rotationOrder;
+	for (size_t i = 0; i < rotations.size(); i++)
+		result.bones[i].quaternion = rotations[i];
+	RotationBatch::pawnQuatToEuler(result);
+	return result;
+}
@@ -0,0 +1,139 @@
+/// <title>Pose Retarget</title>
+/// <desc>
+///		Transfer of poses between skeletons with different bone sets, names and orderings.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <cctype>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+#include "RotationBatch.h"
+
+/// <summary>
+/// PoseRetarget moves poses from a source skeleton onto a target skeleton. Bones are paired by name through a MappingTable,
+/// which is built once per pair of skeletons and reused for every pose. The rotations are either copied as they are, or
+/// corrected for the different rest orientations of the two rigs: target = targetRest * inverse(sourceRest) * source.
+/// </summary>
+namespace PoseRetarget {
+
+	/// <summary>
+	/// Names denoting the same bone on different rigs, such as Pelvis and Hips.
+	/// </summary>
+	using AliasGroup = std::vector<std::string>;
+
+	/// <returns>aliases of the bones of our skeletons on common rigs.</returns>
+	std::vector<AliasGroup> defaultAliases();
+
+	/// <returns>the name in lower case without '_', '-', '.' and spaces and without a namespace prefix ending in ':' (such as "rig:").</returns>
+	std::string normalizeName(const std::string& name);
+
+	/// <summary>
+	/// Reads a manual mapping: one "target name, source name" pair per line. Empty lines and lines starting with '#' are skipped.
+	/// </summary>
+	/// <param name="pairs">receives the (target, source) pairs.</param>
+	/// <returns>true if the file could be read.</returns>
+	bool readMapFile(const std::string& path, std::vector<std::pair<std::string, std::string>>& pairs);
+
+	/// <summary>
+	/// Pairing of the bones of a target skeleton with the bones of a source skeleton, indexed the same as the target bones.
+	/// </summary>
+	struct MappingTable {
+		/// <summary>offset into the source bones for every target bone, -1 for bones keeping their rest rotation.</summary>
+		std::vector<int> sources;
+		/// <summary>amount of target bones with a source bone.</summary>
+		int mappedCount = 0;
+		/// <summary>true if the rotations are corrected by the rest orientations below.</summary>
+		bool restCorrection = false;
+		/// <summary>rest rotation of every target bone, taken by the unmapped ones.</summary>
+		std::vector<glm::quat> targetRest;
+		/// <summary>inverse rest rotation of the source bone of every target bone, identity without a source rest pose.</summary>
+		std::vector<glm::quat> inverseSourceRest;
+	};
+
+	/// <summary>
+	/// Transfers the rotations of the source pawn along the table.
+	/// </summary>
+	/// <param name="table">table built for the skeleton of source.</param>
+	/// <param name="rotations">resized to the target bone count, receives the rotations indexed the same as the target bones.</param>
+	void transfer(const PoseData::BonePawn& source, const MappingTable& table, std::vector<glm::quat>& rotations);
+
+	/// <summary>
+	/// Retargets poses onto one target skeleton. Tables are built on the first pose of every source skeleton and kept until
+	/// the target or the matching rules change. The pairing of a target bone is decided by the first of:
+	/// the manual map, the exact name, the normalized name and the alias groups.
+	/// </summary>
+	class Retargeter {
+	private:
+		struct Entry {
+			/// <summary>bone names of the source skeleton in their order, a table only depends on them.</summary>
+			std::vector<std::string> names;
+			MappingTable table;
+		};
+		PoseData::BonePawn m_Target;
+		bool m_HasTarget = false;
+		std::vector<std::pair<std::string, std::string>> m_Manual;
+		std::vector<AliasGroup> m_Aliases = defaultAliases();
+		PoseData::BonePawn m_SourceRest;
+		bool m_HasSourceRest = false;
+		/// <summary>one entry per source skeleton. A deque keeps the tables in place as entries are added.</summary>
+		std::deque<Entry> m_Tables;
+
+		MappingTable buildTable(const PoseData::BonePawn& source) const;
+
+	public:
+		/// <summary>
+		/// Sets the skeleton poses are moved onto. Its rotations are the rest pose of the target rig.
+		/// </summary>
+		void setTarget(const PoseData::BonePawn& skeleton);
+
+		/// <returns>true once setTarget() was called.</returns>
+		bool hasTarget() const;
+
+		/// <returns>the target skeleton.</returns>
+		const PoseData::BonePawn& getTarget() const;
+
+		/// <summary>
+		/// Sets (target name, source name) pairs taking precedence over the name matching.
+		/// </summary>
+		void setManualMap(std::vector<std::pair<std::string, std::string>> pairs);
+
+		/// <summary>
+		/// Replaces the alias groups, defaultAliases() unless set.
+		/// </summary>
+		void setAliases(std::vector<AliasGroup> aliases);
+
+		/// <summary>
+		/// Sets the rest pose of the source rig, enabling the rest orientation correction. Bones are found by name.
+		/// </summary>
+		/// <param name="rest">rest pose, nullptr to copy the rotations without correction.</param>
+		void setSourceRest(const PoseData::BonePawn* rest);
+
+		/// <returns>table of the skeleton of source, built on the first request. Valid until the next change of the Retargeter.</returns>
+		const MappingTable& table(const PoseData::BonePawn& source);
+
+		/// <returns>amount of source skeletons with a table.</returns>
+		int tableCount() const;
+
+		/// <summary>
+		/// Moves the pose of source onto the target skeleton.
+		/// </summary>
+		/// <returns>copy of the target skeleton holding the pose, in the rotation order of source and not loaded from any file.</returns>
+		PoseData::BonePawn retarget(const PoseData::BonePawn& source);
+	};
+}
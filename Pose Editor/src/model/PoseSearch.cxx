@@ -0,0 +1,360 @@
+/// <title>Pose Search</title>
+/// <desc>
+///		Similarity search over the poses of a library: a vantage point tree of pose features under a quaternion metric.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>poses scanned instead of split further, and the range of poses the build hands to threads as whole subtrees.</summary>
+#define SEARCH_LEAF 16
+#define SEARCH_SUBTREES 64
+/// <summary>poses per parallel chunk when extracting features and measuring the distances of a large node.</summary>
+#define EXTRACT_GRAIN 4096
+#define DISTANCE_GRAIN 8192
+/// <summary>poses tried as the vantage pose of a node, and poses their spread of distances is measured on.</summary>
+#define VANTAGE_CANDIDATES 8
+#define VANTAGE_SAMPLES 32
+
+#include "PoseSearch.h"
+
+float PoseSearch::toDegrees(float chord) {
+	return glm::degrees(4.0f * std::asin(std::min(std::max(chord, 0.0f) * 0.5f, 1.0f)));
+}
+
+float PoseSearch::toChord(float degrees) {
+	return 2.0f * std::sin(glm::radians(std::min(std::max(degrees, 0.0f), 360.0f)) * 0.25f);
+}
+
+/// <summary>
+/// Sums the squared chords min(|a - b|^2, |a + b|^2) of the rotations of two feature blocks. Measuring both lengths instead of
+/// the dot product keeps the precision for nearly equal rotations. Lanes holding no rotation are zero in both blocks and add nothing.
+/// </summary>
+/// <param name="limit">the sum stops once it exceeds limit, returning a value above it.</param>
+static float chordSum(const float* a, const float* b, int groups, float limit) {
+	float result = 0.0f;
+	for (int g = 0; g < groups; g++, a += 16, b += 16) {
+#if QUAT_SIMD_SSE2
+		/* four rotations at once, lane by lane: w, x, y, z */
+		__m128 difference = _mm_setzero_ps(), sum = _mm_setzero_ps();
+		for (int c = 0; c < 16; c += 4) {
+			__m128 va = _mm_loadu_ps(a + c), vb = _mm_loadu_ps(b + c);
+			__m128 d = _mm_sub_ps(va, vb), s = _mm_add_ps(va, vb);
+			difference = _mm_add_ps(difference, _mm_mul_ps(d, d));
+			sum = _mm_add_ps(sum, _mm_mul_ps(s, s));
+		}
+		__m128 chords = _mm_min_ps(difference, sum);
+		__m128 shuffled = _mm_shuffle_ps(chords, chords, _MM_SHUFFLE(2, 3, 0, 1));
+		chords = _mm_add_ps(chords, shuffled);
+		shuffled = _mm_movehl_ps(shuffled, chords);
+		result += _mm_cvtss_f32(_mm_add_ss(chords, shuffled));
+#else
+		for (int l = 0; l < 4; l++) {
+			float difference = 0.0f, sum = 0.0f;
+			for (int c = l; c < 16; c += 4) {
+				difference += (a[c] - b[c]) * (a[c] - b[c]);
+				sum += (a[c] + b[c]) * (a[c] + b[c]);
+			}
+			result += std::min(difference, sum);
+		}
+#endif
+		if (result > limit)
+			return result;
+	}
+	return result;
+}
+
+void PoseSearch::Features::extract(const std::vector<glm::quat>& rotations, float* block, std::vector<glm::quat>& local, std::vector<glm::quat>& global) const {
+	const std::vector<glm::quat>* source = &rotations;
+	if (m_Settings.feature == Feature::Global) {
+		/* the same pass as PoseKinematics::evaluate(), which may not run on the worker threads as it records a profiler phase */
+		size_t count = m_Order.bones.size();
+		local.resize(count);
+		global.resize(count);
+		for (size_t slot = 0; slot < count; slot++)
+			local[slot] = rotations[m_Order.bones[slot]];
+		for (size_t slot = 0; slot < count; slot++)
+			global[slot] = m_Order.parents[slot] < 0 ? local[slot] : QuatSimd::mul(global[m_Order.parents[slot]], local[slot]);
+		source = &global;
+	}
+	std::fill(block, block + m_Stride, 0.0f);
+	for (int f = 0; f < m_Dimension; f++) {
+		int index = m_Settings.feature == Feature::Global ? m_Order.slots[m_Bones[f]] : m_Bones[f];
+		glm::quat q = glm::normalize((*source)[index]);
+		float* lanes = block + (f / 4) * 16 + f % 4;
+		lanes[0] = q.w;
+		lanes[4] = q.x;
+		lanes[8] = q.y;
+		lanes[12] = q.z;
+	}
+}
+
+void PoseSearch::Features::extract(const PoseLibrary::Library& library, const std::vector<int>& poses, std::vector<float>& blocks) const {
+	blocks.assign(poses.size() * m_Stride, 0.0f);
+	Parallel::ThreadPool::shared().parallelFor(poses.size(), EXTRACT_GRAIN, [&](size_t begin, size_t end) {
+		std::vector<glm::quat> rotations, local, global;
+		for (size_t i = begin; i < end; i++) {
+			library.getPose(poses[i], rotations);
+			extract(rotations, blocks.data() + i * m_Stride, local, global);
+		}
+	});
+}
+
+float PoseSearch::Features::chordSum(const float* a, const float* b, float limit) const {
+	return ::chordSum(a, b, m_Stride / 16, limit);
+}
+
+float PoseSearch::Features::distance(const float* a, const float* b) const {
+	return std::sqrt(::chordSum(a, b, m_Stride / 16, std::numeric_limits<float>::infinity()) / m_Dimension);
+}
+
+bool PoseSearch::Features::setup(const PoseData::BonePawn& skeleton, const Settings& settings) {
+	*this = Features();
+	m_Settings = settings;
+	if (settings.bones.empty()) {
+		for (int b = 0; b < static_cast<int>(skeleton.bones.size()); b++)
+			m_Bones.push_back(b);
+	}
+	else {
+		for (ID id : settings.bones) {
+			auto bone = std::find_if(skeleton.bones.begin(), skeleton.bones.end(), [id](const PoseData::BoneData& bone) { return bone.id == id; });
+			int index = static_cast<int>(bone - skeleton.bones.begin());
+			if (bone != skeleton.bones.end() && std::find(m_Bones.begin(), m_Bones.end(), index) == m_Bones.end())
+				m_Bones.push_back(index);
+		}
+	}
+	if (m_Bones.empty())
+		return false;
+	m_Order = PoseKinematics::buildOrder(skeleton);
+	m_Dimension = static_cast<int>(m_Bones.size());
+	m_Stride = (m_Dimension + 3) / 4 * 16;
+	return true;
+}
+
+/// <summary>
+/// Splits the ranges of the vantage point tree. Every range belongs to one node, so subtrees can be built by different
+/// threads. The vantage pose of a range is picked by a generator seeded from the range, which gives the same tree for any
+/// amount of threads.
+/// </summary>
+struct TreeBuilder {
+	const PoseSearch::Features& metric;
+	/// <summary>feature blocks in library order.</summary>
+	const std::vector<float>& features;
+	/// <summary>library pose at every tree position, permuted by the splits.</summary>
+	std::vector<int>& poses;
+	std::vector<float>& radii;
+	/// <summary>squared chord sum from the vantage pose of its node, indexed by pose.</summary>
+	std::vector<float> sums;
+
+	const float* block(int pose) const {
+		return features.data() + static_cast<size_t>(pose) * metric.getStride();
+	}
+
+	/// <summary>
+	/// Picks the vantage pose of [begin, end), moves it to begin, then orders the rest around the median of their distances from it.
+	/// </summary>
+	/// <returns>beginning of the second half, the poses at least as far as the radius.</returns>
+	int split(int begin, int end, bool parallel) {
+		/* the candidate whose distances to a sample of the range spread the most separates the range best */
+		uint32_t seed = static_cast<uint32_t>(begin) * 2654435761u ^ static_cast<uint32_t>(end);
+		auto random = [&seed](int count) { seed = seed * 1664525u + 1013904223u; return static_cast<int>((seed >> 8) % static_cast<uint32_t>(count)); };
+		int count = end - begin, best = begin;
+		float bestSpread = -1.0f;
+		for (int c = 0; c < VANTAGE_CANDIDATES; c++) {
+			int candidate = begin + random(count);
+			float mean = 0.0f, square = 0.0f;
+			for (int s = 0; s < VANTAGE_SAMPLES; s++) {
+				float d = metric.distance(block(poses[candidate]), block(poses[begin + random(count)]));
+				mean += d;
+				square += d * d;
+			}
+			float spread = square / VANTAGE_SAMPLES - (mean / VANTAGE_SAMPLES) * (mean / VANTAGE_SAMPLES);
+			if (spread > bestSpread) {
+				bestSpread = spread;
+				best = candidate;
+			}
+		}
+		std::swap(poses[begin], poses[best]);
+
+		const float* vantage = block(poses[begin]);
+		auto measure = [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) {
+				int pose = poses[begin + 1 + i];
+				sums[pose] = metric.chordSum(vantage, block(pose));
+			}
+		};
+		if (parallel)
+			Parallel::ThreadPool::shared().parallelFor(static_cast<size_t>(count - 1), DISTANCE_GRAIN, measure);
+		else
+			measure(0, static_cast<size_t>(count - 1));
+		int middle = begin + 1 + (count - 1) / 2;
+		std::nth_element(poses.begin() + begin + 1, poses.begin() + middle, poses.begin() + end,
+			[this](int a, int b) { return sums[a] < sums[b]; });
+		radii[begin] = std::sqrt(sums[poses[middle]] / metric.getDimension());
+		return middle;
+	}
+
+	void buildSubtree(int begin, int end) {
+		if (end - begin <= SEARCH_LEAF)
+			return;
+		int middle = split(begin, end, false);
+		buildSubtree(begin + 1, middle);
+		buildSubtree(middle, end);
+	}
+};
+
+bool PoseSearch::Index::build(const PoseLibrary::Library& library, const Settings& settings) {
+	PROFILE_SCOPE("PoseSearch::Index::build");
+	*this = Index();
+	if (!m_Features.setup(library.getSkeleton(), settings))
+		return false;
+
+	int count = library.getPoseCount();
+	m_Poses.resize(count);
+	for (int p = 0; p < count; p++)
+		m_Poses[p] = p;
+	m_Radii.assign(count, 0.0f);
+	std::vector<float> features;
+	m_Features.extract(library, m_Poses, features);
+
+	/* the top levels split one node at a time with the distances measured in parallel, the subtrees below them go to the threads whole */
+	TreeBuilder builder{ m_Features, features, m_Poses, m_Radii, std::vector<float>(count) };
+	std::vector<std::pair<int, int>> ranges{ { 0, count } }, next;
+	while (!ranges.empty() && ranges.size() < SEARCH_SUBTREES) {
+		next.clear();
+		for (const std::pair<int, int>& range : ranges) {
+			if (range.second - range.first <= SEARCH_LEAF)
+				continue;
+			int middle = builder.split(range.first, range.second, true);
+			next.push_back({ range.first + 1, middle });
+			next.push_back({ middle, range.second });
+		}
+		ranges.swap(next);
+	}
+	Parallel::ThreadPool::shared().parallelFor(ranges.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t r = begin; r < end; r++)
+			builder.buildSubtree(ranges[r].first, ranges[r].second);
+	});
+
+	/* features are extracted again in tree order, so a subtree reads a contiguous block and only one copy is held at a time */
+	features.clear();
+	features.shrink_to_fit();
+	m_Features.extract(library, m_Poses, m_Blocks);
+	return true;
+}
+
+void PoseSearch::Index::searchNode(int begin, int end, const float* query, int count, float radius, std::vector<Match>& heap, int& distanceCount) const {
+	auto closer = [](const Match& a, const Match& b) { return a.distance < b.distance; };
+	/* the farthest distance a pose may have to be returned, shrinking as the heap of the closest poses fills */
+	auto bound = [&]() { return count > 0 && static_cast<int>(heap.size()) == count ? std::min(radius, heap.front().distance) : radius; };
+	auto consider = [&](int position, float distance) {
+		if (count > 0 && static_cast<int>(heap.size()) == count) {
+			if (distance >= bound())
+				return;
+			std::pop_heap(heap.begin(), heap.end(), closer);
+			heap.pop_back();
+		}
+		else if (distance > radius) {
+			return;
+		}
+		heap.push_back({ position, distance });
+		std::push_heap(heap.begin(), heap.end(), closer);
+	};
+
+	int stride = m_Features.getStride(), dimension = m_Features.getDimension();
+	if (end - begin <= SEARCH_LEAF) {
+		for (int position = begin; position < end; position++) {
+			float limit = bound();
+			float sum = m_Features.chordSum(query, m_Blocks.data() + static_cast<size_t>(position) * stride, limit * limit * dimension);
+			consider(position, std::sqrt(sum / dimension));
+		}
+		distanceCount += end - begin;
+		return;
+	}
+	float distance = m_Features.distance(query, m_Blocks.data() + static_cast<size_t>(begin) * stride);
+	distanceCount++;
+	consider(begin, distance);
+	/* by the triangle inequality the near half lies beyond the bound once distance - bound exceeds the radius, the far half once distance + bound falls short of it */
+	int middle = begin + 1 + (end - begin - 1) / 2;
+	float split = m_Radii[begin];
+	if (distance < split) {
+		if (distance - bound() <= split)
+			searchNode(begin + 1, middle, query, count, radius, heap, distanceCount);
+		if (distance + bound() >= split)
+			searchNode(middle, end, query, count, radius, heap, distanceCount);
+	}
+	else {
+		if (distance + bound() >= split)
+			searchNode(middle, end, query, count, radius, heap, distanceCount);
+		if (distance - bound() <= split)
+			searchNode(begin + 1, middle, query, count, radius, heap, distanceCount);
+	}
+}
+
+/// <summary>
+/// Turns the heap of matches at tree positions into library poses sorted by distance in degrees.
+/// </summary>
+static std::vector<PoseSearch::Match> finishMatches(std::vector<PoseSearch::Match>& heap, const std::vector<int>& poses) {
+	for (PoseSearch::Match& match : heap) {
+		match.pose = poses[match.pose];
+		match.distance = PoseSearch::toDegrees(match.distance);
+	}
+	std::sort(heap.begin(), heap.end(), [](const PoseSearch::Match& a, const PoseSearch::Match& b) {
+		return a.distance < b.distance || (a.distance == b.distance && a.pose < b.pose);
+	});
+	return std::move(heap);
+}
+
+std::vector<PoseSearch::Match> PoseSearch::Index::search(const std::vector<glm::quat>& rotations, int count, float radius, int* distanceCount) const {
+	std::vector<Match> heap;
+	if (m_Poses.empty() || static_cast<int>(rotations.size()) != m_Features.getBoneCount())
+		return heap;
+	std::vector<float> query(m_Features.getStride());
+	std::vector<glm::quat> local, global;
+	m_Features.extract(rotations, query.data(), local, global);
+	int distances = 0;
+	searchNode(0, static_cast<int>(m_Poses.size()), query.data(), count, radius < 0.0f ? std::numeric_limits<float>::infinity() : toChord(radius), heap, distances);
+	if (distanceCount)
+		*distanceCount = distances;
+	return finishMatches(heap, m_Poses);
+}
+
+std::vector<PoseSearch::Match> PoseSearch::Index::scan(const std::vector<glm::quat>& rotations, int count, float radius) const {
+	std::vector<Match> heap;
+	if (m_Poses.empty() || static_cast<int>(rotations.size()) != m_Features.getBoneCount())
+		return heap;
+	std::vector<float> query(m_Features.getStride());
+	std::vector<glm::quat> local, global;
+	m_Features.extract(rotations, query.data(), local, global);
+	float limit = radius < 0.0f ? std::numeric_limits<float>::infinity() : toChord(radius);
+	auto closer = [](const Match& a, const Match& b) { return a.distance < b.distance; };
+	for (int position = 0; position < static_cast<int>(m_Poses.size()); position++) {
+		float distance = m_Features.distance(query.data(), m_Blocks.data() + static_cast<size_t>(position) * m_Features.getStride());
+		if (distance > limit || (count > 0 && static_cast<int>(heap.size()) == count && distance >= heap.front().distance))
+			continue;
+		if (count > 0 && static_cast<int>(heap.size()) == count) {
+			std::pop_heap(heap.begin(), heap.end(), closer);
+			heap.pop_back();
+		}
+		heap.push_back({ position, distance });
+		std::push_heap(heap.begin(), heap.end(), closer);
+	}
+	return finishMatches(heap, m_Poses);
+}
+
+int PoseSearch::Index::getSize() const {
+	return static_cast<int>(m_Poses.size());
+}
+
+int PoseSearch::Index::getDimension() const {
+	return m_Features.getDimension();
+}
+
+const PoseSearch::Settings& PoseSearch::Index::getSettings() const {
+	return m_Features.getSettings();
+}
+
+size_t PoseSearch::Index::getByteSize() const {
+	return (m_Blocks.size() + m_Radii.size()) * sizeof(float) + m_Poses.size() * sizeof(int);
+}
@@ -0,0 +1,162 @@
+/// <title>Pose Search</title>
+/// <desc>
+///		Similarity search over the poses of a library: a vantage point tree of pose features under a quaternion metric.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../parallel/ThreadPool.h"
+#include "../profiler/Profiler.h"
+#include "PoseKinematics.h"
+#include "PoseLibrary.h"
+#include "QuatSimd.h"
+
+/// <summary>
+/// PoseSearch finds the poses of a library closest to a given pose. A pose is described by a feature: the local rotations of
+/// some or all bones, or the global orientations of key bones (which also sees differences spread over a chain of bones).
+/// Two features are compared bone by bone with the chord min(|a - b|, |a + b|) = 2 sin(angle / 4) between the quaternions,
+/// a metric on rotations which ignores the sign of the quaternions. The distance of two poses is the root mean square of
+/// these chords, which is again a metric, so the poses can be organized in a vantage point tree pruned by the triangle
+/// inequality. Distances are presented as the angle giving that chord: every bone rotated by the same angle is that far.
+/// </summary>
+namespace PoseSearch {
+
+	/// <summary>
+	/// Rotations a pose is compared by: the local rotations of the bones, or their global orientations (parent_global * local).
+	/// </summary>
+	enum class Feature { Local, Global };
+
+	/// <summary>
+	/// What the index compares.
+	/// </summary>
+	struct Settings {
+		Feature feature = Feature::Local;
+		/// <summary>IDs of the key bones compared, all bones of the skeleton when empty. IDs missing in the skeleton are ignored.</summary>
+		std::vector<ID> bones;
+	};
+
+	/// <summary>
+	/// A pose found by a query.
+	/// </summary>
+	struct Match {
+		/// <summary>index of the pose in the library.</summary>
+		int pose = -1;
+		/// <summary>distance from the query in degrees, see toDegrees().</summary>
+		float distance = 0.0f;
+	};
+
+	/// <returns>distance in degrees of the root mean square chord, the angle whose chord 2 sin(angle / 4) it is.</returns>
+	float toDegrees(float chord);
+	/// <returns>root mean square chord of a distance in degrees, the inverse of toDegrees().</returns>
+	float toChord(float degrees);
+
+	/// <summary>
+	/// Features turns poses of a skeleton into feature blocks and measures the distance between them. A block holds the
+	/// compared rotations in groups of four, lane by lane (w, x, y, z of four rotations each), padded with zeros.
+	/// </summary>
+	class Features {
+	private:
+		Settings m_Settings;
+		/// <summary>parent-before-child order of the skeleton, global features are evaluated in it.</summary>
+		PoseKinematics::FKOrder m_Order;
+		/// <summary>bones (offsets into the skeleton's bones) whose rotations form the feature.</summary>
+		std::vector<int> m_Bones;
+		/// <summary>rotations of a feature, and floats of a feature block.</summary>
+		int m_Dimension = 0;
+		int m_Stride = 0;
+
+	public:
+		/// <summary>
+		/// Picks the bones of the skeleton the settings compare.
+		/// </summary>
+		/// <returns>false if none of the key bones is in the skeleton.</returns>
+		bool setup(const PoseData::BonePawn& skeleton, const Settings& settings);
+		/// <summary>
+		/// Writes the feature block of a pose given by the local rotation of every bone of the skeleton. Safe to call from
+		/// several threads with their own scratch space.
+		/// </summary>
+		/// <param name="block">has to hold getStride() floats.</param>
+		/// <param name="local">scratch space for the rotations in slot order.</param>
+		/// <param name="global">scratch space for the global rotations in slot order.</param>
+		void extract(const std::vector<glm::quat>& rotations, float* block, std::vector<glm::quat>& local, std::vector<glm::quat>& global) const;
+		/// <summary>
+		/// Writes the feature blocks of the library poses into blocks, a block per entry of poses. Runs on the shared thread pool.
+		/// </summary>
+		void extract(const PoseLibrary::Library& library, const std::vector<int>& poses, std::vector<float>& blocks) const;
+		/// <returns>
+		/// sum over the rotations of the squared chords min(|a - b|^2, |a + b|^2), stopping with a value above limit once it exceeds it.
+		/// </returns>
+		float chordSum(const float* a, const float* b, float limit = std::numeric_limits<float>::infinity()) const;
+		/// <returns>distance of two feature blocks as the root mean square chord, see toDegrees().</returns>
+		float distance(const float* a, const float* b) const;
+
+		/// <returns>amount of rotations compared per pose.</returns>
+		int getDimension() const { return m_Dimension; }
+		/// <returns>floats of a feature block.</returns>
+		int getStride() const { return m_Stride; }
+		/// <returns>amount of bones of the skeleton, the length of the rotations of a pose.</returns>
+		int getBoneCount() const { return static_cast<int>(m_Order.bones.size()); }
+		const Settings& getSettings() const { return m_Settings; }
+	};
+
+	/// <summary>
+	/// Index holds the features of every pose of a library, ordered as the nodes of a vantage point tree. A node covering
+	/// positions [begin, end) keeps its vantage pose at begin, the poses closer to it than its radius in the first half of the
+	/// rest and the farther ones in the second half, so the tree needs no pointers and a subtree reads contiguous features.
+	/// Ranges of at most a leaf of poses are scanned. The index does not follow later changes of the library.
+	/// </summary>
+	class Index {
+	private:
+		Features m_Features;
+		/// <summary>feature block of every pose in tree order.</summary>
+		std::vector<float> m_Blocks;
+		/// <summary>library pose at every tree position.</summary>
+		std::vector<int> m_Poses;
+		/// <summary>radius (as a root mean square chord) of the node whose vantage pose is at the position, unused by leaves.</summary>
+		std::vector<float> m_Radii;
+
+		void searchNode(int begin, int end, const float* query, int count, float radius, std::vector<Match>& heap, int& distanceCount) const;
+
+	public:
+		/// <summary>
+		/// Builds the index over every pose of the library, on the shared thread pool. Gives the same tree for any amount of threads.
+		/// </summary>
+		/// <returns>false if none of the key bones is in the skeleton, the index is left empty.</returns>
+		bool build(const PoseLibrary::Library& library, const Settings& settings);
+
+		/// <summary>
+		/// Finds the closest poses to the pose given by its rotations. Safe to call from several threads at once.
+		/// </summary>
+		/// <param name="rotations">local rotation of every bone, indexed the same as the skeleton's bones.</param>
+		/// <param name="count">most poses returned, the closest ones. 0 or less returns every pose within radius.</param>
+		/// <param name="radius">largest distance in degrees of a returned pose, negative for any distance.</param>
+		/// <param name="distanceCount">receives the amount of poses compared with the query, if given.</param>
+		/// <returns>the poses found, closest first.</returns>
+		std::vector<Match> search(const std::vector<glm::quat>& rotations, int count, float radius = -1.0f, int* distanceCount = nullptr) const;
+		/// <summary>
+		/// Same as search(), comparing the query with every pose instead of walking the tree. The reference of the tree.
+		/// </summary>
+		std::vector<Match> scan(const std::vector<glm::quat>& rotations, int count, float radius = -1.0f) const;
+
+		/// <returns>amount of poses indexed.</returns>
+		int getSize() const;
+		/// <returns>amount of rotations compared per pose.</returns>
+		int getDimension() const;
+		const Settings& getSettings() const;
+		/// <returns>bytes held by the features and the tree.</returns>
+		size_t getByteSize() const;
+	};
+}
@@ -0,0 +1,362 @@
+/// <title>Quaternion Pack</title>
+/// <desc>
+///		Smallest-three quantization of unit quaternions into 32 or 48 bits, with SSE2 batch kernels.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>largest magnitude of the three smaller components of a unit quaternion, 1/sqrt(2).</summary>
+#define PACK_RANGE 0.70710678f
+/// <summary>largest quantized values, one below the top of 10 and 15 bits so an odd count of steps keeps zero exact.</summary>
+#define PACK_MAX_32 1022
+#define PACK_MAX_48 32766
+
+#include "QuatPack.h"
+
+/// <returns>largest quantized value of a component.</returns>
+static inline int quantMax(QuatPack::Precision precision) {
+	return precision == QuatPack::Precision::Bits32 ? PACK_MAX_32 : PACK_MAX_48;
+}
+
+/// <summary>
+/// Drops the largest component of q and quantizes the other three into values[0..2], mirroring the SSE2 kernel operation by operation.
+/// </summary>
+/// <returns>index of the dropped component, 0 to 3 for w, x, y, z.</returns>
+static inline int encode(const glm::quat& q, int maximum, uint32_t values[3]) {
+	float c[4] = { q.w, q.x, q.y, q.z };
+	int index = 0;
+	float best = std::abs(c[0]);
+	for (int k = 1; k < 4; k++) {
+		if (std::abs(c[k]) > best) {
+			best = std::abs(c[k]);
+			index = k;
+		}
+	}
+	float sign = c[index] < 0.0f ? -1.0f : 1.0f;
+	const float scale = maximum / (2.0f * PACK_RANGE), top = static_cast<float>(maximum);
+	for (int k = 0, n = 0; k < 4; k++) {
+		if (k == index)
+			continue;
+		float v = (c[k] * sign + PACK_RANGE) * scale + 0.5f;
+		values[n++] = static_cast<uint32_t>(std::min(std::max(v, 0.0f), top));
+	}
+	return index;
+}
+
+/// <summary>
+/// Rebuilds the quaternion from the index of the dropped component and the three quantized ones, then normalizes it.
+/// </summary>
+static inline glm::quat decode(int index, const uint32_t values[3], int maximum) {
+	const float step = 2.0f * PACK_RANGE / maximum;
+	float a = values[0] * step - PACK_RANGE, b = values[1] * step - PACK_RANGE, c = values[2] * step - PACK_RANGE;
+	float d = std::sqrt(std::max(0.0f, 1.0f - (a * a + b * b + c * c)));
+	float r[4];
+	r[0] = index == 0 ? d : a;
+	r[1] = index == 0 ? a : (index == 1 ? d : b);
+	r[2] = index <= 1 ? b : (index == 2 ? d : c);
+	r[3] = index <= 2 ? c : d;
+	float inverse = 1.0f / std::sqrt((r[0] * r[0] + r[1] * r[1]) + (r[2] * r[2] + r[3] * r[3]));
+	return glm::quat(r[0] * inverse, r[1] * inverse, r[2] * inverse, r[3] * inverse);
+}
+
+static inline void writeWord(uint8_t* out, uint32_t word) {
+	out[0] = static_cast<uint8_t>(word & 0xff);
+	out[1] = static_cast<uint8_t>((word >> 8) & 0xff);
+}
+
+static inline uint32_t readWord(const uint8_t* in) {
+	return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8);
+}
+
+int QuatPack::bytesPer(Precision precision) {
+	return precision == Precision::Bits32 ? 4 : 6;
+}
+
+float QuatPack::maxError(Precision precision) {
+	float halfStep = PACK_RANGE / quantMax(precision);
+	return glm::degrees(2.0f * std::asin(std::min(1.0f, std::sqrt(39.0f) * halfStep)));
+}
+
+float QuatPack::angleBetween(const glm::quat& a, const glm::quat& b) {
+	/* the quaternions of two orientations lie 2 sin(angle / 4) apart, either sign of them being the same */
+	glm::quat to = glm::dot(a, b) < 0.0f ? -b : b;
+	glm::quat difference = a - to;
+	float distance = std::sqrt(glm::dot(difference, difference));
+	return glm::degrees(4.0f * std::asin(std::min(1.0f, distance * 0.5f)));
+}
+
+bool QuatPack::choosePrecision(float maxErrorDegrees, Precision& precision) {
+	for (Precision candidate : { Precision::Bits32, Precision::Bits48 }) {
+		if (maxError(candidate) <= maxErrorDegrees) {
+			precision = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t QuatPack::pack32(const glm::quat& q) {
+	uint32_t values[3];
+	uint32_t index = static_cast<uint32_t>(encode(q, PACK_MAX_32, values));
+	return (index << 30) | (values[0] << 20) | (values[1] << 10) | values[2];
+}
+
+glm::quat QuatPack::unpack32(uint32_t bits) {
+	uint32_t values[3] = { (bits >> 20) & 0x3ff, (bits >> 10) & 0x3ff, bits & 0x3ff };
+	return decode(static_cast<int>(bits >> 30), values, PACK_MAX_32);
+}
+
+void QuatPack::pack48(const glm::quat& q, uint8_t* out) {
+	uint32_t values[3];
+	uint32_t index = static_cast<uint32_t>(encode(q, PACK_MAX_48, values));
+	writeWord(out, values[0] | ((index & 1) << 15));
+	writeWord(out + 2, values[1] | ((index >> 1) << 15));
+	writeWord(out + 4, values[2]);
+}
+
+glm::quat QuatPack::unpack48(const uint8_t* in) {
+	uint32_t words[3] = { readWord(in), readWord(in + 2), readWord(in + 4) };
+	uint32_t values[3] = { words[0] & 0x7fff, words[1] & 0x7fff, words[2] & 0x7fff };
+	return decode(static_cast<int>((words[0] >> 15) | ((words[1] >> 15) << 1)), values, PACK_MAX_48);
+}
+
+#if QUAT_SIMD_SSE2
+/// <returns>lanes of a where mask is set, lanes of b elsewhere.</returns>
+static inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// <summary>
+/// Encodes four quaternions held as one register per component, the same as encode() per lane.
+/// </summary>
+static inline void encode4(const __m128 q[4], int maximum, __m128i& index, __m128i values[3]) {
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 best = _mm_and_ps(q[0], absMask), largest = q[0];
+	index = _mm_setzero_si128();
+	for (int k = 1; k < 4; k++) {
+		__m128 magnitude = _mm_and_ps(q[k], absMask);
+		__m128 greater = _mm_cmpgt_ps(magnitude, best);
+		best = select(greater, magnitude, best);
+		largest = select(greater, q[k], largest);
+		index = _mm_or_si128(_mm_andnot_si128(_mm_castps_si128(greater), index), _mm_and_si128(_mm_castps_si128(greater), _mm_set1_epi32(k)));
+	}
+	/* flip the quaternions whose largest component is negative */
+	__m128 flip = _mm_and_ps(largest, QuatSimd::signMask());
+	__m128 c[4];
+	for (int k = 0; k < 4; k++)
+		c[k] = _mm_xor_ps(q[k], flip);
+	__m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_setzero_si128()));
+	__m128 below2 = _mm_castsi128_ps(_mm_cmplt_epi32(index, _mm_set1_epi32(2)));
+	__m128 below3 = _mm_castsi128_ps(_mm_cmplt_epi32(index, _mm_set1_epi32(3)));
+	__m128 kept[3] = { select(is0, c[1], c[0]), select(below2, c[2], c[1]), select(below3, c[3], c[2]) };
+	const __m128 range = _mm_set1_ps(PACK_RANGE), scale = _mm_set1_ps(maximum / (2.0f * PACK_RANGE));
+	const __m128 half = _mm_set1_ps(0.5f), top = _mm_set1_ps(static_cast<float>(maximum));
+	for (int n = 0; n < 3; n++) {
+		__m128 v = _mm_add_ps(_mm_mul_ps(_mm_add_ps(kept[n], range), scale), half);
+		values[n] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), top));
+	}
+}
+
+/// <summary>
+/// Decodes four quaternions into one register per component, the same as decode() per lane.
+/// </summary>
+static inline void decode4(__m128i index, const __m128i values[3], int maximum, __m128 r[4]) {
+	const __m128 step = _mm_set1_ps(2.0f * PACK_RANGE / maximum), range = _mm_set1_ps(PACK_RANGE), one = _mm_set1_ps(1.0f);
+	__m128 a = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(values[0]), step), range);
+	__m128 b = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(values[1]), step), range);
+	__m128 c = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(values[2]), step), range);
+	__m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c));
+	__m128 d = _mm_sqrt_ps(_mm_max_ps(_mm_setzero_ps(), _mm_sub_ps(one, sum)));
+	__m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_setzero_si128()));
+	__m128 is1 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(1)));
+	__m128 is2 = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(2)));
+	__m128 below2 = _mm_castsi128_ps(_mm_cmplt_epi32(index, _mm_set1_epi32(2)));
+	__m128 below3 = _mm_castsi128_ps(_mm_cmplt_epi32(index, _mm_set1_epi32(3)));
+	r[0] = select(is0, d, a);
+	r[1] = select(is0, a, select(is1, d, b));
+	r[2] = select(below2, b, select(is2, d, c));
+	r[3] = select(below3, c, d);
+	__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[0], r[0]), _mm_mul_ps(r[1], r[1])),
+		_mm_add_ps(_mm_mul_ps(r[2], r[2]), _mm_mul_ps(r[3], r[3]))));
+	__m128 inverse = _mm_div_ps(one, length);
+	for (int k = 0; k < 4; k++)
+		r[k] = _mm_mul_ps(r[k], inverse);
+}
+#endif
+
+void QuatPack::pack(const RotationBatch::QuatLanes& lanes, Precision precision, uint8_t* out) {
+	PROFILE_SCOPE("QuatPack::pack");
+	size_t count = lanes.size(), i = 0;
+	int bytes = bytesPer(precision);
+#if QUAT_SIMD_SSE2
+	int maximum = quantMax(precision);
+	alignas(16) uint32_t words[3][4];
+	for (; i + 4 <= count; i += 4) {
+		__m128 q[4] = { _mm_loadu_ps(&lanes.w[i]), _mm_loadu_ps(&lanes.x[i]), _mm_loadu_ps(&lanes.y[i]), _mm_loadu_ps(&lanes.z[i]) };
+		__m128i index, values[3];
+		encode4(q, maximum, index, values);
+		if (precision == Precision::Bits32) {
+			__m128i bits = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(index, 30), _mm_slli_epi32(values[0], 20)),
+				_mm_or_si128(_mm_slli_epi32(values[1], 10), values[2]));
+			_mm_store_si128(reinterpret_cast<__m128i*>(words[0]), bits);
+			for (int l = 0; l < 4; l++) {
+				writeWord(out + (i + l) * 4, words[0][l] & 0xffff);
+				writeWord(out + (i + l) * 4 + 2, words[0][l] >> 16);
+			}
+		}
+		else {
+			const __m128i low = _mm_set1_epi32(1);
+			_mm_store_si128(reinterpret_cast<__m128i*>(words[0]), _mm_or_si128(values[0], _mm_slli_epi32(_mm_and_si128(index, low), 15)));
+			_mm_store_si128(reinterpret_cast<__m128i*>(words[1]), _mm_or_si128(values[1], _mm_slli_epi32(_mm_srli_epi32(index, 1), 15)));
+			_mm_store_si128(reinterpret_cast<__m128i*>(words[2]), values[2]);
+			for (int l = 0; l < 4; l++) {
+				for (int w = 0; w < 3; w++)
+					writeWord(out + (i + l) * 6 + w * 2, words[w][l]);
+			}
+		}
+	}
+#endif
+	/* remainder (everything without SSE2) */
+	for (; i < count; i++) {
+		glm::quat q(lanes.w[i], lanes.x[i], lanes.y[i], lanes.z[i]);
+		if (precision == Precision::Bits32) {
+			uint32_t bits = pack32(q);
+			writeWord(out + i * bytes, bits & 0xffff);
+			writeWord(out + i * bytes + 2, bits >> 16);
+		}
+		else {
+			pack48(q, out + i * bytes);
+		}
+	}
+}
+
+void QuatPack::unpack(const uint8_t* in, size_t count, Precision precision, RotationBatch::QuatLanes& lanes) {
+	PROFILE_SCOPE("QuatPack::unpack");
+	lanes.resize(count);
+	size_t i = 0;
+	int bytes = bytesPer(precision);
+#if QUAT_SIMD_SSE2
+	int maximum = quantMax(precision);
+	alignas(16) uint32_t words[3][4];
+	for (; i + 4 <= count; i += 4) {
+		__m128i index, values[3];
+		if (precision == Precision::Bits32) {
+			for (int l = 0; l < 4; l++)
+				words[0][l] = readWord(in + (i + l) * 4) | (readWord(in + (i + l) * 4 + 2) << 16);
+			__m128i bits = _mm_load_si128(reinterpret_cast<const __m128i*>(words[0]));
+			const __m128i mask = _mm_set1_epi32(0x3ff);
+			index = _mm_srli_epi32(bits, 30);
+			values[0] = _mm_and_si128(_mm_srli_epi32(bits, 20), mask);
+			values[1] = _mm_and_si128(_mm_srli_epi32(bits, 10), mask);
+			values[2] = _mm_and_si128(bits, mask);
+		}
+		else {
+			for (int l = 0; l < 4; l++) {
+				for (int w = 0; w < 3; w++)
+					words[w][l] = readWord(in + (i + l) * 6 + w * 2);
+			}
+			__m128i first = _mm_load_si128(reinterpret_cast<const __m128i*>(words[0]));
+			__m128i second = _mm_load_si128(reinterpret_cast<const __m128i*>(words[1]));
+			const __m128i mask = _mm_set1_epi32(0x7fff);
+			index = _mm_or_si128(_mm_srli_epi32(first, 15), _mm_slli_epi32(_mm_srli_epi32(second, 15), 1));
+			values[0] = _mm_and_si128(first, mask);
+			values[1] = _mm_and_si128(second, mask);
+			values[2] = _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(words[2])), mask);
+		}
+		__m128 r[4];
+		decode4(index, values, maximum, r);
+		_mm_storeu_ps(&lanes.w[i], r[0]);
+		_mm_storeu_ps(&lanes.x[i], r[1]);
+		_mm_storeu_ps(&lanes.y[i], r[2]);
+		_mm_storeu_ps(&lanes.z[i], r[3]);
+	}
+#endif
+	/* remainder (everything without SSE2) */
+	for (; i < count; i++) {
+		glm::quat q = precision == Precision::Bits32 ?
+			unpack32(readWord(in + i * bytes) | (readWord(in + i * bytes + 2) << 16)) : unpack48(in + i * bytes);
+		lanes.w[i] = q.w; lanes.x[i] = q.x; lanes.y[i] = q.y; lanes.z[i] = q.z;
+	}
+}
+
+void QuatPack::PackedRotations::reset(Precision precision) {
+	m_Precision = precision;
+	m_Count = 0;
+	m_Bytes.clear();
+}
+
+size_t QuatPack::PackedRotations::append(const std::vector<glm::quat>& rotations) {
+	m_Lanes.resize(rotations.size());
+	for (size_t i = 0; i < rotations.size(); i++) {
+		m_Lanes.w[i] = rotations[i].w; m_Lanes.x[i] = rotations[i].x; m_Lanes.y[i] = rotations[i].y; m_Lanes.z[i] = rotations[i].z;
+	}
+	return append(m_Lanes);
+}
+
+size_t QuatPack::PackedRotations::append(const RotationBatch::QuatLanes& lanes) {
+	size_t first = m_Count;
+	m_Bytes.resize((m_Count + lanes.size()) * bytesPer(m_Precision));
+	pack(lanes, m_Precision, m_Bytes.data() + m_Count * bytesPer(m_Precision));
+	m_Count += lanes.size();
+	return first;
+}
+
+size_t QuatPack::PackedRotations::append(const glm::quat& rotation) {
+	size_t first = m_Count;
+	m_Bytes.resize((m_Count + 1) * bytesPer(m_Precision));
+	uint8_t* out = m_Bytes.data() + m_Count * bytesPer(m_Precision);
+	if (m_Precision == Precision::Bits32) {
+		uint32_t bits = pack32(rotation);
+		writeWord(out, bits & 0xffff);
+		writeWord(out + 2, bits >> 16);
+	}
+	else {
+		pack48(rotation, out);
+	}
+	m_Count++;
+	return first;
+}
+
+size_t QuatPack::PackedRotations::appendPacked(const uint8_t* in, size_t count) {
+	size_t first = m_Count;
+	m_Bytes.insert(m_Bytes.end(), in, in + count * bytesPer(m_Precision));
+	m_Count += count;
+	return first;
+}
+
+void QuatPack::PackedRotations::reserve(size_t count) {
+	m_Bytes.reserve(count * bytesPer(m_Precision));
+}
+
+void QuatPack::PackedRotations::decode(size_t first, size_t count, RotationBatch::QuatLanes& lanes) const {
+	count = first < m_Count ? std::min(count, m_Count - first) : 0;
+	unpack(m_Bytes.data() + first * bytesPer(m_Precision), count, m_Precision, lanes);
+}
+
+glm::quat QuatPack::PackedRotations::get(size_t index) const {
+	const uint8_t* in = m_Bytes.data() + index * bytesPer(m_Precision);
+	return m_Precision == Precision::Bits32 ? unpack32(readWord(in) | (readWord(in + 2) << 16)) : unpack48(in);
+}
+
+size_t QuatPack::PackedRotations::size() const {
+	return m_Count;
+}
+
+size_t QuatPack::PackedRotations::getByteSize() const {
+	return m_Bytes.size();
+}
+
+const uint8_t* QuatPack::PackedRotations::data() const {
+	return m_Bytes.data();
+}
+
+QuatPack::Precision QuatPack::PackedRotations::getPrecision() const {
+	return m_Precision;
+}
+
+void QuatPack::PackedRotations::shrink() {
+	m_Bytes.shrink_to_fit();
+	m_Lanes = RotationBatch::QuatLanes();
+}
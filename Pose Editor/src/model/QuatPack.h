@@ -0,0 +1,140 @@
+/// <title>Quaternion Pack</title>
+/// <desc>
+///		Smallest-three quantization of unit quaternions into 32 or 48 bits, with SSE2 batch kernels.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../profiler/Profiler.h"
+#include "QuatSimd.h"
+#include "RotationBatch.h"
+
+/// <summary>
+/// QuatPack stores unit quaternions in 4 or 6 bytes instead of 16. The largest component (by magnitude) is dropped and rebuilt
+/// from the unit length, the sign of the quaternion is chosen to make it positive. The other three lie within +-1/sqrt(2),
+/// they are quantized evenly over that range: 10 bits each in 32 bits, 15 bits each in 48 bits, plus 2 bits of the index.
+/// Packed data is little endian bytes, the same on disk and in memory.
+/// </summary>
+namespace QuatPack {
+
+	/// <summary>
+	/// Size of a packed quaternion. Bits32 keeps rotations within half a degree, Bits48 within a sixtieth of a degree.
+	/// </summary>
+	enum class Precision { Bits32, Bits48 };
+
+	/// <returns>bytes per packed quaternion: 4 or 6.</returns>
+	int bytesPer(Precision precision);
+
+	/// <returns>
+	/// bound in degrees of the angle between a unit quaternion and its packed and unpacked copy. Every component is off by at
+	/// most half a step e, the rebuilt one by at most 6e (it is at least 1/2), so the copy lies within 2 asin(sqrt(39) e).
+	/// </returns>
+	float maxError(Precision precision);
+
+	/// <returns>
+	/// angle in degrees between the orientations of two unit quaternions, from the length of their difference. Unlike the
+	/// cosine taken from their dot product it keeps its precision for the tiny angles packing brings.
+	/// </returns>
+	float angleBetween(const glm::quat& a, const glm::quat& b);
+
+	/// <summary>
+	/// Picks the smallest precision whose maxError() is within maxErrorDegrees.
+	/// </summary>
+	/// <returns>false if not even Bits48 is precise enough, precision is left untouched.</returns>
+	bool choosePrecision(float maxErrorDegrees, Precision& precision);
+
+	/// <summary>
+	/// Packs a unit quaternion into 4 bytes: the index of the dropped component in the top 2 bits, then the other three in 10 bits each.
+	/// </summary>
+	uint32_t pack32(const glm::quat& q);
+	glm::quat unpack32(uint32_t bits);
+	/// <summary>
+	/// Packs a unit quaternion into 6 bytes: three 16 bit words holding the other three components in 15 bits each, the top bits
+	/// of the first two words hold the index of the dropped component.
+	/// </summary>
+	void pack48(const glm::quat& q, uint8_t* out);
+	glm::quat unpack48(const uint8_t* in);
+
+	/// <summary>
+	/// Packs every quaternion of the lanes into bytesPer(precision) bytes, four at a time with SSE2. Gives the same bytes as
+	/// pack32() and pack48() per quaternion.
+	/// </summary>
+	/// <param name="out">has to hold lanes.size() * bytesPer(precision) bytes.</param>
+	void pack(const RotationBatch::QuatLanes& lanes, Precision precision, uint8_t* out);
+
+	/// <summary>
+	/// Unpacks count quaternions into the lanes, four at a time with SSE2. The result is normalized.
+	/// </summary>
+	/// <param name="lanes">resized to count.</param>
+	void unpack(const uint8_t* in, size_t count, Precision precision, RotationBatch::QuatLanes& lanes);
+
+	/// <summary>
+	/// PackedRotations keeps a growing list of rotations packed, such as the bones of every pose of a library one pose after another.
+	/// </summary>
+	class PackedRotations {
+	private:
+		Precision m_Precision = Precision::Bits48;
+		size_t m_Count = 0;
+		std::vector<uint8_t> m_Bytes;
+		/// <summary>rotations being appended, in lanes for the kernel.</summary>
+		RotationBatch::QuatLanes m_Lanes;
+
+	public:
+		/// <summary>
+		/// Empties the list and sets the precision of the rotations appended from now on.
+		/// </summary>
+		void reset(Precision precision);
+		/// <summary>
+		/// Packs the rotations at the end of the list.
+		/// </summary>
+		/// <returns>index of the first appended rotation.</returns>
+		size_t append(const std::vector<glm::quat>& rotations);
+		/// <summary>
+		/// Packs the rotations of the lanes at the end of the list. They have to be unit quaternions.
+		/// </summary>
+		/// <returns>index of the first appended rotation.</returns>
+		size_t append(const RotationBatch::QuatLanes& lanes);
+		/// <summary>
+		/// Packs a single unit quaternion at the end of the list.
+		/// </summary>
+		/// <returns>index of the rotation.</returns>
+		size_t append(const glm::quat& rotation);
+		/// <summary>
+		/// Appends count rotations already packed at the precision of the list, such as a row of a library file.
+		/// </summary>
+		/// <returns>index of the first appended rotation.</returns>
+		size_t appendPacked(const uint8_t* in, size_t count);
+		/// <summary>
+		/// Preallocates the bytes for count rotations in total.
+		/// </summary>
+		void reserve(size_t count);
+		/// <summary>
+		/// Unpacks count rotations starting at first into the lanes.
+		/// </summary>
+		void decode(size_t first, size_t count, RotationBatch::QuatLanes& lanes) const;
+		/// <returns>the unpacked rotation at index.</returns>
+		glm::quat get(size_t index) const;
+		/// <returns>amount of rotations held.</returns>
+		size_t size() const;
+		/// <returns>bytes held by the packed rotations.</returns>
+		size_t getByteSize() const;
+		/// <returns>the packed rotations, bytesPer(getPrecision()) bytes each.</returns>
+		const uint8_t* data() const;
+		Precision getPrecision() const;
+		/// <summary>
+		/// Releases the capacity beyond the packed rotations and the append buffers.
+		/// </summary>
+		void shrink();
+	};
+}
@@ -0,0 +1,203 @@
+/// <title>Quaternion SIMD</title>
+/// <desc>
+///		Inline SSE helpers shared by the batch quaternion kernels of the model: the quaternion product and four lane
+///		approximations of the trigonometric functions they need.
+///		QUAT_SIMD_SSE2 is 1 when the target supports SSE2, kernels provide a scalar fallback otherwise.
+///		(GLM keeps its own SSE quaternion product disabled, so the product is implemented here.)
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <glm/gtc/quaternion.hpp>
+
+#if !defined(QUAT_SIMD_DISABLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define QUAT_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define QUAT_SIMD_SSE2 0
+#endif
+
+namespace QuatSimd {
+
+	/// <summary>
+	/// Hamilton product a * b, the same as glm::quat operator* with the operands spelled out.
+	/// </summary>
+	inline glm::quat mul(const glm::quat& a, const glm::quat& b) {
+		return glm::quat(
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+			a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+			a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+			a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w);
+	}
+
+	/// <summary>
+	/// Rotates v by the unit quaternion q, the same as q * v: v + w * t + cross(u, t) with u = (x, y, z) and t = 2 * cross(u, v).
+	/// </summary>
+	inline glm::vec3 rotate(const glm::quat& q, const glm::vec3& v) {
+		glm::vec3 u(q.x, q.y, q.z);
+		glm::vec3 t = 2.0f * glm::cross(u, v);
+		return v + q.w * t + glm::cross(u, t);
+	}
+
+#if QUAT_SIMD_SSE2
+	/// <summary>
+	/// Hamilton product a * b with both quaternions held in the memory order of glm::quat: (w, x, y, z) lanes.
+	/// </summary>
+	inline __m128 mul(__m128 a, __m128 b) {
+		// _mm_set_ps lists the lanes from the highest (z) to the lowest (w).
+		const __m128 signX = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+		const __m128 signY = _mm_set_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+		const __m128 signZ = _mm_set_ps(0.0f, 0.0f, -0.0f, -0.0f);
+		__m128 aw = _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 ax = _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 ay = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 az = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3));
+		/* aw * (bw, bx, by, bz) + ax * (-bx, bw, -bz, by) + ay * (-by, bz, bw, -bx) + az * (-bz, -by, bx, bw) */
+		__m128 result = _mm_mul_ps(aw, b);
+		result = _mm_add_ps(result, _mm_mul_ps(ax, _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), signX)));
+		result = _mm_add_ps(result, _mm_mul_ps(ay, _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), signY)));
+		result = _mm_add_ps(result, _mm_mul_ps(az, _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), signZ)));
+		return result;
+	}
+
+	/// <summary>
+	/// Hamilton products of four quaternion pairs held as one register per component: a[0] holds the four w, a[1] the four x and so on.
+	/// </summary>
+	/// <param name="result">may not alias a or b.</param>
+	inline void mul(const __m128 a[4], const __m128 b[4], __m128 result[4]) {
+		result[0] = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(a[0], b[0]), _mm_mul_ps(a[1], b[1])), _mm_add_ps(_mm_mul_ps(a[2], b[2]), _mm_mul_ps(a[3], b[3])));
+		result[1] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], b[1]), _mm_mul_ps(a[1], b[0])), _mm_sub_ps(_mm_mul_ps(a[2], b[3]), _mm_mul_ps(a[3], b[2])));
+		result[2] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a[0], b[2]), _mm_mul_ps(a[1], b[3])), _mm_add_ps(_mm_mul_ps(a[2], b[0]), _mm_mul_ps(a[3], b[1])));
+		result[3] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], b[3]), _mm_mul_ps(a[1], b[2])), _mm_sub_ps(_mm_mul_ps(a[3], b[0]), _mm_mul_ps(a[2], b[1])));
+	}
+
+	/// <summary>
+	/// Rotates four vectors by four unit quaternions, both held as one register per component: q as (w, x, y, z), v as (x, y, z).
+	/// </summary>
+	/// <param name="result">may not alias v.</param>
+	inline void rotate(const __m128 q[4], const __m128 v[3], __m128 result[3]) {
+		const __m128 two = _mm_set1_ps(2.0f);
+		__m128 tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(q[2], v[2]), _mm_mul_ps(q[3], v[1])));
+		__m128 ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(q[3], v[0]), _mm_mul_ps(q[1], v[2])));
+		__m128 tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(q[1], v[1]), _mm_mul_ps(q[2], v[0])));
+		result[0] = _mm_add_ps(_mm_add_ps(v[0], _mm_mul_ps(q[0], tx)), _mm_sub_ps(_mm_mul_ps(q[2], tz), _mm_mul_ps(q[3], ty)));
+		result[1] = _mm_add_ps(_mm_add_ps(v[1], _mm_mul_ps(q[0], ty)), _mm_sub_ps(_mm_mul_ps(q[3], tx), _mm_mul_ps(q[1], tz)));
+		result[2] = _mm_add_ps(_mm_add_ps(v[2], _mm_mul_ps(q[0], tz)), _mm_sub_ps(_mm_mul_ps(q[1], ty), _mm_mul_ps(q[2], tx)));
+	}
+
+	/// <summary>loads a glm::quat into (w, x, y, z) lanes.</summary>
+	inline __m128 load(const glm::quat& q) {
+		return _mm_loadu_ps(&q.w);
+	}
+
+	/// <summary>stores (w, x, y, z) lanes into a glm::quat.</summary>
+	inline void store(glm::quat& q, __m128 v) {
+		_mm_storeu_ps(&q.w, v);
+	}
+
+	// === lane math ===
+	// The approximations follow the single precision routines of the Cephes library (sinf, cosf, atanf, asinf).
+
+	/// <summary>only the sign bit set in every lane.</summary>
+	inline __m128 signMask() {
+		return _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+	}
+
+	/// <summary>sine and cosine of four angles in radians. Accurate for |x| below 8192.</summary>
+	inline void sinCos(__m128 x, __m128& sinOut, __m128& cosOut) {
+		__m128 sinSign = _mm_and_ps(x, signMask());
+		x = _mm_andnot_ps(signMask(), x);
+		/* octant j of the angle, rounded up to an even number */
+		__m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(j);
+		__m128 sinSwap = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+		__m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		__m128 usePolySin = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		sinSign = _mm_xor_ps(sinSign, sinSwap);
+		/* extended precision modular arithmetic: x - j * pi/4 */
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+		__m128 z = _mm_mul_ps(x, x);
+		__m128 polyCos = _mm_set1_ps(2.443315711809948e-5f);
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(-1.388731625493765e-3f));
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(4.166664568298827e-2f));
+		polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+		polyCos = _mm_sub_ps(polyCos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		polyCos = _mm_add_ps(polyCos, _mm_set1_ps(1.0f));
+		__m128 polySin = _mm_set1_ps(-1.9515295891e-4f);
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(8.3321608736e-3f));
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(-1.6666654611e-1f));
+		polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), x), x);
+		/* octants 1, 2, 5, 6 swap the polynomials */
+		__m128 s = _mm_or_ps(_mm_and_ps(usePolySin, polySin), _mm_andnot_ps(usePolySin, polyCos));
+		__m128 c = _mm_or_ps(_mm_and_ps(usePolySin, polyCos), _mm_andnot_ps(usePolySin, polySin));
+		sinOut = _mm_xor_ps(s, sinSign);
+		cosOut = _mm_xor_ps(c, cosSign);
+	}
+
+	/// <summary>arc tangent of four values.</summary>
+	inline __m128 atan(__m128 x) {
+		__m128 sign = _mm_and_ps(x, signMask());
+		x = _mm_andnot_ps(signMask(), x);
+		/* reduce the range to [0, tan(pi/8)] */
+		__m128 big = _mm_cmpgt_ps(x, _mm_set1_ps(2.414213562373095f));
+		__m128 mid = _mm_andnot_ps(big, _mm_cmpgt_ps(x, _mm_set1_ps(0.4142135623730950f)));
+		__m128 xBig = _mm_div_ps(_mm_set1_ps(-1.0f), x);
+		__m128 xMid = _mm_div_ps(_mm_sub_ps(x, _mm_set1_ps(1.0f)), _mm_add_ps(x, _mm_set1_ps(1.0f)));
+		x = _mm_or_ps(_mm_and_ps(big, xBig), _mm_andnot_ps(big, x));
+		x = _mm_or_ps(_mm_and_ps(mid, xMid), _mm_andnot_ps(mid, x));
+		__m128 y = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(1.5707963267948966f)), _mm_and_ps(mid, _mm_set1_ps(0.7853981633974483f)));
+		__m128 z = _mm_mul_ps(x, x);
+		__m128 poly = _mm_set1_ps(8.05374449538e-2f);
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(-1.38776856032e-1f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(1.99777106478e-1f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(-3.33329491539e-1f));
+		poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(poly, z), x), x);
+		return _mm_xor_ps(_mm_add_ps(y, poly), sign);
+	}
+
+	/// <summary>atan2(y, x) of four value pairs, including the signed zero and x = 0 cases of std::atan2.</summary>
+	inline __m128 atan2(__m128 y, __m128 x) {
+		__m128 zero = _mm_setzero_ps();
+		__m128 xZero = _mm_cmpeq_ps(x, zero);
+		/* the x = 0 lanes are replaced below, avoid the division by zero there */
+		__m128 angle = atan(_mm_div_ps(y, _mm_or_ps(x, _mm_and_ps(xZero, _mm_set1_ps(1.0f)))));
+		/* x < 0 (or -0) adds pi with the sign of y */
+		__m128 ySign = _mm_and_ps(y, signMask());
+		__m128 xNegative = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+		angle = _mm_add_ps(angle, _mm_and_ps(xNegative, _mm_or_ps(_mm_set1_ps(3.14159265358979f), ySign)));
+		/* x = 0: +-pi/2 for y != 0 and (signed) 0 or pi for y = 0 */
+		__m128 yZero = _mm_cmpeq_ps(y, zero);
+		__m128 onAxis = _mm_or_ps(_mm_andnot_ps(yZero, _mm_set1_ps(1.5707963267948966f)),
+			_mm_and_ps(yZero, _mm_and_ps(xNegative, _mm_set1_ps(3.14159265358979f))));
+		onAxis = _mm_or_ps(onAxis, ySign);
+		return _mm_or_ps(_mm_and_ps(xZero, onAxis), _mm_andnot_ps(xZero, angle));
+	}
+
+	/// <summary>arc sine of four values in [-1, 1].</summary>
+	inline __m128 asin(__m128 x) {
+		__m128 sign = _mm_and_ps(x, signMask());
+		__m128 a = _mm_andnot_ps(signMask(), x);
+		/* above 0.5 use asin(a) = pi/2 - 2 asin(sqrt((1 - a) / 2)) */
+		__m128 flip = _mm_cmpgt_ps(a, _mm_set1_ps(0.5f));
+		__m128 zFlip = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(_mm_set1_ps(1.0f), a));
+		__m128 z = _mm_or_ps(_mm_and_ps(flip, zFlip), _mm_andnot_ps(flip, _mm_mul_ps(a, a)));
+		__m128 v = _mm_or_ps(_mm_and_ps(flip, _mm_sqrt_ps(zFlip)), _mm_andnot_ps(flip, a));
+		__m128 poly = _mm_set1_ps(4.2163199048e-2f);
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(2.4181311049e-2f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(4.5470025998e-2f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(7.4953002686e-2f));
+		poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(1.6666752422e-1f));
+		poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(poly, z), v), v);
+		__m128 flipped = _mm_sub_ps(_mm_set1_ps(1.5707963267948966f), _mm_add_ps(poly, poly));
+		poly = _mm_or_ps(_mm_and_ps(flip, flipped), _mm_andnot_ps(flip, poly));
+		return _mm_xor_ps(poly, sign);
+	}
+#endif
+}
@@ -0,0 +1,199 @@
+/// <title>Rotation Batch</title>
+/// <desc>
+///		Array-at-a-time euler/quaternion conversions over structure of arrays lanes.
+///		Batch counterpart of PoseDataUtil::eulerToQuat and PoseDataUtil::quatToEuler.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+/// <summary>amount of bones converted at once by the pawn helpers, keeps the lanes on the stack.</summary>
+#define PAWN_BLOCK 256
+
+#include "RotationBatch.h"
+
+#if QUAT_SIMD_SSE2
+/// <returns>all bits set in lanes where both |x| and |y| are within the epsilon GLM uses to detect the atan2(0, 0) singularity.</returns>
+static inline __m128 nearZero(__m128 x, __m128 y) {
+	__m128 epsilon = _mm_set1_ps(std::numeric_limits<float>::epsilon());
+	return _mm_and_ps(_mm_cmplt_ps(_mm_andnot_ps(QuatSimd::signMask(), x), epsilon), _mm_cmplt_ps(_mm_andnot_ps(QuatSimd::signMask(), y), epsilon));
+}
+
+template<PoseData::RotationOrder Order>
+static inline void eulerToQuat4(const float* ex, const float* ey, const float* ez, float* qw, float* qx, float* qy, float* qz) {
+	using A = EulerOrder::Axes<Order>;
+	/* degrees to half angles in radians */
+	const __m128 toHalfRadians = _mm_set1_ps(3.14159265358979f / 360.0f);
+	const __m128 p = _mm_set1_ps(A::parity);
+	__m128 s[3], c[3];
+	QuatSimd::sinCos(_mm_mul_ps(_mm_loadu_ps(ex), toHalfRadians), s[0], c[0]);
+	QuatSimd::sinCos(_mm_mul_ps(_mm_loadu_ps(ey), toHalfRadians), s[1], c[1]);
+	QuatSimd::sinCos(_mm_mul_ps(_mm_loadu_ps(ez), toHalfRadians), s[2], c[2]);
+	__m128 sa = s[A::first], ca = c[A::first], sb = s[A::second], cb = c[A::second], sc = s[A::third], cc = c[A::third];
+	/* same products as EulerOrder::eulerToQuat */
+	__m128 v[3];
+	v[A::first] = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(sa, cb), cc), _mm_mul_ps(p, _mm_mul_ps(_mm_mul_ps(ca, sb), sc)));
+	v[A::second] = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ca, sb), cc), _mm_mul_ps(p, _mm_mul_ps(_mm_mul_ps(sa, cb), sc)));
+	v[A::third] = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(ca, cb), sc), _mm_mul_ps(p, _mm_mul_ps(_mm_mul_ps(sa, sb), cc)));
+	_mm_storeu_ps(qw, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ca, cb), cc), _mm_mul_ps(p, _mm_mul_ps(_mm_mul_ps(sa, sb), sc))));
+	_mm_storeu_ps(qx, v[0]);
+	_mm_storeu_ps(qy, v[1]);
+	_mm_storeu_ps(qz, v[2]);
+}
+
+/// <summary>element [row][column] of the rotation matrix, same as EulerOrder::matrixElement.</summary>
+template<int Row, int Column>
+static inline __m128 matrixElement4(__m128 w, const __m128* v) {
+	constexpr int other = 3 - Row - Column;
+	const __m128 sign = _mm_set1_ps((Row - Column + 3) % 3 == 1 ? 1.0f : -1.0f);
+	__m128 sum = _mm_add_ps(_mm_mul_ps(v[Row], v[Column]), _mm_mul_ps(sign, _mm_mul_ps(w, v[other])));
+	return _mm_add_ps(sum, sum);
+}
+
+template<PoseData::RotationOrder Order>
+static inline void quatToEuler4(const float* qw, const float* qx, const float* qy, const float* qz, float* ex, float* ey, float* ez) {
+	using A = EulerOrder::Axes<Order>;
+	__m128 w = _mm_loadu_ps(qw), v[3] = { _mm_loadu_ps(qx), _mm_loadu_ps(qy), _mm_loadu_ps(qz) };
+	/* glm::normalize, zero length quaternions become identity */
+	__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(w, w), _mm_mul_ps(v[0], v[0])), _mm_add_ps(_mm_mul_ps(v[1], v[1]), _mm_mul_ps(v[2], v[2]))));
+	__m128 degenerate = _mm_cmple_ps(length, _mm_setzero_ps());
+	__m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), _mm_or_ps(length, _mm_and_ps(degenerate, _mm_set1_ps(1.0f))));
+	w = _mm_or_ps(_mm_andnot_ps(degenerate, _mm_mul_ps(w, inverse)), _mm_and_ps(degenerate, _mm_set1_ps(1.0f)));
+	for (int axis = 0; axis < 3; axis++)
+		v[axis] = _mm_andnot_ps(degenerate, _mm_mul_ps(v[axis], inverse));
+	const __m128 p = _mm_set1_ps(A::parity);
+	__m128 ww = _mm_mul_ps(w, w);
+	__m128 aa = _mm_mul_ps(v[A::first], v[A::first]), bb = _mm_mul_ps(v[A::second], v[A::second]), cc = _mm_mul_ps(v[A::third], v[A::third]);
+	__m128 euler[3];
+	/* first angle, the singular case takes the whole rotation as glm::pitch does */
+	__m128 firstY = _mm_mul_ps(p, matrixElement4<A::third, A::second>(w, v));
+	__m128 firstX = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(ww, aa), bb), cc);
+	__m128 firstSingular = nearZero(firstX, firstY);
+	__m128 first = QuatSimd::atan2(_mm_or_ps(_mm_andnot_ps(firstSingular, firstY), _mm_and_ps(firstSingular, v[A::first])),
+		_mm_or_ps(_mm_andnot_ps(firstSingular, firstX), _mm_and_ps(firstSingular, w)));
+	euler[A::first] = _mm_add_ps(first, _mm_and_ps(firstSingular, first));
+	/* middle angle */
+	__m128 middleSin = _mm_mul_ps(_mm_xor_ps(p, QuatSimd::signMask()), matrixElement4<A::third, A::first>(w, v));
+	middleSin = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(_mm_set1_ps(1.0f), middleSin));
+	euler[A::second] = QuatSimd::asin(middleSin);
+	/* last angle, 0 in the singular case as glm::roll does */
+	__m128 thirdY = _mm_mul_ps(p, matrixElement4<A::second, A::first>(w, v));
+	__m128 thirdX = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(ww, aa), bb), cc);
+	euler[A::third] = _mm_andnot_ps(nearZero(thirdX, thirdY), QuatSimd::atan2(thirdY, thirdX));
+	const __m128 toDegrees = _mm_set1_ps(180.0f / 3.14159265358979f);
+	_mm_storeu_ps(ex, _mm_mul_ps(euler[0], toDegrees));
+	_mm_storeu_ps(ey, _mm_mul_ps(euler[1], toDegrees));
+	_mm_storeu_ps(ez, _mm_mul_ps(euler[2], toDegrees));
+}
+#endif
+
+template<PoseData::RotationOrder Order>
+static void eulerToQuatKernel(const float* ex, const float* ey, const float* ez,
+	float* qw, float* qx, float* qy, float* qz, size_t count) {
+	size_t i = 0;
+#if QUAT_SIMD_SSE2
+	for (; i + 4 <= count; i += 4)
+		eulerToQuat4<Order>(ex + i, ey + i, ez + i, qw + i, qx + i, qy + i, qz + i);
+	if (i < count) {
+		/* pad the remainder, so every element goes through the same kernel */
+		float in[3][4] = {}, out[4][4];
+		for (size_t k = i; k < count; k++) {
+			in[0][k - i] = ex[k]; in[1][k - i] = ey[k]; in[2][k - i] = ez[k];
+		}
+		eulerToQuat4<Order>(in[0], in[1], in[2], out[0], out[1], out[2], out[3]);
+		for (size_t k = i; k < count; k++) {
+			qw[k] = out[0][k - i]; qx[k] = out[1][k - i]; qy[k] = out[2][k - i]; qz[k] = out[3][k - i];
+		}
+	}
+#else
+	for (; i < count; i++) {
+		glm::quat q = EulerOrder::eulerToQuat<Order>(glm::vec3(ex[i], ey[i], ez[i]));
+		qw[i] = q.w; qx[i] = q.x; qy[i] = q.y; qz[i] = q.z;
+	}
+#endif
+}
+
+template<PoseData::RotationOrder Order>
+static void quatToEulerKernel(const float* qw, const float* qx, const float* qy, const float* qz,
+	float* ex, float* ey, float* ez, size_t count) {
+	size_t i = 0;
+#if QUAT_SIMD_SSE2
+	for (; i + 4 <= count; i += 4)
+		quatToEuler4<Order>(qw + i, qx + i, qy + i, qz + i, ex + i, ey + i, ez + i);
+	if (i < count) {
+		/* pad the remainder with identity, so every element goes through the same kernel */
+		float in[4][4] = { { 1, 1, 1, 1 } }, out[3][4];
+		for (size_t k = i; k < count; k++) {
+			in[0][k - i] = qw[k]; in[1][k - i] = qx[k]; in[2][k - i] = qy[k]; in[3][k - i] = qz[k];
+		}
+		quatToEuler4<Order>(in[0], in[1], in[2], in[3], out[0], out[1], out[2]);
+		for (size_t k = i; k < count; k++) {
+			ex[k] = out[0][k - i]; ey[k] = out[1][k - i]; ez[k] = out[2][k - i];
+		}
+	}
+#else
+	for (; i < count; i++) {
+		glm::vec3 euler = EulerOrder::quatToEuler<Order>(glm::quat(qw[i], qx[i], qy[i], qz[i]));
+		ex[i] = euler.x; ey[i] = euler.y; ez[i] = euler.z;
+	}
+#endif
+}
+
+void RotationBatch::eulerToQuat(const float* ex, const float* ey, const float* ez,
+	float* qw, float* qx, float* qy, float* qz, size_t count, PoseData::RotationOrder order) {
+	EulerOrder::dispatch(order, [&](auto tag) { eulerToQuatKernel<decltype(tag)::value>(ex, ey, ez, qw, qx, qy, qz, count); });
+}
+
+void RotationBatch::quatToEuler(const float* qw, const float* qx, const float* qy, const float* qz,
+	float* ex, float* ey, float* ez, size_t count, PoseData::RotationOrder order) {
+	EulerOrder::dispatch(order, [&](auto tag) { quatToEulerKernel<decltype(tag)::value>(qw, qx, qy, qz, ex, ey, ez, count); });
+}
+
+void RotationBatch::eulerToQuat(const EulerLanes& euler, QuatLanes& quat, PoseData::RotationOrder order) {
+	quat.resize(euler.size());
+	eulerToQuat(euler.x.data(), euler.y.data(), euler.z.data(), quat.w.data(), quat.x.data(), quat.y.data(), quat.z.data(), euler.size(), order);
+}
+
+void RotationBatch::quatToEuler(const QuatLanes& quat, EulerLanes& euler, PoseData::RotationOrder order) {
+	euler.resize(quat.size());
+	quatToEuler(quat.w.data(), quat.x.data(), quat.y.data(), quat.z.data(), euler.x.data(), euler.y.data(), euler.z.data(), quat.size(), order);
+}
+
+void RotationBatch::pawnEulerToQuat(PoseData::BonePawn& pawn) {
+	bonesEulerToQuat(pawn.bones, pawn.rotationOrder);
+}
+
+void RotationBatch::pawnQuatToEuler(PoseData::BonePawn& pawn) {
+	bonesQuatToEuler(pawn.bones, pawn.rotationOrder);
+}
+
+void RotationBatch::bonesEulerToQuat(std::vector<PoseData::BoneData>& bones, PoseData::RotationOrder order) {
+	PROFILE_SCOPE("RotationBatch::bonesEulerToQuat");
+	float e[3][PAWN_BLOCK], q[4][PAWN_BLOCK];
+	for (size_t begin = 0; begin < bones.size(); begin += PAWN_BLOCK) {
+		size_t count = std::min(bones.size() - begin, static_cast<size_t>(PAWN_BLOCK));
+		for (size_t i = 0; i < count; i++) {
+			const glm::vec3& euler = bones[begin + i].eulerRotation;
+			e[0][i] = euler.x; e[1][i] = euler.y; e[2][i] = euler.z;
+		}
+		eulerToQuat(e[0], e[1], e[2], q[0], q[1], q[2], q[3], count, order);
+		for (size_t i = 0; i < count; i++)
+			bones[begin + i].quaternion = glm::quat(q[0][i], q[1][i], q[2][i], q[3][i]);
+	}
+}
+
+void RotationBatch::bonesQuatToEuler(std::vector<PoseData::BoneData>& bones, PoseData::RotationOrder order) {
+	PROFILE_SCOPE("RotationBatch::bonesQuatToEuler");
+	float q[4][PAWN_BLOCK], e[3][PAWN_BLOCK];
+	for (size_t begin = 0; begin < bones.size(); begin += PAWN_BLOCK) {
+		size_t count = std::min(bones.size() - begin, static_cast<size_t>(PAWN_BLOCK));
+		for (size_t i = 0; i < count; i++) {
+			const glm::quat& quat = bones[begin + i].quaternion;
+			q[0][i] = quat.w; q[1][i] = quat.x; q[2][i] = quat.y; q[3][i] = quat.z;
+		}
+		quatToEuler(q[0], q[1], q[2], q[3], e[0], e[1], e[2], count, order);
+		for (size_t i = 0; i < count; i++)
+			bones[begin + i].eulerRotation = glm::vec3(e[0][i], e[1][i], e[2][i]);
+	}
+}
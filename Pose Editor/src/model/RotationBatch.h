@@ -0,0 +1,103 @@
+/// <title>Rotation Batch</title>
+/// <desc>
+///		Array-at-a-time euler/quaternion conversions over structure of arrays lanes.
+///		Batch counterpart of PoseDataUtil::eulerToQuat and PoseDataUtil::quatToEuler.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "../PoseData.h"
+#include "../profiler/Profiler.h"
+#include "EulerOrder.h"
+#include "QuatSimd.h"
+
+/// <summary>
+/// Largest difference from the GLM conversions in quaternion components (eulerToQuat).
+/// </summary>
+#define ROTATION_BATCH_QUAT_TOLERANCE 1e-6f
+/// <summary>
+/// Largest difference from the GLM conversions in degrees (quatToEuler). Within 1e-2 degrees of gimbal lock
+/// (pitch of +-90 degrees) the decomposition itself is ill-conditioned and the angles may differ more, the rotation they describe does not.
+/// </summary>
+#define ROTATION_BATCH_EULER_TOLERANCE 1e-3f
+
+/// <summary>
+/// RotationBatch converts many rotations at once. The SSE2 kernels process four rotations per iteration with polynomial
+/// sine, cosine, arc tangent and arc sine approximations, the scalar fallback calls EulerOrder directly.
+/// Results follow EulerOrder (for XYZ the GLM conversions of PoseDataUtil) within ROTATION_BATCH_QUAT_TOLERANCE
+/// and ROTATION_BATCH_EULER_TOLERANCE. The order is resolved once per call, each order has its own kernel.
+/// </summary>
+namespace RotationBatch {
+
+	/// <summary>
+	/// Euler angles in degrees stored as one array per axis.
+	/// </summary>
+	struct EulerLanes {
+		std::vector<float> x, y, z;
+		void resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); }
+		size_t size() const { return x.size(); }
+	};
+
+	/// <summary>
+	/// Quaternions stored as one array per component.
+	/// </summary>
+	struct QuatLanes {
+		std::vector<float> w, x, y, z;
+		void resize(size_t count) { w.resize(count); x.resize(count); y.resize(count); z.resize(count); }
+		size_t size() const { return w.size(); }
+	};
+
+	/// <summary>
+	/// Converts count euler angles in degrees into quaternions. Same as PoseDataUtil::eulerToQuat per element.
+	/// </summary>
+	void eulerToQuat(const float* ex, const float* ey, const float* ez,
+		float* qw, float* qx, float* qy, float* qz, size_t count, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
+
+	/// <summary>
+	/// Converts count quaternions into euler angles in degrees. Same as PoseDataUtil::quatToEuler per element,
+	/// the quaternions don't have to be normalized.
+	/// </summary>
+	void quatToEuler(const float* qw, const float* qx, const float* qy, const float* qz,
+		float* ex, float* ey, float* ez, size_t count, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
+
+	/// <summary>
+	/// Converts all euler angles of the input lanes. The output lanes are resized to match.
+	/// </summary>
+	void eulerToQuat(const EulerLanes& euler, QuatLanes& quat, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
+
+	/// <summary>
+	/// Converts all quaternions of the input lanes. The output lanes are resized to match.
+	/// </summary>
+	void quatToEuler(const QuatLanes& quat, EulerLanes& euler, PoseData::RotationOrder order = PoseData::RotationOrder::XYZ);
+
+	/// <summary>
+	/// Sets the quaternion of every bone of the pawn from its eulerRotation, in the rotation order of the pawn.
+	/// </summary>
+	void pawnEulerToQuat(PoseData::BonePawn& pawn);
+
+	/// <summary>
+	/// Sets the eulerRotation of every bone of the pawn from its quaternion, in the rotation order of the pawn.
+	/// </summary>
+	void pawnQuatToEuler(PoseData::BonePawn& pawn);
+
+	/// <summary>
+	/// Sets the quaternion of every bone from its eulerRotation in the provided order.
+	/// </summary>
+	void bonesEulerToQuat(std::vector<PoseData::BoneData>& bones, PoseData::RotationOrder order);
+
+	/// <summary>
+	/// Sets the eulerRotation of every bone from its quaternion in the provided order.
+	/// </summary>
+	void bonesQuatToEuler(std::vector<PoseData::BoneData>& bones, PoseData::RotationOrder order);
+}
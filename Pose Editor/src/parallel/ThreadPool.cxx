@@ -0,0 +1,90 @@
+/// <title>Thread Pool</title>
+/// <desc>
+///		Persistent worker threads splitting loops over large arrays (bones, poses) into fixed chunks.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include "ThreadPool.h"
+
+/// <summary>true on the workers and on a thread running chunks, nested loops then run serially.</summary>
+static thread_local bool insideLoop = false;
+
+Parallel::ThreadPool::ThreadPool(int threadCount) {
+	if (threadCount <= 0)
+		threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	for (int i = 1; i < threadCount; i++)
+		m_Workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+Parallel::ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_Wake.notify_all();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+int Parallel::ThreadPool::getThreadCount() const {
+	return static_cast<int>(m_Workers.size()) + 1;
+}
+
+void Parallel::ThreadPool::runChunks() {
+	size_t begin;
+	while ((begin = m_Next.fetch_add(m_Grain)) < m_Count)
+		(*m_Body)(begin, std::min(begin + m_Grain, m_Count));
+}
+
+void Parallel::ThreadPool::workerLoop() {
+	insideLoop = true;
+	size_t seen = 0;
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true) {
+		m_Wake.wait(lock, [&] { return m_Stop || m_Generation != seen; });
+		if (m_Stop)
+			return;
+		seen = m_Generation;
+		lock.unlock();
+		runChunks();
+		lock.lock();
+		if (--m_Busy == 0)
+			m_Done.notify_one();
+	}
+}
+
+void Parallel::ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+	grain = std::max<size_t>(grain, 1);
+	if (count == 0)
+		return;
+	if (m_Workers.empty() || count <= grain || insideLoop) {
+		for (size_t begin = 0; begin < count; begin += grain)
+			body(begin, std::min(begin + grain, count));
+		return;
+	}
+	std::lock_guard<std::mutex> call(m_CallMutex);
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Body = &body;
+		m_Count = count;
+		m_Grain = grain;
+		m_Next = 0;
+		m_Busy = static_cast<int>(m_Workers.size());
+		m_Generation++;
+	}
+	m_Wake.notify_all();
+	insideLoop = true;
+	runChunks();
+	insideLoop = false;
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Done.wait(lock, [&] { return m_Busy == 0; });
+	m_Body = nullptr;
+}
+
+Parallel::ThreadPool& Parallel::ThreadPool::shared() {
+	static ThreadPool pool;
+	return pool;
+}
@@ -0,0 +1,71 @@
+/// <title>Thread Pool</title>
+/// <desc>
+///		Persistent worker threads splitting loops over large arrays (bones, poses) into fixed chunks.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+
+	/// <summary>
+	/// Pool of worker threads running parallelFor loops. The loop range is split into chunks of a fixed size independent
+	/// of the amount of threads, so a body writing only into its own chunk gives the same result with any pool.
+	/// The calling thread works on the chunks too. Bodies may not throw and should not record PROFILE_SCOPE phases,
+	/// the Profiler is meant for the main thread (Trace events are fine).
+	/// </summary>
+	class ThreadPool {
+	private:
+		std::vector<std::thread> m_Workers;
+		/// <summary>guards the state below, workers wait on m_Wake for a new loop and the caller on m_Done for its end.</summary>
+		std::mutex m_Mutex;
+		std::condition_variable m_Wake;
+		std::condition_variable m_Done;
+		/// <summary>serializes parallelFor calls from different threads.</summary>
+		std::mutex m_CallMutex;
+		const std::function<void(size_t, size_t)>* m_Body = nullptr;
+		size_t m_Count = 0;
+		size_t m_Grain = 1;
+		/// <summary>beginning of the next chunk nobody took yet.</summary>
+		std::atomic<size_t> m_Next{ 0 };
+		/// <summary>incremented with every loop, so a worker knows it has not seen it yet.</summary>
+		size_t m_Generation = 0;
+		/// <summary>workers still running chunks of the current loop.</summary>
+		int m_Busy = 0;
+		bool m_Stop = false;
+
+		void workerLoop();
+		void runChunks();
+
+	public:
+		/// <param name="threadCount">amount of threads working on a loop including the calling one. 0 uses std::thread::hardware_concurrency().</param>
+		explicit ThreadPool(int threadCount = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/// <returns>amount of threads working on a loop including the calling one.</returns>
+		int getThreadCount() const;
+
+		/// <summary>
+		/// Calls body(begin, end) for the chunks [0, grain), [grain, 2 * grain) ... covering [0, count) and returns once all of them finished.
+		/// Called from inside a body, the chunks run on the calling thread alone.
+		/// </summary>
+		void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+		/// <returns>pool shared by the application, using all hardware threads.</returns>
+		static ThreadPool& shared();
+	};
+}
@@ -0,0 +1,99 @@
+/// <title>Profiler</title>
+/// <desc>
+///		Low overhead scoped timers which keep a ring buffer of recent samples for each named phase of the frame.
+///		Intended for the main thread. The Viewer displays the rolling statistics and headless code can query them directly.
+///		While a Trace capture runs, every scope also records its begin and end event.
+///		Define PROFILER_ENABLED as 0 to compile all profiling scopes out of the application.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include <algorithm>
+#include <cstring>
+
+#include "Profiler.h"
+
+namespace {
+	/// <summary>Ring buffer of a single phase.</summary>
+	struct PhaseRecord {
+		const char* name;
+		float samples[PROFILER_SAMPLE_COUNT];
+		/// <summary>position the next sample is written to.</summary>
+		int next;
+		long long totalCount;
+	};
+
+	PhaseRecord s_Phases[PROFILER_MAX_PHASES];
+	int s_PhaseCount = 0;
+	/// <summary>scratch space for the percentile, so computing statistics does not allocate.</summary>
+	float s_Sorted[PROFILER_SAMPLE_COUNT];
+
+	void computeStats(const PhaseRecord& phase, Profiler::PhaseStats& stats) {
+		int count = static_cast<int>(std::min<long long>(phase.totalCount, PROFILER_SAMPLE_COUNT));
+		stats = Profiler::PhaseStats();
+		stats.name = phase.name;
+		stats.sampleCount = count;
+		stats.totalCount = phase.totalCount;
+		if (count == 0)
+			return;
+		std::copy(phase.samples, phase.samples + count, s_Sorted);
+		std::sort(s_Sorted, s_Sorted + count);
+		double sum = 0;
+		for (int i = 0; i < count; i++)
+			sum += s_Sorted[i];
+		stats.last = phase.samples[(phase.next + PROFILER_SAMPLE_COUNT - 1) % PROFILER_SAMPLE_COUNT];
+		stats.min = s_Sorted[0];
+		stats.max = s_Sorted[count - 1];
+		stats.avg = sum / count;
+		stats.p99 = s_Sorted[std::min(count - 1, (count * 99) / 100)];
+	}
+}
+
+int Profiler::registerPhase(const char* name) {
+	for (int i = 0; i < s_PhaseCount; i++) {
+		if (std::strcmp(s_Phases[i].name, name) == 0)
+			return i;
+	}
+	if (s_PhaseCount >= PROFILER_MAX_PHASES)
+		return -1;
+	s_Phases[s_PhaseCount] = { name, {}, 0, 0 };
+	return s_PhaseCount++;
+}
+
+void Profiler::record(int phase, double milliseconds) {
+	if (phase < 0)
+		return;
+	PhaseRecord& record = s_Phases[phase];
+	record.samples[record.next] = static_cast<float>(milliseconds);
+	record.next = (record.next + 1) % PROFILER_SAMPLE_COUNT;
+	record.totalCount++;
+}
+
+void Profiler::getStats(std::vector<PhaseStats>& stats) {
+	stats.clear();
+	for (int i = 0; i < s_PhaseCount; i++) {
+		if (s_Phases[i].totalCount == 0)
+			continue;
+		stats.emplace_back();
+		computeStats(s_Phases[i], stats.back());
+	}
+}
+
+bool Profiler::getStats(const char* name, PhaseStats& stats) {
+	for (int i = 0; i < s_PhaseCount; i++) {
+		if (std::strcmp(s_Phases[i].name, name) == 0) {
+			computeStats(s_Phases[i], stats);
+			return true;
+		}
+	}
+	return false;
+}
+
+void Profiler::reset() {
+	for (int i = 0; i < s_PhaseCount; i++) {
+		s_Phases[i].next = 0;
+		s_Phases[i].totalCount = 0;
+	}
+}
@@ -0,0 +1,108 @@
+/// <title>Profiler</title>
+/// <desc>
+///		Low overhead scoped timers which keep a ring buffer of recent samples for each named phase of the frame.
+///		Intended for the main thread. The Viewer displays the rolling statistics and headless code can query them directly.
+///		While a Trace capture runs, every scope also records its begin and end event.
+///		Define PROFILER_ENABLED as 0 to compile all profiling scopes out of the application.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+/// <summary>maximum amount of distinct phases. Further phases are ignored.</summary>
+#define PROFILER_MAX_PHASES 64
+/// <summary>amount of most recent samples kept per phase.</summary>
+#define PROFILER_SAMPLE_COUNT 240
+
+#include <chrono>
+#include <vector>
+
+#include "Trace.h"
+
+#if PROFILER_ENABLED
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+/// <summary>
+/// Times the rest of the enclosing scope as the phase with the provided name. The phase is registered once per call site.
+/// </summary>
+#define PROFILE_SCOPE(name) \
+	static const int PROFILER_CONCAT(profilerPhase, __LINE__) = Profiler::registerPhase(name); \
+	Profiler::ScopedTimer PROFILER_CONCAT(profilerTimer, __LINE__)(PROFILER_CONCAT(profilerPhase, __LINE__), name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+namespace Profiler {
+
+	/// <summary>
+	/// Rolling statistics of a single phase over its most recent samples. All times are in milliseconds.
+	/// </summary>
+	struct PhaseStats {
+		const char* name = "";
+		/// <summary>amount of samples the statistics are computed from. (at most PROFILER_SAMPLE_COUNT)</summary>
+		int sampleCount = 0;
+		/// <summary>total amount of samples recorded since the last reset.</summary>
+		long long totalCount = 0;
+		double last = 0;
+		double min = 0;
+		double avg = 0;
+		double p99 = 0;
+		double max = 0;
+	};
+
+	/// <summary>
+	/// Finds or creates the phase with the provided name. The name has to outlive the profiler (use string literals).
+	/// </summary>
+	/// <returns>phase handle for record(), or -1 if PROFILER_MAX_PHASES was exceeded.</returns>
+	int registerPhase(const char* name);
+
+	/// <summary>
+	/// Stores a sample into the ring buffer of the phase.
+	/// </summary>
+	void record(int phase, double milliseconds);
+
+	/// <summary>
+	/// Computes the statistics of all phases which have samples, in order of registration.
+	/// </summary>
+	/// <param name="stats">output, reused between calls to avoid allocations.</param>
+	void getStats(std::vector<PhaseStats>& stats);
+
+	/// <summary>
+	/// Computes the statistics of the phase with the provided name.
+	/// </summary>
+	/// <returns>false if no such phase was registered.</returns>
+	bool getStats(const char* name, PhaseStats& stats);
+
+	/// <summary>
+	/// Discards all samples. Phases stay registered.
+	/// </summary>
+	void reset();
+
+	/// <summary>
+	/// Records the time between its construction and destruction, as well as the trace events if a capture runs. Use through PROFILE_SCOPE.
+	/// </summary>
+	class ScopedTimer {
+	private:
+		int m_Phase;
+		const char* m_Name;
+		std::chrono::high_resolution_clock::time_point m_Begin;
+	public:
+		ScopedTimer(int phase, const char* name) : m_Phase(phase), m_Name(name) {
+			Trace::begin(m_Name);
+			m_Begin = std::chrono::high_resolution_clock::now();
+		}
+		~ScopedTimer() {
+			record(m_Phase, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_Begin).count());
+			Trace::end(m_Name);
+		}
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+}
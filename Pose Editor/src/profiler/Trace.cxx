@@ -0,0 +1,159 @@
+/// <title>Trace</title>
+/// <desc>
+///		Records begin/end events of the PROFILE_SCOPE phases into bounded per-thread buffers and writes them
+///		as a Chrome trace-event JSON file, which opens in Perfetto or about:tracing.
+///		Recording does not lock. Each thread writes only into its own buffer, a lock is taken once when a thread records its first event.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Trace.h"
+
+namespace {
+	struct Event {
+		const char* name;
+		/// <summary>nanoseconds since the capture started.</summary>
+		long long timestamp;
+		/// <summary>'B' or 'E' as in the trace-event format.</summary>
+		char phase;
+	};
+
+	/// <summary>Events of a single thread. Only that thread writes into it, count is published with release ordering.</summary>
+	struct ThreadBuffer {
+		int threadId;
+		std::unique_ptr<Event[]> events;
+		std::atomic<int> count;
+		std::atomic<long long> dropped;
+	};
+
+	/// <summary>set with release ordering after s_CaptureStart, so a thread seeing it set also sees the start of its capture.</summary>
+	std::atomic<bool> s_Capturing(false);
+	/// <summary>steady_clock time in nanoseconds when the capture started.</summary>
+	std::atomic<long long> s_CaptureStart(0);
+	std::string s_OutputPath = TRACE_DEFAULT_PATH;
+	/// <summary>all buffers ever created. Guarded by s_BuffersLock, buffers are never destroyed.</summary>
+	std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+	std::mutex s_BuffersLock;
+	thread_local ThreadBuffer* t_Buffer = nullptr;
+
+	long long nanoseconds() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	ThreadBuffer* threadBuffer() {
+		if (!t_Buffer) {
+			std::lock_guard<std::mutex> guard(s_BuffersLock);
+			auto buffer = std::make_unique<ThreadBuffer>();
+			buffer->threadId = static_cast<int>(s_Buffers.size()) + 1;
+			buffer->events.reset(new Event[TRACE_EVENTS_PER_THREAD]);
+			buffer->count.store(0);
+			buffer->dropped.store(0);
+			t_Buffer = buffer.get();
+			s_Buffers.push_back(std::move(buffer));
+		}
+		return t_Buffer;
+	}
+
+	void push(const char* name, char phase) {
+		if (!s_Capturing.load(std::memory_order_acquire))
+			return;
+		long long timestamp = nanoseconds() - s_CaptureStart.load(std::memory_order_relaxed);
+		ThreadBuffer* buffer = threadBuffer();
+		int count = buffer->count.load(std::memory_order_relaxed);
+		if (count >= TRACE_EVENTS_PER_THREAD) {
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		buffer->events[count] = { name, timestamp, phase };
+		buffer->count.store(count + 1, std::memory_order_release);
+	}
+
+	void writeEscaped(std::ofstream& file, const char* text) {
+		for (; *text; text++) {
+			if (*text == '"' || *text == '\\')
+				file << '\\';
+			file << *text;
+		}
+	}
+}
+
+void Trace::start() {
+	{
+		std::lock_guard<std::mutex> guard(s_BuffersLock);
+		for (auto& buffer : s_Buffers) {
+			buffer->count.store(0);
+			buffer->dropped.store(0);
+		}
+	}
+	s_CaptureStart.store(nanoseconds(), std::memory_order_relaxed);
+	s_Capturing.store(true, std::memory_order_release);
+}
+
+void Trace::stop() {
+	s_Capturing.store(false);
+}
+
+bool Trace::isCapturing() {
+	return s_Capturing.load(std::memory_order_relaxed);
+}
+
+bool Trace::flush(const std::string& path) {
+	std::ofstream file(path.c_str(), std::ios::out);
+	if (!file.is_open()) {
+		std::fprintf(stderr, "Trouble writing trace to '%s': Could not open file.", path.c_str());
+		return false;
+	}
+	char timestamp[32];
+	bool first = true;
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	std::lock_guard<std::mutex> guard(s_BuffersLock);
+	for (auto& buffer : s_Buffers) {
+		int count = buffer->count.load(std::memory_order_acquire);
+		for (int i = 0; i < count; i++) {
+			const Event& event = buffer->events[i];
+			// trace-event timestamps are in microseconds
+			std::snprintf(timestamp, sizeof(timestamp), "%.3f", event.timestamp / 1000.0);
+			file << (first ? "\n" : ",\n") << "{\"name\":\"";
+			writeEscaped(file, event.name);
+			file << "\",\"cat\":\"editor\",\"ph\":\"" << event.phase << "\",\"ts\":" << timestamp
+				<< ",\"pid\":1,\"tid\":" << buffer->threadId << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+	file.close();
+	return true;
+}
+
+void Trace::setOutputPath(const std::string& path) {
+	s_OutputPath = path;
+}
+
+const std::string& Trace::getOutputPath() {
+	return s_OutputPath;
+}
+
+long long Trace::getDroppedCount() {
+	std::lock_guard<std::mutex> guard(s_BuffersLock);
+	long long dropped = 0;
+	for (auto& buffer : s_Buffers)
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	return dropped;
+}
+
+void Trace::begin(const char* name) {
+	push(name, 'B');
+}
+
+void Trace::end(const char* name) {
+	push(name, 'E');
+}
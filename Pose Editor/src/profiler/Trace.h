@@ -0,0 +1,62 @@
+/// <title>Trace</title>
+/// <desc>
+///		Records begin/end events of the PROFILE_SCOPE phases into bounded per-thread buffers and writes them
+///		as a Chrome trace-event JSON file, which opens in Perfetto or about:tracing.
+///		Recording does not lock. Each thread writes only into its own buffer, a lock is taken once when a thread records its first event.
+/// </desc>
+/// <date>10/18/2026</date>
+/// <version>1.0</version>
+/// <author>David Hrusa</author>
+/// <email>hrusadav@gmail.com</email>
+
+#pragma once
+
+/// <summary>maximum amount of events kept per thread during a single capture. Later events are dropped.</summary>
+#define TRACE_EVENTS_PER_THREAD (1 << 18)
+/// <summary>output file used when no other path is configured.</summary>
+#define TRACE_DEFAULT_PATH "pose_editor_trace.json"
+
+#include <atomic>
+#include <string>
+
+namespace Trace {
+
+	/// <summary>
+	/// Discards previously recorded events and starts recording.
+	/// </summary>
+	void start();
+
+	/// <summary>
+	/// Stops recording. The recorded events are kept until the next start().
+	/// </summary>
+	void stop();
+
+	/// <returns>true if events are currently being recorded.</returns>
+	bool isCapturing();
+
+	/// <summary>
+	/// Writes the events recorded during the last capture into a Chrome trace-event JSON file.
+	/// Should be called after stop() so no thread writes into the buffers meanwhile.
+	/// </summary>
+	/// <returns>true if the file was written.</returns>
+	bool flush(const std::string& path);
+
+	/// <summary>
+	/// Sets the file the editor writes the trace to when a capture is stopped.
+	/// </summary>
+	void setOutputPath(const std::string& path);
+	/// <returns>the file the editor writes the trace to when a capture is stopped.</returns>
+	const std::string& getOutputPath();
+
+	/// <returns>amount of events dropped during the last capture because a thread's buffer was full.</returns>
+	long long getDroppedCount();
+
+	/// <summary>
+	/// Records the beginning of a named scope on the calling thread. The name has to outlive the trace (use string literals).
+	/// </summary>
+	void begin(const char* name);
+	/// <summary>
+	/// Records the end of a named scope on the calling thread.
+	/// </summary>
+	void end(const char* name);
+}
@@ -43,11 +43,27 @@ bool ViewerGUI::ViewerGLFW::init() {
 	/* configure file browser */
 	m_FileOpenDialog = ImGui::FileBrowser();
 	m_FileOpenDialog.SetTitle("open file");
-	m_FileOpenDialog.SetTypeFilters({ ".csv" });
+	m_FileOpenDialog.SetTypeFilters({ ".csv", ".posq" });
 
 	m_FileSaveDialog = ImGui::FileBrowser(ImGuiFileBrowserFlags_EnterNewFilename | ImGuiFileBrowserFlags_CreateNewDir);
 	m_FileSaveDialog.SetTitle("save file");
-	m_FileSaveDialog.SetTypeFilters({ ".csv" });
+	m_FileSaveDialog.SetTypeFilters({ ".csv", ".posq" });
+
+	m_ClipOpenDialog = ImGui::FileBrowser();
+	m_ClipOpenDialog.SetTitle("open clip");
+	m_ClipOpenDialog.SetTypeFilters({ ".clip", ".clipb" });
+
+	m_ClipSaveDialog = ImGui::FileBrowser(ImGuiFileBrowserFlags_EnterNewFilename | ImGuiFileBrowserFlags_CreateNewDir);
+	m_ClipSaveDialog.SetTitle("save clip");
+	m_ClipSaveDialog.SetTypeFilters({ ".clip", ".clipb" });
+
+	m_LibraryOpenDialog = ImGui::FileBrowser();
+	m_LibraryOpenDialog.SetTitle("open library");
+	m_LibraryOpenDialog.SetTypeFilters({ ".plib" });
+
+	m_LibrarySaveDialog = ImGui::FileBrowser(ImGuiFileBrowserFlags_EnterNewFilename | ImGuiFileBrowserFlags_CreateNewDir);
+	m_LibrarySaveDialog.SetTitle("save library");
+	m_LibrarySaveDialog.SetTypeFilters({ ".plib" });
 
 	/* load fonts */
 	//m_Font = io.Fonts->AddFontFromFileTTF("data/arial.ttf", 10.0f);
@@ -62,6 +78,7 @@ bool ViewerGUI::ViewerGLFW::init() {
 }
 
 void ViewerGUI::ViewerGLFW::renderUI() {
+	PROFILE_SCOPE("ViewerGLFW::renderUI");
 	/* top bar menu */
 	if (ImGui::BeginMainMenuBar()) {
 		if (ImGui::BeginMenu("File")) {
@@ -80,14 +97,109 @@ void ViewerGUI::ViewerGLFW::renderUI() {
 				m_FileSaveDialog.Open();
 				m_FileSaveDialog.SetInputText(m_InternalPawn.originalFileName);
 			}
+			ImGui::Separator();
+			if (ImGui::MenuItem("New Clip From Pose")) {
+				m_Controller->cmdNewClip(m_ClipState.frameRate);
+			}
+			if (ImGui::MenuItem("Open Clip")) {
+				m_ClipOpenDialog.SetPwd(m_ClipOpenDialog.GetPwd()); //refresh folder
+				m_ClipOpenDialog.Open();
+			}
+			if (ImGui::MenuItem("Save Clip", "", false, m_ClipState.loaded && !m_ClipState.filePath.empty())) {
+				m_Controller->cmdSaveClip(m_ClipState.filePath);
+			}
+			if (ImGui::MenuItem("Save Clip As", "", false, m_ClipState.loaded)) {
+				m_ClipSaveDialog.SetPwd(m_ClipSaveDialog.GetPwd()); //refresh folder
+				m_ClipSaveDialog.Open();
+				m_ClipSaveDialog.SetInputText(m_ClipState.fileName);
+			}
+			ImGui::Separator();
+			if (ImGui::MenuItem("New Library")) {
+				m_Controller->cmdNewLibrary();
+			}
+			if (ImGui::MenuItem("Open Library")) {
+				m_LibraryOpenDialog.SetPwd(m_LibraryOpenDialog.GetPwd()); //refresh folder
+				m_LibraryOpenDialog.Open();
+			}
+			if (ImGui::MenuItem("Save Library", "", false, m_LibraryState.loaded && !m_LibraryState.filePath.empty())) {
+				m_Controller->cmdSaveLibrary(m_LibraryState.filePath);
+			}
+			if (ImGui::MenuItem("Save Library As", "", false, m_LibraryState.loaded)) {
+				m_LibrarySaveDialog.SetPwd(m_LibrarySaveDialog.GetPwd()); //refresh folder
+				m_LibrarySaveDialog.Open();
+				m_LibrarySaveDialog.SetInputText(m_LibraryState.fileName);
+			}
+			ImGui::EndMenu();
+		}
+		if (ImGui::BeginMenu("Edit")) {
+			if (ImGui::MenuItem("Undo", "Ctrl+Z")) {
+				m_Controller->cmdUndo();
+			}
+			if (ImGui::MenuItem("Redo", "Ctrl+Y")) {
+				m_Controller->cmdRedo();
+			}
+			if (ImGui::MenuItem("Clamp to Limits")) {
+				m_Controller->cmdClampToLimits();
+			}
+			if (ImGui::BeginMenu("Mirror Pose")) {
+				if (ImGui::MenuItem("Across YZ (left / right)")) {
+					m_Controller->cmdMirror(PoseData::MirrorPlane::YZ, {});
+				}
+				if (ImGui::MenuItem("Across XZ")) {
+					m_Controller->cmdMirror(PoseData::MirrorPlane::XZ, {});
+				}
+				if (ImGui::MenuItem("Across XY")) {
+					m_Controller->cmdMirror(PoseData::MirrorPlane::XY, {});
+				}
+				ImGui::EndMenu();
+			}
+			ImGui::EndMenu();
+		}
+		if (ImGui::BeginMenu("View")) {
+			if (ImGui::BeginMenu("Rotation Order")) {
+				const PoseData::RotationOrder orders[] = { PoseData::RotationOrder::XYZ, PoseData::RotationOrder::XZY, PoseData::RotationOrder::YXZ,
+					PoseData::RotationOrder::YZX, PoseData::RotationOrder::ZXY, PoseData::RotationOrder::ZYX };
+				for (PoseData::RotationOrder order : orders) {
+					if (ImGui::MenuItem(EulerOrder::orderName(order), "", m_InternalPawn.rotationOrder == order)) {
+						m_Controller->cmdSetRotationOrder(order);
+					}
+				}
+				ImGui::EndMenu();
+			}
+#if PROFILER_ENABLED
+			ImGui::MenuItem("Profiler", "", &m_ShowProfiler);
+			if (ImGui::MenuItem("Trace Capture", "", Trace::isCapturing())) {
+				if (Trace::isCapturing()) {
+					Trace::stop();
+					if (Trace::flush(Trace::getOutputPath()))
+						std::cout << "Trace written: " << Trace::getOutputPath() << "\n";
+				}
+				else {
+					Trace::start();
+				}
+			}
+#endif
 			ImGui::EndMenu();
 		}
 		ImGui::EndMainMenuBar();
 	}
 
+	/* shortcuts (text fields keep their own undo) */
+	ImGuiIO& io = ImGui::GetIO();
+	if (io.KeyCtrl && !io.WantTextInput) {
+		if (ImGui::IsKeyPressed(GLFW_KEY_Z))
+			m_Controller->cmdUndo();
+		if (ImGui::IsKeyPressed(GLFW_KEY_Y))
+			m_Controller->cmdRedo();
+	}
+
 	/* file browsing dialogs */
 	m_FileOpenDialog.Display();
 	m_FileSaveDialog.Display();
+	m_ClipOpenDialog.Display();
+	m_ClipSaveDialog.Display();
+	m_LibraryOpenDialog.Display();
+	m_LibrarySaveDialog.Display();
 
 	if (m_FileOpenDialog.HasSelected())
 	{
@@ -101,6 +213,31 @@ void ViewerGUI::ViewerGLFW::renderUI() {
 		m_FileSaveDialog.ClearSelected();
 		m_Controller->cmdSaveFile(savePath);
 	}
+	if (m_ClipOpenDialog.HasSelected())
+	{
+		std::string openPath = m_ClipOpenDialog.GetSelected().string();
+		m_ClipOpenDialog.ClearSelected();
+		m_ClipPlaying = false;
+		m_Controller->cmdOpenClip(openPath);
+	}
+	if (m_ClipSaveDialog.HasSelected())
+	{
+		std::string savePath = m_ClipSaveDialog.GetSelected().string();
+		m_ClipSaveDialog.ClearSelected();
+		m_Controller->cmdSaveClip(savePath);
+	}
+	if (m_LibraryOpenDialog.HasSelected())
+	{
+		std::string openPath = m_LibraryOpenDialog.GetSelected().string();
+		m_LibraryOpenDialog.ClearSelected();
+		m_Controller->cmdOpenLibrary(openPath);
+	}
+	if (m_LibrarySaveDialog.HasSelected())
+	{
+		std::string savePath = m_LibrarySaveDialog.GetSelected().string();
+		m_LibrarySaveDialog.ClearSelected();
+		m_Controller->cmdSaveLibrary(savePath);
+	}
 
 	/* pop up messages */
 	if (m_PopupCloseNoSave) {
@@ -148,19 +285,18 @@ void ViewerGUI::ViewerGLFW::renderUI() {
 		ImGui::BeginChild("node block", ImVec2(-1, (-FOOTER_HEIGHT - 5 + ImGui::GetContentRegionAvail().y))); {
 			if (m_ShowHierarchy) {
 				/* traverse from root elements with indentation */
-				auto roots = PoseDataUtil::pawnGetBoneChildren(m_InternalPawn, -1);
-				for (auto rootidx : roots)
+				for (auto rootidx : m_RootRows)
 				{
 					auto& bone = m_InternalPawn.bones[rootidx];
 					renderBoneUI(rootidx, bone);
 					m_IndentCount = 0;
-					recursiveHierarchyRenderUI(bone.id);
+					recursiveHierarchyRenderUI(rootidx);
 				}
 			}
 			else {
 				/* traverse regularly */
 				int boneidx = 0;
-				for (PoseData::BoneData bone : m_InternalPawn.bones) {
+				for (PoseData::BoneData& bone : m_InternalPawn.bones) {
 					renderBoneUI(boneidx, bone);
 					boneidx++;
 				}
@@ -178,13 +314,195 @@ void ViewerGUI::ViewerGLFW::renderUI() {
 
 	}
 	ImGui::End();
+
+	if (m_ClipState.loaded)
+		renderTimelineUI();
+
+	if (m_LibraryState.loaded)
+		renderLibraryUI();
+
+	if (m_ShowProfiler)
+		renderProfilerUI();
+
+	/* slider drags are coalesced into a single command per frame */
+	flushPendingEdit();
+}
+
+void ViewerGUI::ViewerGLFW::renderTimelineUI() {
+	/* playback advances by the frame time and wraps around, a clip of a single frame has nothing to play */
+	if (m_ClipPlaying && m_ClipState.duration > 0.0f) {
+		float time = m_ClipState.time + ImGui::GetIO().DeltaTime;
+		m_Controller->cmdSetClipTime(time > m_ClipState.duration ? std::fmod(time, m_ClipState.duration) : time);
+	}
+	ImGui::SetNextWindowSize(ImVec2(560, 135), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Timeline")) {
+		ImGui::Text("%s%s", m_ClipState.fileName.c_str(), m_ClipState.saved ? "" : "*");
+		ImGui::SameLine();
+		ImGui::TextDisabled("%d tracks, %d keys, %.4g fps", m_ClipState.trackCount, m_ClipState.keyCount, m_ClipState.frameRate);
+		if (ImGui::Button(m_ClipPlaying ? "pause" : "play", ImVec2(50, 0)))
+			m_ClipPlaying = !m_ClipPlaying;
+		ImGui::SameLine();
+		/* the slider steps by whole frames */
+		int frames = static_cast<int>(std::round(m_ClipState.duration * m_ClipState.frameRate));
+		int frame = static_cast<int>(std::round(m_ClipState.time * m_ClipState.frameRate));
+		ImGui::SetNextItemWidth(-90);
+		if (ImGui::SliderInt("##frame", &frame, 0, frames, "frame %d")) {
+			m_ClipPlaying = false;
+			m_Controller->cmdSetClipTime(frame / m_ClipState.frameRate);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("key pose"))
+			m_Controller->cmdClipKeyPose(frame / m_ClipState.frameRate);
+		ImGui::Text("%.3f / %.3f s", m_ClipState.time, m_ClipState.duration);
+		ImGui::SameLine();
+		/* applies to every track, tracks set apart in the file show as mixed */
+		ImGui::SetNextItemWidth(100);
+		if (ImGui::BeginCombo("interpolation", m_ClipState.mixedInterpolation ? "mixed" : PoseClip::interpolationName(m_ClipState.interpolation))) {
+			for (PoseData::Interpolation interpolation : { PoseData::Interpolation::Step, PoseData::Interpolation::Nlerp, PoseData::Interpolation::Slerp }) {
+				if (ImGui::Selectable(PoseClip::interpolationName(interpolation), !m_ClipState.mixedInterpolation && interpolation == m_ClipState.interpolation))
+					m_Controller->cmdSetClipInterpolation(interpolation, {});
+			}
+			ImGui::EndCombo();
+		}
+		/* key reduction, tolerance in degrees */
+		ImGui::SetNextItemWidth(80);
+		ImGui::DragFloat("##tolerance", &m_ReduceTolerance, 0.05f, 0.0f, 30.0f, "%.2f deg");
+		ImGui::SameLine();
+		ImGui::Checkbox("global", &m_ReduceGlobal);
+		ImGui::SameLine();
+		if (ImGui::Button("reduce keys"))
+			m_ReduceReport = m_Controller->cmdReduceClip(m_ReduceTolerance, m_ReduceGlobal, {}, {});
+		if (m_ReduceReport.keysAfter > 0) {
+			ImGui::SameLine();
+			ImGui::TextDisabled("%d -> %d keys, max error %.3g deg", m_ReduceReport.keysBefore, m_ReduceReport.keysAfter,
+				m_ReduceReport.maxGlobalError >= 0.0f ? m_ReduceReport.maxGlobalError : m_ReduceReport.maxError);
+		}
+	}
+	ImGui::End();
+}
+
+void ViewerGUI::ViewerGLFW::renderLibraryUI() {
+	ImGui::SetNextWindowSize(ImVec2(560, 265), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Library")) {
+		ImGui::Text("%s%s", m_LibraryState.fileName.c_str(), m_LibraryState.saved ? "" : "*");
+		ImGui::SameLine();
+		ImGui::TextDisabled("%d poses, %d bones", m_LibraryState.poseCount, m_LibraryState.boneCount);
+		/* browsing reads a single pose, so the slider stays responsive for any size of library */
+		int pose = std::max(m_LibraryState.pose, 0);
+		if (ImGui::Button("<", ImVec2(25, 0)))
+			m_Controller->cmdShowLibraryPose(pose - 1);
+		ImGui::SameLine();
+		if (ImGui::Button(">", ImVec2(25, 0)))
+			m_Controller->cmdShowLibraryPose(pose + 1);
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(-90);
+		if (ImGui::SliderInt("##pose", &pose, 0, std::max(m_LibraryState.poseCount - 1, 0), "pose %d", ImGuiSliderFlags_AlwaysClamp) && m_LibraryState.poseCount > 0)
+			m_Controller->cmdShowLibraryPose(pose);
+		ImGui::SameLine();
+		if (ImGui::Button("add pose"))
+			m_Controller->cmdLibraryAddPose();
+		if (m_LibraryState.pose >= 0)
+			ImGui::TextDisabled("%s", m_LibraryState.poseName.c_str());
+		/* similarity search for the current pose, the found poses are shown by clicking them */
+		ImGui::SetNextItemWidth(90);
+		ImGui::DragInt("##count", &m_SearchCount, 0.2f, 1, 1000, "%d closest", ImGuiSliderFlags_AlwaysClamp);
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(110);
+		ImGui::DragFloat("##radius", &m_SearchRadius, 0.05f, 0.0f, 180.0f, m_SearchRadius > 0.0f ? "within %.2f deg" : "any distance", ImGuiSliderFlags_AlwaysClamp);
+		ImGui::SameLine();
+		ImGui::Checkbox("global", &m_SearchGlobal);
+		ImGui::SameLine();
+		if (ImGui::Button("find similar") && m_LibraryState.poseCount > 0)
+			m_Controller->cmdFindSimilarPoses(m_SearchCount, m_SearchRadius > 0.0f ? m_SearchRadius : -1.0f, m_SearchGlobal, {});
+		/* replaces the poses by representatives of clusters of similar poses, the mapping of the poses is written next to the library */
+		ImGui::SetNextItemWidth(90);
+		ImGui::DragInt("##clusters", &m_ClusterCount, 0.5f, 1, 1000000, "%d clusters", ImGuiSliderFlags_AlwaysClamp);
+		ImGui::SameLine();
+		if (ImGui::Button("cluster")) {
+			m_ClusterMapping = PoseCluster::mappingPath(m_LibraryState.filePath);
+			m_ClusterReport = m_Controller->cmdClusterLibrary(m_ClusterCount, 0.0f, m_SearchGlobal, {}, m_ClusterMapping);
+		}
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(110);
+		ImGui::DragFloat("##threshold", &m_DedupThreshold, 0.05f, 0.0f, 180.0f, "within %.2f deg", ImGuiSliderFlags_AlwaysClamp);
+		ImGui::SameLine();
+		if (ImGui::Button("deduplicate")) {
+			m_ClusterMapping = PoseCluster::mappingPath(m_LibraryState.filePath);
+			m_ClusterReport = m_Controller->cmdClusterLibrary(0, m_DedupThreshold, m_SearchGlobal, {}, m_ClusterMapping);
+		}
+		if (m_LibraryState.restorable) {
+			ImGui::SameLine();
+			if (ImGui::Button("restore") && m_Controller->cmdRestoreLibrary())
+				m_ClusterReport = PoseData::ClusterReport();
+		}
+		if (m_ClusterReport.posesAfter > 0) {
+			ImGui::TextDisabled("%d -> %d poses, max %.3g deg", m_ClusterReport.posesBefore, m_ClusterReport.posesAfter, m_ClusterReport.maxDistance);
+			if (!m_ClusterMapping.empty()) {
+				ImGui::SameLine();
+				ImGui::TextDisabled("mapping: %s", PoseDataUtil::parseFilename(m_ClusterMapping).c_str());
+			}
+		}
+		if (!m_LibraryState.matches.empty()) {
+			ImGui::BeginChild("matches", ImVec2(0, 0), true);
+			for (const PoseData::PoseMatch& match : m_LibraryState.matches) {
+				ImGui::PushID(match.pose);
+				if (ImGui::Selectable(match.name.c_str(), match.pose == m_LibraryState.pose))
+					m_Controller->cmdShowLibraryPose(match.pose);
+				ImGui::SameLine(ImGui::GetWindowWidth() - 150);
+				ImGui::TextDisabled("pose %d, %.2f deg", match.pose, match.distance);
+				ImGui::PopID();
+			}
+			ImGui::EndChild();
+		}
+	}
+	ImGui::End();
+}
+
+void ViewerGUI::ViewerGLFW::renderProfilerUI() {
+	ImGui::SetNextWindowSize(ImVec2(560, 300), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Profiler", &m_ShowProfiler)) {
+		if (ImGui::Button("Reset")) {
+			Profiler::reset();
+		}
+		ImGui::SameLine();
+		ImGui::Text("last %d samples per phase, times in ms", PROFILER_SAMPLE_COUNT);
+
+		Profiler::getStats(m_ProfilerStats);
+		if (ImGui::BeginTable("phases", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp)) {
+			ImGui::TableSetupColumn("phase", ImGuiTableColumnFlags_WidthStretch, 3.f);
+			ImGui::TableSetupColumn("last");
+			ImGui::TableSetupColumn("min");
+			ImGui::TableSetupColumn("avg");
+			ImGui::TableSetupColumn("p99");
+			ImGui::TableSetupColumn("count");
+			ImGui::TableHeadersRow();
+			for (const auto& phase : m_ProfilerStats) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(phase.name);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", phase.last);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", phase.min);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", phase.avg);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", phase.p99);
+				ImGui::TableNextColumn();
+				ImGui::Text("%lld", phase.totalCount);
+			}
+			ImGui::EndTable();
+		}
+	}
+	ImGui::End();
 }
 
 void ViewerGUI::ViewerGLFW::renderBoneUI(int boneidx, PoseData::BoneData& bone, int indent) {
 	ImGui::PushID(boneidx);
 	float indentDistance = static_cast<float>(indent) * INDENT_SIZE;
 	float maxw = ImGui::GetContentRegionAvail().x;
-	ImGui::TextColored(ImVec4(0.71f, 0.30f, 0.62f, 1.f), ("[" + std::to_string(bone.id) + "] " + bone.displayName).c_str());
+	const BoneRowCache& row = m_RowCache[boneidx];
+	ImGui::TextColored(ImVec4(0.71f, 0.30f, 0.62f, 1.f), "%s", row.label.c_str());
 
 	/* controls */
 	if (!m_ShowHierarchy) {
@@ -237,17 +555,14 @@ void ViewerGUI::ViewerGLFW::renderBoneUI(int boneidx, PoseData::BoneData& bone,
 		ImGui::Text("parent");
 		ImGui::SameLine();
 		ImGui::SetCursorPosX(indentDistance + 50);
-		std::string selectedName = "[Root]";
-		int pcoord = PoseDataUtil::pawnFindBoneId(m_InternalPawn, bone.parent);
-		if (pcoord >= 0) {
-			selectedName = m_InternalPawn.bones[pcoord].displayName;
-		}
-		if (ImGui::BeginCombo("combo", selectedName.c_str())) {
+		int pcoord = row.parentCoord;
+		const char* selectedName = pcoord >= 0 ? m_InternalPawn.bones[pcoord].displayName.c_str() : "[Root]";
+		if (ImGui::BeginCombo("combo", selectedName)) {
 			if (ImGui::Selectable("[Root]", pcoord < 0)) {
 				m_Controller->cmdBoneSetParent(bone.id, -1);
 			}
 			int pidx = 0;
-			for (PoseData::BoneData pbone : m_InternalPawn.bones) {
+			for (const PoseData::BoneData& pbone : m_InternalPawn.bones) {
 				if (ImGui::Selectable(pbone.displayName.c_str(), pidx++ == pcoord)) {
 					m_Controller->cmdBoneSetParent(bone.id, pbone.id);
 				}
@@ -255,52 +570,186 @@ void ViewerGUI::ViewerGLFW::renderBoneUI(int boneidx, PoseData::BoneData& bone,
 			ImGui::EndCombo();
 		}
 
-		/* angle */
+		/* angle, the middle axis of the rotation order only covers half a turn */
+		int middleAxis = EulerOrder::middleAxis(m_InternalPawn.rotationOrder);
 		ImGui::Text("angle");
 		ImGui::SameLine();
 		ImGui::SetCursorPosX(indentDistance + 50);
 		ImGui::PopItemWidth();
 		ImGui::PushItemWidth((maxw - 50) / 3 - 10);
 		ImGui::PushID("angx");
-		if (ImGui::SliderFloat("", &glm::value_ptr(bone.eulerRotation)[0], -179.f, 179.f)) {
-			m_Controller->cmdBoneSetRotation(bone.id, bone.eulerRotation);
-		}
+		trackRotationEdit(bone, ImGui::SliderFloat("", &glm::value_ptr(bone.eulerRotation)[0], middleAxis == 0 ? -89.f : -179.f, middleAxis == 0 ? 89.f : 179.f));
 		ImGui::PopID();
 		ImGui::SameLine();
 		ImGui::PushID("angy");
 		ImGui::SetCursorPosX(indentDistance + 50 + (maxw - 50) / 3);
-		if (ImGui::SliderFloat("", &glm::value_ptr(bone.eulerRotation)[1], -89.f, 89.f)) {
-			m_Controller->cmdBoneSetRotation(bone.id, bone.eulerRotation);
-		}
+		trackRotationEdit(bone, ImGui::SliderFloat("", &glm::value_ptr(bone.eulerRotation)[1], middleAxis == 1 ? -89.f : -179.f, middleAxis == 1 ? 89.f : 179.f));
 		ImGui::PopID();
 		ImGui::SameLine();
 		ImGui::PushID("angz");
 		ImGui::SetCursorPosX(indentDistance + 50 + 2 * (maxw - 50) / 3);
-		if (ImGui::SliderFloat("", &glm::value_ptr(bone.eulerRotation)[2], -179.f, 179.f)) {
-			m_Controller->cmdBoneSetRotation(bone.id, bone.eulerRotation);
+		trackRotationEdit(bone, ImGui::SliderFloat("", &glm::value_ptr(bone.eulerRotation)[2], middleAxis == 2 ? -89.f : -179.f, middleAxis == 2 ? 89.f : 179.f));
+		ImGui::PopID();
+		ImGui::PopItemWidth();
+
+		/* offset from the parent joint, sent once the field is left so typing does not record an undo step per character */
+		ImGui::Text("offset");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(indentDistance + 50);
+		ImGui::PushItemWidth(-1);
+		ImGui::PushID("offset");
+		ImGui::InputFloat3("", glm::value_ptr(bone.offset));
+		if (ImGui::IsItemDeactivatedAfterEdit()) {
+			m_Controller->cmdBoneSetOffset(bone.id, bone.offset);
 		}
 		ImGui::PopID();
+		ImGui::PopItemWidth();
 
+		/* swing cone, twist min and twist max in degrees, sent the same way as the offset */
+		ImGui::Text("limit");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(indentDistance + 50);
+		ImGui::PushItemWidth(-1);
+		ImGui::PushID("limit");
+		/* the members are edited through an array of their own, JointLimit is not guaranteed to be laid out as one */
+		float limit[3] = { bone.limit.swing, bone.limit.twistMin, bone.limit.twistMax };
+		if (ImGui::InputFloat3("", limit, "%.1f")) {
+			bone.limit.swing = limit[0];
+			bone.limit.twistMin = limit[1];
+			bone.limit.twistMax = limit[2];
+		}
+		if (ImGui::IsItemDeactivatedAfterEdit()) {
+			m_Controller->cmdBoneSetLimit(bone.id, bone.limit);
+		}
+		ImGui::PopID();
+		ImGui::PopItemWidth();
+
+		/* constraint: type, driver and factor, the bone follows its driver from then on */
+		ImGui::Text("driver");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(indentDistance + 50);
+		ImGui::PushItemWidth((maxw - 50) / 3 - 10);
+		ImGui::PushID("ctype");
+		PoseData::BoneConstraint constraint = bone.constraint;
+		if (ImGui::BeginCombo("", PoseConstraints::typeName(constraint.type))) {
+			for (PoseData::ConstraintType type : { PoseData::ConstraintType::Free, PoseData::ConstraintType::CopyRotation,
+				PoseData::ConstraintType::Twist, PoseData::ConstraintType::AimAt }) {
+				if (ImGui::Selectable(PoseConstraints::typeName(type), type == constraint.type)) {
+					constraint.type = type;
+					m_Controller->cmdBoneSetConstraint(bone.id, constraint);
+				}
+			}
+			ImGui::EndCombo();
+		}
+		ImGui::PopID();
+		ImGui::SameLine();
+		ImGui::PushID("cdriver");
+		ImGui::SetCursorPosX(indentDistance + 50 + (maxw - 50) / 3);
+		auto driver = m_CoordById.find(constraint.driver);
+		if (ImGui::BeginCombo("", driver != m_CoordById.end() ? m_InternalPawn.bones[driver->second].displayName.c_str() : "[None]")) {
+			for (const PoseData::BoneData& dbone : m_InternalPawn.bones) {
+				if (dbone.id != bone.id && ImGui::Selectable(dbone.displayName.c_str(), dbone.id == constraint.driver)) {
+					constraint.driver = dbone.id;
+					m_Controller->cmdBoneSetConstraint(bone.id, constraint);
+				}
+			}
+			ImGui::EndCombo();
+		}
+		ImGui::PopID();
+		ImGui::SameLine();
+		ImGui::PushID("cfactor");
+		ImGui::SetCursorPosX(indentDistance + 50 + 2 * (maxw - 50) / 3);
+		ImGui::InputFloat("", &bone.constraint.factor, 0.0f, 0.0f, "%.2f");
+		if (ImGui::IsItemDeactivatedAfterEdit()) {
+			m_Controller->cmdBoneSetConstraint(bone.id, bone.constraint);
+		}
+		ImGui::PopID();
 		ImGui::PopItemWidth();
 	}
 	ImGui::Separator();
 	ImGui::PopID();
 }
 
-void ViewerGUI::ViewerGLFW::recursiveHierarchyRenderUI(ID boneId) {
-	auto children = PoseDataUtil::pawnGetBoneChildren(m_InternalPawn, boneId);
+void ViewerGUI::ViewerGLFW::trackRotationEdit(const PoseData::BoneData& bone, bool changed) {
+	if (ImGui::IsItemActivated()) {
+		m_Controller->cmdBeginEdit();
+		m_EditBoneId = bone.id;
+	}
+	if (changed) {
+		/* the slider already wrote into m_InternalPawn, which serves as the preview */
+		m_PendingEdit = true;
+		m_PendingEditBoneId = bone.id;
+		m_PendingEditEuler = bone.eulerRotation;
+	}
+	if (ImGui::IsItemDeactivated()) {
+		flushPendingEdit();
+		m_Controller->cmdCommitEdit();
+		m_EditBoneId = -1;
+	}
+}
+
+void ViewerGUI::ViewerGLFW::flushPendingEdit() {
+	if (m_PendingEdit) {
+		m_PendingEdit = false;
+		m_Controller->cmdBoneSetRotation(m_PendingEditBoneId, m_PendingEditEuler);
+	}
+}
+
+void ViewerGUI::ViewerGLFW::recursiveHierarchyRenderUI(int boneidx) {
 	ImGui::Indent(INDENT_SIZE);
 	m_IndentCount++;
-	for (auto childidx : children)
+	for (auto childidx : m_RowCache[boneidx].children)
 	{
 		auto& bone = m_InternalPawn.bones[childidx];
 		renderBoneUI(childidx, bone, m_IndentCount);
-		recursiveHierarchyRenderUI(bone.id);
+		recursiveHierarchyRenderUI(childidx);
 	}
 	ImGui::Unindent(INDENT_SIZE);
 	m_IndentCount--;
 }
 
+void ViewerGUI::ViewerGLFW::rebuildRowCache() {
+	m_RowCache.assign(m_InternalPawn.bones.size(), BoneRowCache());
+	for (int i = 0; i < m_InternalPawn.bones.size(); i++) {
+		const auto& bone = m_InternalPawn.bones[i];
+		m_RowCache[i].label = "[" + std::to_string(bone.id) + "] " + bone.displayName;
+	}
+	relinkRowCache();
+}
+
+void ViewerGUI::ViewerGLFW::refreshRowCache(const std::vector<ID>& boneids) {
+	for (ID boneid : boneids) {
+		auto found = m_CoordById.find(boneid);
+		if (found != m_CoordById.end()) {
+			const auto& bone = m_InternalPawn.bones[found->second];
+			m_RowCache[found->second].label = "[" + std::to_string(bone.id) + "] " + bone.displayName;
+		}
+	}
+	relinkRowCache();
+}
+
+void ViewerGUI::ViewerGLFW::relinkRowCache() {
+	/* the first bone with a given id wins, same as PoseDataUtil::pawnFindBoneId */
+	auto& coords = m_CoordById;
+	coords.clear();
+	coords.reserve(m_InternalPawn.bones.size());
+	for (int i = 0; i < m_InternalPawn.bones.size(); i++)
+		coords.emplace(m_InternalPawn.bones[i].id, i);
+
+	m_RootRows.clear();
+	for (auto& row : m_RowCache)
+		row.children.clear();
+	for (int i = 0; i < m_InternalPawn.bones.size(); i++) {
+		ID parent = m_InternalPawn.bones[i].parent;
+		auto found = coords.find(parent);
+		m_RowCache[i].parentCoord = found != coords.end() ? found->second : -1;
+		if (parent == -1)
+			m_RootRows.push_back(i);
+		else if (m_RowCache[i].parentCoord >= 0)
+			m_RowCache[m_RowCache[i].parentCoord].children.push_back(i);
+	}
+}
+
 GLuint ViewerGUI::ViewerGLFW::createGLTextureBuffer(std::string path) {
 	GLuint tex = 0;
 
@@ -328,6 +777,7 @@ void ViewerGUI::ViewerGLFW::destroyGLTextureBuffer(GLuint handle) {
 }
 
 void ViewerGUI::ViewerGLFW::updateRender() {
+	PROFILE_SCOPE("ViewerGLFW::updateRender");
 	glClear(GL_COLOR_BUFFER_BIT);
 
 	ImGui_ImplOpenGL3_NewFrame();
@@ -347,6 +797,7 @@ void ViewerGUI::ViewerGLFW::updateRender() {
 }
 
 void ViewerGUI::ViewerGLFW::updateEvents() {
+	PROFILE_SCOPE("ViewerGLFW::updateEvents");
 	glfwPollEvents();
 
 	/* Detect closing of the window */
@@ -367,6 +818,12 @@ void ViewerGUI::ViewerGLFW::update() {
 }
 
 void ViewerGUI::ViewerGLFW::cleanUp() {
+	if (!m_Window) {
+		/* headless viewer only owns the imgui context */
+		ImGui::DestroyContext();
+		return;
+	}
+
 	/* clean up imgui */
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
@@ -384,8 +841,58 @@ void ViewerGUI::ViewerGLFW::cleanUp() {
 	glfwTerminate();
 }
 
-void ViewerGUI::ViewerGLFW::updateView(const PoseData::BonePawn currentPawn) {
-	m_InternalPawn = PoseDataUtil::pawnDeepCopy(currentPawn);
+void ViewerGUI::ViewerGLFW::updateView(const PoseData::BonePawn& currentPawn, const PoseData::PawnDelta& delta) {
+	PROFILE_SCOPE("ViewerGLFW::updateView");
+	bool synced = !delta.structure && m_RowCache.size() == currentPawn.bones.size();
+	if (synced) {
+		/* patch only the bones reported by the model, so small edits do not depend on the pawn size */
+		for (ID boneid : delta.labels) {
+			auto found = m_CoordById.find(boneid);
+			if (found == m_CoordById.end() || currentPawn.bones[found->second].id != boneid) {
+				synced = false; // the bone moved, fall back to a full copy
+				break;
+			}
+			auto& bone = m_InternalPawn.bones[found->second];
+			bone.parent = currentPawn.bones[found->second].parent;
+			bone.displayName = currentPawn.bones[found->second].displayName;
+		}
+	}
+	if (synced) {
+		for (ID boneid : delta.rotations) {
+			auto found = m_CoordById.find(boneid);
+			if (boneid == m_EditBoneId || found == m_CoordById.end())
+				continue; // the dragged bone keeps showing the local preview until the edit is committed.
+			auto& bone = m_InternalPawn.bones[found->second];
+			bone.quaternion = currentPawn.bones[found->second].quaternion;
+			bone.eulerRotation = currentPawn.bones[found->second].eulerRotation;
+		}
+		for (ID boneid : delta.offsets) {
+			auto found = m_CoordById.find(boneid);
+			if (found != m_CoordById.end())
+				m_InternalPawn.bones[found->second].offset = currentPawn.bones[found->second].offset;
+		}
+		for (ID boneid : delta.limits) {
+			auto found = m_CoordById.find(boneid);
+			if (found != m_CoordById.end())
+				m_InternalPawn.bones[found->second].limit = currentPawn.bones[found->second].limit;
+		}
+		for (ID boneid : delta.constraints) {
+			auto found = m_CoordById.find(boneid);
+			if (found != m_CoordById.end())
+				m_InternalPawn.bones[found->second].constraint = currentPawn.bones[found->second].constraint;
+		}
+		if (!delta.labels.empty())
+			refreshRowCache(delta.labels);
+		m_InternalPawn.originalFilePath = currentPawn.originalFilePath;
+		m_InternalPawn.originalFileName = currentPawn.originalFileName;
+		m_InternalPawn.loaded = currentPawn.loaded;
+		m_InternalPawn.saved = currentPawn.saved;
+		m_InternalPawn.rotationOrder = currentPawn.rotationOrder;
+	}
+	else {
+		m_InternalPawn = PoseDataUtil::pawnDeepCopy(currentPawn);
+		rebuildRowCache();
+	}
 
 	std::stringstream ss("");
 	if (m_InternalPawn.loaded)
@@ -395,8 +902,60 @@ void ViewerGUI::ViewerGLFW::updateView(const PoseData::BonePawn currentPawn) {
 	if (!m_InternalPawn.saved)
 		ss << "* - Unsaved Changes";
 	ss.flush();
-	glfwSetWindowTitle(m_Window, ss.str().c_str());
+	if (m_Window)
+		glfwSetWindowTitle(m_Window, ss.str().c_str());
 	// the UI will adapt on the next render call.
 }
 
+bool ViewerGUI::ViewerGLFW::initHeadless(float displayWidth, float displayHeight) {
+	m_Window = nullptr;
+
+	/* configure imgui without any platform or renderer bindings */
+	IMGUI_CHECKVERSION();
+	ImGui::CreateContext();
+	ImGuiIO& io = ImGui::GetIO();
+	io.DisplaySize = ImVec2(displayWidth, displayHeight);
+	io.IniFilename = nullptr; // do not touch imgui.ini of the interactive editor
+	/* the renderer backend normally builds the font atlas, so it has to be done by hand */
+	unsigned char* pixels;
+	int width, height;
+	io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+
+	/* icons are left as texture 0, imgui only passes the id through to the draw commands */
+	m_upIcon = m_downIcon = m_childIcon = m_closeIcon = 0;
+	return true;
+}
+
+ViewerGUI::FrameStats ViewerGUI::ViewerGLFW::renderHeadlessFrame() {
+	FrameStats stats;
+	ImGui::GetIO().DeltaTime = 1.0f / 60.0f;
+
+	auto begin = std::chrono::high_resolution_clock::now();
+	ImGui::NewFrame();
+	renderUI();
+	ImGui::Render();
+	auto end = std::chrono::high_resolution_clock::now();
+	stats.cpuTime = std::chrono::duration<double, std::milli>(end - begin).count();
+
+	ImDrawData* drawData = ImGui::GetDrawData();
+	stats.vertexCount = drawData->TotalVtxCount;
+	stats.indexCount = drawData->TotalIdxCount;
+	for (int i = 0; i < drawData->CmdListsCount; i++)
+		stats.drawCommandCount += drawData->CmdLists[i]->CmdBuffer.Size;
+	return stats;
+}
+
+void ViewerGUI::ViewerGLFW::updateClip(const PoseData::ClipState& clip) {
+	m_ClipState = clip;
+}
+
+void ViewerGUI::ViewerGLFW::updateLibrary(const PoseData::LibraryState& library) {
+	m_LibraryState = library;
+}
+
+void ViewerGUI::ViewerGLFW::setDisplayMode(bool showHierarchy, bool showSimple) {
+	m_ShowHierarchy = showHierarchy;
+	m_ShowSimple = showSimple;
+}
+
 void ViewerGUI::ViewerGLFW::setController(std::shared_ptr<PoseEditor::Controller> _controller) { m_Controller = _controller; }
\ No newline at end of file
@@ -13,6 +13,10 @@
 
 #include <memory>
 #include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <CImg/CImg.h>
@@ -21,6 +25,9 @@
 #include "../ControllerInterface.h"
 #include "../ModelInterface.h"
 #include "../model/PoseDataUtil.h"
+#include "../model/PoseClip.h"
+#include "../model/PoseCluster.h"
+#include "../profiler/Profiler.h"
 
 #include "../imgui/imgui.h"
 #include "../imgui/imgui_impl_opengl3.h"
@@ -34,6 +41,32 @@
 
 namespace ViewerGUI {
 
+	/// <summary>
+	/// Cost of a single UI frame as measured by renderHeadlessFrame(). Counts are read from ImDrawData after ImGui::Render().
+	/// </summary>
+	struct FrameStats {
+		/// <summary>CPU time spent between ImGui::NewFrame() and ImGui::Render() in milliseconds.</summary>
+		double cpuTime = 0;
+		int vertexCount = 0;
+		int indexCount = 0;
+		int drawCommandCount = 0;
+		/// <summary>Heap allocations during the frame. Only measured by the Benchmark module, which hooks the allocators.</summary>
+		int allocationCount = 0;
+	};
+
+	/// <summary>
+	/// Strings and lookups derived from a single bone of the viewer's internal pawn. Kept between frames,
+	/// so that drawing a row does not need to format or search anything.
+	/// </summary>
+	struct BoneRowCache {
+		/// <summary>"[id] name" label of the row.</summary>
+		std::string label;
+		/// <summary>Offset of the parent bone in the internal pawn (its display name is the parent name shown). -1 if not found.</summary>
+		int parentCoord = -1;
+		/// <summary>Offsets of the child bones in the internal pawn. Used by the hierarchy display.</summary>
+		std::vector<int> children;
+	};
+
 	/// <summary>
 	///		Specific implementation of the ViewerInterface.
 	///		You could substitute a headless or some other graphics library implementation
@@ -41,8 +74,8 @@ namespace ViewerGUI {
 	/// </summary>
 	class ViewerGLFW : public PoseEditor::Viewer {
 	private:
-		/// <summary>GLFW application window</summary>
-		GLFWwindow* m_Window;
+		/// <summary>GLFW application window. Stays null when the viewer runs headless (see initHeadless())</summary>
+		GLFWwindow* m_Window = nullptr;
 		/// <summary>Controller to report any user input operations to:</summary>
 		std::shared_ptr<PoseEditor::Controller> m_Controller;
 		/// <summary>
@@ -52,14 +85,59 @@ namespace ViewerGUI {
 		/// The alternative would be reading from the model on every frame.
 		/// </summary>
 		PoseData::BonePawn m_InternalPawn;
+		/// <summary>
+		/// Per-row cache matching m_InternalPawn.bones by offset. Only rows whose bone changed id, name or parent
+		/// are refreshed by updateView(), so steady-state frames do not allocate.
+		/// </summary>
+		std::vector<BoneRowCache> m_RowCache;
+		/// <summary>Offsets of the root bones in m_InternalPawn. Used by the hierarchy display.</summary>
+		std::vector<int> m_RootRows;
+		/// <summary>Maps bone ID to its offset in m_InternalPawn. Rebuilt together with the row links.</summary>
+		std::unordered_map<ID, int> m_CoordById;
+		/// <summary>Bone whose rotation slider is being dragged. Its rotation is a local preview until the edit ends. -1 if none.</summary>
+		ID m_EditBoneId = -1;
+		/// <summary>true if a rotation change waits to be sent to the Controller at the end of the frame.</summary>
+		bool m_PendingEdit = false;
+		/// <summary>Bone of the waiting rotation change.</summary>
+		ID m_PendingEditBoneId = -1;
+		/// <summary>Euler angles of the waiting rotation change.</summary>
+		glm::vec3 m_PendingEditEuler = glm::vec3(0, 0, 0);
 		/// <summary> toggles display of indented hierarchy of bones. </summary>
 		bool m_ShowHierarchy = false;
 		/// <summary> toggles display of bone editing tools. </summary>
 		bool m_ShowSimple = false;
+		/// <summary> toggles display of the profiler overlay window. </summary>
+		bool m_ShowProfiler = false;
+		/// <summary> statistics shown by the profiler overlay. Kept between frames to avoid allocations. </summary>
+		std::vector<Profiler::PhaseStats> m_ProfilerStats;
 		/// <summary> toggles window closing confirmation. Needed, because ImGui can only prompt popups during its update loop and closing may happen outside of that. </summary>
 		bool m_PopupCloseNoSave = false;
 		ImGui::FileBrowser m_FileOpenDialog;
 		ImGui::FileBrowser m_FileSaveDialog;
+		ImGui::FileBrowser m_ClipOpenDialog;
+		ImGui::FileBrowser m_ClipSaveDialog;
+		ImGui::FileBrowser m_LibraryOpenDialog;
+		ImGui::FileBrowser m_LibrarySaveDialog;
+		/// <summary>Copy of the clip state updated by the controller, the timeline is drawn from it.</summary>
+		PoseData::ClipState m_ClipState;
+		/// <summary>true while the timeline plays the clip.</summary>
+		bool m_ClipPlaying = false;
+		/// <summary>settings of the timeline's key reduction and the outcome of its last run.</summary>
+		float m_ReduceTolerance = 0.5f;
+		bool m_ReduceGlobal = false;
+		PoseData::KeyReduction m_ReduceReport;
+		/// <summary>Copy of the library state updated by the controller, the library browser is drawn from it.</summary>
+		PoseData::LibraryState m_LibraryState;
+		/// <summary>settings of the library's similarity search, a radius of 0 finds poses at any distance.</summary>
+		int m_SearchCount = 10;
+		float m_SearchRadius = 0.0f;
+		bool m_SearchGlobal = false;
+		/// <summary>settings of the library's clustering and deduplication, which share the search's choice of feature, and the outcome of the last run.</summary>
+		int m_ClusterCount = 256;
+		float m_DedupThreshold = 1.0f;
+		PoseData::ClusterReport m_ClusterReport;
+		/// <summary>file the last run wrote the cluster of every pose to, empty for a library not saved yet.</summary>
+		std::string m_ClusterMapping;
 		ImFont* m_Font;
 		/// <summary>OpenGL texture bufffer handle for the up icon.</summary>
 		int m_IndentCount = 0;
@@ -87,6 +165,21 @@ namespace ViewerGUI {
 		/// </summary>
 		void renderUI();
 
+		/// <summary>
+		/// Displays the rolling frame phase statistics collected by the Profiler.
+		/// </summary>
+		void renderProfilerUI();
+
+		/// <summary>
+		/// Displays the timeline of the open clip: playback, the time slider and keying of the current pose.
+		/// </summary>
+		void renderTimelineUI();
+
+		/// <summary>
+		/// Displays the browser of the open pose library: the pose slider and adding the current pose.
+		/// </summary>
+		void renderLibraryUI();
+
 		/// <summary>
 		/// Displays options related to a particular bone. (Within an existing imgui panel)
 		/// </summary>
@@ -96,9 +189,35 @@ namespace ViewerGUI {
 		void renderBoneUI(int boneidx, PoseData::BoneData& bone, int indent = 0);
 
 		/// <summary>
-		/// Displays indented hierarchy for all children of the bone with ID boneId.
+		/// Displays indented hierarchy for all children of the bone at offset boneidx.
+		/// </summary>
+		void recursiveHierarchyRenderUI(int boneidx);
+
+		/// <summary>
+		/// Call right after a rotation slider of the provided bone. Opens and commits the edit transaction as the slider
+		/// is grabbed and released and queues the new rotation, so the Controller receives at most one command per frame.
+		/// </summary>
+		/// <param name="changed">value returned by the slider.</param>
+		void trackRotationEdit(const PoseData::BoneData& bone, bool changed);
+
+		/// <summary>
+		/// Sends the rotation change queued by trackRotationEdit() to the Controller.
+		/// </summary>
+		void flushPendingEdit();
+
+		/// <summary>
+		/// Recreates m_RowCache and m_RootRows for the whole internal pawn.
+		/// </summary>
+		void rebuildRowCache();
+		/// <summary>
+		/// Reformats the labels of the provided bones and relinks parents and children of all rows. (No strings are touched for the rest)
+		/// </summary>
+		/// <param name="boneids">IDs of bones whose id, name or parent changed.</param>
+		void refreshRowCache(const std::vector<ID>& boneids);
+		/// <summary>
+		/// Recomputes parentCoord and children of every row as well as m_RootRows and m_CoordById.
 		/// </summary>
-		void recursiveHierarchyRenderUI(ID boneId);
+		void relinkRowCache();
 
 		/// <summary>
 		/// Loads the BMP image in the provided path into an OpenGL texture.
@@ -136,7 +255,37 @@ namespace ViewerGUI {
 		/// It is important that this reference is const to avoid improper application design.
 		/// </summary>
 		/// <param name="currentPawn">Const reference to the active pawn in the model.</param>
-		void updateView(const PoseData::BonePawn currentPawn) override;
+		/// <param name="delta">Which bones of the pawn changed since the last call.</param>
+		void updateView(const PoseData::BonePawn& currentPawn, const PoseData::PawnDelta& delta) override;
+
+		/// <summary>
+		/// Called by the controller whenever the animation clip, or the time shown from it, changes.
+		/// </summary>
+		/// <param name="clip">Const reference to the state of the clip held by the controller.</param>
+		void updateClip(const PoseData::ClipState& clip) override;
+
+		/// <summary>
+		/// Called by the controller whenever the pose library, or the pose shown from it, changes.
+		/// </summary>
+		/// <param name="library">Const reference to the state of the library held by the controller.</param>
+		void updateLibrary(const PoseData::LibraryState& library) override;
+
+		// === headless functions ===
+
+		/// <summary>
+		/// Alternative to init() which creates only the ImGui context with a dummy display size and no window or renderer backend.
+		/// Used to measure the cost of renderUI() on machines without a GPU. cleanUp() works for both modes.
+		/// </summary>
+		bool initHeadless(float displayWidth, float displayHeight);
+		/// <summary>
+		/// Runs a single ImGui frame of renderUI() without drawing it. Requires initHeadless().
+		/// </summary>
+		/// <returns>timing and draw data counts of the frame.</returns>
+		FrameStats renderHeadlessFrame();
+		/// <summary>
+		/// Sets the bone list display toggles otherwise controlled by the checkboxes in the Bone Editor window.
+		/// </summary>
+		void setDisplayMode(bool showHierarchy, bool showSimple);
 	};
 
 }
\ No newline at end of file